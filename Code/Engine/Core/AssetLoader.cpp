@@ -0,0 +1,490 @@
+#include "AssetLoader.hpp"
+#include "Image.hpp"
+#include "Time.hpp"
+#include "OBJLoader.hpp"
+#include "StringUtils.hpp"
+#include "ErrorWarningAssert.hpp"
+#include "EngineCommon.hpp"
+#include "Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/CPUMesh.hpp"
+#include "Engine/Simulations/RigidBody3D.hpp"
+#include "Engine/Simulations/Collider3D.hpp"
+
+//-----------------------------------------------------------------------------------------------
+class TextureLoadJob : public AssetLoadJob
+{
+public:
+	TextureLoadJob(std::string const& imageFilePath) :AssetLoadJob(AssetType::TEXTURE, imageFilePath) {}
+	virtual ~TextureLoadJob() { delete m_image; }
+
+	virtual bool Decode() override
+	{
+		m_image = new Image();
+		if (!m_image->LoadFromFile(m_path.c_str()))
+		{
+			delete m_image;
+			m_image = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	virtual bool Finalize(Renderer* renderer) override
+	{
+		m_texture = renderer->CreateOrGetTextureFromImage(*m_image);
+		delete m_image;
+		m_image = nullptr;
+		return m_texture != nullptr;
+	}
+
+	virtual void* GetAsset() const override { return m_texture; }
+
+public:
+	Image*		m_image = nullptr;
+	Texture*	m_texture = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+class BitmapFontLoadJob : public AssetLoadJob
+{
+public:
+	BitmapFontLoadJob(std::string const& fontFilePathNoExtension) :AssetLoadJob(AssetType::BITMAP_FONT, fontFilePathNoExtension) {}
+	virtual ~BitmapFontLoadJob() { delete m_image; }
+
+	virtual bool Decode() override
+	{
+		std::string fileWithExtension = m_path + ".png";
+		m_image = new Image();
+		if (!m_image->LoadFromFile(fileWithExtension.c_str()))
+		{
+			delete m_image;
+			m_image = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	virtual bool Finalize(Renderer* renderer) override
+	{
+		m_font = renderer->CreateOrGetBitmapFontFromImage(m_path.c_str(), *m_image);
+		delete m_image;
+		m_image = nullptr;
+		return m_font != nullptr;
+	}
+
+	virtual void* GetAsset() const override { return m_font; }
+
+public:
+	Image*		m_image = nullptr;
+	BitmapFont*	m_font = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+class OBJMeshLoadJob : public AssetLoadJob
+{
+public:
+	OBJMeshLoadJob(std::string const& objFilePath, Mat44 const& transform) :AssetLoadJob(AssetType::OBJ_MESH, objFilePath), m_transform(transform) {}
+	virtual ~OBJMeshLoadJob() { delete m_mesh; }
+
+	virtual bool Decode() override
+	{
+		m_mesh = new CPUMesh();
+		OBJLoader::Load(m_path, m_mesh->m_vertices, m_mesh->m_indices, m_transform);
+		if (m_mesh->m_vertices.empty())
+		{
+			delete m_mesh;
+			m_mesh = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	virtual bool Finalize(Renderer* renderer) override
+	{
+		UNUSED(renderer);
+		return true;
+	}
+
+	virtual void* GetAsset() const override { return m_mesh; }
+
+public:
+	Mat44		m_transform;
+	CPUMesh*	m_mesh = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+class RigidBodyLoadJob : public AssetLoadJob
+{
+public:
+	RigidBodyLoadJob(std::string const& xmlFilePath, float totalMass) :AssetLoadJob(AssetType::RIGID_BODY, xmlFilePath), m_totalMass(totalMass) {}
+	virtual ~RigidBodyLoadJob() { delete m_rigidBody; }
+
+	virtual bool Decode() override
+	{
+		m_rigidBody = new RigidBody3D(m_path, m_totalMass);
+		if (m_rigidBody->m_collider->m_hull == nullptr)
+		{
+			delete m_rigidBody;
+			m_rigidBody = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	virtual bool Finalize(Renderer* renderer) override
+	{
+		UNUSED(renderer);
+		return true;
+	}
+
+	virtual void* GetAsset() const override { return m_rigidBody; }
+
+public:
+	float			m_totalMass = 0.0f;
+	RigidBody3D*	m_rigidBody = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+AssetLoadJob::AssetLoadJob(AssetType type, std::string const& path)
+	:m_path(path)
+	,m_type(type)
+{
+	m_jobType = JOB_TYPE_ASSET_LOAD;
+	m_stats.m_path = path;
+	m_stats.m_type = type;
+	m_stats.m_requestTimeSeconds = GetCurrentTimeSeconds();
+	m_stats.m_numRequests = 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoadJob::Execute()
+{
+	m_statsMutex.lock();
+	m_stats.m_decodeStartTimeSeconds = GetCurrentTimeSeconds();
+	m_statsMutex.unlock();
+
+	m_loadStatus = AssetLoadStatus::DECODING;
+	bool wasDecoded = Decode();
+
+	m_statsMutex.lock();
+	m_stats.m_decodeEndTimeSeconds = GetCurrentTimeSeconds();
+	m_statsMutex.unlock();
+
+	m_loadStatus = wasDecoded ? AssetLoadStatus::AWAITING_UPLOAD : AssetLoadStatus::FAILED;
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetLoadStats AssetLoadJob::GetStats() const
+{
+	m_statsMutex.lock();
+	AssetLoadStats stats = m_stats;
+	m_statsMutex.unlock();
+	return stats;
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetLoader::AssetLoader(AssetLoaderConfig const& config)
+	:m_config(config)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetLoader::~AssetLoader()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::Startup()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::Shutdown()
+{
+	//Loads still queued on a quitting job system will never run, so only wait while workers are alive
+	if (g_theJobSystem != nullptr && !g_theJobSystem->IsQuitting())
+	{
+		WaitUntilAllReady();
+	}
+
+	m_loadsMutex.lock();
+	for (int typeIndex = 0; typeIndex < static_cast<int>(AssetType::COUNT); typeIndex++)
+	{
+		for (auto loadItr = m_loadsByPath[typeIndex].begin(); loadItr != m_loadsByPath[typeIndex].end(); loadItr++)
+		{
+			//Meshes and rigid bodies belong to their load job, textures and fonts belong to the renderer
+			AssetLoadJob* loadJob = loadItr->second;
+			AssetLoadStatus status = loadJob->GetLoadStatus();
+			if (status == AssetLoadStatus::READY || status == AssetLoadStatus::FAILED)
+			{
+				delete loadJob;
+			}
+		}
+		m_loadsByPath[typeIndex].clear();
+	}
+	m_pendingUploads.clear();
+	m_loadsMutex.unlock();
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::BeginFrame()
+{
+	PumpCompletedLoads(m_config.m_maxUploadsPerFrame);
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::EndFrame()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetHandle<Texture> AssetLoader::LoadTextureAsync(char const* imageFilePath)
+{
+	m_loadsMutex.lock();
+	AssetLoadJob* loadJob = FindLoad(AssetType::TEXTURE, imageFilePath);
+	if (loadJob == nullptr)
+	{
+		TextureLoadJob* textureLoadJob = new TextureLoadJob(imageFilePath);
+		Texture* existingTexture = m_config.m_renderer->GetTextureForFileName(imageFilePath);
+		if (existingTexture)
+		{
+			//Already loaded synchronously, so there is nothing left to decode or upload
+			textureLoadJob->m_texture = existingTexture;
+			textureLoadJob->m_loadStatus = AssetLoadStatus::READY;
+			m_loadsByPath[static_cast<int>(AssetType::TEXTURE)][imageFilePath] = textureLoadJob;
+		}
+		else
+		{
+			QueueLoad(imageFilePath, textureLoadJob);
+		}
+		loadJob = textureLoadJob;
+	}
+	m_loadsMutex.unlock();
+	return AssetHandle<Texture>(loadJob);
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetHandle<BitmapFont> AssetLoader::LoadBitmapFontAsync(char const* bitmapFontFilePathWithNoExtension)
+{
+	m_loadsMutex.lock();
+	AssetLoadJob* loadJob = FindLoad(AssetType::BITMAP_FONT, bitmapFontFilePathWithNoExtension);
+	if (loadJob == nullptr)
+	{
+		BitmapFontLoadJob* fontLoadJob = new BitmapFontLoadJob(bitmapFontFilePathWithNoExtension);
+		BitmapFont* existingFont = m_config.m_renderer->GetBitMapFont(bitmapFontFilePathWithNoExtension);
+		if (existingFont)
+		{
+			fontLoadJob->m_font = existingFont;
+			fontLoadJob->m_loadStatus = AssetLoadStatus::READY;
+			m_loadsByPath[static_cast<int>(AssetType::BITMAP_FONT)][bitmapFontFilePathWithNoExtension] = fontLoadJob;
+		}
+		else
+		{
+			QueueLoad(bitmapFontFilePathWithNoExtension, fontLoadJob);
+		}
+		loadJob = fontLoadJob;
+	}
+	m_loadsMutex.unlock();
+	return AssetHandle<BitmapFont>(loadJob);
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetHandle<CPUMesh> AssetLoader::LoadOBJMeshAsync(char const* objFilePath, Mat44 const& transform)
+{
+	//The transform is baked into the vertices, so the same file under a different transform is a different mesh
+	std::string key = objFilePath;
+	for (int valueIndex = 0; valueIndex < 16; valueIndex++)
+	{
+		key += Stringf("|%.9g", transform.m_values[valueIndex]);
+	}
+
+	m_loadsMutex.lock();
+	AssetLoadJob* loadJob = FindLoad(AssetType::OBJ_MESH, key);
+	if (loadJob == nullptr)
+	{
+		loadJob = new OBJMeshLoadJob(objFilePath, transform);
+		QueueLoad(key, loadJob);
+	}
+	m_loadsMutex.unlock();
+	return AssetHandle<CPUMesh>(loadJob);
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetHandle<RigidBody3D> AssetLoader::LoadRigidBodyDefinitionAsync(char const* xmlFilePath, float totalMass)
+{
+	//The cooked body is a definition, so the same file with a different mass is a different asset
+	std::string key = Stringf("%s|%f", xmlFilePath, totalMass);
+
+	m_loadsMutex.lock();
+	AssetLoadJob* loadJob = FindLoad(AssetType::RIGID_BODY, key);
+	if (loadJob == nullptr)
+	{
+		loadJob = new RigidBodyLoadJob(xmlFilePath, totalMass);
+		QueueLoad(key, loadJob);
+	}
+	m_loadsMutex.unlock();
+	return AssetHandle<RigidBody3D>(loadJob);
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::WaitUntilReady(AssetLoadJob* loadJob)
+{
+	while (loadJob->GetLoadStatus() != AssetLoadStatus::READY && loadJob->GetLoadStatus() != AssetLoadStatus::FAILED)
+	{
+		if (PumpCompletedLoads(-1) == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(10));
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::WaitUntilAllReady()
+{
+	while (m_numInFlightLoads > 0)
+	{
+		if (PumpCompletedLoads(-1) == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(10));
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+int AssetLoader::GetNumInFlightLoads()
+{
+	return m_numInFlightLoads;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool AssetLoader::GetLoadStats(AssetType type, std::string const& path, AssetLoadStats& outStats)
+{
+	m_loadsMutex.lock();
+	std::map<std::string, AssetLoadJob*> const& loadsForType = m_loadsByPath[static_cast<int>(type)];
+	auto found = loadsForType.find(path);
+	if (found == loadsForType.end())
+	{
+		//Meshes and rigid bodies are keyed by their load parameters too, so fall back to the first load of that file
+		for (found = loadsForType.begin(); found != loadsForType.end(); found++)
+		{
+			if (found->second->m_path == path)
+			{
+				break;
+			}
+		}
+	}
+	if (found == loadsForType.end())
+	{
+		m_loadsMutex.unlock();
+		return false;
+	}
+
+	outStats = found->second->GetStats();
+	m_loadsMutex.unlock();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+std::vector<AssetLoadStats> AssetLoader::GetAllLoadStats()
+{
+	std::vector<AssetLoadStats> allStats;
+
+	m_loadsMutex.lock();
+	for (int typeIndex = 0; typeIndex < static_cast<int>(AssetType::COUNT); typeIndex++)
+	{
+		for (auto loadItr = m_loadsByPath[typeIndex].begin(); loadItr != m_loadsByPath[typeIndex].end(); loadItr++)
+		{
+			allStats.push_back(loadItr->second->GetStats());
+		}
+	}
+	m_loadsMutex.unlock();
+
+	return allStats;
+}
+
+//-----------------------------------------------------------------------------------------------
+AssetLoadJob* AssetLoader::FindLoad(AssetType type, std::string const& key)
+{
+	std::map<std::string, AssetLoadJob*>& loadsForType = m_loadsByPath[static_cast<int>(type)];
+	auto found = loadsForType.find(key);
+	if (found == loadsForType.end())
+	{
+		return nullptr;
+	}
+
+	AssetLoadJob* loadJob = found->second;
+	loadJob->m_statsMutex.lock();
+	loadJob->m_stats.m_numRequests++;
+	loadJob->m_statsMutex.unlock();
+	return loadJob;
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::QueueLoad(std::string const& key, AssetLoadJob* loadJob)
+{
+	m_loadsByPath[static_cast<int>(loadJob->m_type)][key] = loadJob;
+	m_numInFlightLoads++;
+
+	if (g_theJobSystem == nullptr)
+	{
+		//No workers to hand the decode to, so load in place and upload right away
+		loadJob->Execute();
+		m_pendingUploads.push_back(loadJob);
+		return;
+	}
+
+	g_theJobSystem->PostNewJob(loadJob);
+}
+
+//-----------------------------------------------------------------------------------------------
+void AssetLoader::FinalizeLoad(AssetLoadJob* loadJob)
+{
+	loadJob->m_statsMutex.lock();
+	loadJob->m_stats.m_uploadStartTimeSeconds = GetCurrentTimeSeconds();
+	loadJob->m_statsMutex.unlock();
+
+	bool wasFinalized = false;
+	if (loadJob->GetLoadStatus() == AssetLoadStatus::AWAITING_UPLOAD)
+	{
+		wasFinalized = loadJob->Finalize(m_config.m_renderer);
+	}
+
+	loadJob->m_statsMutex.lock();
+	loadJob->m_stats.m_readyTimeSeconds = GetCurrentTimeSeconds();
+	loadJob->m_statsMutex.unlock();
+
+	if (!wasFinalized)
+	{
+		DebuggerPrintf("AssetLoader failed to load \"%s\"\n", loadJob->m_path.c_str());
+	}
+
+	loadJob->m_loadStatus = wasFinalized ? AssetLoadStatus::READY : AssetLoadStatus::FAILED;
+	m_numInFlightLoads--;
+}
+
+//-----------------------------------------------------------------------------------------------
+int AssetLoader::PumpCompletedLoads(int maxUploads)
+{
+	if (g_theJobSystem != nullptr)
+	{
+		Job* completedJob = g_theJobSystem->RetreiveCompletedJob(JOB_TYPE_ASSET_LOAD);
+		while (completedJob != nullptr)
+		{
+			m_pendingUploads.push_back(static_cast<AssetLoadJob*>(completedJob));
+			completedJob = g_theJobSystem->RetreiveCompletedJob(JOB_TYPE_ASSET_LOAD);
+		}
+	}
+
+	int numUploads = 0;
+	while (!m_pendingUploads.empty() && (maxUploads < 0 || numUploads < maxUploads))
+	{
+		AssetLoadJob* loadJob = m_pendingUploads.front();
+		m_pendingUploads.pop_front();
+		FinalizeLoad(loadJob);
+		numUploads++;
+	}
+
+	return numUploads;
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include "JobSystem.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <atomic>
+#include <mutex>
+
+//-----------------------------------------------------------------------------------------------
+class	Renderer;
+class	Texture;
+class	BitmapFont;
+class	CPUMesh;
+class	RigidBody3D;
+struct	Mat44;
+class	AssetLoader;
+
+//-----------------------------------------------------------------------------------------------
+extern	AssetLoader* g_theAssetLoader;
+
+//-----------------------------------------------------------------------------------------------
+enum class AssetType
+{
+	TEXTURE,
+	BITMAP_FONT,
+	OBJ_MESH,
+	RIGID_BODY,
+	COUNT
+};
+
+//-----------------------------------------------------------------------------------------------
+enum class AssetLoadStatus
+{
+	QUEUED,
+	DECODING,
+	AWAITING_UPLOAD,
+	READY,
+	FAILED
+};
+
+//-----------------------------------------------------------------------------------------------
+struct AssetLoadStats
+{
+	double GetQueuedSeconds() const { return m_decodeStartTimeSeconds - m_requestTimeSeconds; }
+	double GetDecodeSeconds() const { return m_decodeEndTimeSeconds - m_decodeStartTimeSeconds; }
+	double GetUploadSeconds() const { return m_readyTimeSeconds - m_uploadStartTimeSeconds; }
+	double GetTotalSeconds() const { return m_readyTimeSeconds - m_requestTimeSeconds; }
+
+	std::string	m_path;
+	AssetType	m_type = AssetType::TEXTURE;
+	double		m_requestTimeSeconds = 0.0;
+	double		m_decodeStartTimeSeconds = 0.0;
+	double		m_decodeEndTimeSeconds = 0.0;
+	double		m_uploadStartTimeSeconds = 0.0;
+	double		m_readyTimeSeconds = 0.0;
+	int			m_numRequests = 0;					// includes requests that were deduplicated onto this load
+};
+
+//-----------------------------------------------------------------------------------------------
+// File read and decode run on a JobSystem worker, Finalize() runs on the main thread in BeginFrame
+class AssetLoadJob : public Job
+{
+	friend class AssetLoader;
+
+public:
+	AssetLoadJob(AssetType type, std::string const& path);
+	virtual ~AssetLoadJob() = default;
+
+	virtual void	Execute() override;
+	virtual bool	Decode() = 0;
+	virtual bool	Finalize(Renderer* renderer) = 0;
+	virtual void*	GetAsset() const = 0;
+
+	AssetLoadStatus	GetLoadStatus() const { return m_loadStatus; }
+	AssetLoadStats	GetStats() const;
+
+protected:
+	std::string						m_path;
+	AssetType						m_type = AssetType::TEXTURE;
+	std::atomic<AssetLoadStatus>	m_loadStatus = AssetLoadStatus::QUEUED;
+	AssetLoadStats					m_stats;
+	mutable std::mutex				m_statsMutex;
+};
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+class AssetHandle
+{
+public:
+	AssetHandle() = default;
+	explicit AssetHandle(AssetLoadJob* loadJob) :m_loadJob(loadJob) {}
+
+	bool			IsValid() const { return m_loadJob != nullptr; }
+	bool			IsReady() const { return IsValid() && m_loadJob->GetLoadStatus() == AssetLoadStatus::READY; }
+	bool			IsFailed() const { return IsValid() && m_loadJob->GetLoadStatus() == AssetLoadStatus::FAILED; }
+	AssetLoadStatus	GetStatus() const { return IsValid() ? m_loadJob->GetLoadStatus() : AssetLoadStatus::FAILED; }
+	T*				Get() const { return IsReady() ? static_cast<T*>(m_loadJob->GetAsset()) : nullptr; }
+	T*				Wait() const;
+
+private:
+	AssetLoadJob*	m_loadJob = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct AssetLoaderConfig
+{
+	Renderer*	m_renderer = nullptr;
+	int			m_maxUploadsPerFrame = 8;		// negative means no limit
+};
+
+//-----------------------------------------------------------------------------------------------
+class AssetLoader
+{
+public:
+	AssetLoader(AssetLoaderConfig const& config);
+	~AssetLoader();
+	void							Startup();
+	void							Shutdown();
+	void							BeginFrame();
+	void							EndFrame();
+
+	AssetHandle<Texture>			LoadTextureAsync(char const* imageFilePath);
+	AssetHandle<BitmapFont>			LoadBitmapFontAsync(char const* bitmapFontFilePathWithNoExtension);
+	AssetHandle<CPUMesh>			LoadOBJMeshAsync(char const* objFilePath, Mat44 const& transform);
+	AssetHandle<RigidBody3D>		LoadRigidBodyDefinitionAsync(char const* xmlFilePath, float totalMass);
+
+	void							WaitUntilReady(AssetLoadJob* loadJob);
+	void							WaitUntilAllReady();
+	int								GetNumInFlightLoads();
+	bool							GetLoadStats(AssetType type, std::string const& path, AssetLoadStats& outStats);
+	std::vector<AssetLoadStats>		GetAllLoadStats();
+
+protected:
+	AssetLoadJob*					FindLoad(AssetType type, std::string const& key);
+	void							QueueLoad(std::string const& key, AssetLoadJob* loadJob);
+	void							FinalizeLoad(AssetLoadJob* loadJob);
+	int								PumpCompletedLoads(int maxUploads);
+
+protected:
+	AssetLoaderConfig						m_config;
+	std::map<std::string, AssetLoadJob*>	m_loadsByPath[static_cast<int>(AssetType::COUNT)];
+	std::mutex								m_loadsMutex;
+	std::deque<AssetLoadJob*>				m_pendingUploads;
+	std::atomic<int>						m_numInFlightLoads = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+inline T* AssetHandle<T>::Wait() const
+{
+	if (!IsValid())
+	{
+		return nullptr;
+	}
+
+	g_theAssetLoader->WaitUntilReady(m_loadJob);
+	return Get();
+}
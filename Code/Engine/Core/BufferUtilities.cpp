@@ -12,6 +12,12 @@
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cstring>
+#include <cstddef>
+#if defined(__AVX__) || defined(__SSSE3__)
+#include <tmmintrin.h>
+#define BUFFER_UTILITIES_USE_SSSE3
+#endif
 
 //-----------------------------------------------------------------------------------------------
 BufferWriter::BufferWriter(std::vector<unsigned char>& buffer, EndianMode const& endianMode)
@@ -374,6 +380,134 @@ void BufferWriter::Reverse8Bytes(unsigned char*& bytesToReverse)
 	bytesToReverse[4] = tempChar4;
 }
 
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::Reserve(size_t numBytesToAppend)
+{
+	m_buffer.reserve(m_buffer.size() + numBytesToAppend);
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendBytes(void const* bytesToAppend, size_t numBytes)
+{
+	if (numBytes == 0)
+		return;
+
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>(bytesToAppend);
+	m_buffer.insert(m_buffer.end(), bytes, bytes + numBytes);
+}
+
+//-----------------------------------------------------------------------------------------------
+unsigned char* BufferWriter::AppendScalars(void const* scalarsToAppend, size_t numScalars, size_t scalarSizeInBytes)
+{
+	size_t numBytes = numScalars * scalarSizeInBytes;
+	size_t startOffset = m_buffer.size();
+	AppendBytes(scalarsToAppend, numBytes);
+	if (numBytes == 0)
+		return nullptr;
+
+	unsigned char* appendedBytes = &m_buffer[startOffset];
+	if (m_isEndianOppisiteOfPlatform && scalarSizeInBytes > 1)
+		ReverseBytesOfScalars(appendedBytes, numScalars, scalarSizeInBytes);
+
+	return appendedBytes;
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(unsigned char const* bytesToAppend, size_t count)
+{
+	AppendBytes(bytesToAppend, count);
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(unsigned short const* shortsToAppend, size_t count)
+{
+	AppendScalars(shortsToAppend, count, sizeof(unsigned short));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(unsigned int const* intsToAppend, size_t count)
+{
+	AppendScalars(intsToAppend, count, sizeof(unsigned int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(int const* intsToAppend, size_t count)
+{
+	AppendScalars(intsToAppend, count, sizeof(int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(float const* floatsToAppend, size_t count)
+{
+	AppendScalars(floatsToAppend, count, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(double const* doublesToAppend, size_t count)
+{
+	AppendScalars(doublesToAppend, count, sizeof(double));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(Vec2 const* vec2sToAppend, size_t count)
+{
+	static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 must be tightly packed floats");
+	AppendScalars(vec2sToAppend, count * 2, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(Vec3 const* vec3sToAppend, size_t count)
+{
+	static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 must be tightly packed floats");
+	AppendScalars(vec3sToAppend, count * 3, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(Vec4 const* vec4sToAppend, size_t count)
+{
+	static_assert(sizeof(Vec4) == 4 * sizeof(float), "Vec4 must be tightly packed floats");
+	AppendScalars(vec4sToAppend, count * 4, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(IntVec2 const* intVec2sToAppend, size_t count)
+{
+	static_assert(sizeof(IntVec2) == 2 * sizeof(int), "IntVec2 must be tightly packed ints");
+	AppendScalars(intVec2sToAppend, count * 2, sizeof(int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(IntVec3 const* intVec3sToAppend, size_t count)
+{
+	static_assert(sizeof(IntVec3) == 3 * sizeof(int), "IntVec3 must be tightly packed ints");
+	AppendScalars(intVec3sToAppend, count * 3, sizeof(int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(Rgba8 const* rgba8sToAppend, size_t count)
+{
+	static_assert(sizeof(Rgba8) == 4, "Rgba8 must be four bytes");
+	AppendBytes(rgba8sToAppend, count * sizeof(Rgba8));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferWriter::AppendArray(Vertex_PCU const* pcusToAppend, size_t count)
+{
+	static_assert(sizeof(Vertex_PCU) == sizeof(Vec3) + sizeof(Rgba8) + sizeof(Vec2), "Vertex_PCU must match the AppendVertexPCU layout");
+	size_t startOffset = m_buffer.size();
+	AppendBytes(pcusToAppend, count * sizeof(Vertex_PCU));
+	if (!m_isEndianOppisiteOfPlatform)
+		return;
+
+	//Color bytes are endian independent, only the position and uv floats get swapped
+	for (size_t vertIndex = 0; vertIndex < count; vertIndex++)
+	{
+		unsigned char* vertBytes = &m_buffer[startOffset + vertIndex * sizeof(Vertex_PCU)];
+		ReverseBytesOfScalars(vertBytes + offsetof(Vertex_PCU, m_position), 3, sizeof(float));
+		ReverseBytesOfScalars(vertBytes + offsetof(Vertex_PCU, m_uvTexCoords), 2, sizeof(float));
+	}
+}
+
 //-----------------------------------------------------------------------------------------------
 BufferParser::BufferParser(unsigned char const* bufferToParse, size_t bufferSizeInBytes, EndianMode const& endianMode)
 	:m_bufferStart(bufferToParse)
@@ -648,51 +782,153 @@ Vertex_PCU BufferParser::ParseVertexPCU()
 //-----------------------------------------------------------------------------------------------
 std::string BufferParser::ParseStringZeroTerminated()
 {
-	std::string returnString = "";
-	while(true)
-	{
-		char c = ParseChar();
-		if (c == '\0')
-			break;
-		returnString += c;
-	}
+	std::string_view stringInBuffer = ParseStringZeroTerminatedView();
+	if (m_isEndianOppisiteOfPlatform)
+		return std::string(stringInBuffer.rbegin(), stringInBuffer.rend());
 
+	return std::string(stringInBuffer);
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string BufferParser::ParseStringGivenSize32Bit(unsigned int size)
+{
+	std::string_view stringInBuffer = ParseStringGivenSize32BitView(size);
 	if (m_isEndianOppisiteOfPlatform)
-	{
-		std::string reverseString = "";
-		for(int index = int(returnString.length()) - 1; index >= 0; index--)
-		{
-			reverseString += returnString[index];
-		}
+		return std::string(stringInBuffer.rbegin(), stringInBuffer.rend());
 
-		return reverseString;
-	}
+	return std::string(stringInBuffer);
+}
+
+//-----------------------------------------------------------------------------------------------
+// The view points into the parsed buffer and is only valid while that buffer is alive.
+// Strings written with the opposite endian are stored reversed, so the view is too.
+std::string_view BufferParser::ParseStringZeroTerminatedView()
+{
+	unsigned char const* stringStart = &m_bufferStart[m_currentReadOffset];
+	void const* terminator = memchr(stringStart, '\0', GetRemainingBytes());
+	if (terminator == nullptr)
+		ERROR_AND_DIE("TRYING TO READ OUTSIDE BUFFER BOUNDS");
 
-	return returnString;
+	size_t length = reinterpret_cast<unsigned char const*>(terminator) - stringStart;
+	m_currentReadOffset += length + 1;
+	return std::string_view(reinterpret_cast<char const*>(stringStart), length);
 }
 
 //-----------------------------------------------------------------------------------------------
-std::string BufferParser::ParseStringGivenSize32Bit(unsigned int size)
+std::string_view BufferParser::ParseStringGivenSize32BitView(unsigned int size)
 {
-	std::string returnString = "";
-	for (unsigned int index = 0; index < size; index++)
-	{
-		char c = ParseChar();
-		returnString += c;
-	}
+	unsigned char const* stringStart = ParseBytes(size);
+	return std::string_view(reinterpret_cast<char const*>(stringStart), size);
+}
 
-	if (m_isEndianOppisiteOfPlatform)
-	{
-		std::string reverseString = "";
-		for (int index = int(returnString.length()) - 1; index >= 0; index--)
-		{
-			reverseString += returnString[index];
-		}
+//-----------------------------------------------------------------------------------------------
+unsigned char const* BufferParser::ParseBytes(size_t numBytes)
+{
+	if (numBytes > GetRemainingBytes())
+		ERROR_AND_DIE("TRYING TO READ OUTSIDE BUFFER BOUNDS");
 
-		return reverseString;
-	}
+	unsigned char const* bytesInBuffer = &m_bufferStart[m_currentReadOffset];
+	m_currentReadOffset += numBytes;
+	return bytesInBuffer;
+}
 
-	return returnString;
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseScalars(void* outScalars, size_t numScalars, size_t scalarSizeInBytes)
+{
+	size_t numBytes = numScalars * scalarSizeInBytes;
+	if (numBytes == 0)
+		return;
+
+	memcpy(outScalars, ParseBytes(numBytes), numBytes);
+	if (m_isEndianOppisiteOfPlatform && scalarSizeInBytes > 1)
+		ReverseBytesOfScalars(outScalars, numScalars, scalarSizeInBytes);
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(unsigned char* outBytes, size_t count)
+{
+	ParseScalars(outBytes, count, sizeof(unsigned char));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(unsigned short* outShorts, size_t count)
+{
+	ParseScalars(outShorts, count, sizeof(unsigned short));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(unsigned int* outInts, size_t count)
+{
+	ParseScalars(outInts, count, sizeof(unsigned int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(int* outInts, size_t count)
+{
+	ParseScalars(outInts, count, sizeof(int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(float* outFloats, size_t count)
+{
+	ParseScalars(outFloats, count, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(double* outDoubles, size_t count)
+{
+	ParseScalars(outDoubles, count, sizeof(double));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(Vec2* outVec2s, size_t count)
+{
+	ParseScalars(outVec2s, count * 2, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(Vec3* outVec3s, size_t count)
+{
+	ParseScalars(outVec3s, count * 3, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(Vec4* outVec4s, size_t count)
+{
+	ParseScalars(outVec4s, count * 4, sizeof(float));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(IntVec2* outIntVec2s, size_t count)
+{
+	ParseScalars(outIntVec2s, count * 2, sizeof(int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(IntVec3* outIntVec3s, size_t count)
+{
+	ParseScalars(outIntVec3s, count * 3, sizeof(int));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(Rgba8* outRgba8s, size_t count)
+{
+	ParseScalars(outRgba8s, count * sizeof(Rgba8), sizeof(unsigned char));
+}
+
+//-----------------------------------------------------------------------------------------------
+void BufferParser::ParseArray(Vertex_PCU* outPCUs, size_t count)
+{
+	ParseScalars(outPCUs, count * sizeof(Vertex_PCU), sizeof(unsigned char));
+	if (!m_isEndianOppisiteOfPlatform)
+		return;
+
+	for (size_t vertIndex = 0; vertIndex < count; vertIndex++)
+	{
+		unsigned char* vertBytes = reinterpret_cast<unsigned char*>(&outPCUs[vertIndex]);
+		ReverseBytesOfScalars(vertBytes + offsetof(Vertex_PCU, m_position), 3, sizeof(float));
+		ReverseBytesOfScalars(vertBytes + offsetof(Vertex_PCU, m_uvTexCoords), 2, sizeof(float));
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -739,3 +975,42 @@ void BufferParser::Reverse8Bytes(void* bytesToReverse)
 	bytes[5] = tempChar3;
 	bytes[4] = tempChar4;
 }
+
+//-----------------------------------------------------------------------------------------------
+void ReverseBytesOfScalars(void* scalarsToReverse, size_t numScalars, size_t scalarSizeInBytes)
+{
+	unsigned char* bytes = reinterpret_cast<unsigned char*>(scalarsToReverse);
+	size_t scalarIndex = 0;
+
+#ifdef BUFFER_UTILITIES_USE_SSSE3
+	//Swap 16 bytes at a time with a byte shuffle, the scalar loop below picks up the tail
+	if (scalarSizeInBytes == 2 || scalarSizeInBytes == 4 || scalarSizeInBytes == 8)
+	{
+		__m128i shuffleMask;
+		if (scalarSizeInBytes == 2)
+			shuffleMask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+		else if (scalarSizeInBytes == 4)
+			shuffleMask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+		else
+			shuffleMask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+		size_t scalarsPerBlock = 16 / scalarSizeInBytes;
+		for (; scalarIndex + scalarsPerBlock <= numScalars; scalarIndex += scalarsPerBlock)
+		{
+			__m128i* block = reinterpret_cast<__m128i*>(bytes + scalarIndex * scalarSizeInBytes);
+			_mm_storeu_si128(block, _mm_shuffle_epi8(_mm_loadu_si128(block), shuffleMask));
+		}
+	}
+#endif
+
+	for (; scalarIndex < numScalars; scalarIndex++)
+	{
+		unsigned char* scalarBytes = bytes + scalarIndex * scalarSizeInBytes;
+		for (size_t byteIndex = 0; byteIndex < scalarSizeInBytes / 2; byteIndex++)
+		{
+			unsigned char tempChar = scalarBytes[byteIndex];
+			scalarBytes[byteIndex] = scalarBytes[scalarSizeInBytes - 1 - byteIndex];
+			scalarBytes[scalarSizeInBytes - 1 - byteIndex] = tempChar;
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <string_view>
 #include <Engine/Core/FileUtils.hpp>
 
 //-----------------------------------------------------------------------------------------------
@@ -46,16 +47,41 @@ public:
 	void AppendStringZeroTerminated(std::string stringToAppend);
 	void AppendStringGivenSize32Bit(std::string stringToAppend, unsigned int size);
 	void OverwriteUInt32(uint32_t intToAppend, int position);
+	void Reserve(size_t numBytesToAppend);
+	size_t GetSizeInBytes() const { return m_buffer.size(); }
+
+	//Bulk appends memcpy the whole span, byte swapping each scalar only when the endian differs
+	void AppendBytes(void const* bytesToAppend, size_t numBytes);
+	void AppendArray(unsigned char const* bytesToAppend, size_t count);
+	void AppendArray(unsigned short const* shortsToAppend, size_t count);
+	void AppendArray(unsigned int const* intsToAppend, size_t count);
+	void AppendArray(int const* intsToAppend, size_t count);
+	void AppendArray(float const* floatsToAppend, size_t count);
+	void AppendArray(double const* doublesToAppend, size_t count);
+	void AppendArray(Vec2 const* vec2sToAppend, size_t count);
+	void AppendArray(Vec3 const* vec3sToAppend, size_t count);
+	void AppendArray(Vec4 const* vec4sToAppend, size_t count);
+	void AppendArray(IntVec2 const* intVec2sToAppend, size_t count);
+	void AppendArray(IntVec3 const* intVec3sToAppend, size_t count);
+	void AppendArray(Rgba8 const* rgba8sToAppend, size_t count);
+	void AppendArray(Vertex_PCU const* pcusToAppend, size_t count);
+
 	void Reverse2Bytes(unsigned char*& bytesToReverse);
 	void Reverse4Bytes(unsigned char*& bytesToReverse);
 	void Reverse8Bytes(unsigned char*& bytesToReverse);
 
+private:
+	unsigned char* AppendScalars(void const* scalarsToAppend, size_t numScalars, size_t scalarSizeInBytes);
+
 public:
 	EndianMode						m_currentEndian = EndianMode::NATIVE;
 	std::vector<unsigned char>&		m_buffer;
 	bool							m_isEndianOppisiteOfPlatform = false;
 };
 
+//-----------------------------------------------------------------------------------------------
+void ReverseBytesOfScalars(void* scalarsToReverse, size_t numScalars, size_t scalarSizeInBytes);
+
 //-----------------------------------------------------------------------------------------------
 class BufferParser
 {
@@ -85,15 +111,38 @@ public:
 	Vertex_PCU				ParseVertexPCU();
 	std::string				ParseStringZeroTerminated();
 	std::string				ParseStringGivenSize32Bit(unsigned int size);
+	std::string_view		ParseStringZeroTerminatedView();
+	std::string_view		ParseStringGivenSize32BitView(unsigned int size);
+	unsigned char const*	ParseBytes(size_t numBytes);
+	size_t					GetRemainingBytes() const { return m_bufferSizeInBytes - m_currentReadOffset; }
 	void					ShiftCurrentBufferReadPosition(int offset);
+
+	//Bulk parses copy straight out of the buffer into the caller's storage
+	void					ParseArray(unsigned char* outBytes, size_t count);
+	void					ParseArray(unsigned short* outShorts, size_t count);
+	void					ParseArray(unsigned int* outInts, size_t count);
+	void					ParseArray(int* outInts, size_t count);
+	void					ParseArray(float* outFloats, size_t count);
+	void					ParseArray(double* outDoubles, size_t count);
+	void					ParseArray(Vec2* outVec2s, size_t count);
+	void					ParseArray(Vec3* outVec3s, size_t count);
+	void					ParseArray(Vec4* outVec4s, size_t count);
+	void					ParseArray(IntVec2* outIntVec2s, size_t count);
+	void					ParseArray(IntVec3* outIntVec3s, size_t count);
+	void					ParseArray(Rgba8* outRgba8s, size_t count);
+	void					ParseArray(Vertex_PCU* outPCUs, size_t count);
+
 	void					Reverse2Bytes(void* addressToBytesToReverse);
 	void					Reverse4Bytes(void* bytesToReverse);
 	void					Reverse8Bytes(void* bytesToReverse);
 
+private:
+	void					ParseScalars(void* outScalars, size_t numScalars, size_t scalarSizeInBytes);
+
 public:
 	unsigned char const*	m_bufferStart = nullptr;
 	size_t					m_bufferSizeInBytes = 0;
 	size_t					m_currentReadOffset = 0;
 	EndianMode				m_currentEndian = EndianMode::NATIVE;
 	bool					m_isEndianOppisiteOfPlatform = false;
-};
\ No newline at end of file
+};
\ No newline at end of file
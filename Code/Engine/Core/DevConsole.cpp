@@ -108,16 +108,16 @@ void DevConsole::Execute(std::string const& consoleCommandText)
 		args.SetValue("argument", splitString[1]);
 	}
 
-	g_theEventSystem->FireEvent(eventName, args);
+	EventReturnStatus returnStatus = g_theEventSystem->FireEvent(eventName, args);
 
-	if (args.GetValue("returnValue", "") == "success")
+	if (returnStatus == EventReturnStatus::CONSUMED)
 	{
 		if (eventName != "Echo")
 		{
 			g_theDevConsole->AddLine(DevConsole::COMMAND_ECHO, consoleCommandText);
 		}
 	}
-	else if (args.GetValue("returnValue", "") == "failure")
+	else if (returnStatus == EventReturnStatus::UNKNOWN_EVENT)
 	{
 		std::string errorResponse = "Unknown Command: ";
 		errorResponse += eventName;
@@ -126,7 +126,7 @@ void DevConsole::Execute(std::string const& consoleCommandText)
 }
 
 //-----------------------------------------------------------------------------------------------
-void DevConsole::AddLine(Rgba8 const& color, HCIString const& text)
+void DevConsole::AddLine(Rgba8 const& color, std::string const& text)
 {
 	m_devConsoleMutex.lock();
 	DevConsoleLine line;
@@ -173,7 +173,7 @@ void DevConsole::Render(AABB2 const& bounds)
 		}
 
 		//Allows for rendering of large strings
-		Strings splitString = SplitStringOnDelimiter(m_lines[lineIndex].m_text.GetOriginalString(), '\n');
+		Strings splitString = SplitStringOnDelimiter(m_lines[lineIndex].m_text, '\n');
 		if (splitString.size() > 1)
 		{
 			for (int splitStringIndex = static_cast<int>(splitString.size()) - 1; splitStringIndex >= 0; splitStringIndex--)
@@ -190,7 +190,7 @@ void DevConsole::Render(AABB2 const& bounds)
 		}
 		else
 		{
-			theFont->AddVertsForTextInBox2D(textVerts, bounds, bounds.GetDimensions().y / m_config.m_linesOnScreen, m_lines[lineIndex].m_text.GetOriginalString(), m_lines[lineIndex].m_color, m_config.m_fontAspect, Vec2(0.0f, RangeMap(static_cast<float>(linePosition), 0.0f, 40.0f, 0.0f, 1.0f)), SHRINK_TO_FIT);
+			theFont->AddVertsForTextInBox2D(textVerts, bounds, bounds.GetDimensions().y / m_config.m_linesOnScreen, m_lines[lineIndex].m_text, m_lines[lineIndex].m_color, m_config.m_fontAspect, Vec2(0.0f, RangeMap(static_cast<float>(linePosition), 0.0f, 40.0f, 0.0f, 1.0f)), SHRINK_TO_FIT);
 			linePosition++;
 		}
 
@@ -255,9 +255,9 @@ bool DevConsole::IsOpen()
 }
 
 //-----------------------------------------------------------------------------------------------
-bool DevConsole::Event_KeyPressed(EventArgs& args)
+bool DevConsole::Event_KeyPressed(TypedEventArgs& args)
 {
-	unsigned char keyCode = static_cast<unsigned char>(args.GetValue("KeyCode", -1));
+	unsigned char keyCode = static_cast<unsigned char>(args.GetValue(EVENT_ARG_KEY_CODE, -1));
 	if (keyCode == KEYCODE_TILDE)
 	{
 		g_theDevConsole->ToggleOpen();
@@ -365,7 +365,7 @@ bool DevConsole::Event_KeyPressed(EventArgs& args)
 }
 
 //-----------------------------------------------------------------------------------------------
-bool DevConsole::Event_CharInput(EventArgs& args)
+bool DevConsole::Event_CharInput(TypedEventArgs& args)
 {
 	if (g_theDevConsole->m_isOpen == false)
 	{
@@ -376,7 +376,7 @@ bool DevConsole::Event_CharInput(EventArgs& args)
 	g_theDevConsole->m_caretVisible = true;
 	g_theDevConsole->m_caretStopwatch->Restart();
 
-	std::string stringChar = args.GetValue("Char", "test");
+	std::string_view stringChar = args.GetValue(EVENT_ARG_CHAR, "test");
 	char singleChar = stringChar[0];
 	if (singleChar >= 32 && singleChar <= 126 && singleChar != '~' && singleChar != '`')
 	{
@@ -434,7 +434,7 @@ bool DevConsole::Command_Help(EventArgs& args)
 	std::vector<HCIString> commands = g_theEventSystem->GetRegisteredCommands();
 	for (int commandIndex = 0; commandIndex < commands.size(); commandIndex++)
 	{
-		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, commands[commandIndex]);
+		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, commands[commandIndex].GetOriginalString());
 	}
 	
 	return true;
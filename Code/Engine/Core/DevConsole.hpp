@@ -20,7 +20,7 @@ extern	DevConsole* g_theDevConsole;
 //-----------------------------------------------------------------------------------------------
 struct DevConsoleLine
 {
-	HCIString	m_text;
+	std::string	m_text;
 	Rgba8		m_color;
 };
 
@@ -48,13 +48,13 @@ public:
 	void		EndFrame();
 
 	void		Execute(std::string const& consoleCommandText);
-	void		AddLine(Rgba8 const& color, HCIString const& text);
+	void		AddLine(Rgba8 const& color, std::string const& text);
 	void		Render(AABB2 const& bounds);
 	void		ToggleOpen();
 	bool		IsOpen();
 
-	static bool Event_KeyPressed(EventArgs& args);
-	static bool Event_CharInput(EventArgs& args);
+	static bool Event_KeyPressed(TypedEventArgs& args);
+	static bool Event_CharInput(TypedEventArgs& args);
 	static bool Event_Echo(EventArgs& args);
 	static bool Command_Clear(EventArgs& args);
 	static bool Command_Help(EventArgs& args);
@@ -2,6 +2,7 @@
 #include "NamedStrings.hpp"
 #include "DevConsole.hpp"
 #include <string>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------------------------
 EventSystem::EventSystem(EventSystemConfig const& config)
@@ -12,6 +13,17 @@ EventSystem::EventSystem(EventSystemConfig const& config)
 //-----------------------------------------------------------------------------------------------
 EventSystem::~EventSystem()
 {
+	for (int entryIndex = 0; entryIndex < m_subscriptionEntries.size(); entryIndex++)
+	{
+		EventSubscriptionEntry* entry = m_subscriptionEntries[entryIndex];
+		for (int index = 0; index < entry->m_subscribers.size(); index++)
+		{
+			delete entry->m_subscribers[index];
+		}
+		delete entry;
+	}
+	m_subscriptionEntries.clear();
+	m_subscriptionTable.clear();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -38,9 +50,9 @@ void EventSystem::EndFrame()
 void EventSystem::SubscribeEventCallbackFunciton(HCIString const& eventName, EventCallbackFuncPtr functionPtr)
 {
 	m_eventSystemMutex.lock();
-	SubscriptionList& subscribersForThisEvent = m_subscriptionListsByName[eventName];
+	EventSubscriptionEntry* entry = FindOrCreateEntry(eventName);
 	EventSubscription_Function* subscriber = new EventSubscription_Function(functionPtr);
-	subscribersForThisEvent.push_back(subscriber);
+	entry->m_subscribers.push_back(subscriber);
 	m_eventSystemMutex.unlock();
 }
 
@@ -48,93 +60,282 @@ void EventSystem::SubscribeEventCallbackFunciton(HCIString const& eventName, Eve
 void EventSystem::UnsubscribeEventCallbackFunciton(HCIString const& eventName, EventCallbackFuncPtr functionPtr)
 {
 	m_eventSystemMutex.lock();
-	auto found = m_subscriptionListsByName.find(eventName);
-	if (found == m_subscriptionListsByName.end())
+	EventSubscriptionEntry* entry = FindEntry(eventName);
+	if (entry)
 	{
-		m_eventSystemMutex.unlock();
-		return;
+		UnsubscribeFunctionFromEntry(entry, functionPtr);
 	}
+	m_eventSystemMutex.unlock();
+}
 
-	SubscriptionList& subscribersForThisEvent = found->second;
-	for (int index = 0; index < subscribersForThisEvent.size(); index++)
+//-----------------------------------------------------------------------------------------------
+void EventSystem::UnsubscribeFromAllEvents(EventCallbackFuncPtr functionPtr)
+{
+	m_eventSystemMutex.lock();
+	for (int entryIndex = 0; entryIndex < m_subscriptionEntries.size(); entryIndex++)
 	{
-		EventSubscriptionBase* subscriber = subscribersForThisEvent[index];
-		EventSubscription_Function* funcPtrSubscriber = dynamic_cast<EventSubscription_Function*>(subscriber);
-		if (funcPtrSubscriber && funcPtrSubscriber->m_funcPtr == functionPtr)
-		{
-			delete subscriber;
-			subscribersForThisEvent[index] = nullptr;
-		}
+		UnsubscribeFunctionFromEntry(m_subscriptionEntries[entryIndex], functionPtr);
 	}
 	m_eventSystemMutex.unlock();
 }
 
 //-----------------------------------------------------------------------------------------------
-void EventSystem::UnsubscribeFromAllEvents(EventCallbackFuncPtr functionPtr)
+EventReturnStatus EventSystem::FireEvent(HCIString const& eventName, EventArgs& eventArgs)
+{
+	return FireEventToSubscribers(eventName, &eventArgs, nullptr);
+}
+
+//-----------------------------------------------------------------------------------------------
+EventReturnStatus EventSystem::FireEvent(HCIString const& eventName, TypedEventArgs& eventArgs)
+{
+	return FireEventToSubscribers(eventName, nullptr, &eventArgs);
+}
+
+//-----------------------------------------------------------------------------------------------
+EventReturnStatus EventSystem::FireEvent(HCIString const& eventName)
+{
+	EventArgs emptyArgs;
+	return FireEvent(eventName, emptyArgs);
+}
+
+//-----------------------------------------------------------------------------------------------
+std::vector<HCIString> EventSystem::GetRegisteredCommands()
+{
+	std::vector<HCIString> registerCommands;
+
+	m_eventSystemMutex.lock();
+	registerCommands.reserve(m_subscriptionEntries.size());
+	for (int entryIndex = 0; entryIndex < m_subscriptionEntries.size(); entryIndex++)
+	{
+		registerCommands.push_back(m_subscriptionEntries[entryIndex]->m_eventName);
+	}
+	m_eventSystemMutex.unlock();
+
+	std::sort(registerCommands.begin(), registerCommands.end(), [](HCIString const& a, HCIString const& b) { return _stricmp(a.c_str(), b.c_str()) < 0; });
+	return registerCommands;
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventSystem::SubscribeEventCallbackFunciton(HCIString const& eventName, TypedEventCallbackFuncPtr functionPtr)
 {
 	m_eventSystemMutex.lock();
-	for (auto eventItr = m_subscriptionListsByName.begin(); eventItr != m_subscriptionListsByName.end(); eventItr++)
+	EventSubscriptionEntry* entry = FindOrCreateEntry(eventName);
+	EventSubscription_TypedFunction* subscriber = new EventSubscription_TypedFunction(functionPtr);
+	entry->m_subscribers.push_back(subscriber);
+	m_eventSystemMutex.unlock();
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventSystem::UnsubscribeEventCallbackFunciton(HCIString const& eventName, TypedEventCallbackFuncPtr functionPtr)
+{
+	m_eventSystemMutex.lock();
+	EventSubscriptionEntry* entry = FindEntry(eventName);
+	if (entry)
 	{
-		HCIString const& eventName = eventItr->first;
-		m_eventSystemMutex.unlock();
-		UnsubscribeEventCallbackFunciton(eventName, functionPtr);
-		m_eventSystemMutex.lock();
+		UnsubscribeFunctionFromEntry(entry, functionPtr);
+	}
+	m_eventSystemMutex.unlock();
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventSystem::UnsubscribeFromAllEvents(TypedEventCallbackFuncPtr functionPtr)
+{
+	m_eventSystemMutex.lock();
+	for (int entryIndex = 0; entryIndex < m_subscriptionEntries.size(); entryIndex++)
+	{
+		UnsubscribeFunctionFromEntry(m_subscriptionEntries[entryIndex], functionPtr);
 	}
 	m_eventSystemMutex.unlock();
 }
 
 //-----------------------------------------------------------------------------------------------
-void EventSystem::FireEvent(HCIString const& eventName, EventArgs& eventArgs)
+EventReturnStatus EventSystem::FireEventToSubscribers(HCIString const& eventName, EventArgs* eventArgs, TypedEventArgs* typedEventArgs)
 {
 	m_eventSystemMutex.lock();
-	auto found = m_subscriptionListsByName.find(eventName);
-	if (found == m_subscriptionListsByName.end())
+	EventSubscriptionEntry* entry = FindEntry(eventName);
+	if (entry == nullptr)
 	{
-		eventArgs.SetValue("returnValue", "failure");
 		m_eventSystemMutex.unlock();
-		return;
+		return EventReturnStatus::UNKNOWN_EVENT;
 	}
 
+	//Only built if a string subscriber is listening to a typed fire
+	EventArgs fallbackArgs;
+	bool isFallbackArgsBuilt = false;
 
-	SubscriptionList& subscribersForThisEvent = found->second;
+	//Subscribers may subscribe or unsubscribe while the lock is released, so the size is re-read every pass
+	EventReturnStatus returnStatus = EventReturnStatus::NOT_CONSUMED;
+	entry->m_numActiveFires++;
+	SubscriptionList& subscribersForThisEvent = entry->m_subscribers;
 	for (int index = 0; index < subscribersForThisEvent.size(); index++)
 	{
 		EventSubscriptionBase* subscriber = subscribersForThisEvent[index];
-		if (subscriber)
+		if (subscriber == nullptr || (subscriber->IsTyped() && typedEventArgs == nullptr))
+		{
+			continue;
+		}
+
+		m_eventSystemMutex.unlock();
+		bool wasConsumed = false;
+		if (subscriber->IsTyped())
+		{
+			wasConsumed = subscriber->ExecuteTyped(*typedEventArgs);
+		}
+		else if (eventArgs)
+		{
+			wasConsumed = subscriber->Execute(*eventArgs);
+		}
+		else
 		{
-			m_eventSystemMutex.unlock();
-			bool wasConsumed = subscriber->Execute(eventArgs); 
-			m_eventSystemMutex.lock();
-			if (wasConsumed)
+			if (!isFallbackArgsBuilt)
 			{
-				eventArgs.SetValue("returnValue", "success");
-				break; //event was consumed by this subscriber so no other subscribers will be called
+				typedEventArgs->CopyToNamedStrings(fallbackArgs);
+				isFallbackArgsBuilt = true;
 			}
+			wasConsumed = subscriber->Execute(fallbackArgs);
+		}
+		m_eventSystemMutex.lock();
+
+		if (wasConsumed)
+		{
+			returnStatus = EventReturnStatus::CONSUMED;
+			break; //event was consumed by this subscriber so no other subscribers will be called
 		}
-		
 	}
+	entry->m_numActiveFires--;
+	RemoveTombstones(entry);
 	m_eventSystemMutex.unlock();
+	return returnStatus;
 }
 
 //-----------------------------------------------------------------------------------------------
-void EventSystem::FireEvent(HCIString const& eventName)
+EventSubscriptionEntry* EventSystem::FindEntry(HCIString const& eventName) const
 {
-	EventArgs emptyArgs;
-	FireEvent(eventName, emptyArgs);
+	if (m_subscriptionTable.empty())
+	{
+		return nullptr;
+	}
+
+	size_t slotMask = m_subscriptionTable.size() - 1;
+	size_t slot = GetTableSlotForID(eventName.GetID(), m_subscriptionTable.size());
+	while (m_subscriptionTable[slot] != nullptr)
+	{
+		EventSubscriptionEntry* entry = m_subscriptionTable[slot];
+		if (entry->m_eventName == eventName)
+		{
+			return entry;
+		}
+		slot = (slot + 1) & slotMask;
+	}
+
+	return nullptr;
 }
 
 //-----------------------------------------------------------------------------------------------
-std::vector<HCIString> EventSystem::GetRegisteredCommands()
+EventSubscriptionEntry* EventSystem::FindOrCreateEntry(HCIString const& eventName)
 {
-	std::vector<HCIString> registerCommands;
+	EventSubscriptionEntry* entry = FindEntry(eventName);
+	if (entry)
+	{
+		return entry;
+	}
+
+	//Keep the load factor under 3/4 so probe chains stay short
+	if ((m_subscriptionEntries.size() + 1) * 4 > m_subscriptionTable.size() * 3)
+	{
+		GrowTable();
+	}
 
+	entry = new EventSubscriptionEntry();
+	entry->m_eventName = eventName;
+	m_subscriptionEntries.push_back(entry);
 
-	m_eventSystemMutex.lock();
-	for (const auto& subscriptionLists : m_subscriptionListsByName)
+	size_t slotMask = m_subscriptionTable.size() - 1;
+	size_t slot = GetTableSlotForID(eventName.GetID(), m_subscriptionTable.size());
+	while (m_subscriptionTable[slot] != nullptr)
 	{
-		registerCommands.push_back(subscriptionLists.first);
+		slot = (slot + 1) & slotMask;
 	}
-	m_eventSystemMutex.unlock();
-	
-	return registerCommands;
+	m_subscriptionTable[slot] = entry;
+	return entry;
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventSystem::GrowTable()
+{
+	size_t newTableSize = m_subscriptionTable.empty() ? 64 : m_subscriptionTable.size() * 2;
+	m_subscriptionTable.assign(newTableSize, nullptr);
+
+	//Entries are heap allocated, so rehashing only moves pointers and any entry a FireEvent is walking stays put
+	size_t slotMask = newTableSize - 1;
+	for (int entryIndex = 0; entryIndex < m_subscriptionEntries.size(); entryIndex++)
+	{
+		EventSubscriptionEntry* entry = m_subscriptionEntries[entryIndex];
+		size_t slot = GetTableSlotForID(entry->m_eventName.GetID(), newTableSize);
+		while (m_subscriptionTable[slot] != nullptr)
+		{
+			slot = (slot + 1) & slotMask;
+		}
+		m_subscriptionTable[slot] = entry;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventSystem::UnsubscribeFunctionFromEntry(EventSubscriptionEntry* entry, EventCallbackFuncPtr functionPtr)
+{
+	SubscriptionList& subscribersForThisEvent = entry->m_subscribers;
+	for (int index = 0; index < subscribersForThisEvent.size(); index++)
+	{
+		EventSubscriptionBase* subscriber = subscribersForThisEvent[index];
+		EventSubscription_Function* funcPtrSubscriber = dynamic_cast<EventSubscription_Function*>(subscriber);
+		if (funcPtrSubscriber && funcPtrSubscriber->m_funcPtr == functionPtr)
+		{
+			delete subscriber;
+			subscribersForThisEvent[index] = nullptr;
+			entry->m_numTombstones++;
+		}
+	}
+	RemoveTombstones(entry);
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventSystem::UnsubscribeFunctionFromEntry(EventSubscriptionEntry* entry, TypedEventCallbackFuncPtr functionPtr)
+{
+	SubscriptionList& subscribersForThisEvent = entry->m_subscribers;
+	for (int index = 0; index < subscribersForThisEvent.size(); index++)
+	{
+		EventSubscriptionBase* subscriber = subscribersForThisEvent[index];
+		EventSubscription_TypedFunction* funcPtrSubscriber = dynamic_cast<EventSubscription_TypedFunction*>(subscriber);
+		if (funcPtrSubscriber && funcPtrSubscriber->m_funcPtr == functionPtr)
+		{
+			delete subscriber;
+			subscribersForThisEvent[index] = nullptr;
+			entry->m_numTombstones++;
+		}
+	}
+	RemoveTombstones(entry);
+}
+
+//-----------------------------------------------------------------------------------------------
+void EventSystem::RemoveTombstones(EventSubscriptionEntry* entry)
+{
+	if (entry->m_numTombstones == 0 || entry->m_numActiveFires > 0)
+	{
+		return;
+	}
+
+	SubscriptionList& subscribers = entry->m_subscribers;
+	subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), nullptr), subscribers.end());
+	entry->m_numTombstones = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+unsigned int EventSystem::GetTableSlotForID(unsigned int eventNameID, size_t tableSize)
+{
+	//Interned IDs are handed out sequentially, so mix them before masking
+	unsigned int hash = eventNameID;
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3b;
+	hash ^= hash >> 16;
+	return hash & static_cast<unsigned int>(tableSize - 1);
 }
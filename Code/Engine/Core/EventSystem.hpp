@@ -1,13 +1,14 @@
 #pragma once
 #include "NamedStrings.hpp"
+#include "TypedEventArgs.hpp"
 #include <vector>
 #include <string>
-#include <map>
 #include <mutex>
 
 //-----------------------------------------------------------------------------------------------
 typedef NamedStrings EventArgs;
 typedef bool (*EventCallbackFuncPtr)(EventArgs& eventArgs);
+typedef bool (*TypedEventCallbackFuncPtr)(TypedEventArgs& eventArgs);
 
 //-----------------------------------------------------------------------------------------------
 struct EventSystemConfig
@@ -22,7 +23,9 @@ class EventSubscriptionBase
 protected:
 	EventSubscriptionBase() = default;
 	virtual ~EventSubscriptionBase() = default;
-	virtual bool Execute(EventArgs args) = 0;
+	virtual bool Execute(EventArgs& /*args*/) { return false; }
+	virtual bool ExecuteTyped(TypedEventArgs& /*args*/) { return false; }
+	virtual bool IsTyped() const { return false; }
 
 protected:
 };
@@ -35,7 +38,7 @@ class EventSubscription_Function: public EventSubscriptionBase
 protected:
 	EventSubscription_Function(EventCallbackFuncPtr funcPtr) :m_funcPtr(funcPtr) {}
 	virtual ~EventSubscription_Function() = default; 
-	virtual bool Execute(EventArgs eventArgs) override { return m_funcPtr(eventArgs); }
+	virtual bool Execute(EventArgs& eventArgs) override { return m_funcPtr(eventArgs); }
 
 protected:
 	EventCallbackFuncPtr m_funcPtr = nullptr;
@@ -51,16 +54,58 @@ class EventSubscription_ObjectMethod : public EventSubscriptionBase
 protected:
 	EventSubscription_ObjectMethod(T& object, EventCallBackObjectMethod objectMethod) :m_object(object), m_objectMethod(objectMethod) {}
 	virtual ~EventSubscription_ObjectMethod() = default;
-	virtual bool Execute(EventArgs eventArgs) override { return (m_object.*m_objectMethod)(eventArgs); }
+	virtual bool Execute(EventArgs& eventArgs) override { return (m_object.*m_objectMethod)(eventArgs); }
 
 protected:
 	EventCallBackObjectMethod	m_objectMethod = nullptr;
 	T&							m_object;
 };
 
+//-----------------------------------------------------------------------------------------------
+class EventSubscription_TypedFunction : public EventSubscriptionBase
+{
+	friend class EventSystem;
+
+protected:
+	EventSubscription_TypedFunction(TypedEventCallbackFuncPtr funcPtr) :m_funcPtr(funcPtr) {}
+	virtual ~EventSubscription_TypedFunction() = default;
+	virtual bool ExecuteTyped(TypedEventArgs& eventArgs) override { return m_funcPtr(eventArgs); }
+	virtual bool IsTyped() const override { return true; }
+
+protected:
+	TypedEventCallbackFuncPtr m_funcPtr = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+class EventSubscription_TypedObjectMethod : public EventSubscriptionBase
+{
+	friend class EventSystem;
+	typedef bool(T::* TypedEventCallBackObjectMethod) (TypedEventArgs& eventArgs);
+
+protected:
+	EventSubscription_TypedObjectMethod(T& object, TypedEventCallBackObjectMethod objectMethod) :m_object(object), m_objectMethod(objectMethod) {}
+	virtual ~EventSubscription_TypedObjectMethod() = default;
+	virtual bool ExecuteTyped(TypedEventArgs& eventArgs) override { return (m_object.*m_objectMethod)(eventArgs); }
+	virtual bool IsTyped() const override { return true; }
+
+protected:
+	TypedEventCallBackObjectMethod	m_objectMethod = nullptr;
+	T&								m_object;
+};
+
 //-----------------------------------------------------------------------------------------------
 typedef std::vector<EventSubscriptionBase*> SubscriptionList;
 
+//-----------------------------------------------------------------------------------------------
+struct EventSubscriptionEntry
+{
+	HCIString			m_eventName;
+	SubscriptionList	m_subscribers;
+	int					m_numTombstones = 0;		// unsubscribed slots left as nullptr until the list can be compacted
+	int					m_numActiveFires = 0;		// the list is only compacted when nobody is iterating it
+};
+
 //-----------------------------------------------------------------------------------------------
 class EventSystem
 {
@@ -76,16 +121,37 @@ public:
 	void					SubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::*method)(EventArgs& eventArgs));
 	template<typename T>
 	void					UnsubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::* method)(EventArgs& eventArgs));
+	template<typename T>
+	void					SubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::* method)(TypedEventArgs& eventArgs));
+	template<typename T>
+	void					UnsubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::* method)(TypedEventArgs& eventArgs));
 
 	void					SubscribeEventCallbackFunciton(HCIString const& eventName, EventCallbackFuncPtr functionPtr);
 	void					UnsubscribeEventCallbackFunciton(HCIString const& eventName, EventCallbackFuncPtr functionPtr);
 	void					UnsubscribeFromAllEvents(EventCallbackFuncPtr functionPtr);
-	void					FireEvent(HCIString const& eventName, EventArgs& eventArgs);
-	void					FireEvent(HCIString const& eventName);
+	void					SubscribeEventCallbackFunciton(HCIString const& eventName, TypedEventCallbackFuncPtr functionPtr);
+	void					UnsubscribeEventCallbackFunciton(HCIString const& eventName, TypedEventCallbackFuncPtr functionPtr);
+	void					UnsubscribeFromAllEvents(TypedEventCallbackFuncPtr functionPtr);
+
+	//Typed subscribers only hear typed fires, string subscribers hear both through a NamedStrings copy of the typed args
+	EventReturnStatus		FireEvent(HCIString const& eventName, EventArgs& eventArgs);
+	EventReturnStatus		FireEvent(HCIString const& eventName, TypedEventArgs& eventArgs);
+	EventReturnStatus		FireEvent(HCIString const& eventName);
 	std::vector<HCIString>	GetRegisteredCommands();
 
 protected:
-	std::map<HCIString, SubscriptionList>	m_subscriptionListsByName;
+	EventSubscriptionEntry*	FindEntry(HCIString const& eventName) const;
+	EventSubscriptionEntry*	FindOrCreateEntry(HCIString const& eventName);
+	void					GrowTable();
+	void					UnsubscribeFunctionFromEntry(EventSubscriptionEntry* entry, EventCallbackFuncPtr functionPtr);
+	void					UnsubscribeFunctionFromEntry(EventSubscriptionEntry* entry, TypedEventCallbackFuncPtr functionPtr);
+	EventReturnStatus		FireEventToSubscribers(HCIString const& eventName, EventArgs* eventArgs, TypedEventArgs* typedEventArgs);
+	void					RemoveTombstones(EventSubscriptionEntry* entry);
+	static unsigned int		GetTableSlotForID(unsigned int eventNameID, size_t tableSize);
+
+protected:
+	std::vector<EventSubscriptionEntry*>	m_subscriptionTable;		// open addressing with linear probing, size is a power of two
+	std::vector<EventSubscriptionEntry*>	m_subscriptionEntries;		// owns every entry, events are never removed once subscribed
 	std::mutex								m_eventSystemMutex;
 	EventSystemConfig						m_config;
 };
@@ -98,9 +164,9 @@ template<typename T>
 inline void EventSystem::SubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::* method)(EventArgs& eventArgs))
 {
 	m_eventSystemMutex.lock();
-	SubscriptionList& subscribersForThisEvent = m_subscriptionListsByName[eventName];
+	EventSubscriptionEntry* entry = FindOrCreateEntry(eventName);
 	EventSubscription_ObjectMethod<T>* subscriber = new EventSubscription_ObjectMethod<T>(object, method);
-	subscribersForThisEvent.push_back(subscriber);
+	entry->m_subscribers.push_back(subscriber);
 	m_eventSystemMutex.unlock();
 }
 
@@ -109,23 +175,64 @@ template<typename T>
 inline void EventSystem::UnsubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::* method)(EventArgs& eventArgs))
 {
 	m_eventSystemMutex.lock();
-	auto found = m_subscriptionListsByName.find(eventName);
-	if (found == m_subscriptionListsByName.end())
+	EventSubscriptionEntry* entry = FindEntry(eventName);
+	if (entry == nullptr)
 	{
 		m_eventSystemMutex.unlock();
 		return;
 	}
 
-	SubscriptionList& subscribersForThisEvent = found->second;
+	SubscriptionList& subscribersForThisEvent = entry->m_subscribers;
 	for (int index = 0; index < subscribersForThisEvent.size(); index++)
 	{
 		EventSubscriptionBase* subscriber = subscribersForThisEvent[index];
 		EventSubscription_ObjectMethod<T>* objectMethodSubscriber = dynamic_cast<EventSubscription_ObjectMethod<T>*>(subscriber);
-		if (objectMethodSubscriber && objectMethodSubscriber->m_objectMethod == method)
+		if (objectMethodSubscriber && &objectMethodSubscriber->m_object == &object && objectMethodSubscriber->m_objectMethod == method)
+		{
+			delete subscriber;
+			subscribersForThisEvent[index] = nullptr;
+			entry->m_numTombstones++;
+		}
+	}
+	RemoveTombstones(entry);
+	m_eventSystemMutex.unlock();
+}
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+inline void EventSystem::SubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::* method)(TypedEventArgs& eventArgs))
+{
+	m_eventSystemMutex.lock();
+	EventSubscriptionEntry* entry = FindOrCreateEntry(eventName);
+	EventSubscription_TypedObjectMethod<T>* subscriber = new EventSubscription_TypedObjectMethod<T>(object, method);
+	entry->m_subscribers.push_back(subscriber);
+	m_eventSystemMutex.unlock();
+}
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+inline void EventSystem::UnsubscribeEventCallbackObjectMethod(HCIString const& eventName, T& object, bool(T::* method)(TypedEventArgs& eventArgs))
+{
+	m_eventSystemMutex.lock();
+	EventSubscriptionEntry* entry = FindEntry(eventName);
+	if (entry == nullptr)
+	{
+		m_eventSystemMutex.unlock();
+		return;
+	}
+
+	SubscriptionList& subscribersForThisEvent = entry->m_subscribers;
+	for (int index = 0; index < subscribersForThisEvent.size(); index++)
+	{
+		EventSubscriptionBase* subscriber = subscribersForThisEvent[index];
+		EventSubscription_TypedObjectMethod<T>* objectMethodSubscriber = dynamic_cast<EventSubscription_TypedObjectMethod<T>*>(subscriber);
+		if (objectMethodSubscriber && &objectMethodSubscriber->m_object == &object && objectMethodSubscriber->m_objectMethod == method)
 		{
 			delete subscriber;
 			subscribersForThisEvent[index] = nullptr;
+			entry->m_numTombstones++;
 		}
 	}
+	RemoveTombstones(entry);
 	m_eventSystemMutex.unlock();
 }
@@ -1,163 +1,224 @@
 #include "HashedCaseInsensitiveString.hpp"
+#include "ErrorWarningAssert.hpp"
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 //-----------------------------------------------------------------------------------------------
-HashCaseInsensitiveString::HashCaseInsensitiveString(const char* originalText)
-	:m_caseIntactText(originalText)
-	,m_lowerCaseHash(CalculateHashForText(originalText))
+static const unsigned int k_internedChunkSize = 1024;
+static const unsigned int k_maxInternedChunks = 4096;
+
+//-----------------------------------------------------------------------------------------------
+struct InternedString
 {
-}
+	std::string		m_originalText;
+	unsigned int	m_lowerCaseHash = 0;
+};
 
 //-----------------------------------------------------------------------------------------------
-HashCaseInsensitiveString::HashCaseInsensitiveString(std::string const& originalText)
-	:m_caseIntactText(originalText)
-	,m_lowerCaseHash(CalculateHashForText(originalText))
+// Entries are allocated in fixed size chunks that never move or get freed before shutdown,
+// so a reader holding an ID can index straight into them without taking the lock
+struct InternedStringTableData
 {
-}
+	InternedStringTableData();
+	~InternedStringTableData();
+	unsigned int AppendLocked(char const* text, unsigned int lowerCaseHash);
+
+	std::atomic<InternedString*>							m_chunks[k_maxInternedChunks] = {};
+	std::atomic<unsigned int>								m_numStrings = 0;
+	std::unordered_multimap<unsigned int, unsigned int>		m_idsByHash;
+	std::shared_mutex										m_mutex;
+};
 
 //-----------------------------------------------------------------------------------------------
-unsigned int HashCaseInsensitiveString::GetHash() const
+static InternedStringTableData& GetInternedStringTableData()
 {
-	return m_lowerCaseHash;
+	//Function static so HCIStrings built during static initialization still find the table
+	static InternedStringTableData s_tableData;
+	return s_tableData;
 }
 
 //-----------------------------------------------------------------------------------------------
-std::string const& HashCaseInsensitiveString::GetOriginalString() const
+static InternedString const& GetInternedString(unsigned int id)
 {
-	return m_caseIntactText;
+	InternedStringTableData& tableData = GetInternedStringTableData();
+	InternedString* chunk = tableData.m_chunks[id / k_internedChunkSize].load(std::memory_order_acquire);
+	return chunk[id % k_internedChunkSize];
 }
 
 //-----------------------------------------------------------------------------------------------
-char const* HashCaseInsensitiveString::c_str() const
+InternedStringTableData::InternedStringTableData()
 {
-	return m_caseIntactText.c_str();
+	AppendLocked("", 0);
 }
 
 //-----------------------------------------------------------------------------------------------
-unsigned int HashCaseInsensitiveString::CalculateHashForText(const char* text)
+InternedStringTableData::~InternedStringTableData()
 {
-	unsigned int hash = 0;
-	const char* readPos = text;
-	while (*readPos != '\0')
+	for (unsigned int chunkIndex = 0; chunkIndex < k_maxInternedChunks; chunkIndex++)
 	{
-		hash *= 31;
-		hash += (unsigned int) tolower(*readPos);
-		readPos++;
+		delete[] m_chunks[chunkIndex].load();
+		m_chunks[chunkIndex] = nullptr;
 	}
-
-	return hash;
 }
 
 //-----------------------------------------------------------------------------------------------
-unsigned int HashCaseInsensitiveString::CalculateHashForText(std::string const& text)
+unsigned int InternedStringTableData::AppendLocked(char const* text, unsigned int lowerCaseHash)
 {
-	return CalculateHashForText(text.c_str());
+	unsigned int newID = m_numStrings.load(std::memory_order_relaxed);
+	unsigned int chunkIndex = newID / k_internedChunkSize;
+	GUARANTEE_OR_DIE(chunkIndex < k_maxInternedChunks, "Interned string table is full");
+
+	InternedString* chunk = m_chunks[chunkIndex].load(std::memory_order_relaxed);
+	if (chunk == nullptr)
+	{
+		chunk = new InternedString[k_internedChunkSize];
+		m_chunks[chunkIndex].store(chunk, std::memory_order_release);
+	}
+
+	InternedString& newString = chunk[newID % k_internedChunkSize];
+	newString.m_originalText = text;
+	newString.m_lowerCaseHash = lowerCaseHash;
+	m_idsByHash.insert(std::pair<unsigned int, unsigned int>(lowerCaseHash, newID));
+	m_numStrings.store(newID + 1, std::memory_order_release);
+	return newID;
 }
 
 //-----------------------------------------------------------------------------------------------
-bool HashCaseInsensitiveString::operator<(HashCaseInsensitiveString const& compareHCIS) const
+unsigned int InternedStringTable::Intern(char const* text, unsigned int lowerCaseHash)
 {
-	if (m_lowerCaseHash < compareHCIS.m_lowerCaseHash)
+	if (text == nullptr || text[0] == '\0')
 	{
-		return true;
+		return 0;
 	}
-	else if (m_lowerCaseHash > compareHCIS.m_lowerCaseHash)
+
+	InternedStringTableData& tableData = GetInternedStringTableData();
+
+	//Most lookups hit an existing string, so only take the exclusive lock when appending
 	{
-		return false;
+		std::shared_lock<std::shared_mutex> readLock(tableData.m_mutex);
+		auto range = tableData.m_idsByHash.equal_range(lowerCaseHash);
+		for (auto found = range.first; found != range.second; found++)
+		{
+			if (_stricmp(GetInternedString(found->second).m_originalText.c_str(), text) == 0)
+			{
+				return found->second;
+			}
+		}
 	}
-	else
+
+	std::unique_lock<std::shared_mutex> writeLock(tableData.m_mutex);
+	auto range = tableData.m_idsByHash.equal_range(lowerCaseHash);
+	for (auto found = range.first; found != range.second; found++)
 	{
-		//Hash values are equal now need to do actual string comparison
-		return _stricmp(m_caseIntactText.c_str(), compareHCIS.m_caseIntactText.c_str()) < 0;
+		if (_stricmp(GetInternedString(found->second).m_originalText.c_str(), text) == 0)
+		{
+			return found->second;
+		}
 	}
+
+	return tableData.AppendLocked(text, lowerCaseHash);
 }
 
 //-----------------------------------------------------------------------------------------------
-bool HashCaseInsensitiveString::operator>(HashCaseInsensitiveString const& compareHCIS) const
+std::string const& InternedStringTable::GetOriginalString(unsigned int id)
 {
-	if (m_lowerCaseHash > compareHCIS.m_lowerCaseHash)
-	{
-		return true;
-	}
-	else if (m_lowerCaseHash < compareHCIS.m_lowerCaseHash)
-	{
-		return false;
-	}
-	else
-	{
-		//Hash values are equal now need to do actual string comparison
-		return _stricmp(m_caseIntactText.c_str(), compareHCIS.m_caseIntactText.c_str()) > 0;
-	}
+	return GetInternedString(id).m_originalText;
 }
 
 //-----------------------------------------------------------------------------------------------
-bool HashCaseInsensitiveString::operator==(HashCaseInsensitiveString const& compareHCIS) const
+unsigned int InternedStringTable::GetHash(unsigned int id)
 {
-	if (m_lowerCaseHash != compareHCIS.m_lowerCaseHash)
-	{
-		return false;
-	}
-	else
-	{
-		//Hash values are equal now need to do actual string comparison
-		return _stricmp(m_caseIntactText.c_str(), compareHCIS.m_caseIntactText.c_str()) == 0;
-	}
+	return GetInternedString(id).m_lowerCaseHash;
 }
 
 //-----------------------------------------------------------------------------------------------
-bool HashCaseInsensitiveString::operator!=(HashCaseInsensitiveString const& compareHCIS) const
+unsigned int InternedStringTable::GetNumInternedStrings()
 {
-	if (m_lowerCaseHash != compareHCIS.m_lowerCaseHash)
-	{
-		return true;
-	}
-	else
-	{
-		//Hash values are equal now need to do actual string comparison
-		return _stricmp(m_caseIntactText.c_str(), compareHCIS.m_caseIntactText.c_str()) != 0;
-	}
+	return GetInternedStringTableData().m_numStrings.load(std::memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------------------------
+HashCaseInsensitiveString::HashCaseInsensitiveString(const char* originalText)
+	:m_id(InternedStringTable::Intern(originalText, CalculateHashForText(originalText)))
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+HashCaseInsensitiveString::HashCaseInsensitiveString(std::string const& originalText)
+	:m_id(InternedStringTable::Intern(originalText.c_str(), CalculateHashForText(originalText)))
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+HashCaseInsensitiveString::HashCaseInsensitiveString(const char* originalText, unsigned int precomputedHash)
+	:m_id(InternedStringTable::Intern(originalText, precomputedHash))
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+unsigned int HashCaseInsensitiveString::GetHash() const
+{
+	return InternedStringTable::GetHash(m_id);
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string const& HashCaseInsensitiveString::GetOriginalString() const
+{
+	return InternedStringTable::GetOriginalString(m_id);
+}
+
+//-----------------------------------------------------------------------------------------------
+char const* HashCaseInsensitiveString::c_str() const
+{
+	return GetOriginalString().c_str();
+}
+
+//-----------------------------------------------------------------------------------------------
+unsigned int HashCaseInsensitiveString::CalculateHashForText(std::string const& text)
+{
+	return CalculateHashForText(text.c_str());
 }
 
 //-----------------------------------------------------------------------------------------------
 bool HashCaseInsensitiveString::operator==(std::string const& compareText) const
 {
-	return _stricmp(m_caseIntactText.c_str(), compareText.c_str()) == 0;
+	return _stricmp(c_str(), compareText.c_str()) == 0;
 }
 
 //-----------------------------------------------------------------------------------------------
 bool HashCaseInsensitiveString::operator!=(std::string const& compareText) const
 {
-	return _stricmp(m_caseIntactText.c_str(), compareText.c_str()) != 0;
+	return _stricmp(c_str(), compareText.c_str()) != 0;
 }
 
 //-----------------------------------------------------------------------------------------------
 bool HashCaseInsensitiveString::operator==(const char* compareText) const
 {
-	return _stricmp(m_caseIntactText.c_str(), compareText) == 0;
+	return _stricmp(c_str(), compareText) == 0;
 }
 
 //-----------------------------------------------------------------------------------------------
 bool HashCaseInsensitiveString::operator!=(const char* compareText) const
 {
-	return _stricmp(m_caseIntactText.c_str(), compareText) != 0;
+	return _stricmp(c_str(), compareText) != 0;
 }
 
 //-----------------------------------------------------------------------------------------------
 void HashCaseInsensitiveString::operator=(HashCaseInsensitiveString const& assignFrom)
 {
-	m_caseIntactText = assignFrom.m_caseIntactText;
-	m_lowerCaseHash = assignFrom.m_lowerCaseHash;
+	m_id = assignFrom.m_id;
 }
 
 //-----------------------------------------------------------------------------------------------
 void HashCaseInsensitiveString::operator=(std::string const& text)
 {
-	m_caseIntactText = text;
-	m_lowerCaseHash = CalculateHashForText(m_caseIntactText);
+	m_id = InternedStringTable::Intern(text.c_str(), CalculateHashForText(text));
 }
 
 //-----------------------------------------------------------------------------------------------
 void HashCaseInsensitiveString::operator=(const char* text)
 {
-	m_caseIntactText = text;
-	m_lowerCaseHash = CalculateHashForText(m_caseIntactText);
+	m_id = InternedStringTable::Intern(text, CalculateHashForText(text));
 }
@@ -1,7 +1,10 @@
 #pragma once
 #include <string>
+#include <type_traits>
 
 //-----------------------------------------------------------------------------------------------
+// A case insensitive string interned into a global table, so copies and comparisons are one 32 bit ID.
+// Every spelling that differs only by case shares an ID, and GetOriginalString() returns the first spelling interned.
 class HashCaseInsensitiveString
 {
 public:
@@ -9,18 +12,20 @@ public:
 	HashCaseInsensitiveString( HashCaseInsensitiveString const& copyFrom ) = default;
 	HashCaseInsensitiveString(const char* originalText);
 	HashCaseInsensitiveString(std::string const& originalText);
+	HashCaseInsensitiveString(const char* originalText, unsigned int precomputedHash);
 
+	unsigned int		GetID() const { return m_id; }
 	unsigned int		GetHash() const;
 	std::string const&	GetOriginalString() const;
 	char const*			c_str() const;
 
-	static unsigned int CalculateHashForText(const char* text);
+	static constexpr unsigned int CalculateHashForText(const char* text);
 	static unsigned int CalculateHashForText(std::string const& text);
 
-	bool				operator<(HashCaseInsensitiveString const& compareHCIS) const;
-	bool				operator>(HashCaseInsensitiveString const& compareHCIS) const;
-	bool				operator==(HashCaseInsensitiveString const& compareHCIS) const;
-	bool				operator!=(HashCaseInsensitiveString const& compareHCIS) const;
+	bool				operator<(HashCaseInsensitiveString const& compareHCIS) const { return m_id < compareHCIS.m_id; }
+	bool				operator>(HashCaseInsensitiveString const& compareHCIS) const { return m_id > compareHCIS.m_id; }
+	bool				operator==(HashCaseInsensitiveString const& compareHCIS) const { return m_id == compareHCIS.m_id; }
+	bool				operator!=(HashCaseInsensitiveString const& compareHCIS) const { return m_id != compareHCIS.m_id; }
 	bool				operator==(std::string const& compareText) const;
 	bool				operator!=(std::string const& compareText) const;
 	bool				operator==(const char* compareText) const;
@@ -30,9 +35,39 @@ public:
 	void				operator=(const char* text);
 
 private:
-	std::string			m_caseIntactText = "";
-	unsigned int		m_lowerCaseHash = 0;
+	unsigned int		m_id = 0;		// 0 is always the empty string
 };
 
 //-----------------------------------------------------------------------------------------------
-typedef HashCaseInsensitiveString HCIString;
\ No newline at end of file
+typedef HashCaseInsensitiveString HCIString;
+
+//-----------------------------------------------------------------------------------------------
+// Hashes the literal at compile time, so building the HCIString only pays for the table lookup
+#define HCISTR(literalText) HashCaseInsensitiveString(literalText, std::integral_constant<unsigned int, HashCaseInsensitiveString::CalculateHashForText(literalText)>::value)
+
+//-----------------------------------------------------------------------------------------------
+// Append-only and thread safe. Interning takes a lock, reading an interned entry by ID does not.
+class InternedStringTable
+{
+public:
+	static unsigned int			Intern(char const* text, unsigned int lowerCaseHash);
+	static std::string const&	GetOriginalString(unsigned int id);
+	static unsigned int			GetHash(unsigned int id);
+	static unsigned int			GetNumInternedStrings();
+};
+
+//-----------------------------------------------------------------------------------------------
+constexpr unsigned int HashCaseInsensitiveString::CalculateHashForText(const char* text)
+{
+	unsigned int hash = 0;
+	const char* readPos = text;
+	while (*readPos != '\0')
+	{
+		char lowerChar = (*readPos >= 'A' && *readPos <= 'Z') ? static_cast<char>(*readPos - 'A' + 'a') : *readPos;
+		hash *= 31;
+		hash += (unsigned int) lowerChar;
+		readPos++;
+	}
+
+	return hash;
+}
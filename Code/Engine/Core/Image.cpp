@@ -17,6 +17,13 @@ Image::~Image()
 
 //-----------------------------------------------------------------------------------------------
 Image::Image(const char* imageFilePath)
+{
+	bool isLoaded = LoadFromFile(imageFilePath);
+	GUARANTEE_OR_DIE(isLoaded, Stringf("Failed to load image \"%s\"", imageFilePath));
+}
+
+//-----------------------------------------------------------------------------------------------
+bool Image::LoadFromFile(const char* imageFilePath)
 {
 	m_imageFilePath = imageFilePath;
 
@@ -30,10 +37,14 @@ Image::Image(const char* imageFilePath)
 	m_dimensions = dimensions;
 
 	// Check if the load was successful
-	GUARANTEE_OR_DIE(texelData, Stringf("Failed to load image \"%s\"", imageFilePath));
+	if (texelData == nullptr)
+	{
+		return false;
+	}
 
 	int totalTexels = m_dimensions.x * m_dimensions.y;
-
+	m_texelRgba8Data.clear();
+	m_texelRgba8Data.reserve(totalTexels);
 	for (int texelIndex = 0; texelIndex < totalTexels; texelIndex++)
 	{
 		int byteOffset = texelIndex * bytesPerTexel;
@@ -54,6 +65,7 @@ Image::Image(const char* imageFilePath)
 	// Free the raw image texel data now that we've sent a copy of it down to the GPU to be stored in video memory
 	stbi_image_free(texelData);
 	texelData = nullptr;
+	return true;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -18,6 +18,8 @@ public:
 	Image(const char* imageFilePath);
 	Image(IntVec2 size, Rgba8 color);
 
+	bool				LoadFromFile(const char* imageFilePath);	// false instead of dying when the file is missing or can not be decoded
+
 	IntVec2				GetDimensions() const;
 	const std::string&	GetImageFilePath() const;
 	const void*			GetRawData() const;
@@ -27,4 +29,4 @@ private:
 	std::string			m_imageFilePath;
 	std::vector<Rgba8>	m_texelRgba8Data;
 	IntVec2				m_dimensions;
-};
\ No newline at end of file
+};
\ No newline at end of file
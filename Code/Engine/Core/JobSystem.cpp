@@ -1,4 +1,6 @@
 #include "JobSystem.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/StringUtils.hpp"
 
 //-----------------------------------------------------------------------------------------------
 JobWorker::JobWorker(JobSystem* jobSystem, int workerThreadID)
@@ -19,17 +21,18 @@ JobWorker::~JobWorker()
 //-----------------------------------------------------------------------------------------------
 void JobWorker::ThreadMain(int workerID)
 {
-	workerID;
+	if (g_theProfiler)
+	{
+		g_theProfiler->RegisterCurrentThread(Stringf("Job Worker %d", workerID));
+	}
+
 	while (!g_theJobSystem->IsQuitting())
 	{
 		Job* jobToExecute = nullptr;
 		jobToExecute = g_theJobSystem->ClaimJobToExecute();
 		if (jobToExecute != nullptr)
 		{
-			jobToExecute->m_jobStatus = JobStatus::CLAIMED;
-			jobToExecute->Execute(); // typically very slow
-			g_theJobSystem->MoveJobToCompletedList(jobToExecute);
-			jobToExecute->m_jobStatus = JobStatus::COMPLETED;
+			g_theJobSystem->ExecuteJob(jobToExecute);
 		}
 		else
 		{
@@ -99,7 +102,14 @@ void JobSystem::CreateWorkers(int numWorkerThreads)
 void JobSystem::PostNewJob(Job* job)
 {
 	m_unclaimedJobsListMutex.lock();
-	m_unclaimedJobsList.push_back(job);
+	if ((job->m_jobType & JOB_TYPE_SIMULATION) != 0)
+	{
+		m_unclaimedSimulationJobsList.push_back(job);
+	}
+	else
+	{
+		m_unclaimedJobsList.push_back(job);
+	}
 	m_unclaimedJobsListMutex.unlock();
 }
 
@@ -122,16 +132,31 @@ void JobSystem::MoveJobToCompletedList(Job* job)
 }
 
 //-----------------------------------------------------------------------------------------------
-Job* JobSystem::ClaimJobToExecute()
+Job* JobSystem::ClaimJobToExecute(JobTypeFlags jobTypesToClaim)
 {
 	Job* jobToClaim = nullptr;
 
 	m_unclaimedJobsListMutex.lock();
-	if (!m_unclaimedJobsList.empty())
+	if ((jobTypesToClaim & JOB_TYPE_SIMULATION) != 0 && !m_unclaimedSimulationJobsList.empty())
+	{
+		jobToClaim = m_unclaimedSimulationJobsList.front();
+		m_unclaimedSimulationJobsList.pop_front();
+	}
+	else
 	{
-		jobToClaim = m_unclaimedJobsList.front();
-		m_unclaimedJobsList.pop_front();
+		for (auto jobItr = m_unclaimedJobsList.begin(); jobItr != m_unclaimedJobsList.end(); jobItr++)
+		{
+			if (((*jobItr)->m_jobType & jobTypesToClaim) != 0)
+			{
+				jobToClaim = *jobItr;
+				m_unclaimedJobsList.erase(jobItr);
+				break;
+			}
+		}
+	}
 
+	if (jobToClaim != nullptr)
+	{
 		//move to claimed list
 		m_claimedJobsListMutex.lock();
 		m_claimedJobsList.push_back(jobToClaim);
@@ -143,17 +168,72 @@ Job* JobSystem::ClaimJobToExecute()
 }
 
 //-----------------------------------------------------------------------------------------------
-Job* JobSystem::RetreiveCompletedJob()
+void JobSystem::ExecuteJob(Job* claimedJob)
+{
+	claimedJob->m_jobStatus = JobStatus::CLAIMED;
+	{
+		PROFILE_SCOPE("Job::Execute");
+		claimedJob->Execute(); // typically very slow
+	}
+	MoveJobToCompletedList(claimedJob);
+	claimedJob->m_jobStatus = JobStatus::COMPLETED;
+}
+
+//-----------------------------------------------------------------------------------------------
+void JobSystem::WaitForJob(Job* job)
+{
+	//Help with queued simulation jobs instead of spinning, the job being waited on is often one of them
+	while (job->m_jobStatus != JobStatus::COMPLETED)
+	{
+		Job* simulationJob = ClaimJobToExecute(JOB_TYPE_SIMULATION);
+		if (simulationJob != nullptr)
+		{
+			ExecuteJob(simulationJob);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	RetreiveCompletedJob(job);
+}
+
+//-----------------------------------------------------------------------------------------------
+Job* JobSystem::RetreiveCompletedJob(JobTypeFlags jobTypesToRetrieve)
 {
 	Job* completedJob = nullptr;
 
 	m_completedJobsListMutex.lock();
-	if (!m_completedJobsList.empty())
+	for (auto jobItr = m_completedJobsList.begin(); jobItr != m_completedJobsList.end(); jobItr++)
 	{
-		completedJob = m_completedJobsList.front();
-		m_completedJobsList.pop_front();
-		completedJob->m_jobStatus = JobStatus::RETREIVED;
+		if (((*jobItr)->m_jobType & jobTypesToRetrieve) != 0)
+		{
+			completedJob = *jobItr;
+			m_completedJobsList.erase(jobItr);
+			completedJob->m_jobStatus = JobStatus::RETREIVED;
+			break;
+		}
 	}
 	m_completedJobsListMutex.unlock();
 	return completedJob;
 }
+
+//-----------------------------------------------------------------------------------------------
+bool JobSystem::RetreiveCompletedJob(Job* jobToRetrieve)
+{
+	bool isRetrieved = false;
+
+	m_completedJobsListMutex.lock();
+	for (auto jobItr = m_completedJobsList.begin(); jobItr != m_completedJobsList.end(); jobItr++)
+	{
+		if (*jobItr == jobToRetrieve)
+		{
+			m_completedJobsList.erase(jobItr);
+			jobToRetrieve->m_jobStatus = JobStatus::RETREIVED;
+			isRetrieved = true;
+			break;
+		}
+	}
+	m_completedJobsListMutex.unlock();
+	return isRetrieved;
+}
@@ -2,6 +2,8 @@
 #include <queue>
 #include <mutex>
 #include <vector>
+#include <atomic>
+#include <thread>
 
 //-----------------------------------------------------------------------------------------------
 class	JobSystem;
@@ -16,6 +18,13 @@ enum class JobStatus
 	RETREIVED,
 };
 
+//-----------------------------------------------------------------------------------------------
+typedef unsigned int JobTypeFlags;
+constexpr JobTypeFlags JOB_TYPE_GENERIC		= 1 << 0;
+constexpr JobTypeFlags JOB_TYPE_ASSET_LOAD	= 1 << 1;
+constexpr JobTypeFlags JOB_TYPE_SIMULATION	= 1 << 2;	// posted and retrieved within a single simulation step
+constexpr JobTypeFlags JOB_TYPE_ALL			= 0xFFFFFFFF;
+
 //-----------------------------------------------------------------------------------------------
 class Job
 {
@@ -25,6 +34,7 @@ public:
 
 public:
 	std::atomic<JobStatus> m_jobStatus = JobStatus::QUEUED;
+	JobTypeFlags			m_jobType = JOB_TYPE_GENERIC;	// lets systems only retrieve the completed jobs they own
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -63,14 +73,19 @@ public:
 	void CreateWorkers(int numWorkerThreads);
 	void PostNewJob(Job* job);
 	void MoveJobToCompletedList(Job* job);
-	Job* ClaimJobToExecute();
-	Job* RetreiveCompletedJob();
+	Job* ClaimJobToExecute(JobTypeFlags jobTypesToClaim = JOB_TYPE_ALL);
+	void ExecuteJob(Job* claimedJob);
+	void WaitForJob(Job* job);
+	Job* RetreiveCompletedJob(JobTypeFlags jobTypesToRetrieve = JOB_TYPE_GENERIC);
+	bool RetreiveCompletedJob(Job* jobToRetrieve);
+	int  GetNumWorkers() const { return static_cast<int>(m_workers.size()); }
 
 
 private:
 	std::vector<JobWorker*> m_workers;
 
 	std::deque<Job*>		m_unclaimedJobsList;
+	std::deque<Job*>		m_unclaimedSimulationJobsList;	// claimed first, a simulation step never waits behind asset decodes
 	std::mutex				m_unclaimedJobsListMutex;
 
 	std::deque<Job*>		m_claimedJobsList;
@@ -82,3 +97,21 @@ private:
 	JobSystemConfig			m_config;
 	std::atomic<bool>		m_isQuitting = false;
 };
+
+//-----------------------------------------------------------------------------------------------
+// Runs the first job on the calling thread and posts the rest, returns once all of them are done
+template <typename JobType>
+void RunJobsAndWait(std::vector<JobType*> const& jobs, int numJobs)
+{
+	for (int jobIndex = 1; jobIndex < numJobs; jobIndex++)
+	{
+		jobs[jobIndex]->m_jobStatus = JobStatus::QUEUED;
+		g_theJobSystem->PostNewJob(jobs[jobIndex]);
+	}
+
+	jobs[0]->Execute();
+	for (int jobIndex = 1; jobIndex < numJobs; jobIndex++)
+	{
+		g_theJobSystem->WaitForJob(jobs[jobIndex]);
+	}
+}
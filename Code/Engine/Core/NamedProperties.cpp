@@ -1 +1,78 @@
 #include "NamedProperties.hpp"
+
+//-----------------------------------------------------------------------------------------------
+NamedProperty::NamedProperty(NamedProperty const& copyFrom)
+{
+	*this = copyFrom;
+}
+
+//-----------------------------------------------------------------------------------------------
+NamedProperty::~NamedProperty()
+{
+	Reset();
+}
+
+//-----------------------------------------------------------------------------------------------
+NamedProperty& NamedProperty::operator=(NamedProperty const& assignFrom)
+{
+	if (this == &assignFrom)
+	{
+		return *this;
+	}
+
+	Reset();
+	m_typeID = assignFrom.m_typeID;
+	if (assignFrom.m_inlineOps)
+	{
+		assignFrom.m_inlineOps->m_copyConstruct(m_inlineStorage, assignFrom.m_inlineStorage);
+		m_inlineOps = assignFrom.m_inlineOps;
+	}
+	if (assignFrom.m_heapValue)
+	{
+		m_heapValue = assignFrom.m_heapValue->Clone();
+	}
+	return *this;
+}
+
+//-----------------------------------------------------------------------------------------------
+void NamedProperty::Reset()
+{
+	if (m_inlineOps)
+	{
+		m_inlineOps->m_destroy(m_inlineStorage);
+		m_inlineOps = nullptr;
+	}
+	delete m_heapValue;
+	m_heapValue = nullptr;
+	m_typeID = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+void NamedProperties::SetValue(HCIString const& keyName, const char* value)
+{
+	SetValue<std::string>(keyName, std::string(value));
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string NamedProperties::GetValue(HCIString const& keyName, const char* defaultValue) const
+{
+	return GetValue<std::string>(keyName, std::string(defaultValue));
+}
+
+//-----------------------------------------------------------------------------------------------
+bool NamedProperties::HasKey(HCIString const& keyName) const
+{
+	return m_keyValuePairs.find(keyName) != m_keyValuePairs.end();
+}
+
+//-----------------------------------------------------------------------------------------------
+void NamedProperties::RemoveKey(HCIString const& keyName)
+{
+	m_keyValuePairs.erase(keyName);
+}
+
+//-----------------------------------------------------------------------------------------------
+void NamedProperties::Clear()
+{
+	m_keyValuePairs.clear();
+}
@@ -1,8 +1,45 @@
 #pragma once
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "HashedCaseInsensitiveString.hpp"
-#include <map>
+#include <unordered_map>
 #include <string>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+//-----------------------------------------------------------------------------------------------
+// Every T gets its own static tag, so its address is a unique per-type ID without RTTI.
+// The tag is deliberately not const so the linker can never fold two tags together.
+typedef void const* NamedPropertyTypeID;
+template<typename T>
+struct NamedPropertyTypeTag
+{
+	static inline char s_tag = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+constexpr NamedPropertyTypeID GetNamedPropertyTypeID()
+{
+	return &NamedPropertyTypeTag<std::remove_cv_t<std::remove_reference_t<T>>>::s_tag;
+}
+
+//-----------------------------------------------------------------------------------------------
+// How to copy and destroy a value living in a NamedProperty's inline storage without knowing its type
+struct NamedPropertyInlineOps
+{
+	void	(*m_copyConstruct)(void* destination, void const* source) = nullptr;
+	void	(*m_destroy)(void* value) = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+template<typename T>
+struct NamedPropertyInlineOpsOfType
+{
+	static void CopyConstruct(void* destination, void const* source) { new (destination) T(*static_cast<T const*>(source)); }
+	static void Destroy(void* value) { static_cast<T*>(value)->~T(); }
+	static inline NamedPropertyInlineOps const s_ops = { &CopyConstruct, &Destroy };
+};
 
 //-----------------------------------------------------------------------------------------------
 class NamedPropertyBase
@@ -10,85 +47,154 @@ class NamedPropertyBase
 public:
 	NamedPropertyBase(){}
 	virtual ~NamedPropertyBase() {}
+	virtual NamedPropertyBase* Clone() const = 0;
 };
 
 //-----------------------------------------------------------------------------------------------
 template<typename T>
 class NamedPropertyofType : public NamedPropertyBase
 {
-	friend class NamedProperties;
+	friend class NamedProperty;
 
 protected:
 	NamedPropertyofType(T value) :m_value(value) {}
+	virtual NamedPropertyBase* Clone() const override { return new NamedPropertyofType<T>(m_value); }
 	T m_value;
 };
 
+//-----------------------------------------------------------------------------------------------
+// Small copyable values are constructed in place in the inline storage, anything else falls back to a heap NamedPropertyofType<T>
+class NamedProperty
+{
+	friend class NamedProperties;
+
+public:
+	static constexpr size_t INLINE_CAPACITY = 32;
+
+	template<typename T>
+	static constexpr bool IsStoredInline()
+	{
+		return std::is_copy_constructible<T>::value && std::is_nothrow_destructible<T>::value && sizeof(T) <= INLINE_CAPACITY
+			&& alignof(T) <= alignof(std::max_align_t);
+	}
+
+public:
+	NamedProperty() = default;
+	NamedProperty(NamedProperty const& copyFrom);
+	~NamedProperty();
+	NamedProperty&	operator=(NamedProperty const& assignFrom);
+
+	template<typename T>
+	void			Set(T const& value);
+	template<typename T>
+	T const*		Get() const;
+	void			Reset();
+
+private:
+	alignas(std::max_align_t) unsigned char	m_inlineStorage[INLINE_CAPACITY] = {};
+	NamedPropertyInlineOps const*			m_inlineOps = nullptr;		// set while a value is alive in m_inlineStorage
+	NamedPropertyBase*						m_heapValue = nullptr;
+	NamedPropertyTypeID						m_typeID = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct HCIStringHasher
+{
+	size_t operator()(HCIString const& key) const { return key.GetID(); }
+};
+
 //-----------------------------------------------------------------------------------------------
 class NamedProperties
 {
 public:
 	template<typename T>
-	void SetValue(std::string const& keyName, T const& value);
+	void SetValue(HCIString const& keyName, T const& value);
 	template<typename T>
-	T GetValue(std::string const& keyName, T const& defaultValue);
-	void SetValue(std::string const& keyName, const char* value);
-	std::string GetValue(std::string const& keyName, const char* defaultValue);
+	T GetValue(HCIString const& keyName, T const& defaultValue) const;
+	void SetValue(HCIString const& keyName, const char* value);
+	std::string GetValue(HCIString const& keyName, const char* defaultValue) const;
+	bool HasKey(HCIString const& keyName) const;
+	void RemoveKey(HCIString const& keyName);
+	void Clear();
 
 private:
-	std::map< HCIString, NamedPropertyBase*> m_keyValuePairs;
+	std::unordered_map<HCIString, NamedProperty, HCIStringHasher> m_keyValuePairs;
 };
 
-//c++-style
 //-----------------------------------------------------------------------------------------------
 template<typename T>
-void NamedProperties::SetValue(std::string const& keyName, T const& value)
+inline void NamedProperty::Set(T const& value)
 {
-	HCIString key(keyName);
-	m_keyValuePairs[key] = new NamedPropertyofType<T>(value);
+	NamedPropertyTypeID typeID = GetNamedPropertyTypeID<T>();
+	if constexpr (IsStoredInline<T>())
+	{
+		if (m_typeID == typeID)
+		{
+			*reinterpret_cast<T*>(m_inlineStorage) = value;
+			return;
+		}
+
+		Reset();
+		new (m_inlineStorage) T(value);
+		m_inlineOps = &NamedPropertyInlineOpsOfType<T>::s_ops;
+		m_typeID = typeID;
+	}
+	else
+	{
+		//Overwriting with the same type reuses the existing allocation
+		if (m_typeID == typeID)
+		{
+			static_cast<NamedPropertyofType<T>*>(m_heapValue)->m_value = value;
+			return;
+		}
+
+		Reset();
+		m_heapValue = new NamedPropertyofType<T>(value);
+		m_typeID = typeID;
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
 template<typename T>
-inline T NamedProperties::GetValue(std::string const& keyName, T const& defaultValue)
+inline T const* NamedProperty::Get() const
 {
-	HCIString key(keyName);
-	std::map<HCIString, NamedPropertyBase*>::iterator found = m_keyValuePairs.find(key);
-	if (found == m_keyValuePairs.end())
-		return defaultValue;
-
-	NamedPropertyBase* property = found->second;
-	NamedPropertyofType<T>* typedProperty = dynamic_cast<NamedPropertyofType<T>*>(property);
-	if (typedProperty == nullptr)
+	if (m_typeID != GetNamedPropertyTypeID<T>())
 	{
-		ERROR_RECOVERABLE("Asked for value of the incorrect type!");
-		return defaultValue;
+		return nullptr;
 	}
 
-	return typedProperty->m_value;
+	if constexpr (IsStoredInline<T>())
+	{
+		return reinterpret_cast<T const*>(m_inlineStorage);
+	}
+	else
+	{
+		return &static_cast<NamedPropertyofType<T> const*>(m_heapValue)->m_value;
+	}
 }
 
+//c++-style
 //-----------------------------------------------------------------------------------------------
-void NamedProperties::SetValue(std::string const& keyName, const char* value)
+template<typename T>
+inline void NamedProperties::SetValue(HCIString const& keyName, T const& value)
 {
-	HCIString key(keyName);
-	m_keyValuePairs[key] = new NamedPropertyofType<std::string>(value);
+	m_keyValuePairs[keyName].Set<T>(value);
 }
 
 //-----------------------------------------------------------------------------------------------
-inline std::string NamedProperties::GetValue(std::string const& keyName, const char* defaultValue)
+template<typename T>
+inline T NamedProperties::GetValue(HCIString const& keyName, T const& defaultValue) const
 {
-	HCIString key(keyName);
-	std::map<HCIString, NamedPropertyBase*>::iterator found = m_keyValuePairs.find(key);
+	auto found = m_keyValuePairs.find(keyName);
 	if (found == m_keyValuePairs.end())
 		return defaultValue;
 
-	NamedPropertyBase* property = found->second;
-	NamedPropertyofType<std::string>* typedProperty = dynamic_cast<NamedPropertyofType<std::string>*>(property);
-	if (typedProperty == nullptr)
+	T const* typedValue = found->second.Get<T>();
+	if (typedValue == nullptr)
 	{
 		ERROR_RECOVERABLE("Asked for value of the incorrect type!");
 		return defaultValue;
 	}
 
-	return typedProperty->m_value;
+	return *typedValue;
 }
@@ -7,6 +7,7 @@
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Core/Profiler.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Simulations/Collider3D.hpp"
 #include "Engine/Simulations/RigidBody3D.hpp"
@@ -15,6 +16,7 @@
 //-----------------------------------------------------------------------------------------------
 void OBJLoader::Load(std::string filename, std::vector<Vertex_PCUTBN>& vertices, std::vector<unsigned int>& indices, Mat44& transform)
 {
+	PROFILE_SCOPE("OBJLoader::Load");
 	Strings verts;
 	Strings vertTextureCoords;
 	Strings vertNormals;
@@ -320,6 +322,7 @@ void OBJLoader::Load(std::string filename, std::vector<Vertex_PCUTBN>& vertices,
 //-----------------------------------------------------------------------------------------------
 void OBJLoader::LoadIntoRigidBody(std::string filename, RigidBody3D* rigidBody, Mat44& transform)
 {
+	PROFILE_SCOPE("OBJLoader::LoadIntoRigidBody");
 	Strings verts;
 	Strings vertTextureCoords;
 	Strings vertNormals;
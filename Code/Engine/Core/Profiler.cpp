@@ -0,0 +1,360 @@
+#include "Profiler.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// Each thread caches its buffer, the generation catches a cached pointer left over from a previous Startup
+static std::atomic<unsigned int>			s_nextProfilerGeneration = 1;
+static thread_local ProfilerThreadBuffer*	t_threadBuffer = nullptr;
+static thread_local unsigned int			t_threadBufferGeneration = 0;
+
+//-----------------------------------------------------------------------------------------------
+static unsigned int RoundUpToPowerOfTwo(unsigned int value)
+{
+	unsigned int powerOfTwo = 1;
+	while (powerOfTwo < value)
+	{
+		powerOfTwo <<= 1;
+	}
+	return powerOfTwo;
+}
+
+//-----------------------------------------------------------------------------------------------
+ProfilerThreadBuffer::ProfilerThreadBuffer(std::string const& threadName, int threadIndex, unsigned int capacity)
+	:m_threadName(threadName)
+	,m_threadIndex(threadIndex)
+	,m_capacity(RoundUpToPowerOfTwo(capacity))
+{
+	m_events = new ProfileEvent[m_capacity];
+	m_droppedBeginDepths.reserve(64);
+	m_openScopes.reserve(64);
+}
+
+//-----------------------------------------------------------------------------------------------
+ProfilerThreadBuffer::~ProfilerThreadBuffer()
+{
+	delete[] m_events;
+	m_events = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ProfilerThreadBuffer::Push(char const* name, ProfileEventType type)
+{
+	uint64_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+	uint64_t readIndex = m_readIndex.load(std::memory_order_acquire);
+	uint64_t numFreeEvents = m_capacity - (writeIndex - readIndex);
+
+	if (type == ProfileEventType::BEGIN)
+	{
+		//Only accept a BEGIN when there is still room for the END of every open scope, so an END is never dropped
+		if (numFreeEvents < static_cast<uint64_t>(m_producerDepth) + 2)
+		{
+			m_droppedBeginDepths.push_back(m_producerDepth);
+			m_producerDepth++;
+			m_numDroppedEvents.fetch_add(2, std::memory_order_relaxed);
+			return;
+		}
+		m_producerDepth++;
+	}
+	else
+	{
+		m_producerDepth--;
+		if (!m_droppedBeginDepths.empty() && m_droppedBeginDepths.back() == m_producerDepth)
+		{
+			m_droppedBeginDepths.pop_back();
+			return;
+		}
+	}
+
+	ProfileEvent& newEvent = m_events[writeIndex & (m_capacity - 1)];
+	newEvent.m_name = name;
+	newEvent.m_timeTicks = GetCurrentTimeTicks();
+	newEvent.m_type = type;
+	m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+int ProfilerThreadBuffer::FindOrAddChildNode(int parentIndex, char const* name)
+{
+	//Scope names are literals, so comparing pointers is enough to tell scopes apart
+	if (parentIndex >= 0)
+	{
+		for (int childIndex : m_nodes[parentIndex].m_childIndices)
+		{
+			if (m_nodes[childIndex].m_name == name)
+			{
+				return childIndex;
+			}
+		}
+	}
+	else
+	{
+		for (int nodeIndex = 0; nodeIndex < static_cast<int>(m_nodes.size()); nodeIndex++)
+		{
+			if (m_nodes[nodeIndex].m_parentIndex < 0 && m_nodes[nodeIndex].m_name == name)
+			{
+				return nodeIndex;
+			}
+		}
+	}
+
+	int newNodeIndex = static_cast<int>(m_nodes.size());
+	ProfileNode newNode;
+	newNode.m_name = name;
+	newNode.m_parentIndex = parentIndex;
+	m_nodes.push_back(newNode);
+	if (parentIndex >= 0)
+	{
+		m_nodes[parentIndex].m_childIndices.push_back(newNodeIndex);
+	}
+	return newNodeIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+Profiler::Profiler(ProfilerConfig const& config)
+	:m_config(config)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+Profiler::~Profiler()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::Startup()
+{
+	m_generation.store(s_nextProfilerGeneration.fetch_add(1), std::memory_order_release);
+	m_millisecondsPerTick = GetSecondsPerTimeTick() * 1000.0;
+	RegisterCurrentThread("Main");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Shut down after the JobSystem, a worker still writing into its buffer would touch freed memory
+void Profiler::Shutdown()
+{
+	m_threadBuffersMutex.lock();
+	for (int bufferIndex = 0; bufferIndex < static_cast<int>(m_threadBuffers.size()); bufferIndex++)
+	{
+		delete m_threadBuffers[bufferIndex];
+		m_threadBuffers[bufferIndex] = nullptr;
+	}
+	m_threadBuffers.clear();
+	m_generation.store(s_nextProfilerGeneration.fetch_add(1), std::memory_order_release);
+	m_threadBuffersMutex.unlock();
+
+	m_lastFrameStats.clear();
+	m_capturedEvents.clear();
+	m_isCapturing = false;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::BeginFrame()
+{
+	RecordEvent("Frame", ProfileEventType::BEGIN);
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::EndFrame()
+{
+	RecordEvent("Frame", ProfileEventType::END);
+
+	m_threadBuffersMutex.lock();
+	std::vector<ProfilerThreadBuffer*> threadBuffers = m_threadBuffers;
+	m_threadBuffersMutex.unlock();
+
+	m_lastFrameStats.clear();
+	for (int bufferIndex = 0; bufferIndex < static_cast<int>(threadBuffers.size()); bufferIndex++)
+	{
+		ProfilerThreadBuffer* threadBuffer = threadBuffers[bufferIndex];
+		DrainThreadBuffer(threadBuffer);
+
+		for (int nodeIndex = 0; nodeIndex < static_cast<int>(threadBuffer->m_nodes.size()); nodeIndex++)
+		{
+			if (threadBuffer->m_nodes[nodeIndex].m_parentIndex < 0)
+			{
+				AddThreadFrameStats(threadBuffer, nodeIndex, 0);
+			}
+		}
+
+		for (int nodeIndex = 0; nodeIndex < static_cast<int>(threadBuffer->m_nodes.size()); nodeIndex++)
+		{
+			threadBuffer->m_nodes[nodeIndex].m_frameTicks = 0;
+			threadBuffer->m_nodes[nodeIndex].m_frameNumCalls = 0;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::RegisterCurrentThread(std::string const& threadName)
+{
+	ProfilerThreadBuffer* threadBuffer = GetOrCreateCurrentThreadBuffer();
+	m_threadBuffersMutex.lock();
+	threadBuffer->m_threadName = threadName;
+	m_threadBuffersMutex.unlock();
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::RecordEvent(char const* name, ProfileEventType type)
+{
+	GetOrCreateCurrentThreadBuffer()->Push(name, type);
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string Profiler::GetThreadName(int threadIndex)
+{
+	std::string threadName;
+	m_threadBuffersMutex.lock();
+	if (threadIndex >= 0 && threadIndex < static_cast<int>(m_threadBuffers.size()))
+	{
+		threadName = m_threadBuffers[threadIndex]->m_threadName;
+	}
+	m_threadBuffersMutex.unlock();
+	return threadName;
+}
+
+//-----------------------------------------------------------------------------------------------
+int Profiler::GetNumDroppedEvents()
+{
+	int numDroppedEvents = 0;
+	m_threadBuffersMutex.lock();
+	for (int bufferIndex = 0; bufferIndex < static_cast<int>(m_threadBuffers.size()); bufferIndex++)
+	{
+		numDroppedEvents += m_threadBuffers[bufferIndex]->m_numDroppedEvents.load(std::memory_order_relaxed);
+	}
+	m_threadBuffersMutex.unlock();
+	return numDroppedEvents;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::BeginCapture()
+{
+	m_capturedEvents.clear();
+	m_capturedEvents.reserve(m_config.m_maxCapturedEvents < 65536 ? m_config.m_maxCapturedEvents : 65536);
+	m_captureStartTicks = GetCurrentTimeTicks();
+	m_isCapturing = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool Profiler::EndCaptureAndWriteChromeTrace(std::string const& filePath)
+{
+	m_isCapturing = false;
+	double microsecondsPerTick = m_millisecondsPerTick * 1000.0;
+
+	std::string traceText = "{\"traceEvents\":[\n";
+	m_threadBuffersMutex.lock();
+	for (int bufferIndex = 0; bufferIndex < static_cast<int>(m_threadBuffers.size()); bufferIndex++)
+	{
+		traceText += Stringf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+			bufferIndex, m_threadBuffers[bufferIndex]->m_threadName.c_str());
+	}
+	m_threadBuffersMutex.unlock();
+
+	for (int eventIndex = 0; eventIndex < static_cast<int>(m_capturedEvents.size()); eventIndex++)
+	{
+		CapturedEvent const& capturedEvent = m_capturedEvents[eventIndex];
+		double timeMicroseconds = static_cast<double>(capturedEvent.m_event.m_timeTicks - m_captureStartTicks) * microsecondsPerTick;
+		traceText += Stringf("{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":0,\"tid\":%d,\"ts\":%.3f},\n",
+			capturedEvent.m_event.m_name, capturedEvent.m_event.m_type == ProfileEventType::BEGIN ? "B" : "E",
+			capturedEvent.m_threadIndex, timeMicroseconds);
+	}
+
+	//The trailing comma is legal for chrome://tracing but not for strict JSON readers
+	if (traceText.size() >= 2 && traceText[traceText.size() - 2] == ',')
+	{
+		traceText.erase(traceText.size() - 2, 1);
+	}
+	traceText += "]}\n";
+	m_capturedEvents.clear();
+
+	std::vector<uint8_t> traceBuffer(traceText.begin(), traceText.end());
+	return FileWriteToFileBinary(traceBuffer, filePath);
+}
+
+//-----------------------------------------------------------------------------------------------
+ProfilerThreadBuffer* Profiler::GetOrCreateCurrentThreadBuffer()
+{
+	unsigned int generation = m_generation.load(std::memory_order_acquire);
+	if (t_threadBuffer != nullptr && t_threadBufferGeneration == generation)
+	{
+		return t_threadBuffer;
+	}
+
+	m_threadBuffersMutex.lock();
+	int threadIndex = static_cast<int>(m_threadBuffers.size());
+	ProfilerThreadBuffer* newThreadBuffer = new ProfilerThreadBuffer(Stringf("Thread %d", threadIndex), threadIndex, m_config.m_eventsPerThread);
+	m_threadBuffers.push_back(newThreadBuffer);
+	m_threadBuffersMutex.unlock();
+
+	t_threadBuffer = newThreadBuffer;
+	t_threadBufferGeneration = generation;
+	return newThreadBuffer;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::DrainThreadBuffer(ProfilerThreadBuffer* threadBuffer)
+{
+	uint64_t readIndex = threadBuffer->m_readIndex.load(std::memory_order_relaxed);
+	uint64_t writeIndex = threadBuffer->m_writeIndex.load(std::memory_order_acquire);
+	unsigned int indexMask = threadBuffer->m_capacity - 1;
+
+	for (; readIndex < writeIndex; readIndex++)
+	{
+		ProfileEvent const& event = threadBuffer->m_events[readIndex & indexMask];
+		if (m_isCapturing && m_capturedEvents.size() < m_config.m_maxCapturedEvents)
+		{
+			CapturedEvent capturedEvent;
+			capturedEvent.m_event = event;
+			capturedEvent.m_threadIndex = threadBuffer->m_threadIndex;
+			m_capturedEvents.push_back(capturedEvent);
+		}
+
+		if (event.m_type == ProfileEventType::BEGIN)
+		{
+			int parentIndex = threadBuffer->m_openScopes.empty() ? -1 : threadBuffer->m_openScopes.back().m_nodeIndex;
+			ProfilerThreadBuffer::OpenScope openScope;
+			openScope.m_nodeIndex = threadBuffer->FindOrAddChildNode(parentIndex, event.m_name);
+			openScope.m_beginTicks = event.m_timeTicks;
+			threadBuffer->m_openScopes.push_back(openScope);
+		}
+		else if (!threadBuffer->m_openScopes.empty())
+		{
+			ProfilerThreadBuffer::OpenScope const& openScope = threadBuffer->m_openScopes.back();
+			ProfilerThreadBuffer::ProfileNode& node = threadBuffer->m_nodes[openScope.m_nodeIndex];
+			node.m_frameTicks += event.m_timeTicks - openScope.m_beginTicks;
+			node.m_frameNumCalls++;
+			threadBuffer->m_openScopes.pop_back();
+		}
+	}
+
+	threadBuffer->m_readIndex.store(readIndex, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::AddThreadFrameStats(ProfilerThreadBuffer* threadBuffer, int nodeIndex, int depth)
+{
+	ProfilerThreadBuffer::ProfileNode const& node = threadBuffer->m_nodes[nodeIndex];
+	if (node.m_frameNumCalls == 0)
+	{
+		return;
+	}
+
+	int statsIndex = static_cast<int>(m_lastFrameStats.size());
+	ProfileScopeStats stats;
+	stats.m_name = node.m_name;
+	stats.m_threadIndex = threadBuffer->m_threadIndex;
+	stats.m_depth = depth;
+	stats.m_numCalls = node.m_frameNumCalls;
+	stats.m_totalMilliseconds = static_cast<double>(node.m_frameTicks) * m_millisecondsPerTick;
+	stats.m_selfMilliseconds = stats.m_totalMilliseconds;
+	m_lastFrameStats.push_back(stats);
+
+	for (int childIndex : node.m_childIndices)
+	{
+		ProfilerThreadBuffer::ProfileNode const& childNode = threadBuffer->m_nodes[childIndex];
+		m_lastFrameStats[statsIndex].m_selfMilliseconds -= static_cast<double>(childNode.m_frameTicks) * m_millisecondsPerTick;
+		AddThreadFrameStats(threadBuffer, childIndex, depth + 1);
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include "Game/EngineBuildPreferences.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------------------------
+// #define ENGINE_DISABLE_PROFILER in your game's Code/Game/EngineBuildPreferences.hpp to compile every PROFILE_SCOPE out
+#if !defined( ENGINE_DISABLE_PROFILER )
+	#define PROFILE_SCOPE_CONCAT_INNER(a, b) a##b
+	#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_INNER(a, b)
+	#define PROFILE_SCOPE(scopeName) ProfileScope PROFILE_SCOPE_CONCAT(profileScope_, __LINE__)(scopeName)
+#else
+	#define PROFILE_SCOPE(scopeName)
+#endif
+
+//-----------------------------------------------------------------------------------------------
+class	Profiler;
+extern	Profiler* g_theProfiler;
+
+//-----------------------------------------------------------------------------------------------
+enum class ProfileEventType : unsigned char
+{
+	BEGIN,
+	END
+};
+
+//-----------------------------------------------------------------------------------------------
+// Scope names are never copied, so they must be string literals or otherwise outlive the profiler
+struct ProfileEvent
+{
+	char const*			m_name = nullptr;
+	uint64_t			m_timeTicks = 0;
+	ProfileEventType	m_type = ProfileEventType::BEGIN;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Single producer (the owning thread), single consumer (the main thread in EndFrame), no locks
+class ProfilerThreadBuffer
+{
+	friend class Profiler;
+
+public:
+	ProfilerThreadBuffer(std::string const& threadName, int threadIndex, unsigned int capacity);
+	~ProfilerThreadBuffer();
+
+	void	Push(char const* name, ProfileEventType type);
+
+private:
+	struct OpenScope
+	{
+		int			m_nodeIndex = -1;
+		uint64_t	m_beginTicks = 0;
+	};
+
+	struct ProfileNode
+	{
+		char const*			m_name = nullptr;
+		int					m_parentIndex = -1;
+		std::vector<int>	m_childIndices;
+		uint64_t			m_frameTicks = 0;
+		int					m_frameNumCalls = 0;
+	};
+
+	int		FindOrAddChildNode(int parentIndex, char const* name);
+
+private:
+	std::string				m_threadName;
+	int						m_threadIndex = 0;
+	ProfileEvent*			m_events = nullptr;
+	unsigned int			m_capacity = 0;					// power of two
+	std::atomic<uint64_t>	m_writeIndex = 0;
+	std::atomic<uint64_t>	m_readIndex = 0;
+	std::atomic<int>		m_numDroppedEvents = 0;
+
+	//Only touched by the producer, a dropped BEGIN also has to drop its matching END
+	int						m_producerDepth = 0;
+	std::vector<int>		m_droppedBeginDepths;
+
+	//Only touched by the consumer
+	std::vector<ProfileNode>	m_nodes;
+	std::vector<OpenScope>		m_openScopes;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct ProfileScopeStats
+{
+	char const*	m_name = nullptr;
+	int			m_threadIndex = 0;
+	int			m_depth = 0;
+	int			m_numCalls = 0;
+	double		m_totalMilliseconds = 0.0;
+	double		m_selfMilliseconds = 0.0;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct ProfilerConfig
+{
+	unsigned int	m_eventsPerThread = 1 << 16;		// rounded up to a power of two
+	unsigned int	m_maxCapturedEvents = 1 << 22;
+};
+
+//-----------------------------------------------------------------------------------------------
+class Profiler
+{
+public:
+	Profiler(ProfilerConfig const& config);
+	~Profiler();
+	void								Startup();
+	void								Shutdown();
+	void								BeginFrame();
+	void								EndFrame();
+
+	void								RegisterCurrentThread(std::string const& threadName);
+	void								RecordEvent(char const* name, ProfileEventType type);
+
+	//Hierarchical timings of every scope that closed during the last frame, in depth first order per thread
+	std::vector<ProfileScopeStats> const&	GetLastFrameStats() const { return m_lastFrameStats; }
+	std::string							GetThreadName(int threadIndex);
+	int									GetNumDroppedEvents();
+
+	//Chrome trace event JSON, open it in chrome://tracing or ui.perfetto.dev
+	void								BeginCapture();
+	bool								EndCaptureAndWriteChromeTrace(std::string const& filePath);
+	bool								IsCapturing() const { return m_isCapturing; }
+
+protected:
+	ProfilerThreadBuffer*				GetOrCreateCurrentThreadBuffer();
+	void								DrainThreadBuffer(ProfilerThreadBuffer* threadBuffer);
+	void								AddThreadFrameStats(ProfilerThreadBuffer* threadBuffer, int nodeIndex, int depth);
+
+protected:
+	struct CapturedEvent
+	{
+		ProfileEvent	m_event;
+		int				m_threadIndex = 0;
+	};
+
+	ProfilerConfig						m_config;
+	std::vector<ProfilerThreadBuffer*>	m_threadBuffers;
+	std::mutex							m_threadBuffersMutex;
+	std::vector<ProfileScopeStats>		m_lastFrameStats;
+	std::vector<CapturedEvent>			m_capturedEvents;
+	uint64_t							m_captureStartTicks = 0;
+	bool								m_isCapturing = false;
+	double								m_millisecondsPerTick = 0.0;
+	std::atomic<unsigned int>			m_generation = 0;				// read by every thread that opens a scope
+};
+
+//-----------------------------------------------------------------------------------------------
+class ProfileScope
+{
+public:
+	ProfileScope(char const* scopeName)
+		:m_scopeName(scopeName)
+	{
+		if (g_theProfiler)
+		{
+			g_theProfiler->RecordEvent(m_scopeName, ProfileEventType::BEGIN);
+		}
+	}
+
+	~ProfileScope()
+	{
+		if (g_theProfiler)
+		{
+			g_theProfiler->RecordEvent(m_scopeName, ProfileEventType::END);
+		}
+	}
+
+private:
+	char const*	m_scopeName = nullptr;
+};
@@ -32,3 +32,20 @@ double GetCurrentTimeSeconds()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+// Raw performance counter ticks, cheap enough to stamp every profiler scope
+uint64_t GetCurrentTimeTicks()
+{
+	LARGE_INTEGER currentCount;
+	QueryPerformanceCounter( &currentCount );
+	return static_cast< uint64_t >( currentCount.QuadPart );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+double GetSecondsPerTimeTick()
+{
+	static LARGE_INTEGER unusedInitialTime;
+	static double secondsPerTick = InitializeTime( unusedInitialTime );
+	return secondsPerTick;
+}
@@ -2,8 +2,9 @@
 // Time.hpp
 //
 #pragma once
+#include <cstdint>
 
 //-----------------------------------------------------------------------------------------------
 double GetCurrentTimeSeconds();
-
-	
\ No newline at end of file
+uint64_t GetCurrentTimeTicks();
+double GetSecondsPerTimeTick();
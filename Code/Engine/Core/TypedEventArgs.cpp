@@ -0,0 +1,199 @@
+#include "TypedEventArgs.hpp"
+#include "NamedStrings.hpp"
+#include "StringUtils.hpp"
+#include "ErrorWarningAssert.hpp"
+
+//-----------------------------------------------------------------------------------------------
+void TypedEventArgs::SetValue(EventArgKey const& key, int value)
+{
+	TypedEventArg& arg = FindOrAddArg(key);
+	arg.m_type = EventArgType::INT;
+	arg.m_int = value;
+}
+
+//-----------------------------------------------------------------------------------------------
+void TypedEventArgs::SetValue(EventArgKey const& key, float value)
+{
+	TypedEventArg& arg = FindOrAddArg(key);
+	arg.m_type = EventArgType::FLOAT;
+	arg.m_float = value;
+}
+
+//-----------------------------------------------------------------------------------------------
+void TypedEventArgs::SetValue(EventArgKey const& key, Vec3 const& value)
+{
+	TypedEventArg& arg = FindOrAddArg(key);
+	arg.m_type = EventArgType::VEC3;
+	arg.m_vec3[0] = value.x;
+	arg.m_vec3[1] = value.y;
+	arg.m_vec3[2] = value.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+void TypedEventArgs::SetValue(EventArgKey const& key, std::string_view value)
+{
+	TypedEventArg& arg = FindOrAddArg(key);
+	arg.m_type = EventArgType::STRING_VIEW;
+	arg.m_stringView.m_data = value.data();
+	arg.m_stringView.m_size = value.size();
+}
+
+//-----------------------------------------------------------------------------------------------
+int TypedEventArgs::GetValue(EventArgKey const& key, int defaultValue) const
+{
+	TypedEventArg const* arg = FindArg(key.m_hash);
+	if (arg == nullptr)
+	{
+		return defaultValue;
+	}
+
+	if (arg->m_type == EventArgType::INT)
+	{
+		return arg->m_int;
+	}
+	if (arg->m_type == EventArgType::FLOAT)
+	{
+		return static_cast<int>(arg->m_float);
+	}
+
+	return defaultValue;
+}
+
+//-----------------------------------------------------------------------------------------------
+float TypedEventArgs::GetValue(EventArgKey const& key, float defaultValue) const
+{
+	TypedEventArg const* arg = FindArg(key.m_hash);
+	if (arg == nullptr)
+	{
+		return defaultValue;
+	}
+
+	if (arg->m_type == EventArgType::FLOAT)
+	{
+		return arg->m_float;
+	}
+	if (arg->m_type == EventArgType::INT)
+	{
+		return static_cast<float>(arg->m_int);
+	}
+
+	return defaultValue;
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec3 TypedEventArgs::GetValue(EventArgKey const& key, Vec3 const& defaultValue) const
+{
+	TypedEventArg const* arg = FindArg(key.m_hash);
+	if (arg == nullptr || arg->m_type != EventArgType::VEC3)
+	{
+		return defaultValue;
+	}
+
+	return Vec3(arg->m_vec3[0], arg->m_vec3[1], arg->m_vec3[2]);
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string_view TypedEventArgs::GetValue(EventArgKey const& key, std::string_view defaultValue) const
+{
+	TypedEventArg const* arg = FindArg(key.m_hash);
+	if (arg == nullptr || arg->m_type != EventArgType::STRING_VIEW)
+	{
+		return defaultValue;
+	}
+
+	return std::string_view(arg->m_stringView.m_data, arg->m_stringView.m_size);
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string_view TypedEventArgs::GetValue(EventArgKey const& key, char const* defaultValue) const
+{
+	return GetValue(key, std::string_view(defaultValue));
+}
+
+//-----------------------------------------------------------------------------------------------
+bool TypedEventArgs::HasKey(EventArgKey const& key) const
+{
+	return FindArg(key.m_hash) != nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+EventArgType TypedEventArgs::GetType(EventArgKey const& key) const
+{
+	TypedEventArg const* arg = FindArg(key.m_hash);
+	if (arg == nullptr)
+	{
+		return EventArgType::NONE;
+	}
+
+	return arg->m_type;
+}
+
+//-----------------------------------------------------------------------------------------------
+void TypedEventArgs::CopyToNamedStrings(NamedStrings& outNamedStrings) const
+{
+	for (int argIndex = 0; argIndex < m_numArgs; argIndex++)
+	{
+		TypedEventArg const& arg = m_args[argIndex];
+		switch (arg.m_type)
+		{
+			case EventArgType::INT:
+				outNamedStrings.SetValue(arg.m_name, Stringf("%d", arg.m_int));
+				break;
+			case EventArgType::FLOAT:
+				outNamedStrings.SetValue(arg.m_name, Stringf("%f", arg.m_float));
+				break;
+			case EventArgType::VEC3:
+				outNamedStrings.SetValue(arg.m_name, Stringf("%f,%f,%f", arg.m_vec3[0], arg.m_vec3[1], arg.m_vec3[2]));
+				break;
+			case EventArgType::STRING_VIEW:
+				outNamedStrings.SetValue(arg.m_name, std::string(arg.m_stringView.m_data, arg.m_stringView.m_size));
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+TypedEventArgs::TypedEventArg* TypedEventArgs::FindArg(unsigned int keyHash)
+{
+	for (int argIndex = 0; argIndex < m_numArgs; argIndex++)
+	{
+		if (m_args[argIndex].m_keyHash == keyHash)
+		{
+			return &m_args[argIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+TypedEventArgs::TypedEventArg const* TypedEventArgs::FindArg(unsigned int keyHash) const
+{
+	for (int argIndex = 0; argIndex < m_numArgs; argIndex++)
+	{
+		if (m_args[argIndex].m_keyHash == keyHash)
+		{
+			return &m_args[argIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+TypedEventArgs::TypedEventArg& TypedEventArgs::FindOrAddArg(EventArgKey const& key)
+{
+	TypedEventArg* existingArg = FindArg(key.m_hash);
+	if (existingArg)
+	{
+		return *existingArg;
+	}
+
+	GUARANTEE_OR_DIE(m_numArgs < MAX_ARGS, "TypedEventArgs is full, raise MAX_ARGS or use NamedStrings EventArgs");
+	TypedEventArg& newArg = m_args[m_numArgs++];
+	newArg.m_name = key.m_name;
+	newArg.m_keyHash = key.m_hash;
+	return newArg;
+}
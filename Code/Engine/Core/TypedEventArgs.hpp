@@ -0,0 +1,98 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include "HashedCaseInsensitiveString.hpp"
+#include <string_view>
+
+//-----------------------------------------------------------------------------------------------
+class NamedStrings;
+
+//-----------------------------------------------------------------------------------------------
+// Declare keys as constexpr so the hash is folded at compile time.
+// The name is kept for the NamedStrings fallback, so it must be a string literal or otherwise outlive the args.
+struct EventArgKey
+{
+public:
+	constexpr EventArgKey(char const* name)
+		:m_name(name)
+		,m_hash(HCIString::CalculateHashForText(name))
+	{
+	}
+
+public:
+	char const*		m_name = nullptr;
+	unsigned int	m_hash = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+enum class EventArgType : unsigned char
+{
+	NONE,
+	INT,
+	FLOAT,
+	VEC3,
+	STRING_VIEW
+};
+
+//-----------------------------------------------------------------------------------------------
+enum class EventReturnStatus
+{
+	UNKNOWN_EVENT,		// nobody has ever subscribed to this event
+	NOT_CONSUMED,		// every subscriber returned false
+	CONSUMED
+};
+
+//-----------------------------------------------------------------------------------------------
+// Fixed size, allocation free argument list for events fired at high frequency.
+// String values are views, so whatever they point to must stay alive until FireEvent returns.
+class TypedEventArgs
+{
+public:
+	static constexpr int MAX_ARGS = 8;
+
+public:
+	void				SetValue(EventArgKey const& key, int value);
+	void				SetValue(EventArgKey const& key, float value);
+	void				SetValue(EventArgKey const& key, Vec3 const& value);
+	void				SetValue(EventArgKey const& key, std::string_view value);
+	int					GetValue(EventArgKey const& key, int defaultValue) const;
+	float				GetValue(EventArgKey const& key, float defaultValue) const;
+	Vec3				GetValue(EventArgKey const& key, Vec3 const& defaultValue) const;
+	std::string_view	GetValue(EventArgKey const& key, std::string_view defaultValue) const;
+	std::string_view	GetValue(EventArgKey const& key, char const* defaultValue) const;
+	bool				HasKey(EventArgKey const& key) const;
+	EventArgType		GetType(EventArgKey const& key) const;
+	int					GetNumArgs() const { return m_numArgs; }
+	void				Clear() { m_numArgs = 0; }
+	void				CopyToNamedStrings(NamedStrings& outNamedStrings) const;
+
+private:
+	struct TypedEventArg
+	{
+		char const*		m_name = nullptr;
+		unsigned int	m_keyHash = 0;
+		EventArgType	m_type = EventArgType::NONE;
+		union
+		{
+			int			m_int;
+			float		m_float;
+			float		m_vec3[3];
+			struct
+			{
+				char const*	m_data;
+				size_t		m_size;
+			}			m_stringView;
+		};
+	};
+
+	TypedEventArg*			FindArg(unsigned int keyHash);
+	TypedEventArg const*	FindArg(unsigned int keyHash) const;
+	TypedEventArg&			FindOrAddArg(EventArgKey const& key);
+
+private:
+	TypedEventArg	m_args[MAX_ARGS];
+	int				m_numArgs = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+constexpr EventArgKey EVENT_ARG_KEY_CODE("KeyCode");
+constexpr EventArgKey EVENT_ARG_CHAR("Char");
@@ -219,25 +219,25 @@ InputSystemConfig const& InputSystem::GetConfig() const
 }
 
 //-----------------------------------------------------------------------------------------------
-bool InputSystem::Event_KeyPressed(EventArgs& args)
+bool InputSystem::Event_KeyPressed(TypedEventArgs& args)
 {
 	if (!g_theInput)
 	{
 		return false;
 	}
-	unsigned char keyCode = static_cast<unsigned char>(args.GetValue("KeyCode", -1));
+	unsigned char keyCode = static_cast<unsigned char>(args.GetValue(EVENT_ARG_KEY_CODE, -1));
 	g_theInput->HandleKeyPressed(keyCode);
 	return true;
 }
 
 //-----------------------------------------------------------------------------------------------
-bool InputSystem::Event_KeyReleased(EventArgs& args)
+bool InputSystem::Event_KeyReleased(TypedEventArgs& args)
 {
 	if (!g_theInput)
 	{
 		return false;
 	}
-	unsigned char keyCode = static_cast<unsigned char>(args.GetValue("KeyCode", -1));
+	unsigned char keyCode = static_cast<unsigned char>(args.GetValue(EVENT_ARG_KEY_CODE, -1));
 	g_theInput->HandleKeyReleased(keyCode);
 	return true;
 }
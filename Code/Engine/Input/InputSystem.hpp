@@ -94,8 +94,8 @@ public:
 	bool						HandleKeyReleased(unsigned char keyCode);
 	XboxController const&		GetController(int controllerID);
 	InputSystemConfig const&	GetConfig() const;
-	static bool					Event_KeyPressed(EventArgs& args);
-	static bool					Event_KeyReleased(EventArgs& args);
+	static bool					Event_KeyPressed(TypedEventArgs& args);
+	static bool					Event_KeyReleased(TypedEventArgs& args);
 	void						SetCursorMode(bool hidden, bool relative);
 	IntVec2						GetCursorClientDelta() const;
 	IntVec2						GetCursorClientPosition() const;
@@ -113,4 +113,4 @@ protected:
 	InputSystemConfig			m_config;
 };
 
-extern InputSystem*				g_theInput;
\ No newline at end of file
+extern InputSystem*				g_theInput;
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include "CollisionPackets3D.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/OBB3.hpp"
+#include "Engine/Math/Capsule3.hpp"
+#include "Engine/Math/Cylinder3.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cmath>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLLISION_PACKETS_USE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_PACKETS_USE_SSE2
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// The kernels further down are written once against these, each build gets the widest lanes it was compiled for
+#if defined(COLLISION_PACKETS_USE_AVX2)
+constexpr int LANES_PER_STEP = 8;
+typedef __m256 FloatLanes;
+typedef __m256 MaskLanes;
+static inline FloatLanes	LoadLanes(float const* values)							{ return _mm256_load_ps(values); }
+static inline void			StoreLanes(float* values, FloatLanes a)					{ _mm256_store_ps(values, a); }
+static inline FloatLanes	SplatLanes(float value)									{ return _mm256_set1_ps(value); }
+static inline FloatLanes	LaneAdd(FloatLanes a, FloatLanes b)						{ return _mm256_add_ps(a, b); }
+static inline FloatLanes	LaneSub(FloatLanes a, FloatLanes b)						{ return _mm256_sub_ps(a, b); }
+static inline FloatLanes	LaneMul(FloatLanes a, FloatLanes b)						{ return _mm256_mul_ps(a, b); }
+static inline FloatLanes	LaneDiv(FloatLanes a, FloatLanes b)						{ return _mm256_div_ps(a, b); }
+static inline FloatLanes	LaneMin(FloatLanes a, FloatLanes b)						{ return _mm256_min_ps(a, b); }
+static inline FloatLanes	LaneMax(FloatLanes a, FloatLanes b)						{ return _mm256_max_ps(a, b); }
+static inline FloatLanes	LaneSqrt(FloatLanes a)									{ return _mm256_sqrt_ps(a); }
+static inline FloatLanes	LaneAbs(FloatLanes a)									{ return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline MaskLanes		LaneLess(FloatLanes a, FloatLanes b)					{ return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline MaskLanes		LaneLessEqual(FloatLanes a, FloatLanes b)				{ return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+static inline MaskLanes		LaneEqual(FloatLanes a, FloatLanes b)					{ return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+static inline MaskLanes		LaneAnd(MaskLanes a, MaskLanes b)						{ return _mm256_and_ps(a, b); }
+static inline MaskLanes		LaneOr(MaskLanes a, MaskLanes b)						{ return _mm256_or_ps(a, b); }
+static inline MaskLanes		LaneAndNot(MaskLanes a, MaskLanes b)					{ return _mm256_andnot_ps(b, a); }
+static inline FloatLanes	LaneSelect(MaskLanes mask, FloatLanes a, FloatLanes b)	{ return _mm256_blendv_ps(b, a, mask); }
+static inline int			LaneBits(MaskLanes mask)								{ return _mm256_movemask_ps(mask); }
+#elif defined(COLLISION_PACKETS_USE_SSE2)
+constexpr int LANES_PER_STEP = 4;
+typedef __m128 FloatLanes;
+typedef __m128 MaskLanes;
+static inline FloatLanes	LoadLanes(float const* values)							{ return _mm_load_ps(values); }
+static inline void			StoreLanes(float* values, FloatLanes a)					{ _mm_store_ps(values, a); }
+static inline FloatLanes	SplatLanes(float value)									{ return _mm_set1_ps(value); }
+static inline FloatLanes	LaneAdd(FloatLanes a, FloatLanes b)						{ return _mm_add_ps(a, b); }
+static inline FloatLanes	LaneSub(FloatLanes a, FloatLanes b)						{ return _mm_sub_ps(a, b); }
+static inline FloatLanes	LaneMul(FloatLanes a, FloatLanes b)						{ return _mm_mul_ps(a, b); }
+static inline FloatLanes	LaneDiv(FloatLanes a, FloatLanes b)						{ return _mm_div_ps(a, b); }
+static inline FloatLanes	LaneMin(FloatLanes a, FloatLanes b)						{ return _mm_min_ps(a, b); }
+static inline FloatLanes	LaneMax(FloatLanes a, FloatLanes b)						{ return _mm_max_ps(a, b); }
+static inline FloatLanes	LaneSqrt(FloatLanes a)									{ return _mm_sqrt_ps(a); }
+static inline FloatLanes	LaneAbs(FloatLanes a)									{ return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline MaskLanes		LaneLess(FloatLanes a, FloatLanes b)					{ return _mm_cmplt_ps(a, b); }
+static inline MaskLanes		LaneLessEqual(FloatLanes a, FloatLanes b)				{ return _mm_cmple_ps(a, b); }
+static inline MaskLanes		LaneEqual(FloatLanes a, FloatLanes b)					{ return _mm_cmpeq_ps(a, b); }
+static inline MaskLanes		LaneAnd(MaskLanes a, MaskLanes b)						{ return _mm_and_ps(a, b); }
+static inline MaskLanes		LaneOr(MaskLanes a, MaskLanes b)						{ return _mm_or_ps(a, b); }
+static inline MaskLanes		LaneAndNot(MaskLanes a, MaskLanes b)					{ return _mm_andnot_ps(b, a); }
+static inline FloatLanes	LaneSelect(MaskLanes mask, FloatLanes a, FloatLanes b)	{ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline int			LaneBits(MaskLanes mask)								{ return _mm_movemask_ps(mask); }
+#else
+constexpr int LANES_PER_STEP = 1;
+typedef float FloatLanes;
+typedef bool MaskLanes;
+static inline FloatLanes	LoadLanes(float const* values)							{ return *values; }
+static inline void			StoreLanes(float* values, FloatLanes a)					{ *values = a; }
+static inline FloatLanes	SplatLanes(float value)									{ return value; }
+static inline FloatLanes	LaneAdd(FloatLanes a, FloatLanes b)						{ return a + b; }
+static inline FloatLanes	LaneSub(FloatLanes a, FloatLanes b)						{ return a - b; }
+static inline FloatLanes	LaneMul(FloatLanes a, FloatLanes b)						{ return a * b; }
+static inline FloatLanes	LaneDiv(FloatLanes a, FloatLanes b)						{ return a / b; }
+static inline FloatLanes	LaneMin(FloatLanes a, FloatLanes b)						{ return a < b ? a : b; }
+static inline FloatLanes	LaneMax(FloatLanes a, FloatLanes b)						{ return a > b ? a : b; }
+static inline FloatLanes	LaneSqrt(FloatLanes a)									{ return sqrtf(a); }
+static inline FloatLanes	LaneAbs(FloatLanes a)									{ return fabsf(a); }
+static inline MaskLanes		LaneLess(FloatLanes a, FloatLanes b)					{ return a < b; }
+static inline MaskLanes		LaneLessEqual(FloatLanes a, FloatLanes b)				{ return a <= b; }
+static inline MaskLanes		LaneEqual(FloatLanes a, FloatLanes b)					{ return a == b; }
+static inline MaskLanes		LaneAnd(MaskLanes a, MaskLanes b)						{ return a && b; }
+static inline MaskLanes		LaneOr(MaskLanes a, MaskLanes b)						{ return a || b; }
+static inline MaskLanes		LaneAndNot(MaskLanes a, MaskLanes b)					{ return a && !b; }
+static inline FloatLanes	LaneSelect(MaskLanes mask, FloatLanes a, FloatLanes b)	{ return mask ? a : b; }
+static inline int			LaneBits(MaskLanes mask)								{ return mask ? 1 : 0; }
+#endif
+
+//-----------------------------------------------------------------------------------------------
+struct ContactLanes
+{
+	FloatLanes	m_penetration;
+	FloatLanes	m_normalX;
+	FloatLanes	m_normalY;
+	FloatLanes	m_normalZ;
+	MaskLanes	m_isColliding;
+};
+
+//-----------------------------------------------------------------------------------------------
+void SpherePacket3D::SetSphere(int laneIndex, Vec3 const& center, float radius)
+{
+	GUARANTEE_OR_DIE(laneIndex >= 0 && laneIndex < COLLISION_PACKET_WIDTH, "Sphere packet lane out of range");
+	m_centerX[laneIndex] = center.x;
+	m_centerY[laneIndex] = center.y;
+	m_centerZ[laneIndex] = center.z;
+	m_radius[laneIndex] = radius;
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec3 SpherePacket3D::GetCenter(int laneIndex) const
+{
+	return Vec3(m_centerX[laneIndex], m_centerY[laneIndex], m_centerZ[laneIndex]);
+}
+
+//-----------------------------------------------------------------------------------------------
+void AABBPacket3D::SetAABB(int laneIndex, AABB3 const& aabb)
+{
+	GUARANTEE_OR_DIE(laneIndex >= 0 && laneIndex < COLLISION_PACKET_WIDTH, "AABB packet lane out of range");
+	m_minX[laneIndex] = aabb.m_mins.x;
+	m_minY[laneIndex] = aabb.m_mins.y;
+	m_minZ[laneIndex] = aabb.m_mins.z;
+	m_maxX[laneIndex] = aabb.m_maxs.x;
+	m_maxY[laneIndex] = aabb.m_maxs.y;
+	m_maxZ[laneIndex] = aabb.m_maxs.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec3 ContactPacket3D::GetNormal(int laneIndex) const
+{
+	return Vec3(m_normalX[laneIndex], m_normalY[laneIndex], m_normalZ[laneIndex]);
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec3 ContactPacket3D::GetCorrection(int laneIndex) const
+{
+	return GetNormal(laneIndex) * m_penetration[laneIndex];
+}
+
+//-----------------------------------------------------------------------------------------------
+static inline int GetActiveLanesMask(int numActiveLanes)
+{
+	return (1 << numActiveLanes) - 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+static inline int StoreContactLanes(ContactPacket3D& out_contacts, int laneIndex, ContactLanes const& contact)
+{
+	StoreLanes(out_contacts.m_penetration + laneIndex, contact.m_penetration);
+	StoreLanes(out_contacts.m_normalX + laneIndex, contact.m_normalX);
+	StoreLanes(out_contacts.m_normalY + laneIndex, contact.m_normalY);
+	StoreLanes(out_contacts.m_normalZ + laneIndex, contact.m_normalZ);
+	return LaneBits(contact.m_isColliding) << laneIndex;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pushes a sphere straight away from the nearest point on the shape, zero normal when the center sits exactly on it
+static inline ContactLanes GetContactLanesFromNearestPoint(FloatLanes centerX, FloatLanes centerY, FloatLanes centerZ, FloatLanes nearestX, FloatLanes nearestY, FloatLanes nearestZ, 
+	FloatLanes pushDistance, bool isTouchingColliding = false)
+{
+	FloatLanes zero = SplatLanes(0.0f);
+	FloatLanes differenceX = LaneSub(centerX, nearestX);
+	FloatLanes differenceY = LaneSub(centerY, nearestY);
+	FloatLanes differenceZ = LaneSub(centerZ, nearestZ);
+	FloatLanes distanceSquared = LaneAdd(LaneAdd(LaneMul(differenceX, differenceX), LaneMul(differenceY, differenceY)), LaneMul(differenceZ, differenceZ));
+	FloatLanes distance = LaneSqrt(distanceSquared);
+	FloatLanes inverseDistance = LaneSelect(LaneLess(zero, distance), LaneDiv(SplatLanes(1.0f), distance), zero);
+
+	ContactLanes contact;
+	contact.m_penetration = LaneSub(pushDistance, distance);
+	contact.m_normalX = LaneMul(differenceX, inverseDistance);
+	contact.m_normalY = LaneMul(differenceY, inverseDistance);
+	contact.m_normalZ = LaneMul(differenceZ, inverseDistance);
+	FloatLanes pushDistanceSquared = LaneMul(pushDistance, pushDistance);
+	contact.m_isColliding = isTouchingColliding ? LaneLessEqual(distanceSquared, pushDistanceSquared) : LaneLess(distanceSquared, pushDistanceSquared);
+	return contact;
+}
+
+//-----------------------------------------------------------------------------------------------
+// PushSphereOutOfFixedSphere3D, which also counts spheres that are just touching
+static inline ContactLanes GetSphereVsSphereContactLanes(FloatLanes centerX, FloatLanes centerY, FloatLanes centerZ, FloatLanes radius, 
+	FloatLanes fixedCenterX, FloatLanes fixedCenterY, FloatLanes fixedCenterZ, FloatLanes fixedRadius)
+{
+	return GetContactLanesFromNearestPoint(centerX, centerY, centerZ, fixedCenterX, fixedCenterY, fixedCenterZ, LaneAdd(radius, fixedRadius), true);
+}
+
+//-----------------------------------------------------------------------------------------------
+// PushSphereOutOfFixedCapsule3D
+static inline ContactLanes GetSphereVsCapsuleContactLanes(FloatLanes centerX, FloatLanes centerY, FloatLanes centerZ, FloatLanes radius, Capsule3 const& capsule)
+{
+	Vec3 const& boneStart = capsule.m_bone.m_start;
+	Vec3 bone = capsule.m_bone.m_end - boneStart;
+	float boneLengthSquared = bone.GetLengthSquared();
+	FloatLanes boneX = SplatLanes(bone.x);
+	FloatLanes boneY = SplatLanes(bone.y);
+	FloatLanes boneZ = SplatLanes(bone.z);
+	FloatLanes boneStartX = SplatLanes(boneStart.x);
+	FloatLanes boneStartY = SplatLanes(boneStart.y);
+	FloatLanes boneStartZ = SplatLanes(boneStart.z);
+
+	//Clamped fraction along the bone of the nearest point
+	FloatLanes startToCenterX = LaneSub(centerX, boneStartX);
+	FloatLanes startToCenterY = LaneSub(centerY, boneStartY);
+	FloatLanes startToCenterZ = LaneSub(centerZ, boneStartZ);
+	FloatLanes projectedLength = LaneAdd(LaneAdd(LaneMul(startToCenterX, boneX), LaneMul(startToCenterY, boneY)), LaneMul(startToCenterZ, boneZ));
+	FloatLanes boneFraction = LaneMul(projectedLength, SplatLanes(boneLengthSquared > 0.0f ? 1.0f / boneLengthSquared : 0.0f));
+	boneFraction = LaneSelect(LaneLess(projectedLength, SplatLanes(0.0f)), SplatLanes(0.0f), boneFraction);
+	boneFraction = LaneSelect(LaneLess(SplatLanes(boneLengthSquared), projectedLength), SplatLanes(1.0f), boneFraction);
+
+	FloatLanes nearestX = LaneAdd(boneStartX, LaneMul(boneX, boneFraction));
+	FloatLanes nearestY = LaneAdd(boneStartY, LaneMul(boneY, boneFraction));
+	FloatLanes nearestZ = LaneAdd(boneStartZ, LaneMul(boneZ, boneFraction));
+	return GetContactLanesFromNearestPoint(centerX, centerY, centerZ, nearestX, nearestY, nearestZ, LaneAdd(radius, SplatLanes(capsule.m_radius)));
+}
+
+//-----------------------------------------------------------------------------------------------
+// PushSphereOutOfFixedAABB3D. A center inside the box leaves through the closest face, and like the scalar version a center
+// exactly as close to two faces counts as colliding without being moved
+static inline ContactLanes GetSphereVsBoxContactLanes(FloatLanes centerX, FloatLanes centerY, FloatLanes centerZ, FloatLanes radius, 
+	FloatLanes minX, FloatLanes minY, FloatLanes minZ, FloatLanes maxX, FloatLanes maxY, FloatLanes maxZ)
+{
+	FloatLanes zero = SplatLanes(0.0f);
+	FloatLanes nearestX = LaneMin(LaneMax(centerX, minX), maxX);
+	FloatLanes nearestY = LaneMin(LaneMax(centerY, minY), maxY);
+	FloatLanes nearestZ = LaneMin(LaneMax(centerZ, minZ), maxZ);
+	ContactLanes contact = GetContactLanesFromNearestPoint(centerX, centerY, centerZ, nearestX, nearestY, nearestZ, radius);
+	MaskLanes isInside = LaneAnd(LaneAnd(LaneEqual(centerX, nearestX), LaneEqual(centerY, nearestY)), LaneEqual(centerZ, nearestZ));
+
+	//Distance to each face and which one is strictly the closest
+	FloatLanes distancePositiveX = LaneSub(maxX, centerX);
+	FloatLanes distanceNegativeX = LaneSub(centerX, minX);
+	FloatLanes distancePositiveY = LaneSub(maxY, centerY);
+	FloatLanes distanceNegativeY = LaneSub(centerY, minY);
+	FloatLanes distancePositiveZ = LaneSub(maxZ, centerZ);
+	FloatLanes distanceNegativeZ = LaneSub(centerZ, minZ);
+	FloatLanes closestX = LaneMin(distancePositiveX, distanceNegativeX);
+	FloatLanes closestY = LaneMin(distancePositiveY, distanceNegativeY);
+	FloatLanes closestZ = LaneMin(distancePositiveZ, distanceNegativeZ);
+	MaskLanes isPositiveZ = LaneLess(distancePositiveZ, LaneMin(distanceNegativeZ, LaneMin(closestX, closestY)));
+	MaskLanes isNegativeZ = LaneLess(distanceNegativeZ, LaneMin(distancePositiveZ, LaneMin(closestX, closestY)));
+	MaskLanes isPositiveY = LaneLess(distancePositiveY, LaneMin(distanceNegativeY, LaneMin(closestX, closestZ)));
+	MaskLanes isNegativeY = LaneLess(distanceNegativeY, LaneMin(distancePositiveY, LaneMin(closestX, closestZ)));
+	MaskLanes isPositiveX = LaneLess(distancePositiveX, LaneMin(distanceNegativeX, LaneMin(closestY, closestZ)));
+	MaskLanes isNegativeX = LaneLess(distanceNegativeX, LaneMin(distancePositiveX, LaneMin(closestY, closestZ)));
+
+	FloatLanes one = SplatLanes(1.0f);
+	FloatLanes negativeOne = SplatLanes(-1.0f);
+	FloatLanes facePenetration = zero;
+	facePenetration = LaneSelect(isNegativeX, LaneAdd(distanceNegativeX, radius), facePenetration);
+	facePenetration = LaneSelect(isPositiveX, LaneAdd(distancePositiveX, radius), facePenetration);
+	facePenetration = LaneSelect(isNegativeY, LaneAdd(distanceNegativeY, radius), facePenetration);
+	facePenetration = LaneSelect(isPositiveY, LaneAdd(distancePositiveY, radius), facePenetration);
+	facePenetration = LaneSelect(isNegativeZ, LaneAdd(distanceNegativeZ, radius), facePenetration);
+	facePenetration = LaneSelect(isPositiveZ, LaneAdd(distancePositiveZ, radius), facePenetration);
+	FloatLanes faceNormalX = LaneSelect(isPositiveX, one, LaneSelect(isNegativeX, negativeOne, zero));
+	FloatLanes faceNormalY = LaneSelect(isPositiveY, one, LaneSelect(isNegativeY, negativeOne, zero));
+	FloatLanes faceNormalZ = LaneSelect(isPositiveZ, one, LaneSelect(isNegativeZ, negativeOne, zero));
+
+	contact.m_penetration = LaneSelect(isInside, facePenetration, contact.m_penetration);
+	contact.m_normalX = LaneSelect(isInside, faceNormalX, contact.m_normalX);
+	contact.m_normalY = LaneSelect(isInside, faceNormalY, contact.m_normalY);
+	contact.m_normalZ = LaneSelect(isInside, faceNormalZ, contact.m_normalZ);
+	contact.m_isColliding = LaneOr(isInside, contact.m_isColliding);
+	return contact;
+}
+
+//-----------------------------------------------------------------------------------------------
+// PushSphereOutOfFixedCylinderZ3D with the cylinder's start at the origin, the center is already in cylinder space
+static inline ContactLanes GetSphereVsLocalCylinderContactLanes(FloatLanes centerX, FloatLanes centerY, FloatLanes centerZ, FloatLanes radius, 
+	float cylinderRadius, float cylinderLength)
+{
+	FloatLanes zero = SplatLanes(0.0f);
+	FloatLanes cylinderRadiusLanes = SplatLanes(cylinderRadius);
+	FloatLanes cylinderLengthLanes = SplatLanes(cylinderLength);
+	FloatLanes distanceFromAxis = LaneSqrt(LaneAdd(LaneMul(centerX, centerX), LaneMul(centerY, centerY)));
+	FloatLanes inverseDistanceFromAxis = LaneSelect(LaneLess(zero, distanceFromAxis), LaneDiv(SplatLanes(1.0f), distanceFromAxis), zero);
+	MaskLanes isInsideRadius = LaneLessEqual(distanceFromAxis, cylinderRadiusLanes);
+	MaskLanes isInside = LaneAnd(isInsideRadius, LaneAnd(LaneLessEqual(zero, centerZ), LaneLessEqual(centerZ, cylinderLengthLanes)));
+
+	//Outside, nearest point on the solid cylinder
+	FloatLanes radialScale = LaneSelect(isInsideRadius, SplatLanes(1.0f), LaneMul(cylinderRadiusLanes, inverseDistanceFromAxis));
+	FloatLanes nearestX = LaneMul(centerX, radialScale);
+	FloatLanes nearestY = LaneMul(centerY, radialScale);
+	FloatLanes nearestZ = LaneMin(LaneMax(centerZ, zero), cylinderLengthLanes);
+	ContactLanes contact = GetContactLanesFromNearestPoint(centerX, centerY, centerZ, nearestX, nearestY, nearestZ, radius);
+
+	//Inside, out through the side or whichever cap is strictly closer, same tie rules as the scalar version
+	FloatLanes distanceToSide = LaneSub(cylinderRadiusLanes, distanceFromAxis);
+	FloatLanes distanceToTop = LaneAbs(LaneSub(centerZ, cylinderLengthLanes));
+	FloatLanes distanceToBottom = LaneAbs(centerZ);
+	MaskLanes isSideCloserThanTop = LaneLess(distanceToSide, distanceToTop);
+	MaskLanes isTopCloserThanSide = LaneLess(distanceToTop, distanceToSide);
+	MaskLanes isSide = LaneAnd(isSideCloserThanTop, LaneLess(distanceToSide, distanceToBottom));
+	MaskLanes isTop = LaneAnd(isTopCloserThanSide, LaneLess(distanceToTop, distanceToBottom));
+	MaskLanes isBottom = LaneOr(LaneAndNot(isSideCloserThanTop, isSide), LaneAndNot(isTopCloserThanSide, isTop));
+
+	FloatLanes insidePenetration = zero;
+	insidePenetration = LaneSelect(isSide, LaneAdd(distanceToSide, radius), insidePenetration);
+	insidePenetration = LaneSelect(isTop, LaneAdd(distanceToTop, radius), insidePenetration);
+	insidePenetration = LaneSelect(isBottom, LaneAdd(distanceToBottom, radius), insidePenetration);
+	FloatLanes insideNormalX = LaneSelect(isSide, LaneMul(centerX, inverseDistanceFromAxis), zero);
+	FloatLanes insideNormalY = LaneSelect(isSide, LaneMul(centerY, inverseDistanceFromAxis), zero);
+	FloatLanes insideNormalZ = LaneSelect(isTop, SplatLanes(1.0f), LaneSelect(isBottom, SplatLanes(-1.0f), zero));
+
+	contact.m_penetration = LaneSelect(isInside, insidePenetration, contact.m_penetration);
+	contact.m_normalX = LaneSelect(isInside, insideNormalX, contact.m_normalX);
+	contact.m_normalY = LaneSelect(isInside, insideNormalY, contact.m_normalY);
+	contact.m_normalZ = LaneSelect(isInside, insideNormalZ, contact.m_normalZ);
+	contact.m_isColliding = LaneOr(isInside, contact.m_isColliding);
+	return contact;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Moves centers into a frame with the given origin and basis, and rotates a local normal back out of it
+static inline void TransformLanesToLocal(FloatLanes& x, FloatLanes& y, FloatLanes& z, Vec3 const& origin, Vec3 const& iBasis, Vec3 const& jBasis, Vec3 const& kBasis)
+{
+	FloatLanes offsetX = LaneSub(x, SplatLanes(origin.x));
+	FloatLanes offsetY = LaneSub(y, SplatLanes(origin.y));
+	FloatLanes offsetZ = LaneSub(z, SplatLanes(origin.z));
+	x = LaneAdd(LaneAdd(LaneMul(offsetX, SplatLanes(iBasis.x)), LaneMul(offsetY, SplatLanes(iBasis.y))), LaneMul(offsetZ, SplatLanes(iBasis.z)));
+	y = LaneAdd(LaneAdd(LaneMul(offsetX, SplatLanes(jBasis.x)), LaneMul(offsetY, SplatLanes(jBasis.y))), LaneMul(offsetZ, SplatLanes(jBasis.z)));
+	z = LaneAdd(LaneAdd(LaneMul(offsetX, SplatLanes(kBasis.x)), LaneMul(offsetY, SplatLanes(kBasis.y))), LaneMul(offsetZ, SplatLanes(kBasis.z)));
+}
+
+//-----------------------------------------------------------------------------------------------
+static inline void TransformNormalLanesToWorld(ContactLanes& contact, Vec3 const& iBasis, Vec3 const& jBasis, Vec3 const& kBasis)
+{
+	FloatLanes localX = contact.m_normalX;
+	FloatLanes localY = contact.m_normalY;
+	FloatLanes localZ = contact.m_normalZ;
+	contact.m_normalX = LaneAdd(LaneAdd(LaneMul(localX, SplatLanes(iBasis.x)), LaneMul(localY, SplatLanes(jBasis.x))), LaneMul(localZ, SplatLanes(kBasis.x)));
+	contact.m_normalY = LaneAdd(LaneAdd(LaneMul(localX, SplatLanes(iBasis.y)), LaneMul(localY, SplatLanes(jBasis.y))), LaneMul(localZ, SplatLanes(kBasis.y)));
+	contact.m_normalZ = LaneAdd(LaneAdd(LaneMul(localX, SplatLanes(iBasis.z)), LaneMul(localY, SplatLanes(jBasis.z))), LaneMul(localZ, SplatLanes(kBasis.z)));
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetSpherePacketContactsVsSphere3D(SpherePacket3D const& spheres, Vec3 const& fixedSphereCenter, float fixedSphereRadius, ContactPacket3D& out_contacts)
+{
+	FloatLanes fixedCenterX = SplatLanes(fixedSphereCenter.x);
+	FloatLanes fixedCenterY = SplatLanes(fixedSphereCenter.y);
+	FloatLanes fixedCenterZ = SplatLanes(fixedSphereCenter.z);
+	FloatLanes fixedRadius = SplatLanes(fixedSphereRadius);
+	int collidingLanes = 0;
+	for (int laneIndex = 0; laneIndex < spheres.m_numSpheres; laneIndex += LANES_PER_STEP)
+	{
+		ContactLanes contact = GetSphereVsSphereContactLanes(LoadLanes(spheres.m_centerX + laneIndex), LoadLanes(spheres.m_centerY + laneIndex), LoadLanes(spheres.m_centerZ + laneIndex), 
+			LoadLanes(spheres.m_radius + laneIndex), fixedCenterX, fixedCenterY, fixedCenterZ, fixedRadius);
+		collidingLanes |= StoreContactLanes(out_contacts, laneIndex, contact);
+	}
+	return collidingLanes & GetActiveLanesMask(spheres.m_numSpheres);
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetSpherePacketContactsVsCapsule3D(SpherePacket3D const& spheres, Capsule3 const& capsule, ContactPacket3D& out_contacts)
+{
+	int collidingLanes = 0;
+	for (int laneIndex = 0; laneIndex < spheres.m_numSpheres; laneIndex += LANES_PER_STEP)
+	{
+		ContactLanes contact = GetSphereVsCapsuleContactLanes(LoadLanes(spheres.m_centerX + laneIndex), LoadLanes(spheres.m_centerY + laneIndex), LoadLanes(spheres.m_centerZ + laneIndex), 
+			LoadLanes(spheres.m_radius + laneIndex), capsule);
+		collidingLanes |= StoreContactLanes(out_contacts, laneIndex, contact);
+	}
+	return collidingLanes & GetActiveLanesMask(spheres.m_numSpheres);
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetSpherePacketContactsVsAABB3D(SpherePacket3D const& spheres, AABB3 const& aabb, ContactPacket3D& out_contacts)
+{
+	FloatLanes minX = SplatLanes(aabb.m_mins.x);
+	FloatLanes minY = SplatLanes(aabb.m_mins.y);
+	FloatLanes minZ = SplatLanes(aabb.m_mins.z);
+	FloatLanes maxX = SplatLanes(aabb.m_maxs.x);
+	FloatLanes maxY = SplatLanes(aabb.m_maxs.y);
+	FloatLanes maxZ = SplatLanes(aabb.m_maxs.z);
+	int collidingLanes = 0;
+	for (int laneIndex = 0; laneIndex < spheres.m_numSpheres; laneIndex += LANES_PER_STEP)
+	{
+		ContactLanes contact = GetSphereVsBoxContactLanes(LoadLanes(spheres.m_centerX + laneIndex), LoadLanes(spheres.m_centerY + laneIndex), LoadLanes(spheres.m_centerZ + laneIndex), 
+			LoadLanes(spheres.m_radius + laneIndex), minX, minY, minZ, maxX, maxY, maxZ);
+		collidingLanes |= StoreContactLanes(out_contacts, laneIndex, contact);
+	}
+	return collidingLanes & GetActiveLanesMask(spheres.m_numSpheres);
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetSpherePacketContactsVsOBB3D(SpherePacket3D const& spheres, OBB3 const& obb, ContactPacket3D& out_contacts)
+{
+	FloatLanes maxX = SplatLanes(obb.m_halfDimensions.x);
+	FloatLanes maxY = SplatLanes(obb.m_halfDimensions.y);
+	FloatLanes maxZ = SplatLanes(obb.m_halfDimensions.z);
+	FloatLanes minX = SplatLanes(-obb.m_halfDimensions.x);
+	FloatLanes minY = SplatLanes(-obb.m_halfDimensions.y);
+	FloatLanes minZ = SplatLanes(-obb.m_halfDimensions.z);
+	int collidingLanes = 0;
+	for (int laneIndex = 0; laneIndex < spheres.m_numSpheres; laneIndex += LANES_PER_STEP)
+	{
+		FloatLanes localX = LoadLanes(spheres.m_centerX + laneIndex);
+		FloatLanes localY = LoadLanes(spheres.m_centerY + laneIndex);
+		FloatLanes localZ = LoadLanes(spheres.m_centerZ + laneIndex);
+		TransformLanesToLocal(localX, localY, localZ, obb.m_center, obb.m_iBasisNormal, obb.m_jBasisNormal, obb.m_kBasisNormal);
+		ContactLanes contact = GetSphereVsBoxContactLanes(localX, localY, localZ, LoadLanes(spheres.m_radius + laneIndex), minX, minY, minZ, maxX, maxY, maxZ);
+		TransformNormalLanesToWorld(contact, obb.m_iBasisNormal, obb.m_jBasisNormal, obb.m_kBasisNormal);
+		collidingLanes |= StoreContactLanes(out_contacts, laneIndex, contact);
+	}
+	return collidingLanes & GetActiveLanesMask(spheres.m_numSpheres);
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetSpherePacketContactsVsCylinder3D(SpherePacket3D const& spheres, Cylinder3 const& cylinder, ContactPacket3D& out_contacts)
+{
+	float cylinderLength = (cylinder.m_end - cylinder.m_start).GetLength();
+	int collidingLanes = 0;
+	for (int laneIndex = 0; laneIndex < spheres.m_numSpheres; laneIndex += LANES_PER_STEP)
+	{
+		FloatLanes localX = LoadLanes(spheres.m_centerX + laneIndex);
+		FloatLanes localY = LoadLanes(spheres.m_centerY + laneIndex);
+		FloatLanes localZ = LoadLanes(spheres.m_centerZ + laneIndex);
+		TransformLanesToLocal(localX, localY, localZ, cylinder.m_start, cylinder.m_iBasis, cylinder.m_jBasis, cylinder.m_kBasis);
+		ContactLanes contact = GetSphereVsLocalCylinderContactLanes(localX, localY, localZ, LoadLanes(spheres.m_radius + laneIndex), cylinder.m_radius, cylinderLength);
+		TransformNormalLanesToWorld(contact, cylinder.m_iBasis, cylinder.m_jBasis, cylinder.m_kBasis);
+		collidingLanes |= StoreContactLanes(out_contacts, laneIndex, contact);
+	}
+	return collidingLanes & GetActiveLanesMask(spheres.m_numSpheres);
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetSphereContactsVsSpherePacket3D(Vec3 const& sphereCenter, float sphereRadius, SpherePacket3D const& fixedSpheres, ContactPacket3D& out_contacts)
+{
+	FloatLanes centerX = SplatLanes(sphereCenter.x);
+	FloatLanes centerY = SplatLanes(sphereCenter.y);
+	FloatLanes centerZ = SplatLanes(sphereCenter.z);
+	FloatLanes radius = SplatLanes(sphereRadius);
+	int collidingLanes = 0;
+	for (int laneIndex = 0; laneIndex < fixedSpheres.m_numSpheres; laneIndex += LANES_PER_STEP)
+	{
+		ContactLanes contact = GetSphereVsSphereContactLanes(centerX, centerY, centerZ, radius, LoadLanes(fixedSpheres.m_centerX + laneIndex), LoadLanes(fixedSpheres.m_centerY + laneIndex), 
+			LoadLanes(fixedSpheres.m_centerZ + laneIndex), LoadLanes(fixedSpheres.m_radius + laneIndex));
+		collidingLanes |= StoreContactLanes(out_contacts, laneIndex, contact);
+	}
+	return collidingLanes & GetActiveLanesMask(fixedSpheres.m_numSpheres);
+}
+
+//-----------------------------------------------------------------------------------------------
+int GetSphereContactsVsAABBPacket3D(Vec3 const& sphereCenter, float sphereRadius, AABBPacket3D const& fixedBoxes, ContactPacket3D& out_contacts)
+{
+	FloatLanes centerX = SplatLanes(sphereCenter.x);
+	FloatLanes centerY = SplatLanes(sphereCenter.y);
+	FloatLanes centerZ = SplatLanes(sphereCenter.z);
+	FloatLanes radius = SplatLanes(sphereRadius);
+	int collidingLanes = 0;
+	for (int laneIndex = 0; laneIndex < fixedBoxes.m_numBoxes; laneIndex += LANES_PER_STEP)
+	{
+		ContactLanes contact = GetSphereVsBoxContactLanes(centerX, centerY, centerZ, radius, LoadLanes(fixedBoxes.m_minX + laneIndex), LoadLanes(fixedBoxes.m_minY + laneIndex), 
+			LoadLanes(fixedBoxes.m_minZ + laneIndex), LoadLanes(fixedBoxes.m_maxX + laneIndex), LoadLanes(fixedBoxes.m_maxY + laneIndex), LoadLanes(fixedBoxes.m_maxZ + laneIndex));
+		collidingLanes |= StoreContactLanes(out_contacts, laneIndex, contact);
+	}
+	return collidingLanes & GetActiveLanesMask(fixedBoxes.m_numBoxes);
+}
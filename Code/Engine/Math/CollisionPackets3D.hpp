@@ -0,0 +1,72 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+
+struct AABB3;
+struct OBB3;
+struct Capsule3;
+struct Cylinder3;
+
+//-----------------------------------------------------------------------------------------------
+// Batched narrowphase for the sphere pushes in MathUtils: a packet of spheres against one fixed shape, or one sphere against
+// a packet of fixed shapes. Packets are stored a component at a time so eight lanes go through AVX2 in one step, or SSE in
+// two; builds without either run the same code one lane at a time. Each lane matches its scalar MathUtils push (within
+// float rounding), so the correction a lane reports is exactly what PushSphereOutOf...3D would have moved that sphere by.
+constexpr int COLLISION_PACKET_WIDTH = 8;
+
+//-----------------------------------------------------------------------------------------------
+struct SpherePacket3D
+{
+public:
+	alignas(32) float	m_centerX[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_centerY[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_centerZ[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_radius[COLLISION_PACKET_WIDTH] = {};
+	int					m_numSpheres = 0;		// lanes past this are never reported as colliding
+
+public:
+	void	SetSphere(int laneIndex, Vec3 const& center, float radius);
+	Vec3	GetCenter(int laneIndex) const;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct AABBPacket3D
+{
+public:
+	alignas(32) float	m_minX[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_minY[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_minZ[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_maxX[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_maxY[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_maxZ[COLLISION_PACKET_WIDTH] = {};
+	int					m_numBoxes = 0;
+
+public:
+	void	SetAABB(int laneIndex, AABB3 const& aabb);
+};
+
+//-----------------------------------------------------------------------------------------------
+// Per lane results, only meaningful for lanes set in the mask the query returned
+struct ContactPacket3D
+{
+public:
+	alignas(32) float	m_penetration[COLLISION_PACKET_WIDTH] = {};	// distance to move along the normal, can be 0 for spheres just touching
+	alignas(32) float	m_normalX[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_normalY[COLLISION_PACKET_WIDTH] = {};
+	alignas(32) float	m_normalZ[COLLISION_PACKET_WIDTH] = {};
+
+public:
+	Vec3	GetNormal(int laneIndex) const;
+	Vec3	GetCorrection(int laneIndex) const;
+};
+
+//-----------------------------------------------------------------------------------------------
+//Packet of spheres against one fixed shape, returns a bit per colliding lane
+int		GetSpherePacketContactsVsSphere3D(SpherePacket3D const& spheres, Vec3 const& fixedSphereCenter, float fixedSphereRadius, ContactPacket3D& out_contacts);
+int		GetSpherePacketContactsVsCapsule3D(SpherePacket3D const& spheres, Capsule3 const& capsule, ContactPacket3D& out_contacts);
+int		GetSpherePacketContactsVsAABB3D(SpherePacket3D const& spheres, AABB3 const& aabb, ContactPacket3D& out_contacts);
+int		GetSpherePacketContactsVsOBB3D(SpherePacket3D const& spheres, OBB3 const& obb, ContactPacket3D& out_contacts);
+int		GetSpherePacketContactsVsCylinder3D(SpherePacket3D const& spheres, Cylinder3 const& cylinder, ContactPacket3D& out_contacts);
+
+//One sphere against a packet of fixed shapes, the contacts are all for the one sphere
+int		GetSphereContactsVsSpherePacket3D(Vec3 const& sphereCenter, float sphereRadius, SpherePacket3D const& fixedSpheres, ContactPacket3D& out_contacts);
+int		GetSphereContactsVsAABBPacket3D(Vec3 const& sphereCenter, float sphereRadius, AABBPacket3D const& fixedBoxes, ContactPacket3D& out_contacts);
@@ -7,21 +7,21 @@
 #include "Engine/Core/DebugRender.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Core/Profiler.hpp"
 #include <algorithm>
 
-
-//-----------------------------------------------------------------------------------------------
-int	g_maxDebugAmount = INT_MAX;
-
 //-----------------------------------------------------------------------------------------------
 ConvexHull3D::ConvexHull3D(std::vector<Vec3>& points, bool isDebug)
-	:m_pointsToPartition(points)
+	:m_points(points)
 {
+	PROFILE_SCOPE("ConvexHull3D::ConvexHull3D");
 	//float startTime = float(GetCurrentTimeSeconds());
 
 	GenerateQuickhullInitialTetrahedron();
 	if (isDebug)
 	{
+		BuildBoundingPolysFromFaces(false);
+		m_pointsToPartition = m_points;
 		return;
 	}
 	IterativeQuickullGeneration();
@@ -50,517 +50,613 @@ bool ConvexHull3D::IsPointInside(Vec3 const& point)
 void ConvexHull3D::GenerateQuickhullInitialTetrahedron()
 {
 	//QUICKHULL 3D ALGORITHM
+	if (m_points.size() < 4)
+	{
+		return;
+	}
+
 	//Find Extreme Points
-	float positiveZValue = -100000000000.0f;
-	float positiveXValue = -100000000000.0f;
-	float positiveYValue = -100000000000.0f;
-	float negativeZValue = FLT_MAX;
-	float negativeXValue = FLT_MAX;
-	float negativeYValue = FLT_MAX;
-	Vec3 positiveZVert;
-	Vec3 positiveXVert;
-	Vec3 positiveYVert;
-	Vec3 negativeZVert;
-	Vec3 negativeXVert;
-	Vec3 negativeYVert;
-	for (int pointIndex = 0; pointIndex < m_pointsToPartition.size(); pointIndex++)
+	int extremePointIndices[6] = { 0, 0, 0, 0, 0, 0 };
+	for (int pointIndex = 1; pointIndex < m_points.size(); pointIndex++)
 	{
-		if (m_pointsToPartition[pointIndex].z > positiveZValue)
-		{
-			positiveZValue = m_pointsToPartition[pointIndex].z;
-			positiveZVert = m_pointsToPartition[pointIndex];
-		}
-		if (m_pointsToPartition[pointIndex].y > positiveYValue)
-		{
-			positiveYValue = m_pointsToPartition[pointIndex].y;
-			positiveYVert = m_pointsToPartition[pointIndex];
-		}
-		if (m_pointsToPartition[pointIndex].x > positiveXValue)
-		{
-			positiveXValue = m_pointsToPartition[pointIndex].x;
-			positiveXVert = m_pointsToPartition[pointIndex];
-		}
-		if (m_pointsToPartition[pointIndex].z < negativeZValue)
-		{
-			negativeZValue = m_pointsToPartition[pointIndex].z;
-			negativeZVert = m_pointsToPartition[pointIndex];
-		}
-		if (m_pointsToPartition[pointIndex].y < negativeYValue)
-		{
-			negativeYValue = m_pointsToPartition[pointIndex].y;
-			negativeYVert = m_pointsToPartition[pointIndex];
-		}
-		if (m_pointsToPartition[pointIndex].x < negativeXValue)
-		{
-			negativeXValue = m_pointsToPartition[pointIndex].x;
-			negativeXVert = m_pointsToPartition[pointIndex];
-		}
+		Vec3 const& point = m_points[pointIndex];
+		if (point.z > m_points[extremePointIndices[0]].z)
+			extremePointIndices[0] = pointIndex;
+		if (point.y > m_points[extremePointIndices[1]].y)
+			extremePointIndices[1] = pointIndex;
+		if (point.x > m_points[extremePointIndices[2]].x)
+			extremePointIndices[2] = pointIndex;
+		if (point.z < m_points[extremePointIndices[3]].z)
+			extremePointIndices[3] = pointIndex;
+		if (point.y < m_points[extremePointIndices[4]].y)
+			extremePointIndices[4] = pointIndex;
+		if (point.x < m_points[extremePointIndices[5]].x)
+			extremePointIndices[5] = pointIndex;
 	}
-	std::vector<Vec3> maxPoints;
-	maxPoints.push_back(positiveZVert);
-	maxPoints.push_back(positiveYVert);
-	maxPoints.push_back(positiveXVert);
-	maxPoints.push_back(negativeZVert);
-	maxPoints.push_back(negativeYVert);
-	maxPoints.push_back(negativeXVert);
 
 	//Set epsilon
-	float maxX = 0.0f;
-	float maxY = 0.0f;
-	float maxZ = 0.0f;
-	if (fabsf(positiveXValue) > fabsf(negativeXValue))
-		maxX = positiveXValue;
-	else
-		maxX = fabsf(negativeXValue);
-	if (fabsf(positiveYValue) > fabsf(negativeYValue))
-		maxY = positiveYValue;
-	else
-		maxY = fabsf(negativeYValue);
-	if (fabsf(positiveZValue) > fabsf(negativeZValue))
-		maxZ = positiveZValue;
-	else
-		maxZ = fabsf(negativeZValue);
-	m_epsilon = 3.0f * (maxX + maxY + maxZ) * FLT_EPSILON;
+	CalculateNewEpsilon(m_points);
 
 	//Generate Initial Line Segment (From Furthest Points)
-	float maxDist = -100000000000.0f;
-	LineSegment3 maxDistLine;
-	Vec3 p1;
-	Vec3 p2;
-	for (int pointIndexA = 0; pointIndexA < maxPoints.size(); pointIndexA++)
+	float maxDist = -1.0f;
+	int p1 = -1;
+	int p2 = -1;
+	for (int indexA = 0; indexA < 6; indexA++)
 	{
-		Vec3& pointA = maxPoints[pointIndexA];
-		for (int pointIndexB = 0; pointIndexB < maxPoints.size(); pointIndexB++)
+		for (int indexB = indexA + 1; indexB < 6; indexB++)
 		{
-			Vec3& pointB = maxPoints[pointIndexB];
-			if (pointB != pointA)
+			float currentDist = GetDistanceSquared3D(m_points[extremePointIndices[indexA]], m_points[extremePointIndices[indexB]]);
+			if (currentDist > maxDist)
 			{
-				float currentDist = GetDistanceSquared3D(pointA, pointB);
-				if (currentDist > maxDist)
-				{
-					maxDist = currentDist;
-					maxDistLine.m_start = pointA;
-					maxDistLine.m_end = pointB;
-					p1 = maxPoints[pointIndexA];
-					p2 = maxPoints[pointIndexB];
-				}
+				maxDist = currentDist;
+				p1 = extremePointIndices[indexA];
+				p2 = extremePointIndices[indexB];
 			}
 		}
 	}
+	if (maxDist <= m_epsilon * m_epsilon)
+	{
+		return;
+	}
 
 	//Generate Initial Triangle
-	maxDist = -100000000000.0f;
-	Vec3 p3;
-	for (int pointIndex = 0; pointIndex < m_pointsToPartition.size(); pointIndex++)
+	maxDist = -1.0f;
+	int p3 = -1;
+	Vec3 lineDirection = (m_points[p2] - m_points[p1]).GetNormalized();
+	for (int pointIndex = 0; pointIndex < m_points.size(); pointIndex++)
 	{
-		Vec3& point = m_pointsToPartition[pointIndex];
-		float currentDist = GetDistanceToLineSegmentSquared3D(point, maxDistLine);
+		float currentDist = CrossProduct3D(m_points[pointIndex] - m_points[p1], lineDirection).GetLengthSquared();
 		if (currentDist > maxDist)
 		{
 			maxDist = currentDist;
-			p3 = m_pointsToPartition[pointIndex];
+			p3 = pointIndex;
 		}
 	}
-	ConvexPoly3D initialPoly;
-	initialPoly.m_ccwOrderedPoints.push_back(maxDistLine.m_start);
-	initialPoly.m_ccwOrderedPoints.push_back(maxDistLine.m_end);
-	initialPoly.m_ccwOrderedPoints.push_back(p3);
-	m_boundingPolys.push_back(initialPoly);
+	if (maxDist <= m_epsilon * m_epsilon)
+	{
+		return;
+	}
 
 	//Generate Initial Tetrahedron
-	maxDist = -100000000000.0f;
-	Vec3 p4;
-	Vec3 normal = CrossProduct3D((p3 - maxDistLine.m_end), (maxDistLine.m_start - maxDistLine.m_end)).GetNormalized();
-	Plane3D initialPlane(normal, DotProduct3D(maxDistLine.m_start, normal));
-	for (int pointIndex = 0; pointIndex < m_pointsToPartition.size(); pointIndex++)
+	maxDist = -1.0f;
+	int p4 = -1;
+	Vec3 normal = CrossProduct3D(m_points[p2] - m_points[p1], m_points[p3] - m_points[p1]).GetNormalized();
+	float distanceFromOrigin = DotProduct3D(m_points[p1], normal);
+	for (int pointIndex = 0; pointIndex < m_points.size(); pointIndex++)
 	{
-		Vec3& point = m_pointsToPartition[pointIndex];
-		float currentDist = fabsf(DotProduct3D(point, normal) - initialPlane.m_distanceFromOrigin);
+		float currentDist = fabsf(DotProduct3D(m_points[pointIndex], normal) - distanceFromOrigin);
 		if (currentDist > maxDist)
 		{
 			maxDist = currentDist;
-			p4 = m_pointsToPartition[pointIndex];
-		}
-	}
-
-	//Reorder the ConvexPoly and Plane Based on Max Point
-	if (DotProduct3D(p4, normal) - initialPlane.m_distanceFromOrigin > 0.0f)
-	{
-		Vec3 tempPoint = initialPoly.m_ccwOrderedPoints[1];
-		initialPoly.m_ccwOrderedPoints[1] = initialPoly.m_ccwOrderedPoints[2];
-		initialPoly.m_ccwOrderedPoints[2] = tempPoint;
-		m_boundingPolys[0] = initialPoly;
-		initialPlane.m_normal *= -1.0f;
-		initialPlane.m_distanceFromOrigin *= -1.0f;
-	}
-
-	//Add Convex Polys and Planes
-	ConvexPoly3D poly2;
-	poly2.m_ccwOrderedPoints.push_back(initialPoly.m_ccwOrderedPoints[1]);
-	poly2.m_ccwOrderedPoints.push_back(initialPoly.m_ccwOrderedPoints[0]);
-	poly2.m_ccwOrderedPoints.push_back(p4);
-	m_boundingPolys.push_back(poly2);
-	ConvexPoly3D poly3;
-	poly3.m_ccwOrderedPoints.push_back(p4);
-	poly3.m_ccwOrderedPoints.push_back(initialPoly.m_ccwOrderedPoints[0]);
-	poly3.m_ccwOrderedPoints.push_back(initialPoly.m_ccwOrderedPoints[2]);
-	m_boundingPolys.push_back(poly3);
-	ConvexPoly3D poly4;
-	poly4.m_ccwOrderedPoints.push_back(initialPoly.m_ccwOrderedPoints[2]);
-	poly4.m_ccwOrderedPoints.push_back(initialPoly.m_ccwOrderedPoints[1]);
-	poly4.m_ccwOrderedPoints.push_back(p4);
-	m_boundingPolys.push_back(poly4);
-	m_boundingPlanes.push_back(initialPlane);
-	normal = CrossProduct3D((poly2.m_ccwOrderedPoints[2] - poly2.m_ccwOrderedPoints[1]), (poly2.m_ccwOrderedPoints[0] - poly2.m_ccwOrderedPoints[1])).GetNormalized();
-	m_boundingPlanes.push_back(Plane3D(normal, DotProduct3D(poly2.m_ccwOrderedPoints[2], normal)));
-	normal = CrossProduct3D((poly3.m_ccwOrderedPoints[2] - poly3.m_ccwOrderedPoints[1]), (poly3.m_ccwOrderedPoints[0] - poly3.m_ccwOrderedPoints[1])).GetNormalized();
-	m_boundingPlanes.push_back(Plane3D(normal, DotProduct3D(poly3.m_ccwOrderedPoints[2], normal)));
-	normal = CrossProduct3D((poly4.m_ccwOrderedPoints[2] - poly4.m_ccwOrderedPoints[1]), (poly4.m_ccwOrderedPoints[0] - poly4.m_ccwOrderedPoints[1])).GetNormalized();
-	m_boundingPlanes.push_back(Plane3D(normal, DotProduct3D(poly4.m_ccwOrderedPoints[2], normal)));
-	m_conflictLists.resize(4);
-
-	//Remove all inside m_pointsToPartition and maxPoints
-	for (int pointIndex = 0; pointIndex < m_pointsToPartition.size(); pointIndex++)
+			p4 = pointIndex;
+		}
+	}
+	if (maxDist <= m_epsilon)
 	{
-		Vec3& currentPoint = m_pointsToPartition[pointIndex];
-		if (currentPoint == p1 || currentPoint == p2 || currentPoint == p3 || currentPoint == p4)
+		return;
+	}
+
+	//Reorder the base triangle so it faces away from the apex
+	if (DotProduct3D(m_points[p4], normal) - distanceFromOrigin > 0.0f)
+	{
+		int tempIndex = p2;
+		p2 = p3;
+		p3 = tempIndex;
+	}
+
+	m_halfEdges.clear();
+	m_faces.clear();
+	m_facesToProcess.clear();
+	int face1 = AddQuickhullFace(p1, p2, p3);
+	int face2 = AddQuickhullFace(p2, p1, p4);
+	int face3 = AddQuickhullFace(p3, p2, p4);
+	int face4 = AddQuickhullFace(p1, p3, p4);
+
+	//Stitch the twins of the tetrahedron, each face has edges origin->next in creation order
+	for (int edgeIndexA = 0; edgeIndexA < m_halfEdges.size(); edgeIndexA++)
+	{
+		QuickhullHalfEdge& edgeA = m_halfEdges[edgeIndexA];
+		int endA = m_halfEdges[edgeA.m_nextEdgeIndex].m_originPointIndex;
+		for (int edgeIndexB = edgeIndexA + 1; edgeIndexB < m_halfEdges.size(); edgeIndexB++)
 		{
-			m_pointsToPartition.erase(m_pointsToPartition.begin() + pointIndex);
-			pointIndex--;
-			continue;
+			QuickhullHalfEdge& edgeB = m_halfEdges[edgeIndexB];
+			int endB = m_halfEdges[edgeB.m_nextEdgeIndex].m_originPointIndex;
+			if (edgeA.m_originPointIndex == endB && endA == edgeB.m_originPointIndex)
+			{
+				LinkTwinEdges(edgeIndexA, edgeIndexB);
+			}
 		}
+	}
 
-		if (IsPointInside(currentPoint))
+	//Initial Partitioning of Points and Faces
+	std::vector<int> tetrahedronFaces = { face1, face2, face3, face4 };
+	for (int pointIndex = 0; pointIndex < m_points.size(); pointIndex++)
+	{
+		if (pointIndex == p1 || pointIndex == p2 || pointIndex == p3 || pointIndex == p4)
 		{
-			m_pointsToPartition.erase(m_pointsToPartition.begin() + pointIndex);
-			pointIndex--;
 			continue;
 		}
+
+		AssignConflictPoint(pointIndex, tetrahedronFaces);
 	}
 
-	//Initial Partitioning of Points and Faces
-	for (int pointIndex = 0; pointIndex < m_pointsToPartition.size(); pointIndex++)
+	for (int faceIndex = 0; faceIndex < tetrahedronFaces.size(); faceIndex++)
+	{
+		if (!m_faces[tetrahedronFaces[faceIndex]].m_conflictPointIndices.empty())
+		{
+			m_facesToProcess.push_back(tetrahedronFaces[faceIndex]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void ConvexHull3D::GenerateTetrahedron(Vec3 const& pointA, Vec3 const& pointB, Vec3 const& pointC, Vec3 const& pointD)
+{
+	m_points.clear();
+	m_points.push_back(pointA);
+	m_points.push_back(pointB);
+	m_points.push_back(pointC);
+	m_points.push_back(pointD);
+	CalculateNewEpsilon(m_points);
+
+	int p2 = 1;
+	int p3 = 2;
+	Vec3 normal = CrossProduct3D(pointB - pointA, pointC - pointA);
+	if (DotProduct3D(pointD - pointA, normal) > 0.0f)
 	{
-		Vec3& point = m_pointsToPartition[pointIndex];
-		float minDist = FLT_MAX;
-		int closestPlaneIndex = -1;
-		for (int planeIndex = 0; planeIndex < m_boundingPlanes.size(); planeIndex++)
+		p2 = 2;
+		p3 = 1;
+	}
+
+	m_halfEdges.clear();
+	m_faces.clear();
+	m_facesToProcess.clear();
+	AddQuickhullFace(0, p2, p3);
+	AddQuickhullFace(p2, 0, 3);
+	AddQuickhullFace(p3, p2, 3);
+	AddQuickhullFace(0, p3, 3);
+	for (int edgeIndexA = 0; edgeIndexA < m_halfEdges.size(); edgeIndexA++)
+	{
+		int endA = m_halfEdges[m_halfEdges[edgeIndexA].m_nextEdgeIndex].m_originPointIndex;
+		for (int edgeIndexB = edgeIndexA + 1; edgeIndexB < m_halfEdges.size(); edgeIndexB++)
 		{
-			Plane3D& plane = m_boundingPlanes[planeIndex];
-			float altitude = DotProduct3D(point, plane.m_normal) - plane.m_distanceFromOrigin;
-			if (altitude < minDist && altitude > 0.0f)
+			int endB = m_halfEdges[m_halfEdges[edgeIndexB].m_nextEdgeIndex].m_originPointIndex;
+			if (m_halfEdges[edgeIndexA].m_originPointIndex == endB && endA == m_halfEdges[edgeIndexB].m_originPointIndex)
 			{
-				minDist = altitude;
-				closestPlaneIndex = planeIndex;
+				LinkTwinEdges(edgeIndexA, edgeIndexB);
 			}
 		}
-
-		m_conflictLists[closestPlaneIndex].push_back(Vec2(float(pointIndex), minDist));
 	}
-}
 
+	BuildBoundingPolysFromFaces(true);
+}
 
 //-----------------------------------------------------------------------------------------------
 void ConvexHull3D::IterativeQuickullGeneration(bool isCoplanarAllowed, bool isDebug)
 {
 	//Iterative Loop
-	Vec3 normal;
-	while (true)
+	while (!m_facesToProcess.empty())
 	{
-		float maxDist = -100000000000.0f;
-		int maxPointIndex = -1;
-		int maxPlaneIndex = -1;
-		for (int planeIndex = 0; planeIndex < m_conflictLists.size(); planeIndex++)
+		//Any face with outside points can be expanded next, its furthest point is tracked as points are assigned
+		int eyeFaceIndex = m_facesToProcess.back();
+		m_facesToProcess.pop_back();
+		QuickhullFace& eyeFace = m_faces[eyeFaceIndex];
+		if (eyeFace.m_isDeleted || eyeFace.m_conflictPointIndices.empty())
 		{
-			for (int pointIndex = 0; pointIndex < m_conflictLists[planeIndex].size(); pointIndex++)
-			{
-				float currentDist = m_conflictLists[planeIndex][pointIndex].y;
-				if (currentDist > maxDist)
-				{
-					maxDist = currentDist;
-					maxPointIndex = int(m_conflictLists[planeIndex][pointIndex].x);
-					maxPlaneIndex = planeIndex;
-				}
-			}
+			continue;
 		}
 
-		//Early out check (tetrahedron case)
-		if (maxPlaneIndex == -1)
+		AddPointToQuickhull(eyeFace.m_furthestConflictPointIndex, eyeFaceIndex);
+
+		//NEED TO CLEAN THE DEBUG FACTOR UP TO BE MORE GAME SIDE INSTEAD OF ENGINE
+		if (isDebug)
 		{
 			break;
 		}
+	}
+
+	BuildBoundingPolysFromFaces(isCoplanarAllowed);
 
-		//Find all visible planes
-		std::vector<int> visiblePlaneIndicies;
-		std::vector<LineSegment3> horizonEdges;
-		visiblePlaneIndicies.push_back(maxPlaneIndex);
-		for (int pointIndex = 0; pointIndex < m_boundingPolys[maxPlaneIndex].m_ccwOrderedPoints.size(); pointIndex++)
+	m_pointsToPartition.clear();
+	for (int faceIndex = 0; faceIndex < m_faces.size(); faceIndex++)
+	{
+		QuickhullFace const& face = m_faces[faceIndex];
+		if (face.m_isDeleted)
 		{
-			if (pointIndex != m_boundingPolys[maxPlaneIndex].m_ccwOrderedPoints.size() - 1)
-				horizonEdges.push_back(LineSegment3(m_boundingPolys[maxPlaneIndex].m_ccwOrderedPoints[pointIndex], m_boundingPolys[maxPlaneIndex].m_ccwOrderedPoints[pointIndex + 1]));
-			else
-				horizonEdges.push_back(LineSegment3(m_boundingPolys[maxPlaneIndex].m_ccwOrderedPoints[pointIndex], m_boundingPolys[maxPlaneIndex].m_ccwOrderedPoints[0]));
+			continue;
 		}
-
-		for (int planeIndex = 0; planeIndex < m_boundingPlanes.size(); planeIndex++)
+		for (int conflictIndex = 0; conflictIndex < face.m_conflictPointIndices.size(); conflictIndex++)
 		{
-			if (planeIndex == maxPlaneIndex)
-			{
-				continue;
-			}
-
-			Plane3D& plane = m_boundingPlanes[planeIndex];
-			float altitude = DotProduct3D(m_pointsToPartition[maxPointIndex], plane.m_normal) - plane.m_distanceFromOrigin;
-			if (altitude > 0.0f)
-			{
-				visiblePlaneIndicies.push_back(planeIndex);
+			m_pointsToPartition.push_back(m_points[face.m_conflictPointIndices[conflictIndex]]);
+		}
+	}
+}
 
-				std::vector<LineSegment3> lines;
-				std::vector<bool> shouldAddLines;
-				for (int pointIndex = 0; pointIndex < m_boundingPolys[planeIndex].m_ccwOrderedPoints.size(); pointIndex++)
-				{
-					if (pointIndex != m_boundingPolys[planeIndex].m_ccwOrderedPoints.size() - 1)
-					{
-						lines.push_back(LineSegment3(m_boundingPolys[planeIndex].m_ccwOrderedPoints[pointIndex], m_boundingPolys[planeIndex].m_ccwOrderedPoints[pointIndex + 1]));
-					}
-					else
-					{
-						lines.push_back(LineSegment3(m_boundingPolys[planeIndex].m_ccwOrderedPoints[pointIndex], m_boundingPolys[planeIndex].m_ccwOrderedPoints[0]));
-					}
-					
-					shouldAddLines.push_back(true);
-				}
+//-----------------------------------------------------------------------------------------------
+bool ConvexHull3D::AddPointToHull(Vec3 const& point, bool isCoplanarAllowed)
+{
+	if (m_faces.empty())
+	{
+		return false;
+	}
 
-				//Manage all horizon edges
-				for (int edgeIndex = 0; edgeIndex < horizonEdges.size(); edgeIndex++)
-				{
-					for (int lineIndex = 0; lineIndex < lines.size(); lineIndex++)
-					{
-						if (lines[lineIndex] == horizonEdges[edgeIndex])
-						{
-							horizonEdges.erase(horizonEdges.begin() + edgeIndex);
-							edgeIndex--;
-							shouldAddLines[lineIndex] = false;
-							break;
-						}
-					}
-				}
-				for (int lineIndex = 0; lineIndex < lines.size(); lineIndex++)
-				{
-					if (shouldAddLines[lineIndex])
-					{
-						horizonEdges.push_back(lines[lineIndex]);
-					}
-				}
-			}
+	//Expand from the face that sees the point the most
+	int eyeFaceIndex = -1;
+	float maxAltitude = m_epsilon;
+	for (int faceIndex = 0; faceIndex < m_faces.size(); faceIndex++)
+	{
+		QuickhullFace const& face = m_faces[faceIndex];
+		if (face.m_isDeleted)
+		{
+			continue;
 		}
 
-		//Create New Faces From Horizon Edges
-		for (int edgeIndex = 0; edgeIndex < horizonEdges.size(); edgeIndex++)
+		float altitude = DotProduct3D(point, face.m_plane.m_normal) - face.m_plane.m_distanceFromOrigin;
+		if (altitude > maxAltitude)
 		{
-			//Add Polygon
-			ConvexPoly3D newPoly;
-			newPoly.m_ccwOrderedPoints.push_back(horizonEdges[edgeIndex].m_start);
-			newPoly.m_ccwOrderedPoints.push_back(horizonEdges[edgeIndex].m_end);
-			newPoly.m_ccwOrderedPoints.push_back(m_pointsToPartition[maxPointIndex]);
-			
-			//Add Plane
-			normal = CrossProduct3D((newPoly.m_ccwOrderedPoints[2] - newPoly.m_ccwOrderedPoints[1]), (newPoly.m_ccwOrderedPoints[0] - newPoly.m_ccwOrderedPoints[1]));
-			if (normal == Vec3() || (fabsf(normal.x) < m_epsilon && fabsf(normal.y) < m_epsilon && fabsf(normal.z) < m_epsilon))
-			{
-				continue;
-			}
-			normal = normal.GetNormalized();
-			float distanceToOrigin = DotProduct3D(newPoly.m_ccwOrderedPoints[2], normal);
-			std::vector<Vec2> newList;
+			maxAltitude = altitude;
+			eyeFaceIndex = faceIndex;
+		}
+	}
+
+	if (eyeFaceIndex == -1)
+	{
+		return false;
+	}
 
-			//OLD CODE NO COPLANAR REMOVAL
-			if (isCoplanarAllowed)
+	m_points.push_back(point);
+	AddPointToQuickhull(int(m_points.size()) - 1, eyeFaceIndex);
+	BuildBoundingPolysFromFaces(isCoplanarAllowed);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ConvexHull3D::SetBoundingPointsAndEdges()
+{
+	m_boundingPoints.clear();
+	m_boundingEdges.clear();
+
+	//Points and edges are shared between polys, so dedupe them by point index
+	std::vector<bool> isPointOnHull(m_points.size(), false);
+	std::vector<std::pair<int, int>> edgePointIndices;
+	for (int polyIndex = 0; polyIndex < m_boundingPolyPointIndices.size(); polyIndex++)
+	{
+		std::vector<int> const& polyPointIndices = m_boundingPolyPointIndices[polyIndex];
+		for (int pointIndex = 0; pointIndex < polyPointIndices.size(); pointIndex++)
+		{
+			int startIndex = polyPointIndices[pointIndex];
+			int endIndex = polyPointIndices[(pointIndex + 1) % polyPointIndices.size()];
+			if (!isPointOnHull[startIndex])
 			{
-				m_conflictLists.push_back(newList);
-				m_boundingPlanes.push_back(Plane3D(normal, DotProduct3D(newPoly.m_ccwOrderedPoints[2], normal)));
-				m_boundingPolys.push_back(newPoly);
-				continue;
+				isPointOnHull[startIndex] = true;
+				m_boundingPoints.push_back(m_points[startIndex]);
 			}
+			edgePointIndices.push_back(std::pair<int, int>(std::min(startIndex, endIndex), std::max(startIndex, endIndex)));
+		}
+	}
 
-			//Coplanar Removal
-			//Check For Coplanar Planes
-			bool addNewPlane = true;
-			for (int planeIndex = 0; planeIndex < m_boundingPlanes.size(); planeIndex++)
-			{
-				bool isCoPlanar = true;
-				for (int pointIndex = 0; pointIndex < m_boundingPolys[planeIndex].m_ccwOrderedPoints.size(); pointIndex++)
-				{
-					float altitude = DotProduct3D(m_boundingPolys[planeIndex].m_ccwOrderedPoints[pointIndex], normal) - distanceToOrigin;
-					if (altitude > m_epsilon || altitude < -m_epsilon)
-					{
-						isCoPlanar = false;
-						break;
-					}
-				}
+	std::sort(edgePointIndices.begin(), edgePointIndices.end());
+	edgePointIndices.erase(std::unique(edgePointIndices.begin(), edgePointIndices.end()), edgePointIndices.end());
+	m_boundingEdges.reserve(edgePointIndices.size());
+	for (int edgeIndex = 0; edgeIndex < edgePointIndices.size(); edgeIndex++)
+	{
+		m_boundingEdges.push_back(LineSegment3(m_points[edgePointIndices[edgeIndex].first], m_points[edgePointIndices[edgeIndex].second]));
+	}
+}
 
-				if (isCoPlanar)
-				{
-					if (m_debugCounter == g_maxDebugAmount)
-					{
-						DebugAddWorldConvexPoly3D(newPoly, 100.0f, Rgba8::MEDIUM_GREEN, Rgba8::MEDIUM_GREEN);
-					}
-					//Add Point to Existing Convex Polygon
-					m_boundingPolys[planeIndex].AddPoint(m_pointsToPartition[maxPointIndex], m_epsilon);
-					if (m_debugCounter == g_maxDebugAmount)
-					{
-						DebugAddWorldConvexPoly3D(m_boundingPolys[planeIndex], 100.0f, Rgba8::ORANGE, Rgba8::ORANGE);
-					}
-					//Get new normal
-					normal = CrossProduct3D((m_boundingPolys[planeIndex].m_ccwOrderedPoints[2] - m_boundingPolys[planeIndex].m_ccwOrderedPoints[1]),
-						(m_boundingPolys[planeIndex].m_ccwOrderedPoints[0] - m_boundingPolys[planeIndex].m_ccwOrderedPoints[1])).GetNormalized();
-					if (normal == Vec3())
-					{
-						m_boundingPolys[planeIndex].m_ccwOrderedPoints.erase(m_boundingPolys[planeIndex].m_ccwOrderedPoints.begin() + 1);
-						normal = CrossProduct3D((m_boundingPolys[planeIndex].m_ccwOrderedPoints[2] - m_boundingPolys[planeIndex].m_ccwOrderedPoints[1]),
-							(m_boundingPolys[planeIndex].m_ccwOrderedPoints[0] - m_boundingPolys[planeIndex].m_ccwOrderedPoints[1])).GetNormalized();
-					}
-					m_boundingPlanes[planeIndex] = (Plane3D(normal, DotProduct3D(m_boundingPolys[planeIndex].m_ccwOrderedPoints[2], normal)));
+//-----------------------------------------------------------------------------------------------
+int ConvexHull3D::AddQuickhullFace(int pointIndexA, int pointIndexB, int pointIndexC)
+{
+	int faceIndex = int(m_faces.size());
+	int firstEdgeIndex = int(m_halfEdges.size());
+	int pointIndices[3] = { pointIndexA, pointIndexB, pointIndexC };
+	for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+	{
+		QuickhullHalfEdge edge;
+		edge.m_originPointIndex = pointIndices[cornerIndex];
+		edge.m_faceIndex = faceIndex;
+		edge.m_nextEdgeIndex = firstEdgeIndex + (cornerIndex + 1) % 3;
+		edge.m_previousEdgeIndex = firstEdgeIndex + (cornerIndex + 2) % 3;
+		m_halfEdges.push_back(edge);
+	}
 
-					//Erase old visible plane from the list
-					for (int visPlaneIndex = 0; visPlaneIndex < visiblePlaneIndicies.size(); visPlaneIndex++)
-					{
-						if (planeIndex == visiblePlaneIndicies[visPlaneIndex])
-						{
-							visiblePlaneIndicies.erase(visiblePlaneIndicies.begin() + visPlaneIndex);
-						}
-					}
+	QuickhullFace face;
+	face.m_edgeIndex = firstEdgeIndex;
+	Vec3 const& pointA = m_points[pointIndexA];
+	Vec3 normal = CrossProduct3D(m_points[pointIndexB] - pointA, m_points[pointIndexC] - pointA).GetNormalized();
+	Vec3 centroid = (pointA + m_points[pointIndexB] + m_points[pointIndexC]) / 3.0f;
+	face.m_plane = Plane3D(normal, DotProduct3D(centroid, normal));
+	m_faces.push_back(face);
+	return faceIndex;
+}
 
-					addNewPlane = false;
-				}
-			}
+//-----------------------------------------------------------------------------------------------
+void ConvexHull3D::LinkTwinEdges(int edgeIndexA, int edgeIndexB)
+{
+	m_halfEdges[edgeIndexA].m_twinEdgeIndex = edgeIndexB;
+	m_halfEdges[edgeIndexB].m_twinEdgeIndex = edgeIndexA;
+}
 
-			if (addNewPlane)
-			{
-				m_conflictLists.push_back(newList);
-				m_boundingPlanes.push_back(Plane3D(normal, DotProduct3D(newPoly.m_ccwOrderedPoints[2], normal)));
-				m_boundingPolys.push_back(newPoly);
-			}
-		}
-		
-		//Remove old planes and polys
-		std::sort(visiblePlaneIndicies.begin(), visiblePlaneIndicies.end(), std::greater<>());
-		for (int planeIndex = 0; planeIndex < visiblePlaneIndicies.size(); planeIndex++)
+//-----------------------------------------------------------------------------------------------
+void ConvexHull3D::AssignConflictPoint(int pointIndex, std::vector<int> const& candidateFaceIndices)
+{
+	Vec3 const& point = m_points[pointIndex];
+	float maxAltitude = m_epsilon;
+	int bestFaceIndex = -1;
+	for (int candidateIndex = 0; candidateIndex < candidateFaceIndices.size(); candidateIndex++)
+	{
+		Plane3D const& plane = m_faces[candidateFaceIndices[candidateIndex]].m_plane;
+		float altitude = DotProduct3D(point, plane.m_normal) - plane.m_distanceFromOrigin;
+		if (altitude > maxAltitude)
 		{
-			m_boundingPlanes.erase(m_boundingPlanes.begin() + visiblePlaneIndicies[planeIndex]);
-			m_boundingPolys.erase(m_boundingPolys.begin() + visiblePlaneIndicies[planeIndex]);
-			m_conflictLists.erase(m_conflictLists.begin() + visiblePlaneIndicies[planeIndex]);
+			maxAltitude = altitude;
+			bestFaceIndex = candidateFaceIndices[candidateIndex];
 		}
+	}
 
-		//Remove old Points
-		m_pointsToPartition.erase(m_pointsToPartition.begin() + maxPointIndex);
-		for (int pointIndex = 0; pointIndex < m_pointsToPartition.size(); pointIndex++)
+	//Not outside any of the faces, so the point is inside the hull and is dropped for good
+	if (bestFaceIndex == -1)
+	{
+		return;
+	}
+
+	QuickhullFace& face = m_faces[bestFaceIndex];
+	face.m_conflictPointIndices.push_back(pointIndex);
+	if (face.m_furthestConflictPointIndex == -1 || maxAltitude > face.m_furthestConflictDistance)
+	{
+		face.m_furthestConflictPointIndex = pointIndex;
+		face.m_furthestConflictDistance = maxAltitude;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void ConvexHull3D::AddPointToQuickhull(int eyePointIndex, int eyeFaceIndex)
+{
+	m_iterationCounter++;
+
+	std::vector<int> horizonEdgeIndices;
+	std::vector<int> visibleFaceIndices;
+	BuildHorizon(eyePointIndex, eyeFaceIndex, horizonEdgeIndices, visibleFaceIndices);
+
+	//Create New Faces From Horizon Edges (horizon is a closed ccw loop, so neighbors share the eye edges)
+	std::vector<int> newFaceIndices;
+	newFaceIndices.reserve(horizonEdgeIndices.size());
+	for (int horizonIndex = 0; horizonIndex < horizonEdgeIndices.size(); horizonIndex++)
+	{
+		QuickhullHalfEdge const& horizonEdge = m_halfEdges[horizonEdgeIndices[horizonIndex]];
+		int startPointIndex = horizonEdge.m_originPointIndex;
+		int endPointIndex = m_halfEdges[horizonEdge.m_nextEdgeIndex].m_originPointIndex;
+		int outsideTwinIndex = horizonEdge.m_twinEdgeIndex;
+
+		int newFaceIndex = AddQuickhullFace(startPointIndex, endPointIndex, eyePointIndex);
+		LinkTwinEdges(m_faces[newFaceIndex].m_edgeIndex, outsideTwinIndex);
+		newFaceIndices.push_back(newFaceIndex);
+	}
+	for (int newIndex = 0; newIndex < newFaceIndices.size(); newIndex++)
+	{
+		int nextNewIndex = (newIndex + 1) % int(newFaceIndices.size());
+		int edgeToEye = m_halfEdges[m_faces[newFaceIndices[newIndex]].m_edgeIndex].m_nextEdgeIndex;
+		int edgeFromEye = m_halfEdges[m_faces[newFaceIndices[nextNewIndex]].m_edgeIndex].m_previousEdgeIndex;
+		LinkTwinEdges(edgeToEye, edgeFromEye);
+	}
+
+	//Hand the orphaned conflict points of the removed faces to the new faces
+	for (int visibleIndex = 0; visibleIndex < visibleFaceIndices.size(); visibleIndex++)
+	{
+		QuickhullFace& visibleFace = m_faces[visibleFaceIndices[visibleIndex]];
+		visibleFace.m_isDeleted = true;
+		for (int conflictIndex = 0; conflictIndex < visibleFace.m_conflictPointIndices.size(); conflictIndex++)
 		{
-			Vec3& currentPoint = m_pointsToPartition[pointIndex];
-			if (IsPointInside(currentPoint))
+			int pointIndex = visibleFace.m_conflictPointIndices[conflictIndex];
+			if (pointIndex != eyePointIndex)
 			{
-				m_pointsToPartition.erase(m_pointsToPartition.begin() + pointIndex);
-				pointIndex--;
-				continue;
+				AssignConflictPoint(pointIndex, newFaceIndices);
 			}
 		}
+		visibleFace.m_conflictPointIndices.clear();
+		visibleFace.m_conflictPointIndices.shrink_to_fit();
+	}
 
-		//Repartition points to faces
-		for (int planeIndex = 0; planeIndex < m_conflictLists.size(); planeIndex++)
+	for (int newIndex = 0; newIndex < newFaceIndices.size(); newIndex++)
+	{
+		if (!m_faces[newFaceIndices[newIndex]].m_conflictPointIndices.empty())
 		{
-			m_conflictLists[planeIndex].clear();
+			m_facesToProcess.push_back(newFaceIndices[newIndex]);
 		}
-		for (int pointIndex = 0; pointIndex < m_pointsToPartition.size(); pointIndex++)
-		{
-			Vec3& point = m_pointsToPartition[pointIndex];
-			float minDist = FLT_MAX;
-			int closestPlaneIndex = -1;
-			for (int planeIndex = 0; planeIndex < m_boundingPlanes.size(); planeIndex++)
-			{
-				Plane3D& plane = m_boundingPlanes[planeIndex];
-				float altitude = DotProduct3D(point, plane.m_normal) - plane.m_distanceFromOrigin;
-				if (altitude < minDist && altitude > 0.0f)
-				{
-					minDist = altitude;
-					closestPlaneIndex = planeIndex;
-				}
-			}
+	}
+}
 
-			m_conflictLists[closestPlaneIndex].push_back(Vec2(float(pointIndex), minDist));
+//-----------------------------------------------------------------------------------------------
+void ConvexHull3D::BuildHorizon(int eyePointIndex, int eyeFaceIndex, std::vector<int>& outHorizonEdgeIndices, std::vector<int>& outVisibleFaceIndices)
+{
+	//Depth first search across twin edges, the stack keeps the edge each face resumes from so the horizon comes out in ccw order
+	struct HorizonSearchStep
+	{
+		int		m_faceIndex = -1;
+		int		m_startEdgeIndex = -1;
+		int		m_currentEdgeIndex = -1;
+		bool	m_hasStarted = false;
+	};
+
+	Vec3 const& eyePoint = m_points[eyePointIndex];
+	std::vector<HorizonSearchStep> searchStack;
+
+	HorizonSearchStep firstStep;
+	firstStep.m_faceIndex = eyeFaceIndex;
+	firstStep.m_startEdgeIndex = m_faces[eyeFaceIndex].m_edgeIndex;
+	firstStep.m_currentEdgeIndex = firstStep.m_startEdgeIndex;
+	searchStack.push_back(firstStep);
+	m_faces[eyeFaceIndex].m_visibleIteration = m_iterationCounter;
+	outVisibleFaceIndices.push_back(eyeFaceIndex);
+
+	while (!searchStack.empty())
+	{
+		HorizonSearchStep& step = searchStack.back();
+		if (step.m_hasStarted && step.m_currentEdgeIndex == step.m_startEdgeIndex)
+		{
+			searchStack.pop_back();
+			continue;
 		}
+		step.m_hasStarted = true;
+
+		int edgeIndex = step.m_currentEdgeIndex;
+		step.m_currentEdgeIndex = m_halfEdges[edgeIndex].m_nextEdgeIndex;
 
-		if (m_pointsToPartition.size() == 0)
+		int twinEdgeIndex = m_halfEdges[edgeIndex].m_twinEdgeIndex;
+		int neighborFaceIndex = m_halfEdges[twinEdgeIndex].m_faceIndex;
+		QuickhullFace& neighborFace = m_faces[neighborFaceIndex];
+		if (neighborFace.m_visibleIteration == m_iterationCounter)
 		{
-			break;
+			continue;
 		}
 
-		//NEED TO CLEAN THE DEBUG FACTOR UP TO BE MORE GAME SIDE INSTEAD OF ENGINE
-		if (isDebug)
+		float altitude = DotProduct3D(eyePoint, neighborFace.m_plane.m_normal) - neighborFace.m_plane.m_distanceFromOrigin;
+		if (altitude > m_epsilon)
 		{
-			break;
+			neighborFace.m_visibleIteration = m_iterationCounter;
+			outVisibleFaceIndices.push_back(neighborFaceIndex);
+
+			HorizonSearchStep nextStep;
+			nextStep.m_faceIndex = neighborFaceIndex;
+			nextStep.m_startEdgeIndex = m_halfEdges[twinEdgeIndex].m_nextEdgeIndex;
+			nextStep.m_currentEdgeIndex = nextStep.m_startEdgeIndex;
+			searchStack.push_back(nextStep);
+		}
+		else
+		{
+			outHorizonEdgeIndices.push_back(edgeIndex);
 		}
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void ConvexHull3D::SetBoundingPointsAndEdges()
+void ConvexHull3D::BuildBoundingPolysFromFaces(bool isCoplanarAllowed)
 {
-	//TODO: USE HALFEDGE STRUCTURE FOR OPTIMIZATION
-	//Setting all polygon points
-	for (int polyIndex = 0; polyIndex < m_boundingPolys.size(); polyIndex++)
+	m_boundingPlanes.clear();
+	m_boundingPolys.clear();
+	m_boundingPolyPointIndices.clear();
+
+	//Coplanar Removal
+	//Flood fill neighboring coplanar triangles into one polygon and walk its boundary
+	std::vector<int> polyIndexByFace(m_faces.size(), -1);
+	std::vector<int> floodStack;
+	for (int faceIndex = 0; faceIndex < m_faces.size(); faceIndex++)
 	{
-		for (int pointIndex = 0; pointIndex < m_boundingPolys[polyIndex].m_ccwOrderedPoints.size(); pointIndex++)
+		if (m_faces[faceIndex].m_isDeleted || polyIndexByFace[faceIndex] != -1)
 		{
-			Vec3 p1 = m_boundingPolys[polyIndex].m_ccwOrderedPoints[pointIndex];
-			Vec3 p2;
-			if (pointIndex == m_boundingPolys[polyIndex].m_ccwOrderedPoints.size() - 1)
-			{
-				p2 = m_boundingPolys[polyIndex].m_ccwOrderedPoints[0];
-			}
-			else
+			continue;
+		}
+
+		int polyIndex = int(m_boundingPolys.size());
+		QuickhullFace const& referenceFace = m_faces[faceIndex];
+		polyIndexByFace[faceIndex] = polyIndex;
+		if (!isCoplanarAllowed)
+		{
+			floodStack.push_back(faceIndex);
+			while (!floodStack.empty())
 			{
-				p2 = m_boundingPolys[polyIndex].m_ccwOrderedPoints[pointIndex + 1];
+				int currentFaceIndex = floodStack.back();
+				floodStack.pop_back();
+				int edgeIndex = m_faces[currentFaceIndex].m_edgeIndex;
+				do
+				{
+					int neighborFaceIndex = m_halfEdges[m_halfEdges[edgeIndex].m_twinEdgeIndex].m_faceIndex;
+					if (polyIndexByFace[neighborFaceIndex] == -1 && IsFaceCoplanar(referenceFace, neighborFaceIndex))
+					{
+						polyIndexByFace[neighborFaceIndex] = polyIndex;
+						floodStack.push_back(neighborFaceIndex);
+					}
+					edgeIndex = m_halfEdges[edgeIndex].m_nextEdgeIndex;
+				} while (edgeIndex != m_faces[currentFaceIndex].m_edgeIndex);
 			}
-			
-			m_boundingEdges.push_back(LineSegment3(p1, p2));
-			m_boundingPoints.push_back(m_boundingPolys[polyIndex].m_ccwOrderedPoints[pointIndex]);
 		}
-	}
 
-	//Erasing duplicates
-	for (int i = 0; i < m_boundingPoints.size(); i++)
-	{
-		for (int j = i + 1; j < m_boundingPoints.size(); j++)
+		//Find a boundary edge of the polygon to start the walk from
+		int startEdgeIndex = -1;
+		for (int searchFaceIndex = faceIndex; searchFaceIndex < m_faces.size() && startEdgeIndex == -1; searchFaceIndex++)
 		{
-			if (j == m_boundingPoints.size())
+			if (polyIndexByFace[searchFaceIndex] != polyIndex)
 			{
-				break;
+				continue;
 			}
 
-			if (m_boundingPoints[i] == m_boundingPoints[j])
+			int edgeIndex = m_faces[searchFaceIndex].m_edgeIndex;
+			do
 			{
-				m_boundingPoints.erase(m_boundingPoints.begin() + j);
-				j--;
-			}
+				int neighborFaceIndex = m_halfEdges[m_halfEdges[edgeIndex].m_twinEdgeIndex].m_faceIndex;
+				if (polyIndexByFace[neighborFaceIndex] != polyIndex)
+				{
+					startEdgeIndex = edgeIndex;
+					break;
+				}
+				edgeIndex = m_halfEdges[edgeIndex].m_nextEdgeIndex;
+			} while (edgeIndex != m_faces[searchFaceIndex].m_edgeIndex);
 		}
-	}
 
-	for (int i = 0; i < m_boundingEdges.size(); i++)
-	{
-		for (int j = i + 1; j < m_boundingEdges.size(); j++)
+		std::vector<int> polyPointIndices;
+		int edgeIndex = startEdgeIndex;
+		do
 		{
-			if (j == m_boundingEdges.size())
+			polyPointIndices.push_back(m_halfEdges[edgeIndex].m_originPointIndex);
+			int nextEdgeIndex = m_halfEdges[edgeIndex].m_nextEdgeIndex;
+			while (polyIndexByFace[m_halfEdges[m_halfEdges[nextEdgeIndex].m_twinEdgeIndex].m_faceIndex] == polyIndex)
 			{
-				break;
+				nextEdgeIndex = m_halfEdges[m_halfEdges[nextEdgeIndex].m_twinEdgeIndex].m_nextEdgeIndex;
 			}
-
-			if (m_boundingEdges[i] == m_boundingEdges[j])
+			edgeIndex = nextEdgeIndex;
+		} while (edgeIndex != startEdgeIndex && polyPointIndices.size() <= m_halfEdges.size());
+
+		//Drop points that sit on a straight run of the boundary
+		for (int cornerIndex = 0; cornerIndex < polyPointIndices.size() && polyPointIndices.size() > 3; cornerIndex++)
+		{
+			int numPoints = int(polyPointIndices.size());
+			Vec3 const& previousPoint = m_points[polyPointIndices[(cornerIndex + numPoints - 1) % numPoints]];
+			Vec3 const& currentPoint = m_points[polyPointIndices[cornerIndex]];
+			Vec3 const& nextPoint = m_points[polyPointIndices[(cornerIndex + 1) % numPoints]];
+			Vec3 chord = nextPoint - previousPoint;
+			float chordLength = chord.GetLength();
+			if (chordLength <= 0.0f || CrossProduct3D(chord, currentPoint - previousPoint).GetLength() / chordLength <= m_epsilon)
 			{
-				m_boundingEdges.erase(m_boundingEdges.begin() + j);
-				j--;
+				polyPointIndices.erase(polyPointIndices.begin() + cornerIndex);
+				cornerIndex--;
 			}
 		}
+
+		ConvexPoly3D newPoly;
+		newPoly.m_ccwOrderedPoints.reserve(polyPointIndices.size());
+		for (int cornerIndex = 0; cornerIndex < polyPointIndices.size(); cornerIndex++)
+		{
+			newPoly.m_ccwOrderedPoints.push_back(m_points[polyPointIndices[cornerIndex]]);
+		}
+
+		m_boundingPolys.push_back(newPoly);
+		m_boundingPlanes.push_back(referenceFace.m_plane);
+		m_boundingPolyPointIndices.push_back(polyPointIndices);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+bool ConvexHull3D::IsFaceCoplanar(QuickhullFace const& referenceFace, int faceIndex) const
+{
+	QuickhullFace const& face = m_faces[faceIndex];
+	if (face.m_isDeleted || DotProduct3D(face.m_plane.m_normal, referenceFace.m_plane.m_normal) <= 0.0f)
+	{
+		return false;
 	}
+
+	int edgeIndex = face.m_edgeIndex;
+	do
+	{
+		Vec3 const& point = m_points[m_halfEdges[edgeIndex].m_originPointIndex];
+		float altitude = DotProduct3D(point, referenceFace.m_plane.m_normal) - referenceFace.m_plane.m_distanceFromOrigin;
+		if (altitude > m_epsilon || altitude < -m_epsilon)
+		{
+			return false;
+		}
+		edgeIndex = m_halfEdges[edgeIndex].m_nextEdgeIndex;
+	} while (edgeIndex != face.m_edgeIndex);
+
+	return true;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -684,4 +780,4 @@ void ConvexHull3D::CalculateNewEpsilon(std::vector<Vec3> const& points)
 		maxZ = fabsf(negativeZValue);
 	m_epsilon = 3.0f * (maxX + maxY + maxZ) * FLT_EPSILON;
 
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -5,6 +5,30 @@
 #include "LineSegment3.hpp"
 #include <vector>
 
+//-----------------------------------------------------------------------------------------------
+struct QuickhullHalfEdge
+{
+public:
+	int					m_originPointIndex = -1;
+	int					m_faceIndex = -1;
+	int					m_nextEdgeIndex = -1;
+	int					m_previousEdgeIndex = -1;
+	int					m_twinEdgeIndex = -1;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct QuickhullFace
+{
+public:
+	Plane3D				m_plane;
+	std::vector<int>	m_conflictPointIndices;
+	int					m_edgeIndex = -1;
+	int					m_furthestConflictPointIndex = -1;
+	float				m_furthestConflictDistance = 0.0f;
+	int					m_visibleIteration = -1;
+	bool				m_isDeleted = false;
+};
+
 //-----------------------------------------------------------------------------------------------
 struct ConvexHull3D
 {
@@ -15,18 +39,34 @@ public:
 
 	bool IsPointInside(Vec3 const& point);
 	void GenerateQuickhullInitialTetrahedron();
+	void GenerateTetrahedron(Vec3 const& pointA, Vec3 const& pointB, Vec3 const& pointC, Vec3 const& pointD);
 	void IterativeQuickullGeneration(bool isCoplanarAllowed = false, bool isDebug = false);
+	bool AddPointToHull(Vec3 const& point, bool isCoplanarAllowed = true);
 	void SetBoundingPointsAndEdges();
 	void DebugDrawQuickull(bool drawWireOnly = false);
 	void CalculateNewEpsilon(std::vector<Vec3> const& points);
 
+private:
+	int		AddQuickhullFace(int pointIndexA, int pointIndexB, int pointIndexC);
+	void	LinkTwinEdges(int edgeIndexA, int edgeIndexB);
+	void	AssignConflictPoint(int pointIndex, std::vector<int> const& candidateFaceIndices);
+	void	AddPointToQuickhull(int eyePointIndex, int eyeFaceIndex);
+	void	BuildHorizon(int eyePointIndex, int eyeFaceIndex, std::vector<int>& outHorizonEdgeIndices, std::vector<int>& outVisibleFaceIndices);
+	void	BuildBoundingPolysFromFaces(bool isCoplanarAllowed);
+	bool	IsFaceCoplanar(QuickhullFace const& referenceFace, int faceIndex) const;
+
 public:
 	std::vector<Plane3D>			m_boundingPlanes;
 	std::vector<Vec3>				m_boundingPoints;
 	std::vector<ConvexPoly3D>		m_boundingPolys;
+	std::vector<std::vector<int>>	m_boundingPolyPointIndices;		// indexes into m_points, parallel to m_boundingPolys
 	std::vector<LineSegment3>		m_boundingEdges;
-	std::vector<Vec3>				m_pointsToPartition;
-	std::vector<std::vector<Vec2>>	m_conflictLists;
+	std::vector<Vec3>				m_pointsToPartition;			// points still waiting in a conflict list
+	std::vector<Vec3>				m_points;
+	std::vector<QuickhullHalfEdge>	m_halfEdges;
+	std::vector<QuickhullFace>		m_faces;
+	std::vector<int>				m_facesToProcess;
 	float							m_epsilon = 0.0f;
+	int								m_iterationCounter = 0;
 	int								m_debugCounter = 0;
-};
\ No newline at end of file
+};
@@ -954,6 +954,30 @@ Vec3 GetNearestPointOnPlane3D(Vec3 const& referencePosition, Plane3D const& plan
 	return referencePosition + plane.m_normal * alt;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Weights of the reference position projected onto the triangle's plane, returns false if that lands outside the triangle
+bool GetBarycentricCoordinatesOnTriangle(Vec3 const& referencePosition, Vec3 const& a, Vec3 const& b, Vec3 const& c, float& weightA, float& weightB, float& weightC)
+{
+	Vec3 edgeAB = b - a;
+	Vec3 edgeAC = c - a;
+	Vec3 toReference = referencePosition - a;
+	float dotABAB = DotProduct3D(edgeAB, edgeAB);
+	float dotABAC = DotProduct3D(edgeAB, edgeAC);
+	float dotACAC = DotProduct3D(edgeAC, edgeAC);
+	float dotRefAB = DotProduct3D(toReference, edgeAB);
+	float dotRefAC = DotProduct3D(toReference, edgeAC);
+	float denominator = dotABAB * dotACAC - dotABAC * dotABAC;
+	if (denominator == 0.0f)
+	{
+		return false;
+	}
+
+	weightB = (dotACAC * dotRefAB - dotABAC * dotRefAC) / denominator;
+	weightC = (dotABAB * dotRefAC - dotABAC * dotRefAB) / denominator;
+	weightA = 1.0f - weightB - weightC;
+	return weightA >= 0.0f && weightB >= 0.0f && weightC >= 0.0f;
+}
+
 //-----------------------------------------------------------------------------------------------
 bool PushDiscOutOfFixedPoint2D(Vec2& mobileDiscCenter, float discRadius, Vec2 const& fixedPoint)
 {
@@ -3832,6 +3856,285 @@ RaycastResult3D RaycastVsAABB3D(Vec3 startPos, Vec3 fwdNormal, float maxDist, AA
 	return rayResult;
 }
 
+//-----------------------------------------------------------------------------------------------
+// Sets up a sweep result, false when the sphere does not move
+static bool InitializeSweepResult(Vec3 const& start, Vec3 const& end, RaycastResult3D& out_result)
+{
+	Vec3 displacement = end - start;
+	float sweepLength = displacement.GetLength();
+	out_result.m_rayStartPos = start;
+	out_result.m_rayMaxLength = sweepLength;
+	if (sweepLength == 0.0f)
+	{
+		return false;
+	}
+	out_result.m_rayFwdNormal = displacement / sweepLength;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Ray against a sphere the ray starts outside of, false when it misses or moves away
+static bool GetRayImpactOnSphere3D(Vec3 const& start, Vec3 const& fwdNormal, Vec3 const& center, float radius, float& out_impactDist, Vec3& out_impactNormal)
+{
+	Vec3 centerToStart = start - center;
+	float startDistanceSquared = centerToStart.GetLengthSquared() - radius * radius;
+	float projectedDistance = DotProduct3D(centerToStart, fwdNormal);
+	if (startDistanceSquared <= 0.0f || projectedDistance >= 0.0f)
+	{
+		return false;
+	}
+	float discriminant = projectedDistance * projectedDistance - startDistanceSquared;
+	if (discriminant < 0.0f)
+	{
+		return false;
+	}
+	out_impactDist = -projectedDistance - sqrtf(discriminant);
+	out_impactNormal = (start + fwdNormal * out_impactDist - center).GetNormalized();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Ray against the side of a cylinder between axisStart and axisEnd, caps are not included
+static bool GetRayImpactOnCylinderSide3D(Vec3 const& start, Vec3 const& fwdNormal, Vec3 const& axisStart, Vec3 const& axisEnd, float radius, float& out_impactDist, Vec3& out_impactNormal)
+{
+	Vec3 axis = axisEnd - axisStart;
+	float axisLengthSquared = axis.GetLengthSquared();
+	if (axisLengthSquared == 0.0f)
+	{
+		return false;
+	}
+
+	//Quadratic in the distance along the ray for the part of it perpendicular to the axis
+	Vec3 axisStartToStart = start - axisStart;
+	float axisDotFwd = DotProduct3D(axis, fwdNormal);
+	float axisDotStart = DotProduct3D(axis, axisStartToStart);
+	float a = axisLengthSquared - axisDotFwd * axisDotFwd;
+	float b = axisLengthSquared * DotProduct3D(axisStartToStart, fwdNormal) - axisDotStart * axisDotFwd;
+	float c = axisLengthSquared * (axisStartToStart.GetLengthSquared() - radius * radius) - axisDotStart * axisDotStart;
+	if (a <= 0.0f || c <= 0.0f || b >= 0.0f)
+	{
+		return false;
+	}
+	float discriminant = b * b - a * c;
+	if (discriminant < 0.0f)
+	{
+		return false;
+	}
+
+	float impactDist = (-b - sqrtf(discriminant)) / a;
+	float axisFraction = (axisDotStart + impactDist * axisDotFwd) / axisLengthSquared;
+	if (axisFraction < 0.0f || axisFraction > 1.0f)
+	{
+		return false;
+	}
+	out_impactDist = impactDist;
+	out_impactNormal = (start + fwdNormal * impactDist - (axisStart + axis * axisFraction)).GetNormalized();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Slab test against a box centered on the origin, the ray and the normal are in the box's space
+static bool GetRayImpactOnCenteredBox3D(Vec3 const& localStart, Vec3 const& localFwdNormal, Vec3 const& halfDimensions, float& out_impactDist, Vec3& out_localImpactNormal)
+{
+	float starts[3] = { localStart.x, localStart.y, localStart.z };
+	float directions[3] = { localFwdNormal.x, localFwdNormal.y, localFwdNormal.z };
+	float halfExtents[3] = { halfDimensions.x, halfDimensions.y, halfDimensions.z };
+	float enterDist = 0.0f;
+	float exitDist = FLT_MAX;
+	int enterAxis = -1;
+	for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+	{
+		if (fabsf(directions[axisIndex]) < 0.000001f)
+		{
+			if (fabsf(starts[axisIndex]) > halfExtents[axisIndex])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float inverseDirection = 1.0f / directions[axisIndex];
+		float nearDist = (-halfExtents[axisIndex] - starts[axisIndex]) * inverseDirection;
+		float farDist = (halfExtents[axisIndex] - starts[axisIndex]) * inverseDirection;
+		if (nearDist > farDist)
+		{
+			float swapDist = nearDist;
+			nearDist = farDist;
+			farDist = swapDist;
+		}
+		if (nearDist > enterDist)
+		{
+			enterDist = nearDist;
+			enterAxis = axisIndex;
+		}
+		if (farDist < exitDist)
+		{
+			exitDist = farDist;
+		}
+		if (enterDist > exitDist)
+		{
+			return false;
+		}
+	}
+
+	//Never entering a slab after the start means the ray started inside
+	if (enterAxis == -1)
+	{
+		return false;
+	}
+	float normal[3] = { 0.0f, 0.0f, 0.0f };
+	normal[enterAxis] = directions[enterAxis] > 0.0f ? -1.0f : 1.0f;
+	out_impactDist = enterDist;
+	out_localImpactNormal = Vec3(normal[0], normal[1], normal[2]);
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+static void SetSweepImpact(RaycastResult3D& out_result, float impactDist, Vec3 const& impactNormal)
+{
+	if (impactDist > out_result.m_rayMaxLength || (out_result.m_didImpact && impactDist >= out_result.m_impactDist))
+	{
+		return;
+	}
+	out_result.m_didImpact = true;
+	out_result.m_impactDist = impactDist;
+	out_result.m_impactPos = out_result.m_rayStartPos + out_result.m_rayFwdNormal * impactDist;
+	out_result.m_impactNormal = impactNormal;
+}
+
+//-----------------------------------------------------------------------------------------------
+RaycastResult3D SweepSphereVsSphere3D(Vec3 const& start, Vec3 const& end, float sphereRadius, Vec3 const& fixedSphereCenter, float fixedSphereRadius)
+{
+	RaycastResult3D sweepResult;
+	float impactDist = 0.0f;
+	Vec3 impactNormal;
+	if (InitializeSweepResult(start, end, sweepResult) &&
+		GetRayImpactOnSphere3D(start, sweepResult.m_rayFwdNormal, fixedSphereCenter, sphereRadius + fixedSphereRadius, impactDist, impactNormal))
+	{
+		SetSweepImpact(sweepResult, impactDist, impactNormal);
+	}
+	return sweepResult;
+}
+
+//-----------------------------------------------------------------------------------------------
+RaycastResult3D SweepSphereVsCapsule3D(Vec3 const& start, Vec3 const& end, float sphereRadius, Capsule3 const& capsule)
+{
+	RaycastResult3D sweepResult;
+	float radius = sphereRadius + capsule.m_radius;
+	LineSegment3 bone = LineSegment3(capsule.m_bone.m_start, capsule.m_bone.m_end);
+	if (InitializeSweepResult(start, end, sweepResult) == false || GetDistanceToLineSegmentSquared3D(start, bone) <= radius * radius)
+	{
+		return sweepResult;
+	}
+
+	float impactDist = 0.0f;
+	Vec3 impactNormal;
+	Vec3 const& fwdNormal = sweepResult.m_rayFwdNormal;
+	if (GetRayImpactOnCylinderSide3D(start, fwdNormal, bone.m_start, bone.m_end, radius, impactDist, impactNormal))
+	{
+		SetSweepImpact(sweepResult, impactDist, impactNormal);
+	}
+	if (GetRayImpactOnSphere3D(start, fwdNormal, bone.m_start, radius, impactDist, impactNormal))
+	{
+		SetSweepImpact(sweepResult, impactDist, impactNormal);
+	}
+	if (GetRayImpactOnSphere3D(start, fwdNormal, bone.m_end, radius, impactDist, impactNormal))
+	{
+		SetSweepImpact(sweepResult, impactDist, impactNormal);
+	}
+	return sweepResult;
+}
+
+//-----------------------------------------------------------------------------------------------
+RaycastResult3D SweepSphereVsAABB3D(Vec3 const& start, Vec3 const& end, float sphereRadius, AABB3 const& aabb)
+{
+	RaycastResult3D sweepResult;
+	if (InitializeSweepResult(start, end, sweepResult) == false)
+	{
+		return sweepResult;
+	}
+
+	Vec3 center = (aabb.m_mins + aabb.m_maxs) * 0.5f;
+	Vec3 halfDimensions = (aabb.m_maxs - aabb.m_mins) * 0.5f + Vec3(sphereRadius, sphereRadius, sphereRadius);
+	float impactDist = 0.0f;
+	Vec3 impactNormal;
+	if (GetRayImpactOnCenteredBox3D(start - center, sweepResult.m_rayFwdNormal, halfDimensions, impactDist, impactNormal))
+	{
+		SetSweepImpact(sweepResult, impactDist, impactNormal);
+	}
+	return sweepResult;
+}
+
+//-----------------------------------------------------------------------------------------------
+RaycastResult3D SweepSphereVsOBB3D(Vec3 const& start, Vec3 const& end, float sphereRadius, OBB3 const& obb)
+{
+	RaycastResult3D sweepResult;
+	if (InitializeSweepResult(start, end, sweepResult) == false)
+	{
+		return sweepResult;
+	}
+
+	Vec3 centerToStart = start - obb.m_center;
+	Vec3 const& fwdNormal = sweepResult.m_rayFwdNormal;
+	Vec3 localStart = Vec3(DotProduct3D(centerToStart, obb.m_iBasisNormal), DotProduct3D(centerToStart, obb.m_jBasisNormal), DotProduct3D(centerToStart, obb.m_kBasisNormal));
+	Vec3 localFwdNormal = Vec3(DotProduct3D(fwdNormal, obb.m_iBasisNormal), DotProduct3D(fwdNormal, obb.m_jBasisNormal), DotProduct3D(fwdNormal, obb.m_kBasisNormal));
+	Vec3 halfDimensions = obb.m_halfDimensions + Vec3(sphereRadius, sphereRadius, sphereRadius);
+	float impactDist = 0.0f;
+	Vec3 localImpactNormal;
+	if (GetRayImpactOnCenteredBox3D(localStart, localFwdNormal, halfDimensions, impactDist, localImpactNormal))
+	{
+		Vec3 impactNormal = obb.m_iBasisNormal * localImpactNormal.x + obb.m_jBasisNormal * localImpactNormal.y + obb.m_kBasisNormal * localImpactNormal.z;
+		SetSweepImpact(sweepResult, impactDist, impactNormal);
+	}
+	return sweepResult;
+}
+
+//-----------------------------------------------------------------------------------------------
+RaycastResult3D SweepSphereVsCylinder3D(Vec3 const& start, Vec3 const& end, float sphereRadius, Cylinder3 const& cylinder)
+{
+	RaycastResult3D sweepResult;
+	Vec3 axis = cylinder.m_end - cylinder.m_start;
+	float axisLength = axis.GetLength();
+	if (InitializeSweepResult(start, end, sweepResult) == false || axisLength == 0.0f)
+	{
+		return sweepResult;
+	}
+
+	//Grown by the sphere radius on the side and past both caps
+	Vec3 axisNormal = axis / axisLength;
+	float radius = cylinder.m_radius + sphereRadius;
+	Vec3 axisStart = cylinder.m_start - axisNormal * sphereRadius;
+	Vec3 axisEnd = cylinder.m_end + axisNormal * sphereRadius;
+	float startAlongAxis = DotProduct3D(start - axisStart, axisNormal);
+	Vec3 startOffAxis = (start - axisStart) - axisNormal * startAlongAxis;
+	if (startAlongAxis >= 0.0f && startAlongAxis <= axisLength + 2.0f * sphereRadius && startOffAxis.GetLengthSquared() <= radius * radius)
+	{
+		return sweepResult;
+	}
+
+	float impactDist = 0.0f;
+	Vec3 impactNormal;
+	Vec3 const& fwdNormal = sweepResult.m_rayFwdNormal;
+	if (GetRayImpactOnCylinderSide3D(start, fwdNormal, axisStart, axisEnd, radius, impactDist, impactNormal))
+	{
+		SetSweepImpact(sweepResult, impactDist, impactNormal);
+	}
+
+	//Caps
+	float fwdAlongAxis = DotProduct3D(fwdNormal, axisNormal);
+	if (fwdAlongAxis != 0.0f)
+	{
+		Vec3 capCenter = fwdAlongAxis > 0.0f ? axisStart : axisEnd;
+		impactDist = DotProduct3D(capCenter - start, axisNormal) / fwdAlongAxis;
+		Vec3 capToImpact = start + fwdNormal * impactDist - capCenter;
+		if (impactDist >= 0.0f && capToImpact.GetLengthSquared() <= radius * radius)
+		{
+			SetSweepImpact(sweepResult, impactDist, fwdAlongAxis > 0.0f ? axisNormal * -1.0f : axisNormal);
+		}
+	}
+	return sweepResult;
+}
+
 //-----------------------------------------------------------------------------------------------
 bool IsLineCollinearWithPlane3D(LineSegment3 const& line, Plane3D const& plane)
 {
@@ -168,6 +168,7 @@ DPVec3				GetNearestPointOnCapsule3D(DPVec3 const& referencePosition, DPCapsule3
 Vec3				GetNearestPointOnCylinderZ3D(Vec3 const& referencePosition, Cylinder3 const& cylinder);
 DPVec3				GetNearestPointOnCylinderZ3D(DPVec3 const& referencePosition, DPCylinder3 const& cylinder);
 Vec3				GetNearestPointOnPlane3D(Vec3 const& referencePosition, Plane3D const& plane);
+bool				GetBarycentricCoordinatesOnTriangle(Vec3 const& referencePosition, Vec3 const& a, Vec3 const& b, Vec3 const& c, float& weightA, float& weightB, float& weightC);
 bool				PushDiscOutOfFixedPoint2D(Vec2& mobileDiscCenter, float discRadius, Vec2 const& fixedPoint);
 bool				PushDiscOutOfFixedDisc2D(Vec2& mobileDiscCenter, float mobileDiscRadius, Vec2 const& fixedDiscCenter, float fixedDiscRadius);
 bool				PushDiscOutOfFixedDisc2D(DPVec2& mobileDiscCenter, double mobileDiscRadius, DPVec2 const& fixedDiscCenter, double fixedDiscRadius);
@@ -219,6 +220,14 @@ RaycastResult2D		RaycastVsPlane2D(Vec2 startPos, Vec2 fwdNormal, float maxDist,
 RaycastResult2D		RaycastVsConvexHull2D(Vec2 startPos, Vec2 fwdNormal, float maxDist, ConvexHull2D& convexHull);
 RaycastResult3D		RaycastVsPlane3D(Vec3 startPos, Vec3 fwdNormal, float maxDist, Plane3D& plane);
 RaycastResult3D		RaycastVsAABB3D(Vec3 startPos, Vec3 fwdNormal, float maxDist, AABB3 const& aabb);
+//Swept spheres moving from start to end, the impact is where the sphere center is when it first touches the shape.
+//A sphere that starts out touching the shape reports no impact, the push out functions above handle that.
+//The box and cylinder versions grow the shape by the radius with sharp edges, so a sweep past an edge can stop a little early.
+RaycastResult3D		SweepSphereVsSphere3D(Vec3 const& start, Vec3 const& end, float sphereRadius, Vec3 const& fixedSphereCenter, float fixedSphereRadius);
+RaycastResult3D		SweepSphereVsCapsule3D(Vec3 const& start, Vec3 const& end, float sphereRadius, Capsule3 const& capsule);
+RaycastResult3D		SweepSphereVsAABB3D(Vec3 const& start, Vec3 const& end, float sphereRadius, AABB3 const& aabb);
+RaycastResult3D		SweepSphereVsOBB3D(Vec3 const& start, Vec3 const& end, float sphereRadius, OBB3 const& obb);
+RaycastResult3D		SweepSphereVsCylinder3D(Vec3 const& start, Vec3 const& end, float sphereRadius, Cylinder3 const& cylinder);
 bool				IsLineCollinearWithPlane3D(LineSegment3 const& line, Plane3D const& plane);
 ConvexHull3D		GetMinkowskiDifference(RigidBody3D* a, RigidBody3D* b);
 float				GetDistanceToLineSegment3D(Vec3 const& referencePoint, LineSegment3 const& line);
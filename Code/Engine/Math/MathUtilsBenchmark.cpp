@@ -0,0 +1,408 @@
+#include "MathUtilsBenchmark.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/CollisionPackets3D.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/OBB3.hpp"
+#include "Engine/Math/Capsule3.hpp"
+#include "Engine/Math/Cylinder3.hpp"
+#include "Engine/Math/LineSegment3.hpp"
+#include "Engine/Math/Plane3D.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/DPVec3.hpp"
+#include "Engine/Math/DPAABB3.hpp"
+#include "Engine/Math/DPOBB3.hpp"
+#include "Engine/Math/DPCapsule3.hpp"
+#include "Engine/Math/DPCylinder3.hpp"
+#include <map>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Every timed result is folded in here so the optimizer cannot drop the calls
+static volatile double s_benchmarkSink = 0.0;
+
+//-----------------------------------------------------------------------------------------------
+// One set of shapes per input index, the double versions are converted from the float ones so both variants
+// see identical geometry and take the same branches
+struct MathUtilsBenchmarkInputs
+{
+	std::vector<Vec3>			m_points;
+	std::vector<Vec3>			m_directions;
+	std::vector<float>			m_radii;
+	std::vector<Vec3>			m_sphereCenters;
+	std::vector<AABB3>			m_aabbs;
+	std::vector<OBB3>			m_obbs;
+	std::vector<Capsule3>		m_capsules;
+	std::vector<Capsule3>		m_otherCapsules;
+	std::vector<Cylinder3>		m_cylinders;
+	std::vector<Cylinder3>		m_zCylinders;
+	std::vector<LineSegment3>	m_lineSegments;
+	std::vector<Plane3D>		m_planes;
+
+	std::vector<DPVec3>			m_dpPoints;
+	std::vector<DPVec3>			m_dpSphereCenters;
+	std::vector<DPAABB3>		m_dpAABBs;
+	std::vector<DPOBB3>			m_dpOBBs;
+	std::vector<DPCapsule3>		m_dpCapsules;
+	std::vector<DPCapsule3>		m_dpOtherCapsules;
+	std::vector<DPCylinder3>	m_dpCylinders;
+	std::vector<DPCylinder3>	m_dpZCylinders;
+
+	std::vector<SpherePacket3D>	m_spherePackets;		// packet i holds the points and radii starting at input i
+	std::vector<AABBPacket3D>	m_aabbPackets;
+};
+
+//-----------------------------------------------------------------------------------------------
+static Vec3 RollRandomPosition(RandomNumberGenerator& rng, float halfExtent)
+{
+	return Vec3(rng.RollRandomFloatInRange(-halfExtent, halfExtent), rng.RollRandomFloatInRange(-halfExtent, halfExtent),
+		rng.RollRandomFloatInRange(-halfExtent, halfExtent));
+}
+
+//-----------------------------------------------------------------------------------------------
+static Vec3 RollRandomDirection(RandomNumberGenerator& rng)
+{
+	Vec3 direction = RollRandomPosition(rng, 1.0f);
+	if (direction.GetLengthSquared() < 0.0001f)
+	{
+		direction = Vec3(1.0f, 0.0f, 0.0f);
+	}
+	return direction.GetNormalized();
+}
+
+//-----------------------------------------------------------------------------------------------
+static void GenerateBenchmarkInputs(MathUtilsBenchmarkInputs& inputs, MathUtilsBenchmarkConfig const& config)
+{
+	//Everything lives in a 4m cube with shapes around a meter across so roughly half of the queries overlap
+	RandomNumberGenerator rng(config.m_seed);
+	for (int inputIndex = 0; inputIndex < config.m_numInputs; inputIndex++)
+	{
+		Vec3 point = RollRandomPosition(rng, 2.0f);
+		inputs.m_points.push_back(point);
+		inputs.m_directions.push_back(RollRandomDirection(rng));
+		inputs.m_radii.push_back(rng.RollRandomFloatInRange(0.1f, 1.0f));
+		inputs.m_sphereCenters.push_back(RollRandomPosition(rng, 2.0f));
+
+		Vec3 boxCenter = RollRandomPosition(rng, 2.0f);
+		Vec3 halfDimensions(rng.RollRandomFloatInRange(0.2f, 1.0f), rng.RollRandomFloatInRange(0.2f, 1.0f), rng.RollRandomFloatInRange(0.2f, 1.0f));
+		inputs.m_aabbs.push_back(AABB3(boxCenter - halfDimensions, boxCenter + halfDimensions));
+		Vec3 iBasis = RollRandomDirection(rng);
+		inputs.m_obbs.push_back(OBB3(boxCenter, iBasis, halfDimensions));
+
+		Vec3 boneStart = RollRandomPosition(rng, 2.0f);
+		Vec3 boneEnd = boneStart + RollRandomDirection(rng) * rng.RollRandomFloatInRange(0.2f, 1.5f);
+		inputs.m_capsules.push_back(Capsule3(boneStart, boneEnd, rng.RollRandomFloatInRange(0.05f, 0.5f)));
+		boneStart = RollRandomPosition(rng, 2.0f);
+		boneEnd = boneStart + RollRandomDirection(rng) * rng.RollRandomFloatInRange(0.2f, 1.5f);
+		inputs.m_otherCapsules.push_back(Capsule3(boneStart, boneEnd, rng.RollRandomFloatInRange(0.05f, 0.5f)));
+
+		Vec3 cylinderStart = RollRandomPosition(rng, 2.0f);
+		Vec3 cylinderEnd = cylinderStart + RollRandomDirection(rng) * rng.RollRandomFloatInRange(0.5f, 2.0f);
+		inputs.m_cylinders.push_back(Cylinder3(cylinderStart, cylinderEnd, rng.RollRandomFloatInRange(0.1f, 1.0f)));
+		cylinderEnd = cylinderStart + Vec3(0.0f, 0.0f, rng.RollRandomFloatInRange(0.5f, 2.0f));
+		inputs.m_zCylinders.push_back(Cylinder3(cylinderStart, cylinderEnd, rng.RollRandomFloatInRange(0.1f, 1.0f)));
+
+		inputs.m_lineSegments.push_back(LineSegment3(RollRandomPosition(rng, 2.0f), RollRandomPosition(rng, 2.0f)));
+		inputs.m_planes.push_back(Plane3D(RollRandomDirection(rng), rng.RollRandomFloatInRange(-1.0f, 1.0f)));
+
+		inputs.m_dpPoints.push_back(DPVec3(point));
+		inputs.m_dpSphereCenters.push_back(DPVec3(inputs.m_sphereCenters.back()));
+		inputs.m_dpAABBs.push_back(DPAABB3(DPVec3(inputs.m_aabbs.back().m_mins), DPVec3(inputs.m_aabbs.back().m_maxs)));
+		DPVec3 dpBoxCenter(boxCenter);
+		DPVec3 dpIBasis(iBasis);
+		DPVec3 dpHalfDimensions(halfDimensions);
+		inputs.m_dpOBBs.push_back(DPOBB3(dpBoxCenter, dpIBasis, dpHalfDimensions));
+		Capsule3 const& capsule = inputs.m_capsules.back();
+		inputs.m_dpCapsules.push_back(DPCapsule3(DPVec3(capsule.m_bone.m_start), DPVec3(capsule.m_bone.m_end), capsule.m_radius));
+		Capsule3 const& otherCapsule = inputs.m_otherCapsules.back();
+		inputs.m_dpOtherCapsules.push_back(DPCapsule3(DPVec3(otherCapsule.m_bone.m_start), DPVec3(otherCapsule.m_bone.m_end), otherCapsule.m_radius));
+		Cylinder3 const& cylinder = inputs.m_cylinders.back();
+		inputs.m_dpCylinders.push_back(DPCylinder3(DPVec3(cylinder.m_start), DPVec3(cylinder.m_end), cylinder.m_radius));
+		Cylinder3 const& zCylinder = inputs.m_zCylinders.back();
+		inputs.m_dpZCylinders.push_back(DPCylinder3(DPVec3(zCylinder.m_start), DPVec3(zCylinder.m_end), zCylinder.m_radius));
+	}
+
+	//Packets reuse the same shapes, wrapping around at the end of the inputs
+	inputs.m_spherePackets.resize(config.m_numInputs);
+	inputs.m_aabbPackets.resize(config.m_numInputs);
+	for (int inputIndex = 0; inputIndex < config.m_numInputs; inputIndex++)
+	{
+		inputs.m_spherePackets[inputIndex].m_numSpheres = COLLISION_PACKET_WIDTH;
+		inputs.m_aabbPackets[inputIndex].m_numBoxes = COLLISION_PACKET_WIDTH;
+		for (int laneIndex = 0; laneIndex < COLLISION_PACKET_WIDTH; laneIndex++)
+		{
+			int laneInputIndex = (inputIndex + laneIndex) % config.m_numInputs;
+			inputs.m_spherePackets[inputIndex].SetSphere(laneIndex, inputs.m_points[laneInputIndex], inputs.m_radii[laneInputIndex]);
+			inputs.m_aabbPackets[inputIndex].SetAABB(laneIndex, inputs.m_aabbs[laneInputIndex]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+template<typename Operation>
+static MathUtilsBenchmarkResult TimeOperation(char const* name, MathUtilsBenchmarkConfig const& config, Operation const& operation)
+{
+	double sink = 0.0;
+
+	//One untimed pass to fault in the inputs and warm the branch predictors
+	for (int inputIndex = 0; inputIndex < config.m_numInputs; inputIndex++)
+	{
+		sink += operation(inputIndex);
+	}
+
+	uint64_t startTicks = GetCurrentTimeTicks();
+	uint64_t startCycles = __rdtsc();
+	for (int passIndex = 0; passIndex < config.m_numPasses; passIndex++)
+	{
+		for (int inputIndex = 0; inputIndex < config.m_numInputs; inputIndex++)
+		{
+			sink += operation(inputIndex);
+		}
+	}
+	uint64_t endCycles = __rdtsc();
+	uint64_t endTicks = GetCurrentTimeTicks();
+	s_benchmarkSink = s_benchmarkSink + sink;
+
+	double numOps = static_cast<double>(config.m_numPasses) * static_cast<double>(config.m_numInputs);
+	MathUtilsBenchmarkResult result;
+	result.m_name = name;
+	result.m_nanosecondsPerOp = static_cast<double>(endTicks - startTicks) * GetSecondsPerTimeTick() * 1000000000.0 / numOps;
+	result.m_cyclesPerOp = static_cast<double>(endCycles - startCycles) / numOps;
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+static double GetPushResult(bool didPush, Vec3 const& pushedPosition)
+{
+	return (didPush ? 1.0 : 0.0) + static_cast<double>(pushedPosition.x);
+}
+
+//-----------------------------------------------------------------------------------------------
+static double GetPushResult(bool didPush, DPVec3 const& pushedPosition)
+{
+	return (didPush ? 1.0 : 0.0) + pushedPosition.x;
+}
+
+//-----------------------------------------------------------------------------------------------
+static double GetPacketResult(int collidingLanes, ContactPacket3D const& contacts)
+{
+	return static_cast<double>(collidingLanes) + static_cast<double>(contacts.m_penetration[0] + contacts.m_normalX[COLLISION_PACKET_WIDTH - 1]);
+}
+
+//-----------------------------------------------------------------------------------------------
+static void LoadBaseline(std::map<std::string, double>& baselineNanosecondsPerOp, std::string const& baselinePath)
+{
+	XmlDocument baselineXml;
+	if (baselineXml.LoadFile(baselinePath.c_str()) != tinyxml2::XML_SUCCESS)
+	{
+		return;
+	}
+
+	XmlElement* rootElement = baselineXml.RootElement();
+	if (rootElement == nullptr)
+	{
+		return;
+	}
+
+	for (XmlElement* benchmarkElement = rootElement->FirstChildElement("Benchmark"); benchmarkElement != nullptr;
+		benchmarkElement = benchmarkElement->NextSiblingElement("Benchmark"))
+	{
+		std::string name = ParseXmlAttribute(*benchmarkElement, "name", "");
+		float nanosecondsPerOp = ParseXmlAttribute(*benchmarkElement, "nsPerOp", -1.0f);
+		if (!name.empty() && nanosecondsPerOp > 0.0f)
+		{
+			baselineNanosecondsPerOp[name] = static_cast<double>(nanosecondsPerOp);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+std::vector<MathUtilsBenchmarkResult> RunMathUtilsBenchmarks(MathUtilsBenchmarkConfig const& config)
+{
+	GUARANTEE_OR_DIE(config.m_numInputs > 0 && config.m_numPasses > 0, "MathUtils benchmark needs at least one input and one pass");
+
+	MathUtilsBenchmarkInputs inputs;
+	GenerateBenchmarkInputs(inputs, config);
+	MathUtilsBenchmarkInputs const& in = inputs;
+	std::vector<MathUtilsBenchmarkResult> results;
+
+	//Overlap and nearest point queries
+	results.push_back(TimeOperation("DoSpheresOverlap", config, [&](int i)
+		{ return DoSpheresOverlap(in.m_points[i], in.m_radii[i], in.m_sphereCenters[i], 0.5f) ? 1.0 : 0.0; }));
+	results.push_back(TimeOperation("DoSpheresOverlap_DP", config, [&](int i)
+		{ return DoSpheresOverlap(in.m_dpPoints[i], static_cast<double>(in.m_radii[i]), in.m_dpSphereCenters[i], 0.5) ? 1.0 : 0.0; }));
+	results.push_back(TimeOperation("GetNearestPointOnAABB3D", config, [&](int i)
+		{ return static_cast<double>(GetNearestPointOnAABB3D(in.m_points[i], in.m_aabbs[i]).x); }));
+	results.push_back(TimeOperation("GetNearestPointOnOBB3D", config, [&](int i)
+		{ return static_cast<double>(GetNearestPointOnOBB3D(in.m_points[i], in.m_obbs[i]).x); }));
+	results.push_back(TimeOperation("GetNearestPointOnLineSegment3D", config, [&](int i)
+		{ return static_cast<double>(GetNearestPointOnLineSegment3D(in.m_points[i], in.m_lineSegments[i]).x); }));
+	results.push_back(TimeOperation("GetNearestPointOnCapsule3D", config, [&](int i)
+		{ return static_cast<double>(GetNearestPointOnCapsule3D(in.m_points[i], in.m_capsules[i]).x); }));
+	results.push_back(TimeOperation("GetNearestPointOnCapsule3D_DP", config, [&](int i)
+		{ return GetNearestPointOnCapsule3D(in.m_dpPoints[i], in.m_dpCapsules[i]).x; }));
+	results.push_back(TimeOperation("GetNearestPointOnCylinderZ3D", config, [&](int i)
+		{ return static_cast<double>(GetNearestPointOnCylinderZ3D(in.m_points[i], in.m_zCylinders[i]).x); }));
+	results.push_back(TimeOperation("GetNearestPointOnCylinderZ3D_DP", config, [&](int i)
+		{ return GetNearestPointOnCylinderZ3D(in.m_dpPoints[i], in.m_dpZCylinders[i]).x; }));
+	results.push_back(TimeOperation("GetNearestPointsBetweenLines3D", config, [&](int i)
+		{ LineSegment3 bone(in.m_capsules[i].m_bone.m_start, in.m_capsules[i].m_bone.m_end);
+		return static_cast<double>(GetNearestPointsBetweenLines3D(in.m_lineSegments[i], bone)[0].x); }));
+
+	//Sphere pushes, the mobile sphere is copied so every pass starts from the same state
+	results.push_back(TimeOperation("PushSphereOutOfFixedSphere3D", config, [&](int i)
+		{ Vec3 center = in.m_points[i]; return GetPushResult(PushSphereOutOfFixedSphere3D(center, in.m_radii[i], in.m_sphereCenters[i], 0.5f), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedSphere3D_DP", config, [&](int i)
+		{ DPVec3 center = in.m_dpPoints[i]; return GetPushResult(PushSphereOutOfFixedSphere3D(center, static_cast<double>(in.m_radii[i]), in.m_dpSphereCenters[i], 0.5), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfSphere3D", config, [&](int i)
+		{ Vec3 centerA = in.m_points[i]; Vec3 centerB = in.m_sphereCenters[i];
+		return GetPushResult(PushSphereOutOfSphere3D(centerA, in.m_radii[i], centerB, 0.5f), centerA) + static_cast<double>(centerB.x); }));
+	results.push_back(TimeOperation("PushSphereOutOfSphere3D_DP", config, [&](int i)
+		{ DPVec3 centerA = in.m_dpPoints[i]; DPVec3 centerB = in.m_dpSphereCenters[i];
+		return GetPushResult(PushSphereOutOfSphere3D(centerA, static_cast<double>(in.m_radii[i]), centerB, 0.5), centerA) + centerB.x; }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedAABB3D", config, [&](int i)
+		{ Vec3 center = in.m_points[i]; return GetPushResult(PushSphereOutOfFixedAABB3D(center, in.m_radii[i], in.m_aabbs[i]), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedAABB3D_DP", config, [&](int i)
+		{ DPVec3 center = in.m_dpPoints[i]; return GetPushResult(PushSphereOutOfFixedAABB3D(center, static_cast<double>(in.m_radii[i]), in.m_dpAABBs[i]), center); }));
+	results.push_back(TimeOperation("PushDiscOutOfFixedOBB3D", config, [&](int i)
+		{ Vec3 center = in.m_points[i]; return GetPushResult(PushDiscOutOfFixedOBB3D(center, in.m_radii[i], in.m_obbs[i]), center); }));
+	results.push_back(TimeOperation("PushDiscOutOfFixedOBB3D_DP", config, [&](int i)
+		{ DPVec3 center = in.m_dpPoints[i]; return GetPushResult(PushDiscOutOfFixedOBB3D(center, static_cast<double>(in.m_radii[i]), in.m_dpOBBs[i]), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedCapsule3D", config, [&](int i)
+		{ Vec3 center = in.m_points[i]; return GetPushResult(PushSphereOutOfFixedCapsule3D(center, in.m_radii[i], in.m_capsules[i]), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedCapsule3D_DP", config, [&](int i)
+		{ DPVec3 center = in.m_dpPoints[i]; return GetPushResult(PushSphereOutOfFixedCapsule3D(center, static_cast<double>(in.m_radii[i]), in.m_dpCapsules[i]), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedCylinderZ3D", config, [&](int i)
+		{ Vec3 center = in.m_points[i]; return GetPushResult(PushSphereOutOfFixedCylinderZ3D(center, in.m_radii[i], in.m_zCylinders[i]), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedCylinderZ3D_DP", config, [&](int i)
+		{ DPVec3 center = in.m_dpPoints[i]; return GetPushResult(PushSphereOutOfFixedCylinderZ3D(center, static_cast<double>(in.m_radii[i]), in.m_dpZCylinders[i]), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedCylinder3D", config, [&](int i)
+		{ Vec3 center = in.m_points[i]; return GetPushResult(PushSphereOutOfFixedCylinder3D(center, in.m_radii[i], in.m_cylinders[i]), center); }));
+	results.push_back(TimeOperation("PushSphereOutOfFixedCylinder3D_DP", config, [&](int i)
+		{ DPVec3 center = in.m_dpPoints[i]; return GetPushResult(PushSphereOutOfFixedCylinder3D(center, static_cast<double>(in.m_radii[i]), in.m_dpCylinders[i]), center); }));
+
+	//Capsule pushes
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedSphere3D", config, [&](int i)
+		{ Capsule3 capsule = in.m_capsules[i]; return GetPushResult(PushCapsuleOutOfFixedSphere3D(capsule, in.m_sphereCenters[i], in.m_radii[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedSphere3D_DP", config, [&](int i)
+		{ DPCapsule3 capsule = in.m_dpCapsules[i]; return GetPushResult(PushCapsuleOutOfFixedSphere3D(capsule, in.m_dpSphereCenters[i], static_cast<double>(in.m_radii[i])), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedAABB3D", config, [&](int i)
+		{ Capsule3 capsule = in.m_capsules[i]; return GetPushResult(PushCapsuleOutOfFixedAABB3D(capsule, in.m_aabbs[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedAABB3D_DP", config, [&](int i)
+		{ DPCapsule3 capsule = in.m_dpCapsules[i]; return GetPushResult(PushCapsuleOutOfFixedAABB3D(capsule, in.m_dpAABBs[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedOBB3D", config, [&](int i)
+		{ Capsule3 capsule = in.m_capsules[i]; return GetPushResult(PushCapsuleOutOfFixedOBB3D(capsule, in.m_obbs[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedOBB3D_DP", config, [&](int i)
+		{ DPCapsule3 capsule = in.m_dpCapsules[i]; return GetPushResult(PushCapsuleOutOfFixedOBB3D(capsule, in.m_dpOBBs[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedCapsule3D", config, [&](int i)
+		{ Capsule3 capsule = in.m_capsules[i]; return GetPushResult(PushCapsuleOutOfFixedCapsule3D(capsule, in.m_otherCapsules[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedCapsule3D_DP", config, [&](int i)
+		{ DPCapsule3 capsule = in.m_dpCapsules[i]; return GetPushResult(PushCapsuleOutOfFixedCapsule3D(capsule, in.m_dpOtherCapsules[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfCapsule3D", config, [&](int i)
+		{ Capsule3 capsuleA = in.m_capsules[i]; Capsule3 capsuleB = in.m_otherCapsules[i];
+		return GetPushResult(PushCapsuleOutOfCapsule3D(capsuleA, capsuleB), capsuleA.m_bone.m_start) + static_cast<double>(capsuleB.m_bone.m_start.x); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfCapsule3D_DP", config, [&](int i)
+		{ DPCapsule3 capsuleA = in.m_dpCapsules[i]; DPCapsule3 capsuleB = in.m_dpOtherCapsules[i];
+		return GetPushResult(PushCapsuleOutOfCapsule3D(capsuleA, capsuleB), capsuleA.m_bone.m_start) + capsuleB.m_bone.m_start.x; }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedCylinderZ3D", config, [&](int i)
+		{ Capsule3 capsule = in.m_capsules[i]; return GetPushResult(PushCapsuleOutOfFixedCylinderZ3D(capsule, in.m_zCylinders[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedCylinderZ3D_DP", config, [&](int i)
+		{ DPCapsule3 capsule = in.m_dpCapsules[i]; return GetPushResult(PushCapsuleOutOfFixedCylinderZ3D(capsule, in.m_dpZCylinders[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedCylinder3D", config, [&](int i)
+		{ Capsule3 capsule = in.m_capsules[i]; return GetPushResult(PushCapsuleOutOfFixedCylinder3D(capsule, in.m_cylinders[i]), capsule.m_bone.m_start); }));
+	results.push_back(TimeOperation("PushCapsuleOutOfFixedCylinder3D_DP", config, [&](int i)
+		{ DPCapsule3 capsule = in.m_dpCapsules[i]; return GetPushResult(PushCapsuleOutOfFixedCylinder3D(capsule, in.m_dpCylinders[i]), capsule.m_bone.m_start); }));
+
+	//Packets of eight, so compare these against eight of the matching scalar pushes above
+	results.push_back(TimeOperation("GetSpherePacketContactsVsSphere3D", config, [&](int i)
+		{ ContactPacket3D contacts; return GetPacketResult(GetSpherePacketContactsVsSphere3D(in.m_spherePackets[i], in.m_sphereCenters[i], 0.5f, contacts), contacts); }));
+	results.push_back(TimeOperation("GetSpherePacketContactsVsCapsule3D", config, [&](int i)
+		{ ContactPacket3D contacts; return GetPacketResult(GetSpherePacketContactsVsCapsule3D(in.m_spherePackets[i], in.m_capsules[i], contacts), contacts); }));
+	results.push_back(TimeOperation("GetSpherePacketContactsVsAABB3D", config, [&](int i)
+		{ ContactPacket3D contacts; return GetPacketResult(GetSpherePacketContactsVsAABB3D(in.m_spherePackets[i], in.m_aabbs[i], contacts), contacts); }));
+	results.push_back(TimeOperation("GetSpherePacketContactsVsOBB3D", config, [&](int i)
+		{ ContactPacket3D contacts; return GetPacketResult(GetSpherePacketContactsVsOBB3D(in.m_spherePackets[i], in.m_obbs[i], contacts), contacts); }));
+	results.push_back(TimeOperation("GetSpherePacketContactsVsCylinder3D", config, [&](int i)
+		{ ContactPacket3D contacts; return GetPacketResult(GetSpherePacketContactsVsCylinder3D(in.m_spherePackets[i], in.m_cylinders[i], contacts), contacts); }));
+	results.push_back(TimeOperation("GetSphereContactsVsSpherePacket3D", config, [&](int i)
+		{ ContactPacket3D contacts; return GetPacketResult(GetSphereContactsVsSpherePacket3D(in.m_points[i], in.m_radii[i], in.m_spherePackets[(i + 1) % config.m_numInputs], contacts), contacts); }));
+	results.push_back(TimeOperation("GetSphereContactsVsAABBPacket3D", config, [&](int i)
+		{ ContactPacket3D contacts; return GetPacketResult(GetSphereContactsVsAABBPacket3D(in.m_points[i], in.m_radii[i], in.m_aabbPackets[i], contacts), contacts); }));
+
+	//Raycasts, there are no double variants of these yet
+	results.push_back(TimeOperation("RaycastVsAABB3D", config, [&](int i)
+		{ return static_cast<double>(RaycastVsAABB3D(in.m_points[i], in.m_directions[i], 4.0f, in.m_aabbs[i]).m_impactDist); }));
+	results.push_back(TimeOperation("RaycastVsPlane3D", config, [&](int i)
+		{ Plane3D plane = in.m_planes[i]; return static_cast<double>(RaycastVsPlane3D(in.m_points[i], in.m_directions[i], 4.0f, plane).m_impactDist); }));
+	results.push_back(TimeOperation("RaycastVsCylinderZ3D", config, [&](int i)
+		{ Cylinder3 const& cylinder = in.m_zCylinders[i];
+		return static_cast<double>(RaycastVsCylinderZ3D(in.m_points[i], in.m_directions[i], 4.0f, Vec2(cylinder.m_start.x, cylinder.m_start.y),
+			cylinder.m_start.z, cylinder.m_end.z, cylinder.m_radius).m_impactDist); }));
+
+	//Compare against the stored baseline
+	std::map<std::string, double> baselineNanosecondsPerOp;
+	LoadBaseline(baselineNanosecondsPerOp, config.m_baselinePath);
+	int numRegressions = 0;
+	for (int resultIndex = 0; resultIndex < static_cast<int>(results.size()); resultIndex++)
+	{
+		MathUtilsBenchmarkResult& result = results[resultIndex];
+		auto baselineIter = baselineNanosecondsPerOp.find(result.m_name);
+		if (baselineIter != baselineNanosecondsPerOp.end())
+		{
+			result.m_baselineNanosecondsPerOp = baselineIter->second;
+			result.m_isRegression = result.m_nanosecondsPerOp > result.m_baselineNanosecondsPerOp * (1.0 + static_cast<double>(config.m_regressionThreshold));
+			if (result.m_isRegression)
+			{
+				numRegressions++;
+			}
+		}
+
+		DebuggerPrintf("[benchmark] %-40s %8.2f ns/op %8.1f cycles/op", result.m_name.c_str(), result.m_nanosecondsPerOp, result.m_cyclesPerOp);
+		if (result.m_baselineNanosecondsPerOp > 0.0)
+		{
+			DebuggerPrintf("   baseline %8.2f ns/op %+6.1f%%%s", result.m_baselineNanosecondsPerOp,
+				(result.m_nanosecondsPerOp / result.m_baselineNanosecondsPerOp - 1.0) * 100.0, result.m_isRegression ? "   REGRESSION" : "");
+		}
+		DebuggerPrintf("\n");
+	}
+
+	//Each result carries m_isRegression, so this is only a summary and never stops the run
+	if (numRegressions > 0)
+	{
+		DebuggerPrintf("[benchmark] %d MathUtils primitives are more than %.0f%% slower than the baseline in %s\n", numRegressions,
+			config.m_regressionThreshold * 100.0f, config.m_baselinePath.c_str());
+	}
+
+	if (config.m_writeBaseline)
+	{
+		std::string baselineText = GetMathUtilsBenchmarkResultsAsXml(results);
+		std::vector<uint8_t> baselineBuffer(baselineText.begin(), baselineText.end());
+		if (!FileWriteToFileBinary(baselineBuffer, config.m_baselinePath))
+		{
+			DebuggerPrintf("Could not write MathUtils benchmark baseline to %s\n", config.m_baselinePath.c_str());
+		}
+	}
+	return results;
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string GetMathUtilsBenchmarkResultsAsXml(std::vector<MathUtilsBenchmarkResult> const& results)
+{
+	std::string xmlText = "<MathUtilsBaseline>\n";
+	for (int resultIndex = 0; resultIndex < static_cast<int>(results.size()); resultIndex++)
+	{
+		MathUtilsBenchmarkResult const& result = results[resultIndex];
+		xmlText += Stringf("\t<Benchmark name=\"%s\" nsPerOp=\"%.3f\" cyclesPerOp=\"%.2f\"/>\n", result.m_name.c_str(), result.m_nanosecondsPerOp, result.m_cyclesPerOp);
+	}
+	xmlText += "</MathUtilsBaseline>\n";
+	return xmlText;
+}
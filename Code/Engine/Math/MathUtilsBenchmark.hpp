@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Times the MathUtils collision and query primitives (float and double variants) over the same seeded inputs.
+// Results are compared against the baseline xml so a slower build is flagged locally; set m_writeBaseline to
+// record a new one after an intentional change. The committed baseline lives in Engine/Math/Benchmarks and is
+// copied into the game's Data/Benchmarks folder like the Simulations models.
+struct MathUtilsBenchmarkConfig
+{
+	unsigned int	m_seed = 12345;
+	int				m_numInputs = 1024;					// small enough to stay in L1/L2 so the math is what gets measured
+	int				m_numPasses = 200;
+	float			m_regressionThreshold = 0.1f;		// fraction slower than baseline before a result is flagged
+	std::string		m_baselinePath = "Data/Benchmarks/MathUtilsBaseline.xml";
+	bool			m_writeBaseline = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct MathUtilsBenchmarkResult
+{
+	std::string		m_name;
+	double			m_nanosecondsPerOp = 0.0;
+	double			m_cyclesPerOp = 0.0;				// reference cycles from the time stamp counter, not core clocks
+	double			m_baselineNanosecondsPerOp = -1.0;	// -1 when the baseline has no entry for this primitive
+	bool			m_isRegression = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+std::vector<MathUtilsBenchmarkResult>	RunMathUtilsBenchmarks(MathUtilsBenchmarkConfig const& config);
+std::string								GetMathUtilsBenchmarkResultsAsXml(std::vector<MathUtilsBenchmarkResult> const& results);
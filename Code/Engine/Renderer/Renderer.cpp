@@ -577,6 +577,19 @@ Texture* Renderer::CreateOrGetTextureFromFile(char const* imageFilePath)
 	return newTexture;
 }
 
+//------------------------------------------------------------------------------------------------
+Texture* Renderer::CreateOrGetTextureFromImage(Image const& image)
+{
+	// Images decoded off the main thread only need the GPU upload here
+	Texture* existingTexture = GetTextureForFileName(image.GetImageFilePath().c_str());
+	if (existingTexture)
+	{
+		return existingTexture;
+	}
+
+	return CreateTextureFromImage(image);
+}
+
 //------------------------------------------------------------------------------------------------
 Texture* Renderer::GetTextureForFileName(char const* imageFilePath)
 {
@@ -1614,6 +1627,21 @@ BitmapFont* Renderer::CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNo
 	return newFont;
 }
 
+//------------------------------------------------------------------------------------------------
+BitmapFont* Renderer::CreateOrGetBitmapFontFromImage(char const* bitmapFontFilePathWithNoExtension, Image const& fontImage)
+{
+	BitmapFont* existingFont = GetBitMapFont(bitmapFontFilePathWithNoExtension);
+	if (existingFont)
+	{
+		return existingFont;
+	}
+
+	Texture* fontTexture = CreateOrGetTextureFromImage(fontImage);
+	BitmapFont* newFont = new BitmapFont(bitmapFontFilePathWithNoExtension, *fontTexture);
+	m_loadedFonts.push_back(newFont);
+	return newFont;
+}
+
 //------------------------------------------------------------------------------------------------
 BitmapFont* Renderer::CreateBitmapFont(char const* fontFilePathNoExtenstion)
 {
@@ -141,6 +141,8 @@ public:
 	Texture*					GetTextureForFileName(char const* imageFilePath);
 	BitmapFont*					GetBitMapFont(char const* bitmapFontFilePathWithNoExtension);
 	BitmapFont*					CreateOrGetBitmapFont(const char* bitmapFontFilePathWithNoExtension);
+	Texture*					CreateOrGetTextureFromImage(Image const& image);
+	BitmapFont*					CreateOrGetBitmapFontFromImage(char const* bitmapFontFilePathWithNoExtension, Image const& fontImage);
 
 	void						BindShader(Shader* shader);
 	void						BindComputeShader(Shader* shader);
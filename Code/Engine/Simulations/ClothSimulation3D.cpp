@@ -1,12 +1,58 @@
+#define _USE_MATH_DEFINES
 #include "ClothSimulation3D.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Renderer/Renderer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+#include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Profiler.hpp"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 #include <vector>
 
+//-----------------------------------------------------------------------------------------------
+// Contacts are found once per substep but projected every iteration, so look a bit further than the contact distance
+constexpr float SELF_COLLISION_DETECTION_MARGIN = 1.5f;
+constexpr float MAX_BENDING_CORRECTION_RADIANS = 0.5f;
+
+//-----------------------------------------------------------------------------------------------
+// Signed angle between the two triangles sharing an edge, zero when they lie flat
+static float GetDihedralAngle(Vec3 const& edgeStart, Vec3 const& edgeEnd, Vec3 const& wingA, Vec3 const& wingB)
+{
+	Vec3 normalA = CrossProduct3D(wingA - edgeStart, wingA - edgeEnd);
+	Vec3 normalB = CrossProduct3D(wingB - edgeEnd, wingB - edgeStart);
+	Vec3 edge = edgeEnd - edgeStart;
+	return atan2f(DotProduct3D(CrossProduct3D(normalB, normalA), edge) / edge.GetLength(), DotProduct3D(normalA, normalB));
+}
+
+//-----------------------------------------------------------------------------------------------
+ClothSelfCollisionJob::ClothSelfCollisionJob(ClothSimulation3D* cloth)
+	:m_cloth(cloth)
+{
+	m_jobType = JOB_TYPE_SIMULATION;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSelfCollisionJob::Execute()
+{
+	m_cloth->DetectSelfCollisions(*this);
+}
+
+//-----------------------------------------------------------------------------------------------
+ClothRenderMeshJob::ClothRenderMeshJob(ClothSimulation3D* cloth)
+	:m_cloth(cloth)
+{
+	m_jobType = JOB_TYPE_SIMULATION;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothRenderMeshJob::Execute()
+{
+	m_cloth->UpdateRenderVerts(m_firstParticleIndex, m_endParticleIndex);
+}
+
 //-----------------------------------------------------------------------------------------------
 ClothSimulation3D::ClothSimulation3D(Renderer* renderer, AABB3 worldBounds, Vec2 dimensions, int totalNumberOfParticles, 
 	int totalSolverIterations, Vec3 attachPointTopLeft, Vec3 attachPointTopRight)
@@ -16,7 +62,10 @@ ClothSimulation3D::ClothSimulation3D(Renderer* renderer, AABB3 worldBounds, Vec2
 	,m_totalNumberOfParticles(totalNumberOfParticles)
 	, m_totalSolverIterations(totalSolverIterations)
 {
-	InitializeShaders();
+	if (m_renderer != nullptr)
+	{
+		InitializeShaders();
+	}
 
 	m_numberOfRows = int(sqrtf(float(totalNumberOfParticles)));
 	m_numberOfParticlesPerRow = m_numberOfRows;
@@ -130,19 +179,95 @@ ClothSimulation3D::ClothSimulation3D(Renderer* renderer, AABB3 worldBounds, Vec2
 				m_distanceConstraintsOriginalDists.push_back(m_originalDiagonalDistance);
 			}
 	}
+
+	InitializeTriangles();
+	InitializeBendingConstraints();
+	InitializeLongRangeAttachments();
+	if (m_renderer != nullptr)
+	{
+		InitializeRenderMesh();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+ClothSimulation3D::~ClothSimulation3D()
+{
+	for (int jobIndex = 0; jobIndex < static_cast<int>(m_selfCollisionJobs.size()); jobIndex++)
+	{
+		delete m_selfCollisionJobs[jobIndex];
+		m_selfCollisionJobs[jobIndex] = nullptr;
+	}
+	m_selfCollisionJobs.clear();
+
+	for (int jobIndex = 0; jobIndex < static_cast<int>(m_renderMeshJobs.size()); jobIndex++)
+	{
+		delete m_renderMeshJobs[jobIndex];
+		m_renderMeshJobs[jobIndex] = nullptr;
+	}
+	m_renderMeshJobs.clear();
+
+	delete m_renderVertexBuffer;
+	m_renderVertexBuffer = nullptr;
+	delete m_renderIndexBuffer;
+	m_renderIndexBuffer = nullptr;
 }
 
 //-----------------------------------------------------------------------------------------------
 void ClothSimulation3D::Update(float deltaSeconds)
 {
+	PROFILE_SCOPE("ClothSimulation3D::Update");
+
+	m_fixedTimestepScheduler.SetFixedTimestep(m_physicsTimestep);
+	m_fixedTimestepScheduler.AddSimulation(this);
+	m_fixedTimestepScheduler.Update(deltaSeconds);
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::BeginFixedUpdates(int numSubsteps)
+{
+	UNUSED(numSubsteps);
 	m_simulationStartTime = float(GetCurrentTimeSeconds());
-	m_physicsDebt += deltaSeconds;
-	while (m_physicsDebt > m_physicsTimestep)
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::SavePreviousState()
+{
+	m_previousPositions = m_particles.m_positions;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::FixedUpdate(float fixedDeltaSeconds)
+{
+	m_physicsTimestep = fixedDeltaSeconds;
+	if (!m_isSleepingEnabled)
 	{
-		UpdateCPU();
-		m_physicsDebt -= m_physicsTimestep;
+		m_sleepIslands.WakeAll();
 	}
+	UpdateCPU();
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::EndFixedUpdates(float interpolationAlpha)
+{
+	m_interpolationAlpha = interpolationAlpha;
 	m_simulationEndTime = float(GetCurrentTimeSeconds());
+	if (m_renderVertexBuffer != nullptr)
+	{
+		UpdateRenderMesh();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec3 ClothSimulation3D::GetRenderPosition(int particleIndex) const
+{
+	Vec3 const& currentPosition = m_particles.m_positions[particleIndex];
+	if (m_previousPositions.size() != m_particles.m_positions.size())
+	{
+		return currentPosition;
+	}
+
+	Vec3 const& previousPosition = m_previousPositions[particleIndex];
+	return previousPosition + (currentPosition - previousPosition) * m_interpolationAlpha;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -154,46 +279,11 @@ void ClothSimulation3D::Render() const
 		//return;
 	}
 	
-	//Normal Render 
-	AABB2 uvs;
-	float uvVertAmount = 1.0f / m_numberOfRows;
-	float uvHorzAmount = 1.0f / m_numberOfParticlesPerRow;
-	std::vector<Vertex_PCUTBN> verts;
-	for (int particleIndex = 0; particleIndex < m_totalNumberOfParticles; particleIndex++)
-	{
-		if (particleIndex < (m_numberOfRows - 1) * m_numberOfParticlesPerRow)
-		{
-			if ((particleIndex + m_numberOfParticlesPerRow + 1) % (m_numberOfParticlesPerRow) != 0)
-			{
-				Vec3 bottomLeft = m_particles.m_positions[particleIndex + m_numberOfParticlesPerRow];
-				Vec3 bottomRight = m_particles.m_positions[particleIndex + m_numberOfParticlesPerRow + 1];
-				Vec3 topLeft = m_particles.m_positions[particleIndex];
-				Vec3 topRight = m_particles.m_positions[particleIndex + 1];
-				
-				if ((particleIndex) % m_numberOfRows == 0)
-				{
-					uvs.m_mins = Vec2(0.0f, uvs.m_maxs.y);
-					uvs.m_maxs = Vec2(uvs.m_mins.x + uvHorzAmount, uvs.m_mins.y + uvVertAmount);
-				}
-				else
-				{
-					uvs.m_mins = Vec2(uvs.m_maxs.x, uvs.m_mins.y);
-					uvs.m_maxs = Vec2(uvs.m_mins.x + uvHorzAmount, uvs.m_mins.y + uvVertAmount);
-				}
-				AddVertsForQuad3D(verts, bottomLeft, bottomRight, topLeft, topRight, Rgba8::YELLOW, uvs);
-			}
-		}
-	}
-
-	CalculateTangentSpaceVectors(verts);
-
+	//Normal Render, the mesh was already refreshed at the end of the fixed updates
 	m_renderer->SetRasterizerMode(RasterizerMode::SOLID_CULL_NONE);
-	Texture* diffuseTexture = m_renderer->CreateOrGetTextureFromFile("Data/Images/Fabric_Diffuse.png");
-	Texture* normalTexture = m_renderer->CreateOrGetTextureFromFile("Data/Images/Fabric_Normal.png");
-	Texture* specGlossEmitTexture = m_renderer->CreateOrGetTextureFromFile("Data/Images/Brick_SpecGlossEmit.png");
-	m_renderer->BindTextures(diffuseTexture, normalTexture, specGlossEmitTexture);
+	m_renderer->BindTextures(m_diffuseTexture, m_normalTexture, m_specGlossEmitTexture);
 	m_renderer->SetModelConstants();
-	m_renderer->DrawVertexArray(int(verts.size()), verts.data(), m_renderShader);
+	m_renderer->DrawIndexBuffer(m_renderShader, m_renderIndexBuffer, m_renderVertexBuffer, static_cast<int>(m_triangleIndices.size()));
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -204,6 +294,7 @@ void ClothSimulation3D::UpdateGrabbedClothParticle(int sentParticleIndex, Vec3 c
 	m_grabbedParticleIndex = sentParticleIndex;
 	m_particles.m_positions[sentParticleIndex] = newPosition;
 	m_particles.m_proposedPositions[sentParticleIndex] = newPosition;
+	m_sleepIslands.WakeParticle(sentParticleIndex);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -215,10 +306,15 @@ void ClothSimulation3D::UpdateCPU()
 //-----------------------------------------------------------------------------------------------
 void ClothSimulation3D::UpdateGaussSeidel()
 {
+	if (m_isSleepingEnabled && !m_sleepIslands.IsInitialized(static_cast<int>(m_particles.m_positions.size())))
+	{
+		InitializeSleepIslands();
+	}
+
 	//Propose Positions
 	for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
 	{
-		if (m_particles.m_isAttached[particleIndex] == 1)
+		if (m_particles.m_isAttached[particleIndex] == 1 || m_sleepIslands.IsParticleAsleep(particleIndex))
 		{
 			m_particles.m_proposedPositions[particleIndex] = m_particles.m_positions[particleIndex];
 			continue;
@@ -231,12 +327,21 @@ void ClothSimulation3D::UpdateGaussSeidel()
 		m_particles.m_proposedPositions[particleIndex] = m_particles.m_positions[particleIndex] + velocity * m_physicsTimestep;
 	}
 
-	//Constraint Projection
-	for (int solverIndex = 0; solverIndex < m_totalSolverIterations; solverIndex++)
+	//Self Collision Detection, a cloth that is asleep everywhere cannot fold into itself
+	m_numActiveSelfCollisionJobs = 0;
+	if (m_isSelfCollisionEnabled && !m_sleepIslands.AreAllAsleep())
 	{
-		ProjectConstraintsGaussSeidel();
+		DetectSelfCollisions();
 	}
 
+	//Constraint Projection, a fully asleep cloth only needs one pass to see whether anything touched it
+	int numSolverIterations = m_sleepIslands.AreAllAsleep() ? 1 : m_totalSolverIterations;
+	for (int solverIndex = 0; solverIndex < numSolverIterations; solverIndex++)
+	{
+		ProjectConstraintsGaussSeidel(solverIndex);
+	}
+	m_sleepIslands.WakeDisturbedIslands(m_particles);
+
 	//Velocity and Friction Updates
 	for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
 	{
@@ -267,23 +372,160 @@ void ClothSimulation3D::UpdateGaussSeidel()
 
 		m_particles.m_positions[particleIndex] = m_particles.m_proposedPositions[particleIndex];
 	}
+
+	if (m_isSleepingEnabled)
+	{
+		m_sleepIslands.UpdateRestTimes(m_particles, m_physicsTimestep);
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void ClothSimulation3D::ProjectConstraintsGaussSeidel()
+void ClothSimulation3D::ProjectConstraintsGaussSeidel(int solverIndex)
 {
+	bool isAnyAsleep = m_sleepIslands.IsAnyAsleep();
 	for (int constraintIndex = 0; constraintIndex < m_distanceConstraints.size(); constraintIndex++)
 	{
+		std::vector<int> const& indices = m_distanceConstraints[constraintIndex].m_indices;
+		if (isAnyAsleep && m_sleepIslands.IsParticleAsleep(indices[0]) && m_sleepIslands.IsParticleAsleep(indices[1]))
+		{
+			continue;
+		}
 		ProjectDistanceConstraintGaussSeidel(constraintIndex);
 	}
+	if (m_bendingCoefficient > 0.0f)
+	{
+		for (int constraintIndex = 0; constraintIndex < static_cast<int>(m_bendingConstraints.size()); constraintIndex++)
+		{
+			std::vector<int> const& indices = m_bendingConstraints[constraintIndex].m_indices;
+			if (isAnyAsleep && m_sleepIslands.IsParticleAsleep(indices[0]) && m_sleepIslands.IsParticleAsleep(indices[1]) &&
+				m_sleepIslands.IsParticleAsleep(indices[2]) && m_sleepIslands.IsParticleAsleep(indices[3]))
+			{
+				continue;
+			}
+			ProjectBendingConstraintGaussSeidel(constraintIndex);
+		}
+	}
+	if (m_isLongRangeAttachmentEnabled)
+	{
+		ProjectLongRangeAttachmentConstraintsGaussSeidel();
+	}
 
 	//Collisions
+	if (m_isSelfCollisionEnabled)
+	{
+		ProjectSelfCollisionConstraintsGaussSeidel();
+	}
+	if (m_collisionWorld != nullptr)
+	{
+		ProjectCollisionWorldConstraintsGaussSeidel();
+	}
 	for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
 	{
+		//Sleeping particles only take the first iteration, which is where a contact would wake them
+		if (solverIndex > 0 && isAnyAsleep && m_sleepIslands.IsParticleAsleep(particleIndex))
+		{
+			continue;
+		}
 		ProjectWorldBoundsConstraintsSpheresGaussSeidel(particleIndex);
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::ProjectLongRangeAttachmentConstraintsGaussSeidel()
+{
+	//Unilateral, a particle only gets pulled back once it is further from its attachment than the cloth could ever reach
+	for (int particleIndex = 0; particleIndex < static_cast<int>(m_longRangeAttachmentIndices.size()); particleIndex++)
+	{
+		int attachmentIndex = m_longRangeAttachmentIndices[particleIndex];
+		if (attachmentIndex == -1 || m_particles.m_isAttached[attachmentIndex] == 0 || GetEffectiveInverseMass(particleIndex) == 0.0f || m_sleepIslands.IsParticleAsleep(particleIndex))
+		{
+			continue;
+		}
+
+		Vec3 displacement = m_particles.m_proposedPositions[particleIndex] - m_particles.m_proposedPositions[attachmentIndex];
+		float maxDistance = m_longRangeAttachmentDistances[particleIndex];
+		float distanceSquared = displacement.GetLengthSquared();
+		if (distanceSquared <= maxDistance * maxDistance)
+		{
+			continue;
+		}
+
+		float distance = sqrtf(distanceSquared);
+		m_particles.m_proposedPositions[particleIndex] -= displacement * ((distance - maxDistance) / distance);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::ProjectBendingConstraintGaussSeidel(int constraintIndex)
+{
+	//Dihedral angle gradients from Bridson et al. "Simulation of Clothing with Folds and Wrinkles", they stay well behaved
+	//when the triangles are flat, unlike the acos form which divides by the sine of the angle
+	Constraint3D const& constraint = m_bendingConstraints[constraintIndex];
+	int indices[4] = { constraint.m_indices[0], constraint.m_indices[1], constraint.m_indices[2], constraint.m_indices[3] };
+	Vec3 const& edgeStart = m_particles.m_proposedPositions[indices[0]];
+	Vec3 const& edgeEnd = m_particles.m_proposedPositions[indices[1]];
+	Vec3 const& wingA = m_particles.m_proposedPositions[indices[2]];
+	Vec3 const& wingB = m_particles.m_proposedPositions[indices[3]];
+
+	Vec3 normalA = CrossProduct3D(wingA - edgeStart, wingA - edgeEnd);
+	Vec3 normalB = CrossProduct3D(wingB - edgeEnd, wingB - edgeStart);
+	Vec3 edge = edgeEnd - edgeStart;
+	float normalALengthSquared = normalA.GetLengthSquared();
+	float normalBLengthSquared = normalB.GetLengthSquared();
+	float edgeLengthSquared = edge.GetLengthSquared();
+
+	//A wing almost on the edge line makes the gradients blow up, skip it until the distance constraints open it back up
+	float minNormalLengthSquared = 1e-4f * edgeLengthSquared * edgeLengthSquared;
+	if (edgeLengthSquared == 0.0f || normalALengthSquared < minNormalLengthSquared || normalBLengthSquared < minNormalLengthSquared)
+	{
+		return;
+	}
+	float edgeLength = sqrtf(edgeLengthSquared);
+
+	float angleOffset = atan2f(DotProduct3D(CrossProduct3D(normalB, normalA), edge) / edgeLength, DotProduct3D(normalA, normalB)) - m_bendingConstraintsRestAngles[constraintIndex];
+	if (angleOffset > float(M_PI))
+	{
+		angleOffset -= 2.0f * float(M_PI);
+	}
+	else if (angleOffset < -float(M_PI))
+	{
+		angleOffset += 2.0f * float(M_PI);
+	}
+	if (angleOffset == 0.0f)
+	{
+		return;
+	}
+
+	//Near a full fold the sign of the angle flips between iterations, so only unfold a little at a time
+	angleOffset = GetClamped(angleOffset, -MAX_BENDING_CORRECTION_RADIANS, MAX_BENDING_CORRECTION_RADIANS);
+
+	Vec3 scaledNormalA = normalA / normalALengthSquared;
+	Vec3 scaledNormalB = normalB / normalBLengthSquared;
+	Vec3 gradients[4];
+	gradients[0] = scaledNormalA * (DotProduct3D(wingA - edgeEnd, edge) / edgeLength) + scaledNormalB * (DotProduct3D(wingB - edgeEnd, edge) / edgeLength);
+	gradients[1] = (scaledNormalA * (DotProduct3D(wingA - edgeStart, edge) / edgeLength) + scaledNormalB * (DotProduct3D(wingB - edgeStart, edge) / edgeLength)) * -1.0f;
+	gradients[2] = scaledNormalA * edgeLength;
+	gradients[3] = scaledNormalB * edgeLength;
+
+	float inverseMasses[4];
+	float weightedGradientSum = 0.0f;
+	for (int pointIndex = 0; pointIndex < 4; pointIndex++)
+	{
+		inverseMasses[pointIndex] = GetEffectiveInverseMass(indices[pointIndex]);
+		weightedGradientSum += inverseMasses[pointIndex] * gradients[pointIndex].GetLengthSquared();
+	}
+	if (weightedGradientSum == 0.0f)
+	{
+		return;
+	}
+
+	float scale = m_bendingCoefficient * angleOffset / weightedGradientSum;
+	for (int pointIndex = 0; pointIndex < 4; pointIndex++)
+	{
+		m_particles.m_proposedPositions[indices[pointIndex]] -= gradients[pointIndex] * (scale * inverseMasses[pointIndex]);
+	}
+}
+
 //-----------------------------------------------------------------------------------------------
 void ClothSimulation3D::ProjectDistanceConstraintGaussSeidel(int constraintIndex)
 {
@@ -352,6 +594,25 @@ void ClothSimulation3D::ProjectDistanceConstraintGaussSeidel(int constraintIndex
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::ProjectCollisionWorldConstraintsGaussSeidel()
+{
+	m_collisionWorldContacts.clear();
+	m_collisionWorld->QuerySphereContacts(m_particles.m_proposedPositions, m_clothThickness, m_collisionWorldContacts, m_collisionWorldHandles);
+	for (int contactIndex = 0; contactIndex < static_cast<int>(m_collisionWorldContacts.size()); contactIndex++)
+	{
+		CollisionContact const& contact = m_collisionWorldContacts[contactIndex];
+		if (GetEffectiveInverseMass(contact.m_queryIndex) == 0.0f)
+		{
+			continue;
+		}
+
+		m_particles.m_proposedPositions[contact.m_queryIndex] += contact.m_correction;
+		m_particles.m_collisionNormals[contact.m_queryIndex] = contact.m_correction.GetNormalized();
+		m_particles.m_isSelfCollision[contact.m_queryIndex] = 0;
+	}
+}
+
 //-----------------------------------------------------------------------------------------------
 void ClothSimulation3D::ProjectWorldBoundsConstraintsSpheresGaussSeidel(int sentParticleIndex)
 {
@@ -399,6 +660,541 @@ void ClothSimulation3D::ProjectWorldBoundsConstraintsSpheresGaussSeidel(int sent
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::DetectSelfCollisions()
+{
+	PROFILE_SCOPE("ClothSimulation3D::DetectSelfCollisions");
+
+	//Cells as wide as a particle query or a rest triangle keep every query down to about 2x2x2 cells
+	float queryWidth = 4.0f * m_clothThickness * SELF_COLLISION_DETECTION_MARGIN;
+	float restSpacing = m_originalHorizontalDistance > m_originalVerticalDistance ? m_originalHorizontalDistance : m_originalVerticalDistance;
+	m_selfCollisionHash.SetCellSize(queryWidth > restSpacing ? queryWidth : restSpacing);
+	m_selfCollisionHash.Build(m_particles.m_proposedPositions);
+
+	//Split the particles between the calling thread and every worker, but only if each job gets enough work to pay for posting it
+	int numParticles = static_cast<int>(m_particles.m_positions.size());
+	int numJobs = GetNumJobsForParticles(m_minSelfCollisionParticlesPerJob);
+	while (static_cast<int>(m_selfCollisionJobs.size()) < numJobs)
+	{
+		m_selfCollisionJobs.push_back(new ClothSelfCollisionJob(this));
+	}
+	m_numActiveSelfCollisionJobs = numJobs;
+
+	int numParticlesPerJob = (numParticles + numJobs - 1) / numJobs;
+	for (int jobIndex = 0; jobIndex < numJobs; jobIndex++)
+	{
+		ClothSelfCollisionJob* job = m_selfCollisionJobs[jobIndex];
+		job->m_firstParticleIndex = jobIndex * numParticlesPerJob;
+		job->m_endParticleIndex = job->m_firstParticleIndex + numParticlesPerJob < numParticles ? job->m_firstParticleIndex + numParticlesPerJob : numParticles;
+	}
+	RunJobsAndWait(m_selfCollisionJobs, numJobs);
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::DetectSelfCollisions(ClothSelfCollisionJob& job) const
+{
+	job.m_particleContacts.clear();
+	job.m_triangleContacts.clear();
+
+	float particleDetectionDistance = 2.0f * m_clothThickness * SELF_COLLISION_DETECTION_MARGIN;
+	float triangleDetectionDistance = m_clothThickness * SELF_COLLISION_DETECTION_MARGIN;
+	std::vector<Vec3> const& proposedPositions = m_particles.m_proposedPositions;
+	std::vector<Vec3> const& startPositions = m_particles.m_positions;
+	int numQuadsPerRow = m_numberOfParticlesPerRow - 1;
+
+	//Each particle owns the grid quad below and to the right of it, one query covers its particle contacts and both of the quad's triangles
+	for (int particleIndex = job.m_firstParticleIndex; particleIndex < job.m_endParticleIndex; particleIndex++)
+	{
+		int particleRow = particleIndex / m_numberOfParticlesPerRow;
+		int particleColumn = particleIndex - particleRow * m_numberOfParticlesPerRow;
+		bool hasQuad = particleRow < m_numberOfRows - 1 && particleColumn < numQuadsPerRow;
+		Vec3 const& particlePosition = proposedPositions[particleIndex];
+
+		int numTriangles = 0;
+		int triangleIndices[2] = {};
+		AABB3 triangleBounds[2];
+		Vec3 triangleNormals[2];
+		Vec3 triangleStartNormals[2];
+		Vec3 queryMins = particlePosition - Vec3(particleDetectionDistance, particleDetectionDistance, particleDetectionDistance);
+		Vec3 queryMaxs = particlePosition + Vec3(particleDetectionDistance, particleDetectionDistance, particleDetectionDistance);
+		if (hasQuad)
+		{
+			int firstTriangleIndex = (particleRow * numQuadsPerRow + particleColumn) * 2;
+			for (int quadTriangleIndex = 0; quadTriangleIndex < 2; quadTriangleIndex++)
+			{
+				int triangleIndex = firstTriangleIndex + quadTriangleIndex;
+				int indexA = m_triangleIndices[triangleIndex * 3];
+				int indexB = m_triangleIndices[triangleIndex * 3 + 1];
+				int indexC = m_triangleIndices[triangleIndex * 3 + 2];
+				Vec3 const& a = proposedPositions[indexA];
+				Vec3 const& b = proposedPositions[indexB];
+				Vec3 const& c = proposedPositions[indexC];
+				Vec3 normal = CrossProduct3D(b - a, c - a);
+				Vec3 startNormal = CrossProduct3D(startPositions[indexB] - startPositions[indexA], startPositions[indexC] - startPositions[indexA]);
+				if (normal.GetLengthSquared() == 0.0f || startNormal.GetLengthSquared() == 0.0f)
+				{
+					continue;
+				}
+
+				Vec3 expansion(triangleDetectionDistance, triangleDetectionDistance, triangleDetectionDistance);
+				Vec3 mins(fminf(a.x, fminf(b.x, c.x)), fminf(a.y, fminf(b.y, c.y)), fminf(a.z, fminf(b.z, c.z)));
+				Vec3 maxs(fmaxf(a.x, fmaxf(b.x, c.x)), fmaxf(a.y, fmaxf(b.y, c.y)), fmaxf(a.z, fmaxf(b.z, c.z)));
+				triangleIndices[numTriangles] = triangleIndex;
+				triangleBounds[numTriangles] = AABB3(mins - expansion, maxs + expansion);
+				triangleNormals[numTriangles] = normal.GetNormalized();
+				triangleStartNormals[numTriangles] = startNormal.GetNormalized();
+				queryMins = Vec3(fminf(queryMins.x, triangleBounds[numTriangles].m_mins.x), fminf(queryMins.y, triangleBounds[numTriangles].m_mins.y),
+					fminf(queryMins.z, triangleBounds[numTriangles].m_mins.z));
+				queryMaxs = Vec3(fmaxf(queryMaxs.x, triangleBounds[numTriangles].m_maxs.x), fmaxf(queryMaxs.y, triangleBounds[numTriangles].m_maxs.y),
+					fmaxf(queryMaxs.z, triangleBounds[numTriangles].m_maxs.z));
+				numTriangles++;
+			}
+		}
+		m_selfCollisionHash.QueryAABB(AABB3(queryMins, queryMaxs), job.m_queryResults);
+
+		for (int resultIndex = 0; resultIndex < static_cast<int>(job.m_queryResults.size()); resultIndex++)
+		{
+			int otherIndex = job.m_queryResults[resultIndex];
+			Vec3 const& otherPosition = proposedPositions[otherIndex];
+			int otherRow = otherIndex / m_numberOfParticlesPerRow;
+			int otherColumn = otherIndex - otherRow * m_numberOfParticlesPerRow;
+
+			//Particle vs particle, each pair is only kept by its lower index
+			if (otherIndex > particleIndex && GetDistanceSquared3D(particlePosition, otherPosition) < particleDetectionDistance * particleDetectionDistance &&
+				(abs(otherRow - particleRow) > m_selfCollisionExcludedRings || abs(otherColumn - particleColumn) > m_selfCollisionExcludedRings))
+			{
+				ClothParticleContact contact;
+				contact.m_particleIndexA = particleIndex;
+				contact.m_particleIndexB = otherIndex;
+				job.m_particleContacts.push_back(contact);
+			}
+
+			//Particle vs triangle, skipping particles in or touching this quad
+			if (otherRow >= particleRow - 1 && otherRow <= particleRow + 2 && otherColumn >= particleColumn - 1 && otherColumn <= particleColumn + 2)
+			{
+				continue;
+			}
+			for (int quadTriangleIndex = 0; quadTriangleIndex < numTriangles; quadTriangleIndex++)
+			{
+				AABB3 const& bounds = triangleBounds[quadTriangleIndex];
+				if (otherPosition.x < bounds.m_mins.x || otherPosition.x > bounds.m_maxs.x || otherPosition.y < bounds.m_mins.y ||
+					otherPosition.y > bounds.m_maxs.y || otherPosition.z < bounds.m_mins.z || otherPosition.z > bounds.m_maxs.z)
+				{
+					continue;
+				}
+
+				//A particle that already crossed the plane this step is always a contact, otherwise it has to be close
+				int triangleIndex = triangleIndices[quadTriangleIndex];
+				int indexA = m_triangleIndices[triangleIndex * 3];
+				float side = DotProduct3D(startPositions[otherIndex] - startPositions[indexA], triangleStartNormals[quadTriangleIndex]) >= 0.0f ? 1.0f : -1.0f;
+				float signedDistance = DotProduct3D(otherPosition - proposedPositions[indexA], triangleNormals[quadTriangleIndex]) * side;
+				if (signedDistance > triangleDetectionDistance)
+				{
+					continue;
+				}
+
+				float barycentricA = 0.0f;
+				float barycentricB = 0.0f;
+				float barycentricC = 0.0f;
+				if (!GetBarycentricCoordinatesOnTriangle(otherPosition, proposedPositions[indexA], proposedPositions[m_triangleIndices[triangleIndex * 3 + 1]],
+					proposedPositions[m_triangleIndices[triangleIndex * 3 + 2]], barycentricA, barycentricB, barycentricC))
+				{
+					continue;
+				}
+
+				ClothTriangleContact contact;
+				contact.m_particleIndex = otherIndex;
+				contact.m_triangleIndex = triangleIndex;
+				contact.m_side = side;
+				job.m_triangleContacts.push_back(contact);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::ProjectSelfCollisionConstraintsGaussSeidel()
+{
+	float particleDistance = 2.0f * m_clothThickness;
+	std::vector<Vec3>& proposedPositions = m_particles.m_proposedPositions;
+
+	//Jobs are walked in order so the result does not depend on how the work was split
+	for (int jobIndex = 0; jobIndex < m_numActiveSelfCollisionJobs; jobIndex++)
+	{
+		ClothSelfCollisionJob const* job = m_selfCollisionJobs[jobIndex];
+		for (int contactIndex = 0; contactIndex < static_cast<int>(job->m_particleContacts.size()); contactIndex++)
+		{
+			ClothParticleContact const& contact = job->m_particleContacts[contactIndex];
+			if (m_sleepIslands.IsParticleAsleep(contact.m_particleIndexA) && m_sleepIslands.IsParticleAsleep(contact.m_particleIndexB))
+			{
+				continue;
+			}
+			Vec3 displacement = proposedPositions[contact.m_particleIndexB] - proposedPositions[contact.m_particleIndexA];
+			float distance = displacement.GetLength();
+			float inverseMassA = GetEffectiveInverseMass(contact.m_particleIndexA);
+			float inverseMassB = GetEffectiveInverseMass(contact.m_particleIndexB);
+			if (distance >= particleDistance || distance == 0.0f || inverseMassA + inverseMassB == 0.0f)
+			{
+				continue;
+			}
+
+			Vec3 normal = displacement / distance;
+			float penetration = distance - particleDistance;
+			proposedPositions[contact.m_particleIndexA] += (inverseMassA / (inverseMassA + inverseMassB)) * penetration * normal;
+			proposedPositions[contact.m_particleIndexB] -= (inverseMassB / (inverseMassA + inverseMassB)) * penetration * normal;
+			m_particles.m_collisionNormals[contact.m_particleIndexA] = normal * -1.0f;
+			m_particles.m_collisionNormals[contact.m_particleIndexB] = normal;
+			m_particles.m_isSelfCollision[contact.m_particleIndexA] = 1;
+			m_particles.m_isSelfCollision[contact.m_particleIndexB] = 1;
+		}
+
+		for (int contactIndex = 0; contactIndex < static_cast<int>(job->m_triangleContacts.size()); contactIndex++)
+		{
+			ClothTriangleContact const& contact = job->m_triangleContacts[contactIndex];
+			int indices[3] = { m_triangleIndices[contact.m_triangleIndex * 3], m_triangleIndices[contact.m_triangleIndex * 3 + 1], m_triangleIndices[contact.m_triangleIndex * 3 + 2] };
+			if (m_sleepIslands.IsParticleAsleep(contact.m_particleIndex) && m_sleepIslands.IsParticleAsleep(indices[0]) &&
+				m_sleepIslands.IsParticleAsleep(indices[1]) && m_sleepIslands.IsParticleAsleep(indices[2]))
+			{
+				continue;
+			}
+			Vec3 const& a = proposedPositions[indices[0]];
+			Vec3 const& b = proposedPositions[indices[1]];
+			Vec3 const& c = proposedPositions[indices[2]];
+			Vec3& particlePosition = proposedPositions[contact.m_particleIndex];
+
+			float barycentrics[3] = {};
+			if (!GetBarycentricCoordinatesOnTriangle(particlePosition, a, b, c, barycentrics[0], barycentrics[1], barycentrics[2]))
+			{
+				continue;
+			}
+			Vec3 normal = CrossProduct3D(b - a, c - a);
+			if (normal.GetLengthSquared() == 0.0f)
+			{
+				continue;
+			}
+			normal = normal.GetNormalized() * contact.m_side;
+
+			Vec3 pointOnTriangle = a * barycentrics[0] + b * barycentrics[1] + c * barycentrics[2];
+			float constraint = DotProduct3D(particlePosition - pointOnTriangle, normal) - m_clothThickness;
+			if (constraint >= 0.0f)
+			{
+				continue;
+			}
+
+			//The particle and the three corners share the correction by inverse mass, corners weighted by how much of the contact point they own
+			float particleInverseMass = GetEffectiveInverseMass(contact.m_particleIndex);
+			float denominator = particleInverseMass;
+			for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+			{
+				denominator += GetEffectiveInverseMass(indices[cornerIndex]) * barycentrics[cornerIndex] * barycentrics[cornerIndex];
+			}
+			if (denominator == 0.0f)
+			{
+				continue;
+			}
+
+			float lambda = -constraint / denominator;
+			particlePosition += (particleInverseMass * lambda) * normal;
+			for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+			{
+				proposedPositions[indices[cornerIndex]] -= (GetEffectiveInverseMass(indices[cornerIndex]) * barycentrics[cornerIndex] * lambda) * normal;
+			}
+			m_particles.m_collisionNormals[contact.m_particleIndex] = normal;
+			m_particles.m_isSelfCollision[contact.m_particleIndex] = 1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+float ClothSimulation3D::GetEffectiveInverseMass(int particleIndex) const
+{
+	if (m_particles.m_isAttached[particleIndex] == 1 || particleIndex == m_grabbedParticleIndex)
+	{
+		return 0.0f;
+	}
+	return m_particles.m_inverseMasses[particleIndex];
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::InitializeTriangles()
+{
+	m_triangleIndices.clear();
+	for (int rowIndex = 0; rowIndex < m_numberOfRows - 1; rowIndex++)
+	{
+		for (int columnIndex = 0; columnIndex < m_numberOfParticlesPerRow - 1; columnIndex++)
+		{
+			int topLeft = rowIndex * m_numberOfParticlesPerRow + columnIndex;
+			int topRight = topLeft + 1;
+			int bottomLeft = topLeft + m_numberOfParticlesPerRow;
+			int bottomRight = bottomLeft + 1;
+
+			m_triangleIndices.push_back(topLeft);
+			m_triangleIndices.push_back(bottomLeft);
+			m_triangleIndices.push_back(topRight);
+
+			m_triangleIndices.push_back(topRight);
+			m_triangleIndices.push_back(bottomLeft);
+			m_triangleIndices.push_back(bottomRight);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::InitializeBendingConstraints()
+{
+	m_bendingConstraints.clear();
+	m_bendingConstraintsRestAngles.clear();
+
+	//Every interior edge of the triangle grid: each quad's diagonal, plus the edges it shares with the quads right of and below it
+	int numQuadsPerRow = m_numberOfParticlesPerRow - 1;
+	int numQuadRows = m_numberOfRows - 1;
+	for (int rowIndex = 0; rowIndex < numQuadRows; rowIndex++)
+	{
+		for (int columnIndex = 0; columnIndex < numQuadsPerRow; columnIndex++)
+		{
+			int topLeft = rowIndex * m_numberOfParticlesPerRow + columnIndex;
+			int topRight = topLeft + 1;
+			int bottomLeft = topLeft + m_numberOfParticlesPerRow;
+			int bottomRight = bottomLeft + 1;
+
+			std::vector<std::vector<int>> edges;
+			edges.push_back({ bottomLeft, topRight, topLeft, bottomRight });
+			if (columnIndex < numQuadsPerRow - 1)
+			{
+				edges.push_back({ topRight, bottomRight, bottomLeft, topRight + 1 });
+			}
+			if (rowIndex < numQuadRows - 1)
+			{
+				edges.push_back({ bottomLeft, bottomRight, topRight, bottomLeft + m_numberOfParticlesPerRow });
+			}
+
+			for (int edgeIndex = 0; edgeIndex < static_cast<int>(edges.size()); edgeIndex++)
+			{
+				Constraint3D constraint;
+				constraint.m_cardinality = 4;
+				constraint.m_constraintEquality = Constraint3DEquality::EQUALITY;
+				constraint.m_constraintType = Constraint3DType::BENDING;
+				constraint.m_stiffnessParameter = 1.0f;
+				constraint.m_indices = edges[edgeIndex];
+
+				m_bendingConstraints.push_back(constraint);
+				m_bendingConstraintsRestAngles.push_back(GetDihedralAngle(m_particles.m_positions[constraint.m_indices[0]], m_particles.m_positions[constraint.m_indices[1]],
+					m_particles.m_positions[constraint.m_indices[2]], m_particles.m_positions[constraint.m_indices[3]]));
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::InitializeLongRangeAttachments()
+{
+	int numParticles = static_cast<int>(m_particles.m_positions.size());
+	m_longRangeAttachmentIndices.assign(numParticles, -1);
+	m_longRangeAttachmentDistances.assign(numParticles, 0.0f);
+
+	std::vector<int> attachedIndices;
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		if (m_particles.m_isAttached[particleIndex] == 1)
+		{
+			attachedIndices.push_back(particleIndex);
+		}
+	}
+
+	//The rest shape is a flat grid with no holes, so the geodesic between two particles is the straight line across the rest grid
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		if (m_particles.m_isAttached[particleIndex] == 1)
+		{
+			continue;
+		}
+
+		int rowIndex = particleIndex / m_numberOfParticlesPerRow;
+		int columnIndex = particleIndex - rowIndex * m_numberOfParticlesPerRow;
+		float nearestDistanceSquared = FLT_MAX;
+		for (int attachedIndex = 0; attachedIndex < static_cast<int>(attachedIndices.size()); attachedIndex++)
+		{
+			int attachedRow = attachedIndices[attachedIndex] / m_numberOfParticlesPerRow;
+			int attachedColumn = attachedIndices[attachedIndex] - attachedRow * m_numberOfParticlesPerRow;
+			float horizontalDistance = static_cast<float>(columnIndex - attachedColumn) * m_originalHorizontalDistance;
+			float verticalDistance = static_cast<float>(rowIndex - attachedRow) * m_originalVerticalDistance;
+			float distanceSquared = horizontalDistance * horizontalDistance + verticalDistance * verticalDistance;
+			if (distanceSquared < nearestDistanceSquared)
+			{
+				nearestDistanceSquared = distanceSquared;
+				m_longRangeAttachmentIndices[particleIndex] = attachedIndices[attachedIndex];
+			}
+		}
+		if (m_longRangeAttachmentIndices[particleIndex] != -1)
+		{
+			m_longRangeAttachmentDistances[particleIndex] = sqrtf(nearestDistanceSquared);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+int ClothSimulation3D::GetNumJobsForParticles(int minParticlesPerJob) const
+{
+	int numParticles = static_cast<int>(m_particles.m_positions.size());
+	int numWorkers = g_theJobSystem != nullptr && !g_theJobSystem->IsQuitting() ? g_theJobSystem->GetNumWorkers() : 0;
+	int numJobs = numParticles / minParticlesPerJob;
+	if (numJobs > numWorkers + 1)
+	{
+		numJobs = numWorkers + 1;
+	}
+	if (numJobs < 1)
+	{
+		numJobs = 1;
+	}
+	return numJobs;
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::InitializeSleepIslands()
+{
+	int patchSize = m_sleepPatchSize > 0 ? m_sleepPatchSize : 1;
+	int numPatchesPerRow = (m_numberOfParticlesPerRow + patchSize - 1) / patchSize;
+	int numPatchRows = (m_numberOfRows + patchSize - 1) / patchSize;
+	std::vector<int> particlePatchIndices(m_particles.m_positions.size());
+	for (int particleIndex = 0; particleIndex < static_cast<int>(particlePatchIndices.size()); particleIndex++)
+	{
+		int row = particleIndex / m_numberOfParticlesPerRow;
+		int column = particleIndex - row * m_numberOfParticlesPerRow;
+		particlePatchIndices[particleIndex] = (row / patchSize) * numPatchesPerRow + column / patchSize;
+	}
+	m_sleepIslands.Initialize(particlePatchIndices, numPatchRows * numPatchesPerRow);
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::InitializeRenderMesh()
+{
+	m_diffuseTexture = m_renderer->CreateOrGetTextureFromFile("Data/Images/Fabric_Diffuse.png");
+	m_normalTexture = m_renderer->CreateOrGetTextureFromFile("Data/Images/Fabric_Normal.png");
+	m_specGlossEmitTexture = m_renderer->CreateOrGetTextureFromFile("Data/Images/Brick_SpecGlossEmit.png");
+
+	//One shared vertex per particle, the uvs stretch the texture once across the whole grid
+	float uStep = m_numberOfParticlesPerRow > 1 ? 1.0f / static_cast<float>(m_numberOfParticlesPerRow - 1) : 0.0f;
+	float vStep = m_numberOfRows > 1 ? 1.0f / static_cast<float>(m_numberOfRows - 1) : 0.0f;
+	m_renderVerts.resize(m_particles.m_positions.size());
+	for (int particleIndex = 0; particleIndex < static_cast<int>(m_renderVerts.size()); particleIndex++)
+	{
+		int rowIndex = particleIndex / m_numberOfParticlesPerRow;
+		int columnIndex = particleIndex - rowIndex * m_numberOfParticlesPerRow;
+		m_renderVerts[particleIndex].m_color = Rgba8::YELLOW;
+		m_renderVerts[particleIndex].m_uvTexCoords = Vec2(static_cast<float>(columnIndex) * uStep, static_cast<float>(rowIndex) * vStep);
+	}
+	UpdateRenderVerts(0, static_cast<int>(m_renderVerts.size()));
+
+	//The triangle list is already laid out as an index list, ints and R32_UINT indices share the same bytes
+	size_t vertexBufferSize = sizeof(Vertex_PCUTBN) * m_renderVerts.size();
+	m_renderVertexBuffer = m_renderer->CreateVertexBuffer(vertexBufferSize, sizeof(Vertex_PCUTBN));
+	m_renderer->CopyCPUToGPU(m_renderVerts.data(), vertexBufferSize, m_renderVertexBuffer);
+	size_t indexBufferSize = sizeof(int) * m_triangleIndices.size();
+	m_renderIndexBuffer = m_renderer->CreateIndexBuffer(indexBufferSize);
+	m_renderer->CopyCPUToGPU(m_triangleIndices.data(), indexBufferSize, m_renderIndexBuffer);
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::UpdateRenderMesh()
+{
+	PROFILE_SCOPE("ClothSimulation3D::UpdateRenderMesh");
+
+	int numParticles = static_cast<int>(m_renderVerts.size());
+	int numJobs = GetNumJobsForParticles(m_minRenderVertsPerJob);
+	while (static_cast<int>(m_renderMeshJobs.size()) < numJobs)
+	{
+		m_renderMeshJobs.push_back(new ClothRenderMeshJob(this));
+	}
+
+	int numParticlesPerJob = (numParticles + numJobs - 1) / numJobs;
+	for (int jobIndex = 0; jobIndex < numJobs; jobIndex++)
+	{
+		ClothRenderMeshJob* job = m_renderMeshJobs[jobIndex];
+		job->m_firstParticleIndex = jobIndex * numParticlesPerJob;
+		job->m_endParticleIndex = job->m_firstParticleIndex + numParticlesPerJob < numParticles ? job->m_firstParticleIndex + numParticlesPerJob : numParticles;
+	}
+	RunJobsAndWait(m_renderMeshJobs, numJobs);
+
+	m_renderer->CopyCPUToGPU(m_renderVerts.data(), sizeof(Vertex_PCUTBN) * m_renderVerts.size(), m_renderVertexBuffer);
+}
+
+//-----------------------------------------------------------------------------------------------
+void ClothSimulation3D::UpdateRenderVerts(int firstParticleIndex, int endParticleIndex)
+{
+	for (int particleIndex = firstParticleIndex; particleIndex < endParticleIndex; particleIndex++)
+	{
+		int rowIndex = particleIndex / m_numberOfParticlesPerRow;
+		int columnIndex = particleIndex - rowIndex * m_numberOfParticlesPerRow;
+
+		//Gather the 3x3 block of render positions around this particle, off grid entries fall back to the center
+		Vec3 neighborhood[3][3];
+		bool isInGrid[3][3] = {};
+		for (int rowOffset = -1; rowOffset <= 1; rowOffset++)
+		{
+			for (int columnOffset = -1; columnOffset <= 1; columnOffset++)
+			{
+				int neighborRow = rowIndex + rowOffset;
+				int neighborColumn = columnIndex + columnOffset;
+				if (neighborRow >= 0 && neighborRow < m_numberOfRows && neighborColumn >= 0 && neighborColumn < m_numberOfParticlesPerRow)
+				{
+					neighborhood[rowOffset + 1][columnOffset + 1] = GetRenderPosition(neighborRow * m_numberOfParticlesPerRow + neighborColumn);
+					isInGrid[rowOffset + 1][columnOffset + 1] = true;
+				}
+			}
+		}
+		for (int rowOffset = 0; rowOffset < 3; rowOffset++)
+		{
+			for (int columnOffset = 0; columnOffset < 3; columnOffset++)
+			{
+				if (!isInGrid[rowOffset][columnOffset])
+				{
+					neighborhood[rowOffset][columnOffset] = neighborhood[1][1];
+				}
+			}
+		}
+
+		//Unnormalized cross products are twice the triangle area, so summing them weights each triangle by its area
+		Vec3 normal;
+		for (int quadRow = 0; quadRow < 2; quadRow++)
+		{
+			for (int quadColumn = 0; quadColumn < 2; quadColumn++)
+			{
+				if (!isInGrid[quadRow][quadColumn] || !isInGrid[quadRow + 1][quadColumn + 1])
+				{
+					continue;
+				}
+
+				Vec3 const& topLeft = neighborhood[quadRow][quadColumn];
+				Vec3 const& topRight = neighborhood[quadRow][quadColumn + 1];
+				Vec3 const& bottomLeft = neighborhood[quadRow + 1][quadColumn];
+				Vec3 const& bottomRight = neighborhood[quadRow + 1][quadColumn + 1];
+				bool isParticleTopLeft = quadRow == 1 && quadColumn == 1;
+				bool isParticleBottomRight = quadRow == 0 && quadColumn == 0;
+				if (!isParticleBottomRight)
+				{
+					normal += CrossProduct3D(bottomLeft - topLeft, topRight - topLeft);
+				}
+				if (!isParticleTopLeft)
+				{
+					normal += CrossProduct3D(bottomLeft - topRight, bottomRight - topRight);
+				}
+			}
+		}
+		normal = normal.GetNormalized();
+
+		//u runs along the columns and v along the rows, matching the uvs laid out at startup
+		Vec3 tangent = neighborhood[1][2] - neighborhood[1][0];
+		tangent -= normal * DotProduct3D(tangent, normal);
+		tangent = tangent.GetNormalized();
+
+		Vertex_PCUTBN& vert = m_renderVerts[particleIndex];
+		vert.m_position = neighborhood[1][1];
+		vert.m_normal = normal;
+		vert.m_tangent = tangent;
+		vert.m_binormal = CrossProduct3D(tangent, normal);
+	}
+}
+
 //-----------------------------------------------------------------------------------------------
 void ClothSimulation3D::RenderDebugVerts() const
 {
@@ -1,6 +1,12 @@
 #pragma once
 #include "Particles3D.hpp"
 #include "Constraint3D.hpp"
+#include "FixedTimestepScheduler.hpp"
+#include "SpatialHash3D.hpp"
+#include "CollisionWorld.hpp"
+#include "SleepIslands.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/AABB3.hpp"
@@ -10,13 +16,67 @@
 //-----------------------------------------------------------------------------------------------
 class	Renderer;
 class   Shader;
+class	Texture;
+class	VertexBuffer;
+class	IndexBuffer;
+class	ClothSimulation3D;
 
 //-----------------------------------------------------------------------------------------------
-class ClothSimulation3D
+struct ClothParticleContact
+{
+	int		m_particleIndexA = -1;
+	int		m_particleIndexB = -1;
+};
+
+//-----------------------------------------------------------------------------------------------
+struct ClothTriangleContact
+{
+	int		m_particleIndex = -1;
+	int		m_triangleIndex = -1;
+	float	m_side = 1.0f;				// side of the triangle the particle started the step on
+};
+
+//-----------------------------------------------------------------------------------------------
+// Self-collision narrowphase for one slice of the particles, each also covering the grid quad it is the top left corner of.
+// Each job fills its own contact lists so the jobs never share writes.
+class ClothSelfCollisionJob : public Job
+{
+public:
+	explicit ClothSelfCollisionJob(ClothSimulation3D* cloth);
+	virtual ~ClothSelfCollisionJob() = default;
+	virtual void Execute() override;
+
+public:
+	ClothSimulation3D*					m_cloth = nullptr;
+	int									m_firstParticleIndex = 0;
+	int									m_endParticleIndex = 0;
+	std::vector<ClothParticleContact>	m_particleContacts;
+	std::vector<ClothTriangleContact>	m_triangleContacts;
+	std::vector<int>					m_queryResults;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Refreshes the render verts for one slice of the particles. Each vertex gathers from its neighbors instead of scattering
+// into them, so slices can be filled in any order.
+class ClothRenderMeshJob : public Job
+{
+public:
+	explicit ClothRenderMeshJob(ClothSimulation3D* cloth);
+	virtual ~ClothRenderMeshJob() = default;
+	virtual void Execute() override;
+
+public:
+	ClothSimulation3D*					m_cloth = nullptr;
+	int									m_firstParticleIndex = 0;
+	int									m_endParticleIndex = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+class ClothSimulation3D : public FixedTimestepSimulation
 {
 public:
 	ClothSimulation3D() {}
-	~ClothSimulation3D() {}
+	~ClothSimulation3D();
 	explicit					ClothSimulation3D(Renderer* renderer, AABB3 worldBounds, Vec2 dimensions, int totalNumberOfParticles,
 								int totalSolverIterations, Vec3 attachPointTopLeft, Vec3 attachPointTopRight);
 
@@ -24,18 +84,40 @@ public:
 	void						Update(float deltaSeconds);
 	void						Render() const;
 
+	//Fixed Timestep Scheduling
+	virtual void				BeginFixedUpdates(int numSubsteps) override;
+	virtual void				SavePreviousState() override;
+	virtual void				FixedUpdate(float fixedDeltaSeconds) override;
+	virtual void				EndFixedUpdates(float interpolationAlpha) override;
+
 	//Misc Public Methods
 	void						UpdateGrabbedClothParticle(int sentParticleIndex, Vec3 const& newPosition);
+	Vec3						GetRenderPosition(int particleIndex) const;
+	void						DetectSelfCollisions(ClothSelfCollisionJob& job) const;
+	void						UpdateRenderVerts(int firstParticleIndex, int endParticleIndex);
+	void						InitializeLongRangeAttachments();						// call again after attaching new particles
 
 protected:
 	void						UpdateCPU();
 	void						UpdateGaussSeidel();
-	void						ProjectConstraintsGaussSeidel();
+	void						ProjectConstraintsGaussSeidel(int solverIndex);
 	void						ProjectDistanceConstraintGaussSeidel(int constraintIndex);
 	void						ProjectWorldBoundsConstraintsSpheresGaussSeidel(int sentParticleIndex);
+	void						ProjectLongRangeAttachmentConstraintsGaussSeidel();
+	void						ProjectBendingConstraintGaussSeidel(int constraintIndex);
+	void						DetectSelfCollisions();
+	void						ProjectSelfCollisionConstraintsGaussSeidel();
+	void						ProjectCollisionWorldConstraintsGaussSeidel();
+	float						GetEffectiveInverseMass(int particleIndex) const;
+	void						InitializeTriangles();
+	void						InitializeBendingConstraints();
+	int							GetNumJobsForParticles(int minParticlesPerJob) const;
+	void						InitializeSleepIslands();
 
 	void						RenderDebugVerts() const;
 	void						InitializeShaders();
+	void						InitializeRenderMesh();
+	void						UpdateRenderMesh();
 
 public:
 	Particles3D					m_particles;
@@ -43,8 +125,29 @@ public:
 public:
 	Renderer*					m_renderer = nullptr;
 	Shader*						m_renderShader = nullptr;
+	Texture*					m_diffuseTexture = nullptr;
+	Texture*					m_normalTexture = nullptr;
+	Texture*					m_specGlossEmitTexture = nullptr;
+	std::vector<Vertex_PCUTBN>	m_renderVerts;									// one per particle, only positions and the tangent space change after startup
+	VertexBuffer*				m_renderVertexBuffer = nullptr;
+	IndexBuffer*				m_renderIndexBuffer = nullptr;
+	std::vector<ClothRenderMeshJob*>	m_renderMeshJobs;
+	int							m_minRenderVertsPerJob = 4096;
 	std::vector<Constraint3D>	m_distanceConstraints;
 	std::vector<float>			m_distanceConstraintsOriginalDists;
+	std::vector<Constraint3D>	m_bendingConstraints;							// shared edge first, then the wing particle of each triangle
+	std::vector<float>			m_bendingConstraintsRestAngles;
+	std::vector<int>			m_longRangeAttachmentIndices;					// nearest attached particle, -1 when nothing was attached
+	std::vector<float>			m_longRangeAttachmentDistances;
+	std::vector<int>			m_triangleIndices;								// three per triangle, two triangles per grid quad
+	SpatialHash3D				m_selfCollisionHash;
+	std::vector<ClothSelfCollisionJob*>	m_selfCollisionJobs;
+	int							m_numActiveSelfCollisionJobs = 0;
+	int							m_minSelfCollisionParticlesPerJob = 2048;
+	int							m_selfCollisionExcludedRings = 2;				// particle pairs this close in the rest grid never collide
+	CollisionWorld*				m_collisionWorld = nullptr;						// optional shared scene, not owned
+	std::vector<CollisionContact>	m_collisionWorldContacts;
+	std::vector<int>				m_collisionWorldHandles;
 	AABB3						m_worldBounds;
 	Vec2						m_dimensions;
 	Vec3						m_grabbedParticlePosition;
@@ -52,7 +155,9 @@ public:
 	int							m_totalNumberOfParticles;
 	int							m_totalSolverIterations;
 	float						m_physicsTimestep = 0.005f;
-	float						m_physicsDebt = 0.0f;
+	FixedTimestepScheduler		m_fixedTimestepScheduler;
+	std::vector<Vec3>			m_previousPositions;
+	float						m_interpolationAlpha = 0.0f;
 	float						m_gravityCoefficient = 9.81f;
 	float						m_dampingCoefficient = 0.99925f;
 	float						m_originalHorizontalDistance = 0.0f;
@@ -62,11 +167,15 @@ public:
 	float						m_kineticFrictionCoefficient = 0.05f;
 	float						m_stretchingCoefficient = 0.0f;
 	float						m_compressionCoefficient = 0.0f;
-	float						m_bendingCoefficient = 0.0f;
+	float						m_bendingCoefficient = 0.0f;							// dihedral bending stiffness, zero skips the bending constraints
 	float						m_simulationStartTime = 0.0f;
 	float						m_simulationEndTime = 0.0f;
 	int							m_numberOfRows;
 	int							m_numberOfParticlesPerRow;
 	bool						m_isDebugCloth = false;
 	bool						m_isSelfCollisionEnabled = false;
-};
\ No newline at end of file
+	bool						m_isLongRangeAttachmentEnabled = true;
+	bool						m_isSleepingEnabled = true;
+	int							m_sleepPatchSize = 8;							// square patches of the particle grid that sleep and wake together
+	SleepIslands				m_sleepIslands;
+};
\ No newline at end of file
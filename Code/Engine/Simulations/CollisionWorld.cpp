@@ -0,0 +1,584 @@
+#include "CollisionWorld.hpp"
+#include "Collider3D.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/CollisionPackets3D.hpp"
+#include "Engine/Math/ConvexHull3D.hpp"
+#include <algorithm>
+#include <cmath>
+
+//-----------------------------------------------------------------------------------------------
+// Objects overlapping more grid cells than this skip the grid and are tested by every query
+constexpr int MAX_GRID_CELLS_PER_OBJECT = 64;
+
+//-----------------------------------------------------------------------------------------------
+static AABB3 GetSweptSphereBounds(Vec3 const& start, Vec3 const& end, float radius)
+{
+	Vec3 mins(start.x < end.x ? start.x : end.x, start.y < end.y ? start.y : end.y, start.z < end.z ? start.z : end.z);
+	Vec3 maxs(start.x > end.x ? start.x : end.x, start.y > end.y ? start.y : end.y, start.z > end.z ? start.z : end.z);
+	Vec3 extents(radius, radius, radius);
+	return AABB3(mins - extents, maxs + extents);
+}
+
+//-----------------------------------------------------------------------------------------------
+CollisionObject::CollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius)
+	:m_boundingDiscCenter(boundingDiscCenter)
+	,m_boundingDiscRadius(boundingDiscRadius)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+SphereCollisionObject::SphereCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Sphere3 const& sphere)
+	:CollisionObject(boundingDiscCenter, boundingDiscRadius)
+	,m_sphere(sphere)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+AABBCollisionObject::AABBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, AABB3 const& aabb)
+	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
+	, m_aabb(aabb) 
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+OBBCollisionObject::OBBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, OBB3 const& obb)
+	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
+	, m_obb(obb) 
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+CapsuleCollisionObject::CapsuleCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Capsule3 const& capsule)
+	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
+	, m_capsule(capsule) 
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+CylinderCollisionObject::CylinderCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Cylinder3 const& cylinder)
+	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
+	, m_cylinder(cylinder) 
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+ConvexHullCollisionObject::ConvexHullCollisionObject(Collider3D* collider)
+	: CollisionObject(Vec3(), 0.0f)
+	, m_collider(collider)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+CollisionWorld::CollisionWorld(float cellSize)
+	:m_grid(cellSize)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+CollisionWorld::~CollisionWorld()
+{
+	for (int handle = 0; handle < static_cast<int>(m_entries.size()); handle++)
+	{
+		delete m_entries[handle].m_object;
+		m_entries[handle].m_object = nullptr;
+	}
+	m_entries.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+int CollisionWorld::AddCollisionObject(CollisionObject* collisionObject, bool isStatic)
+{
+	GUARANTEE_OR_DIE(collisionObject != nullptr, "Cannot add a null object to the CollisionWorld");
+
+	//Resolve the type once here so queries can switch on it
+	CollisionWorldEntry entry;
+	entry.m_object = collisionObject;
+	entry.m_isStatic = isStatic;
+	entry.m_type = collisionObject->GetType();
+	if (entry.m_type == CollisionObjectType::CONVEX_HULL)
+	{
+		ConvexHullCollisionObject* hullObject = static_cast<ConvexHullCollisionObject*>(collisionObject);
+		GUARANTEE_OR_DIE(hullObject->m_collider != nullptr && hullObject->m_collider->m_hull != nullptr && hullObject->m_collider->m_rigidBody != nullptr,
+			"Convex hull collision objects need a collider with a hull and a rigid body");
+		std::vector<Vec3> const& hullPoints = hullObject->m_collider->m_hull->m_boundingPoints;
+		for (int pointIndex = 0; pointIndex < static_cast<int>(hullPoints.size()); pointIndex++)
+		{
+			float pointDistance = hullPoints[pointIndex].GetLength();
+			if (pointDistance > entry.m_boundingRadius)
+			{
+				entry.m_boundingRadius = pointDistance;
+			}
+		}
+	}
+	else if (entry.m_type == CollisionObjectType::COUNT)
+	{
+		ERROR_AND_DIE("Unknown collision object type added to the CollisionWorld");
+	}
+	RefreshBounds(entry);
+
+	int handle = -1;
+	if (!m_freeHandles.empty())
+	{
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+		m_entries[handle] = entry;
+	}
+	else
+	{
+		handle = static_cast<int>(m_entries.size());
+		m_entries.push_back(entry);
+	}
+	m_isGridDirty = true;
+	return handle;
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::RemoveCollisionObject(int handle)
+{
+	if (handle < 0 || handle >= static_cast<int>(m_entries.size()) || m_entries[handle].m_object == nullptr)
+	{
+		ERROR_RECOVERABLE("Tried to remove a CollisionWorld handle that is not in use");
+		return;
+	}
+
+	delete m_entries[handle].m_object;
+	m_entries[handle] = CollisionWorldEntry();
+	m_freeHandles.push_back(handle);
+	m_isGridDirty = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::MarkCollisionObjectMoved(int handle)
+{
+	GUARANTEE_OR_DIE(handle >= 0 && handle < static_cast<int>(m_entries.size()) && m_entries[handle].m_object != nullptr, "Tried to move a CollisionWorld handle that is not in use");
+	RefreshBounds(m_entries[handle]);
+	m_isGridDirty = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::Update()
+{
+	for (int handle = 0; handle < static_cast<int>(m_entries.size()); handle++)
+	{
+		CollisionWorldEntry& entry = m_entries[handle];
+		if (entry.m_object != nullptr && !entry.m_isStatic)
+		{
+			RefreshBounds(entry);
+			m_isGridDirty = true;
+		}
+	}
+
+	if (m_isGridDirty)
+	{
+		RebuildGrid();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+CollisionObject* CollisionWorld::GetCollisionObject(int handle) const
+{
+	return m_entries[handle].m_object;
+}
+
+//-----------------------------------------------------------------------------------------------
+CollisionObjectType CollisionWorld::GetCollisionObjectType(int handle) const
+{
+	return m_entries[handle].m_type;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool CollisionWorld::IsCollisionObjectStatic(int handle) const
+{
+	return m_entries[handle].m_isStatic;
+}
+
+//-----------------------------------------------------------------------------------------------
+int CollisionWorld::GetHandleCount() const
+{
+	return static_cast<int>(m_entries.size());
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::QueryAABB(AABB3 const& bounds, std::vector<int>& out_handles) const
+{
+	out_handles.clear();
+
+	//A query covering a large part of the grid is cheaper as a straight scan
+	if (m_isGridDirty || m_grid.GetNumCellsOverlapped(bounds, MAX_GRID_CELLS_PER_OBJECT) > MAX_GRID_CELLS_PER_OBJECT)
+	{
+		for (int handle = 0; handle < static_cast<int>(m_entries.size()); handle++)
+		{
+			if (m_entries[handle].m_object != nullptr && DoAABB3sOverlap(bounds, m_entries[handle].m_bounds))
+			{
+				out_handles.push_back(handle);
+			}
+		}
+		return;
+	}
+
+	//The grid hands back sorted binned indices, map them to handles in place and drop the ones whose bounds miss
+	m_grid.QueryAABB(bounds, out_handles);
+	int numOverlapping = 0;
+	for (int candidateIndex = 0; candidateIndex < static_cast<int>(out_handles.size()); candidateIndex++)
+	{
+		int handle = m_binnedHandles[out_handles[candidateIndex]];
+		if (DoAABB3sOverlap(bounds, m_entries[handle].m_bounds))
+		{
+			out_handles[numOverlapping] = handle;
+			numOverlapping++;
+		}
+	}
+	out_handles.resize(numOverlapping);
+
+	for (int oversizedIndex = 0; oversizedIndex < static_cast<int>(m_oversizedHandles.size()); oversizedIndex++)
+	{
+		int handle = m_oversizedHandles[oversizedIndex];
+		if (DoAABB3sOverlap(bounds, m_entries[handle].m_bounds))
+		{
+			out_handles.push_back(handle);
+		}
+	}
+	if (numOverlapping != static_cast<int>(out_handles.size()))
+	{
+		std::sort(out_handles.begin(), out_handles.end());
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::QuerySphereContacts(std::vector<Vec3> const& centers, float radius, std::vector<CollisionContact>& out_contacts, std::vector<int>& scratchHandles) const
+{
+	//Callers pass particles in rope or cloth order, so each run of neighbouring queries shares one broadphase lookup
+	//and is tested against every candidate object as a packet
+	std::vector<int>& candidateHandles = scratchHandles;
+	SpherePacket3D spherePacket;
+	ContactPacket3D contactPacket;
+	Vec3 extents(radius, radius, radius);
+	int numQueries = static_cast<int>(centers.size());
+	for (int firstQueryIndex = 0; firstQueryIndex < numQueries; firstQueryIndex += COLLISION_PACKET_WIDTH)
+	{
+		spherePacket.m_numSpheres = std::min(COLLISION_PACKET_WIDTH, numQueries - firstQueryIndex);
+		AABB3 packetBounds(centers[firstQueryIndex], centers[firstQueryIndex]);
+		for (int laneIndex = 0; laneIndex < spherePacket.m_numSpheres; laneIndex++)
+		{
+			Vec3 const& center = centers[firstQueryIndex + laneIndex];
+			spherePacket.SetSphere(laneIndex, center, radius);
+			packetBounds.m_mins = Vec3(std::min(packetBounds.m_mins.x, center.x), std::min(packetBounds.m_mins.y, center.y), std::min(packetBounds.m_mins.z, center.z));
+			packetBounds.m_maxs = Vec3(std::max(packetBounds.m_maxs.x, center.x), std::max(packetBounds.m_maxs.y, center.y), std::max(packetBounds.m_maxs.z, center.z));
+		}
+		QueryAABB(AABB3(packetBounds.m_mins - extents, packetBounds.m_maxs + extents), candidateHandles);
+
+		for (int candidateIndex = 0; candidateIndex < static_cast<int>(candidateHandles.size()); candidateIndex++)
+		{
+			int handle = candidateHandles[candidateIndex];
+			CollisionWorldEntry const& entry = m_entries[handle];
+			int collidingLanes = 0;
+			switch (entry.m_type)
+			{
+				case CollisionObjectType::SPHERE:
+				{
+					Sphere3 const& sphere = static_cast<SphereCollisionObject const*>(entry.m_object)->m_sphere;
+					collidingLanes = GetSpherePacketContactsVsSphere3D(spherePacket, sphere.m_center, sphere.m_radius, contactPacket);
+					break;
+				}
+				case CollisionObjectType::CAPSULE:
+				{
+					collidingLanes = GetSpherePacketContactsVsCapsule3D(spherePacket, static_cast<CapsuleCollisionObject const*>(entry.m_object)->m_capsule, contactPacket);
+					break;
+				}
+				case CollisionObjectType::AABB:
+				{
+					collidingLanes = GetSpherePacketContactsVsAABB3D(spherePacket, static_cast<AABBCollisionObject const*>(entry.m_object)->m_aabb, contactPacket);
+					break;
+				}
+				case CollisionObjectType::OBB:
+				{
+					collidingLanes = GetSpherePacketContactsVsOBB3D(spherePacket, static_cast<OBBCollisionObject const*>(entry.m_object)->m_obb, contactPacket);
+					break;
+				}
+				case CollisionObjectType::CYLINDER:
+				{
+					collidingLanes = GetSpherePacketContactsVsCylinder3D(spherePacket, static_cast<CylinderCollisionObject const*>(entry.m_object)->m_cylinder, contactPacket);
+					break;
+				}
+				default:
+				{
+					//Convex hulls stay on the one sphere at a time path
+					for (int laneIndex = 0; laneIndex < spherePacket.m_numSpheres; laneIndex++)
+					{
+						CollisionContact contact;
+						if (GetSphereContact(handle, centers[firstQueryIndex + laneIndex], radius, contact.m_correction))
+						{
+							contact.m_queryIndex = firstQueryIndex + laneIndex;
+							contact.m_objectHandle = handle;
+							out_contacts.push_back(contact);
+						}
+					}
+					continue;
+				}
+			}
+
+			for (int laneIndex = 0; laneIndex < spherePacket.m_numSpheres; laneIndex++)
+			{
+				if ((collidingLanes & (1 << laneIndex)) != 0)
+				{
+					CollisionContact contact;
+					contact.m_queryIndex = firstQueryIndex + laneIndex;
+					contact.m_objectHandle = handle;
+					contact.m_correction = contactPacket.GetCorrection(laneIndex);
+					out_contacts.push_back(contact);
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::QueryPointContacts(std::vector<Vec3> const& points, std::vector<CollisionContact>& out_contacts, std::vector<int>& scratchHandles) const
+{
+	QuerySphereContacts(points, 0.0f, out_contacts, scratchHandles);
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::QueryCapsuleContacts(std::vector<Capsule3> const& capsules, std::vector<CollisionContact>& out_contacts, std::vector<int>& scratchHandles) const
+{
+	std::vector<int>& candidateHandles = scratchHandles;
+	for (int queryIndex = 0; queryIndex < static_cast<int>(capsules.size()); queryIndex++)
+	{
+		Capsule3 const& capsule = capsules[queryIndex];
+		QueryAABB(GetSweptSphereBounds(capsule.m_bone.m_start, capsule.m_bone.m_end, capsule.m_radius), candidateHandles);
+		for (int candidateIndex = 0; candidateIndex < static_cast<int>(candidateHandles.size()); candidateIndex++)
+		{
+			CollisionContact contact;
+			if (GetCapsuleContact(candidateHandles[candidateIndex], capsule, contact.m_correction, contact.m_endCorrection))
+			{
+				contact.m_queryIndex = queryIndex;
+				contact.m_objectHandle = candidateHandles[candidateIndex];
+				out_contacts.push_back(contact);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+bool CollisionWorld::GetSphereContact(int handle, Vec3 const& center, float radius, Vec3& out_correction) const
+{
+	CollisionWorldEntry const& entry = m_entries[handle];
+	Vec3 pushedCenter = center;
+	bool isColliding = false;
+	switch (entry.m_type)
+	{
+		case CollisionObjectType::SPHERE:
+		{
+			SphereCollisionObject const* sphereObject = static_cast<SphereCollisionObject const*>(entry.m_object);
+			isColliding = PushSphereOutOfFixedSphere3D(pushedCenter, radius, sphereObject->m_sphere.m_center, sphereObject->m_sphere.m_radius);
+			break;
+		}
+		case CollisionObjectType::CAPSULE:
+		{
+			isColliding = PushSphereOutOfFixedCapsule3D(pushedCenter, radius, static_cast<CapsuleCollisionObject const*>(entry.m_object)->m_capsule);
+			break;
+		}
+		case CollisionObjectType::AABB:
+		{
+			isColliding = PushSphereOutOfFixedAABB3D(pushedCenter, radius, static_cast<AABBCollisionObject const*>(entry.m_object)->m_aabb);
+			break;
+		}
+		case CollisionObjectType::OBB:
+		{
+			isColliding = PushDiscOutOfFixedOBB3D(pushedCenter, radius, static_cast<OBBCollisionObject const*>(entry.m_object)->m_obb);
+			break;
+		}
+		case CollisionObjectType::CYLINDER:
+		{
+			isColliding = PushSphereOutOfFixedCylinder3D(pushedCenter, radius, static_cast<CylinderCollisionObject const*>(entry.m_object)->m_cylinder);
+			break;
+		}
+		case CollisionObjectType::CONVEX_HULL:
+		{
+			//Push out through the face the sphere is least inside of, close enough near edges for particle sized spheres
+			Collider3D const* collider = static_cast<ConvexHullCollisionObject const*>(entry.m_object)->m_collider;
+			Vec3 localCenter = entry.m_worldToLocal.TransformVectorQuantity3D(center - collider->m_rigidBody->m_position);
+			std::vector<Plane3D> const& planes = collider->m_hull->m_boundingPlanes;
+			float largestAltitude = -FLT_MAX;
+			int largestPlaneIndex = -1;
+			for (int planeIndex = 0; planeIndex < static_cast<int>(planes.size()); planeIndex++)
+			{
+				float altitude = DotProduct3D(planes[planeIndex].m_normal, localCenter) - planes[planeIndex].m_distanceFromOrigin;
+				if (altitude > largestAltitude)
+				{
+					largestAltitude = altitude;
+					largestPlaneIndex = planeIndex;
+				}
+			}
+			if (largestPlaneIndex != -1 && largestAltitude < radius)
+			{
+				Vec3 localCorrection = planes[largestPlaneIndex].m_normal * (radius - largestAltitude);
+				pushedCenter += collider->m_rigidBody->m_rotation.TransformVectorQuantity3D(localCorrection);
+				isColliding = true;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	out_correction = pushedCenter - center;
+	return isColliding;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool CollisionWorld::GetCapsuleContact(int handle, Capsule3 const& capsule, Vec3& out_startCorrection, Vec3& out_endCorrection) const
+{
+	CollisionWorldEntry const& entry = m_entries[handle];
+	Capsule3 pushedCapsule = capsule;
+	bool isColliding = false;
+	switch (entry.m_type)
+	{
+		case CollisionObjectType::SPHERE:
+		{
+			SphereCollisionObject const* sphereObject = static_cast<SphereCollisionObject const*>(entry.m_object);
+			isColliding = PushCapsuleOutOfFixedSphere3D(pushedCapsule, sphereObject->m_sphere.m_center, sphereObject->m_sphere.m_radius);
+			break;
+		}
+		case CollisionObjectType::CAPSULE:
+		{
+			isColliding = PushCapsuleOutOfFixedCapsule3D(pushedCapsule, static_cast<CapsuleCollisionObject const*>(entry.m_object)->m_capsule);
+			break;
+		}
+		case CollisionObjectType::AABB:
+		{
+			isColliding = PushCapsuleOutOfFixedAABB3D(pushedCapsule, static_cast<AABBCollisionObject const*>(entry.m_object)->m_aabb);
+			break;
+		}
+		case CollisionObjectType::OBB:
+		{
+			isColliding = PushCapsuleOutOfFixedOBB3D(pushedCapsule, static_cast<OBBCollisionObject const*>(entry.m_object)->m_obb);
+			break;
+		}
+		case CollisionObjectType::CYLINDER:
+		{
+			isColliding = PushCapsuleOutOfFixedCylinder3D(pushedCapsule, static_cast<CylinderCollisionObject const*>(entry.m_object)->m_cylinder);
+			break;
+		}
+		case CollisionObjectType::CONVEX_HULL:
+		{
+			//Face normals only: pick the face the capsule is least inside of, then push each end out of it by its own depth
+			Collider3D const* collider = static_cast<ConvexHullCollisionObject const*>(entry.m_object)->m_collider;
+			Vec3 localStart = entry.m_worldToLocal.TransformVectorQuantity3D(capsule.m_bone.m_start - collider->m_rigidBody->m_position);
+			Vec3 localEnd = entry.m_worldToLocal.TransformVectorQuantity3D(capsule.m_bone.m_end - collider->m_rigidBody->m_position);
+			std::vector<Plane3D> const& planes = collider->m_hull->m_boundingPlanes;
+			float largestSeparation = -FLT_MAX;
+			int largestPlaneIndex = -1;
+			for (int planeIndex = 0; planeIndex < static_cast<int>(planes.size()); planeIndex++)
+			{
+				float startAltitude = DotProduct3D(planes[planeIndex].m_normal, localStart) - planes[planeIndex].m_distanceFromOrigin;
+				float endAltitude = DotProduct3D(planes[planeIndex].m_normal, localEnd) - planes[planeIndex].m_distanceFromOrigin;
+				float separation = (startAltitude < endAltitude ? startAltitude : endAltitude) - capsule.m_radius;
+				if (separation > largestSeparation)
+				{
+					largestSeparation = separation;
+					largestPlaneIndex = planeIndex;
+				}
+			}
+			if (largestPlaneIndex != -1 && largestSeparation < 0.0f)
+			{
+				Plane3D const& plane = planes[largestPlaneIndex];
+				float startDepth = capsule.m_radius - (DotProduct3D(plane.m_normal, localStart) - plane.m_distanceFromOrigin);
+				float endDepth = capsule.m_radius - (DotProduct3D(plane.m_normal, localEnd) - plane.m_distanceFromOrigin);
+				Vec3 worldNormal = collider->m_rigidBody->m_rotation.TransformVectorQuantity3D(plane.m_normal);
+				pushedCapsule.m_bone.m_start += worldNormal * (startDepth > 0.0f ? startDepth : 0.0f);
+				pushedCapsule.m_bone.m_end += worldNormal * (endDepth > 0.0f ? endDepth : 0.0f);
+				isColliding = true;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	out_startCorrection = pushedCapsule.m_bone.m_start - capsule.m_bone.m_start;
+	out_endCorrection = pushedCapsule.m_bone.m_end - capsule.m_bone.m_end;
+	return isColliding;
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::RefreshBounds(CollisionWorldEntry& entry)
+{
+	switch (entry.m_type)
+	{
+		case CollisionObjectType::SPHERE:
+		{
+			Sphere3 const& sphere = static_cast<SphereCollisionObject*>(entry.m_object)->m_sphere;
+			Vec3 extents(sphere.m_radius, sphere.m_radius, sphere.m_radius);
+			entry.m_bounds = AABB3(sphere.m_center - extents, sphere.m_center + extents);
+			break;
+		}
+		case CollisionObjectType::CAPSULE:
+		{
+			Capsule3 const& capsule = static_cast<CapsuleCollisionObject*>(entry.m_object)->m_capsule;
+			entry.m_bounds = GetSweptSphereBounds(capsule.m_bone.m_start, capsule.m_bone.m_end, capsule.m_radius);
+			break;
+		}
+		case CollisionObjectType::AABB:
+		{
+			entry.m_bounds = static_cast<AABBCollisionObject*>(entry.m_object)->m_aabb;
+			break;
+		}
+		case CollisionObjectType::OBB:
+		{
+			OBB3 const& obb = static_cast<OBBCollisionObject*>(entry.m_object)->m_obb;
+			Vec3 extents;
+			extents.x = fabsf(obb.m_iBasisNormal.x) * obb.m_halfDimensions.x + fabsf(obb.m_jBasisNormal.x) * obb.m_halfDimensions.y + fabsf(obb.m_kBasisNormal.x) * obb.m_halfDimensions.z;
+			extents.y = fabsf(obb.m_iBasisNormal.y) * obb.m_halfDimensions.x + fabsf(obb.m_jBasisNormal.y) * obb.m_halfDimensions.y + fabsf(obb.m_kBasisNormal.y) * obb.m_halfDimensions.z;
+			extents.z = fabsf(obb.m_iBasisNormal.z) * obb.m_halfDimensions.x + fabsf(obb.m_jBasisNormal.z) * obb.m_halfDimensions.y + fabsf(obb.m_kBasisNormal.z) * obb.m_halfDimensions.z;
+			entry.m_bounds = AABB3(obb.m_center - extents, obb.m_center + extents);
+			break;
+		}
+		case CollisionObjectType::CYLINDER:
+		{
+			Cylinder3 const& cylinder = static_cast<CylinderCollisionObject*>(entry.m_object)->m_cylinder;
+			entry.m_bounds = GetSweptSphereBounds(cylinder.m_start, cylinder.m_end, cylinder.m_radius);
+			break;
+		}
+		case CollisionObjectType::CONVEX_HULL:
+		{
+			RigidBody3D const* rigidBody = static_cast<ConvexHullCollisionObject*>(entry.m_object)->m_collider->m_rigidBody;
+			Vec3 extents(entry.m_boundingRadius, entry.m_boundingRadius, entry.m_boundingRadius);
+			entry.m_bounds = AABB3(rigidBody->m_position - extents, rigidBody->m_position + extents);
+			entry.m_worldToLocal = rigidBody->m_rotation.GetOrthonormalInverse();
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void CollisionWorld::RebuildGrid()
+{
+	m_binnedBounds.clear();
+	m_binnedHandles.clear();
+	m_oversizedHandles.clear();
+	for (int handle = 0; handle < static_cast<int>(m_entries.size()); handle++)
+	{
+		CollisionWorldEntry const& entry = m_entries[handle];
+		if (entry.m_object == nullptr)
+		{
+			continue;
+		}
+
+		if (m_grid.GetNumCellsOverlapped(entry.m_bounds, MAX_GRID_CELLS_PER_OBJECT) > MAX_GRID_CELLS_PER_OBJECT)
+		{
+			m_oversizedHandles.push_back(handle);
+		}
+		else
+		{
+			m_binnedBounds.push_back(entry.m_bounds);
+			m_binnedHandles.push_back(handle);
+		}
+	}
+
+	m_grid.Build(m_binnedBounds);
+	m_isGridDirty = false;
+}
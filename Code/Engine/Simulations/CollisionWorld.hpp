@@ -0,0 +1,178 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Mat33.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/OBB3.hpp"
+#include "Engine/Math/Capsule3.hpp"
+#include "Engine/Math/Sphere3.hpp"
+#include "Engine/Math/Cylinder3.hpp"
+#include "SpatialHash3D.hpp"
+#include <vector>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------------------------
+struct	Collider3D;
+
+//-----------------------------------------------------------------------------------------------
+enum class CollisionObjectType
+{
+	SPHERE,
+	CAPSULE,
+	AABB,
+	OBB,
+	CYLINDER,
+	CONVEX_HULL,
+	COUNT
+};
+
+//-----------------------------------------------------------------------------------------------
+//Polymorphic Collision Objects, the rope compute shaders read these as raw structs so their layout must not change
+struct CollisionObject
+{
+public:
+	CollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius);
+	virtual ~CollisionObject() {}
+	virtual CollisionObjectType GetType() const { return CollisionObjectType::COUNT; }	// virtual so the struct layout stays the same
+	
+public:
+	uint64_t	m_macroBitRegions = 0;
+	uint64_t	m_microBitRegions = 0;
+	Vec3		m_boundingDiscCenter;
+	float		m_boundingDiscRadius = 0.0f;
+};
+struct SphereCollisionObject : public CollisionObject
+{
+public:
+	SphereCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Sphere3 const& sphere);
+	~SphereCollisionObject() {}
+	virtual CollisionObjectType GetType() const override { return CollisionObjectType::SPHERE; }
+
+public:
+	Sphere3 m_sphere;
+};
+struct AABBCollisionObject : public CollisionObject
+{
+public:
+	AABBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, AABB3 const& aabb);
+	~AABBCollisionObject() {}
+	virtual CollisionObjectType GetType() const override { return CollisionObjectType::AABB; }
+
+public:
+	AABB3 m_aabb;
+};
+struct OBBCollisionObject : public CollisionObject
+{
+public:
+	OBBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, OBB3 const& obb);
+	~OBBCollisionObject() {}
+	virtual CollisionObjectType GetType() const override { return CollisionObjectType::OBB; }
+	
+public:
+	OBB3 m_obb;
+};
+struct CapsuleCollisionObject : public CollisionObject
+{
+public:
+	CapsuleCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Capsule3 const& capsule);
+	~CapsuleCollisionObject() {}
+	virtual CollisionObjectType GetType() const override { return CollisionObjectType::CAPSULE; }
+		
+public:
+	Capsule3	m_capsule;
+	Vec3		m_collisionNormalStart;
+	Vec3		m_jacobiCorrectionStart;
+	int			m_jacobiConstraintTotalStart;
+	int			m_isCollidingStart;
+	Vec3		m_collisionNormalEnd;
+	Vec3		m_jacobiCorrectionEnd;
+	int			m_jacobiConstraintTotalEnd;
+	int			m_isCollidingEnd;
+};
+struct CylinderCollisionObject : public CollisionObject
+{
+public:
+	CylinderCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Cylinder3 const& cylinder);
+	~CylinderCollisionObject() {}
+	virtual CollisionObjectType GetType() const override { return CollisionObjectType::CYLINDER; }
+	
+public:
+	Cylinder3 m_cylinder;
+};
+
+struct ConvexHullCollisionObject : public CollisionObject
+{
+public:
+	ConvexHullCollisionObject(Collider3D* collider);
+	~ConvexHullCollisionObject() {}
+	virtual CollisionObjectType GetType() const override { return CollisionObjectType::CONVEX_HULL; }
+
+public:
+	Collider3D*	m_collider = nullptr;			// the hull is in its rigid body's local space, so it follows the body around
+};
+
+//-----------------------------------------------------------------------------------------------
+struct CollisionContact
+{
+	int		m_queryIndex = -1;
+	int		m_objectHandle = -1;
+	Vec3	m_correction;						// moves the query sphere, or the start of the query capsule, out of the object
+	Vec3	m_endCorrection;					// capsule queries only
+};
+
+//-----------------------------------------------------------------------------------------------
+struct CollisionWorldEntry
+{
+	CollisionObject*		m_object = nullptr;
+	CollisionObjectType		m_type = CollisionObjectType::COUNT;
+	AABB3					m_bounds;
+	Mat33					m_worldToLocal;				// convex hulls only
+	float					m_boundingRadius = 0.0f;	// convex hulls only, around the rigid body position
+	bool					m_isStatic = true;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Owns the collision geometry every simulation collides against, so each obstacle is stored and indexed once.
+// Objects are binned into a SpatialHash3D by their bounds, objects too big for the grid are checked by every query.
+// The owner calls Update once per step, before any simulation queries it, to refresh the bounds of dynamic objects;
+// PhysicsScene3D does this at the end of every fixed substep once its rigid bodies have moved.
+// Queries are const and can be made from several threads once Update has run.
+class CollisionWorld
+{
+public:
+	CollisionWorld() {}
+	explicit CollisionWorld(float cellSize);
+	~CollisionWorld();
+
+	//Objects, the world takes ownership and hands back a handle that stays valid until the object is removed
+	int						AddCollisionObject(CollisionObject* collisionObject, bool isStatic = true);
+	void					RemoveCollisionObject(int handle);
+	void					MarkCollisionObjectMoved(int handle);
+	void					Update();
+	CollisionObject*		GetCollisionObject(int handle) const;
+	CollisionObjectType		GetCollisionObjectType(int handle) const;
+	bool					IsCollisionObjectStatic(int handle) const;
+	int						GetHandleCount() const;
+
+	//Queries, batched ones append to out_contacts and tag each contact with the index of the query that produced it.
+	//Sphere queries run eight at a time, so within each group of eight queries the contacts come out grouped by object.
+	//scratchHandles is the caller's candidate list, kept by the caller so solver loops and worker threads never allocate
+	void					QueryAABB(AABB3 const& bounds, std::vector<int>& out_handles) const;
+	void					QuerySphereContacts(std::vector<Vec3> const& centers, float radius, std::vector<CollisionContact>& out_contacts, std::vector<int>& scratchHandles) const;
+	void					QueryPointContacts(std::vector<Vec3> const& points, std::vector<CollisionContact>& out_contacts, std::vector<int>& scratchHandles) const;
+	void					QueryCapsuleContacts(std::vector<Capsule3> const& capsules, std::vector<CollisionContact>& out_contacts, std::vector<int>& scratchHandles) const;
+	bool					GetSphereContact(int handle, Vec3 const& center, float radius, Vec3& out_correction) const;
+	bool					GetCapsuleContact(int handle, Capsule3 const& capsule, Vec3& out_startCorrection, Vec3& out_endCorrection) const;
+
+protected:
+	void					RefreshBounds(CollisionWorldEntry& entry);
+	void					RebuildGrid();
+
+protected:
+	std::vector<CollisionWorldEntry>	m_entries;
+	std::vector<int>					m_freeHandles;
+	SpatialHash3D						m_grid;					// item i of the grid is m_binnedHandles[i]
+	std::vector<AABB3>					m_binnedBounds;
+	std::vector<int>					m_binnedHandles;
+	std::vector<int>					m_oversizedHandles;
+	bool								m_isGridDirty = true;
+};
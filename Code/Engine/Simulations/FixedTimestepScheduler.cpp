@@ -0,0 +1,148 @@
+#include "FixedTimestepScheduler.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cmath>
+
+//-----------------------------------------------------------------------------------------------
+FixedTimestepScheduler::FixedTimestepScheduler(FixedTimestepSchedulerConfig const& config)
+	:m_config(config)
+{
+	GUARANTEE_OR_DIE(m_config.m_fixedTimestep > 0.0f, "Fixed timestep must be greater than zero");
+	GUARANTEE_OR_DIE(m_config.m_maxSubstepsPerFrame >= 0, "Max substeps per frame can not be negative");
+	GUARANTEE_OR_DIE(m_config.m_maxCatchUpSeconds > 0.0f, "Max catch up time must be greater than zero");
+}
+
+//-----------------------------------------------------------------------------------------------
+void FixedTimestepScheduler::AddSimulation(FixedTimestepSimulation* simulation)
+{
+	for (int simulationIndex = 0; simulationIndex < static_cast<int>(m_simulations.size()); simulationIndex++)
+	{
+		if (m_simulations[simulationIndex] == simulation)
+		{
+			return;
+		}
+	}
+	m_simulations.push_back(simulation);
+}
+
+//-----------------------------------------------------------------------------------------------
+bool FixedTimestepScheduler::RemoveSimulation(FixedTimestepSimulation* simulation)
+{
+	for (int simulationIndex = 0; simulationIndex < static_cast<int>(m_simulations.size()); simulationIndex++)
+	{
+		if (m_simulations[simulationIndex] == simulation)
+		{
+			m_simulations.erase(m_simulations.begin() + simulationIndex);
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+int FixedTimestepScheduler::Update()
+{
+	GUARANTEE_OR_DIE(m_config.m_clock != nullptr, "FixedTimestepScheduler::Update() needs a clock, pass deltaSeconds instead");
+	return Update(m_config.m_clock->GetDeltaSeconds());
+}
+
+//-----------------------------------------------------------------------------------------------
+int FixedTimestepScheduler::Update(float deltaSeconds)
+{
+	double fixedTimestep = static_cast<double>(m_config.m_fixedTimestep);
+	if (deltaSeconds > 0.0f)
+	{
+		m_accumulatedSeconds += static_cast<double>(deltaSeconds);
+	}
+
+	int numSubsteps = static_cast<int>(m_accumulatedSeconds / fixedTimestep);
+	int maxSubstepsPerFrame = GetMaxSubstepsPerFrame();
+	if (numSubsteps > maxSubstepsPerFrame)
+	{
+		//Spiral of death protection, running every owed step would only make the next frame slower
+		m_numDroppedSubsteps += numSubsteps - maxSubstepsPerFrame;
+		numSubsteps = maxSubstepsPerFrame;
+		m_accumulatedSeconds = fmod(m_accumulatedSeconds, fixedTimestep);
+	}
+	else
+	{
+		m_accumulatedSeconds -= static_cast<double>(numSubsteps) * fixedTimestep;
+	}
+
+	m_numSubstepsLastFrame = numSubsteps;
+	m_interpolationAlpha = static_cast<float>(m_accumulatedSeconds / fixedTimestep);
+	if (m_interpolationAlpha >= 1.0f)
+	{
+		m_interpolationAlpha = 0.99999f;
+	}
+
+	int numSimulations = static_cast<int>(m_simulations.size());
+	for (int simulationIndex = 0; simulationIndex < numSimulations; simulationIndex++)
+	{
+		m_simulations[simulationIndex]->BeginFixedUpdates(numSubsteps);
+	}
+
+	//Every simulation finishes a step before any of them starts the next, so they all share each step boundary
+	for (int substepIndex = 0; substepIndex < numSubsteps; substepIndex++)
+	{
+		bool isLastSubstep = (substepIndex == numSubsteps - 1);
+		for (int simulationIndex = 0; simulationIndex < numSimulations; simulationIndex++)
+		{
+			if (isLastSubstep)
+			{
+				m_simulations[simulationIndex]->SavePreviousState();
+			}
+			m_simulations[simulationIndex]->FixedUpdate(m_config.m_fixedTimestep);
+		}
+	}
+
+	for (int simulationIndex = 0; simulationIndex < numSimulations; simulationIndex++)
+	{
+		m_simulations[simulationIndex]->EndFixedUpdates(m_interpolationAlpha);
+	}
+
+	return numSubsteps;
+}
+
+//-----------------------------------------------------------------------------------------------
+void FixedTimestepScheduler::Reset()
+{
+	m_accumulatedSeconds = 0.0;
+	m_interpolationAlpha = 0.0f;
+	m_numSubstepsLastFrame = 0;
+	m_numDroppedSubsteps = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+void FixedTimestepScheduler::SetFixedTimestep(float fixedTimestep)
+{
+	GUARANTEE_OR_DIE(fixedTimestep > 0.0f, "Fixed timestep must be greater than zero");
+	m_config.m_fixedTimestep = fixedTimestep;
+}
+
+//-----------------------------------------------------------------------------------------------
+void FixedTimestepScheduler::SetMaxSubstepsPerFrame(int maxSubstepsPerFrame)
+{
+	GUARANTEE_OR_DIE(maxSubstepsPerFrame >= 0, "Max substeps per frame can not be negative");
+	m_config.m_maxSubstepsPerFrame = maxSubstepsPerFrame;
+}
+
+//-----------------------------------------------------------------------------------------------
+void FixedTimestepScheduler::SetMaxCatchUpSeconds(float maxCatchUpSeconds)
+{
+	GUARANTEE_OR_DIE(maxCatchUpSeconds > 0.0f, "Max catch up time must be greater than zero");
+	m_config.m_maxCatchUpSeconds = maxCatchUpSeconds;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Tied to time rather than a fixed count so a small timestep does not turn every slow frame into slow motion
+int FixedTimestepScheduler::GetMaxSubstepsPerFrame() const
+{
+	if (m_config.m_maxSubstepsPerFrame > 0)
+	{
+		return m_config.m_maxSubstepsPerFrame;
+	}
+
+	int maxSubstepsPerFrame = static_cast<int>(m_config.m_maxCatchUpSeconds / m_config.m_fixedTimestep + 0.5f);
+	return maxSubstepsPerFrame > 1 ? maxSubstepsPerFrame : 1;
+}
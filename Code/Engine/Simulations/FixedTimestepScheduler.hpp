@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+class Clock;
+
+//-----------------------------------------------------------------------------------------------
+// Anything stepped by a FixedTimestepScheduler. Every frame the scheduler calls BeginFixedUpdates once,
+// FixedUpdate once per substep (interleaved with every other simulation it owns), then EndFixedUpdates once.
+class FixedTimestepSimulation
+{
+public:
+	virtual ~FixedTimestepSimulation() {}
+	virtual void	BeginFixedUpdates(int) {}
+	virtual void	SavePreviousState() {}
+	virtual void	FixedUpdate(float fixedDeltaSeconds) = 0;
+	virtual void	EndFixedUpdates(float) {}
+};
+
+//-----------------------------------------------------------------------------------------------
+struct FixedTimestepSchedulerConfig
+{
+	Clock*	m_clock = nullptr;						// Update() reads this clock, so pause and time scale carry over
+	float	m_fixedTimestep = 0.0005f;
+	float	m_maxCatchUpSeconds = 0.1f;				// most simulated time one frame may run, any debt past this is dropped
+	int		m_maxSubstepsPerFrame = 0;				// 0 derives the cap from m_maxCatchUpSeconds and the fixed timestep
+};
+
+//-----------------------------------------------------------------------------------------------
+class FixedTimestepScheduler
+{
+public:
+	FixedTimestepScheduler() {}
+	explicit FixedTimestepScheduler(FixedTimestepSchedulerConfig const& config);
+	~FixedTimestepScheduler() {}
+
+	void	AddSimulation(FixedTimestepSimulation* simulation);
+	bool	RemoveSimulation(FixedTimestepSimulation* simulation);
+
+	int		Update();
+	int		Update(float deltaSeconds);
+	void	Reset();
+
+	void	SetClock(Clock* clock) { m_config.m_clock = clock; }
+	void	SetFixedTimestep(float fixedTimestep);
+	void	SetMaxSubstepsPerFrame(int maxSubstepsPerFrame);
+	void	SetMaxCatchUpSeconds(float maxCatchUpSeconds);
+	float	GetFixedTimestep() const { return m_config.m_fixedTimestep; }
+	int		GetMaxSubstepsPerFrame() const;
+
+	//How far the render time sits between the previous and the current fixed step, in [0, 1)
+	float	GetInterpolationAlpha() const { return m_interpolationAlpha; }
+	int		GetNumSubstepsLastFrame() const { return m_numSubstepsLastFrame; }
+	int		GetNumDroppedSubsteps() const { return m_numDroppedSubsteps; }
+
+protected:
+	FixedTimestepSchedulerConfig			m_config;
+	std::vector<FixedTimestepSimulation*>	m_simulations;
+	double									m_accumulatedSeconds = 0.0;
+	float									m_interpolationAlpha = 0.0f;
+	int										m_numSubstepsLastFrame = 0;
+	int										m_numDroppedSubsteps = 0;
+};
@@ -3,11 +3,61 @@
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Math/LineSegment2.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Simulations/Spring2D.hpp"
-#include "Engine/Simulations/Particle2D.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Math/Capsule2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+//-----------------------------------------------------------------------------------------------
+static void AddToBlock(ImplicitBlock2D& block, ImplicitBlock2D const& addThis, float scale)
+{
+	block.m_xx += addThis.m_xx * scale;
+	block.m_xy += addThis.m_xy * scale;
+	block.m_yx += addThis.m_yx * scale;
+	block.m_yy += addThis.m_yy * scale;
+}
+
+//-----------------------------------------------------------------------------------------------
+static Vec2 MultiplyBlock(ImplicitBlock2D const& block, Vec2 const& vector)
+{
+	return Vec2(block.m_xx * vector.x + block.m_xy * vector.y, block.m_yx * vector.x + block.m_yy * vector.y);
+}
+
+//-----------------------------------------------------------------------------------------------
+static ImplicitBlock2D MultiplyBlocks(ImplicitBlock2D const& a, ImplicitBlock2D const& b)
+{
+	ImplicitBlock2D result;
+	result.m_xx = a.m_xx * b.m_xx + a.m_xy * b.m_yx;
+	result.m_xy = a.m_xx * b.m_xy + a.m_xy * b.m_yy;
+	result.m_yx = a.m_yx * b.m_xx + a.m_yy * b.m_yx;
+	result.m_yy = a.m_yx * b.m_xy + a.m_yy * b.m_yy;
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+static ImplicitBlock2D GetTransposedBlock(ImplicitBlock2D const& block)
+{
+	ImplicitBlock2D result;
+	result.m_xx = block.m_xx;
+	result.m_xy = block.m_yx;
+	result.m_yx = block.m_xy;
+	result.m_yy = block.m_yy;
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+static ImplicitBlock2D GetInverseBlock(ImplicitBlock2D const& block)
+{
+	float determinant = block.m_xx * block.m_yy - block.m_xy * block.m_yx;
+	GUARANTEE_OR_DIE(determinant != 0.0f, "Implicit Euler system is singular, check for zero mass particles");
+	float inverseDeterminant = 1.0f / determinant;
+	ImplicitBlock2D result;
+	result.m_xx = block.m_yy * inverseDeterminant;
+	result.m_xy = -block.m_xy * inverseDeterminant;
+	result.m_yx = -block.m_yx * inverseDeterminant;
+	result.m_yy = block.m_xx * inverseDeterminant;
+	return result;
+}
 
 //-----------------------------------------------------------------------------------------------
 MassSpringRope2D::MassSpringRope2D(IntegrationMethod integrationMethod, int totalPoints, 
@@ -19,44 +69,7 @@ MassSpringRope2D::MassSpringRope2D(IntegrationMethod integrationMethod, int tota
 	,m_ropeStartPosition(start)
 	,m_ropeEndPosition(end)
 {
-	Vec2 displacement = end - start;
-	Vec2 direction = displacement.GetNormalized();
-	float magnitude = displacement.GetLength();
-	float lengthPerSpring = magnitude / (totalPoints - 1);
-	float massPerPoint = (massOfEachPoint / totalPoints);
-	float inverseMassPerPoint = 1.0f / massPerPoint;
-	Particle2D* particleA = nullptr;
-	Particle2D* particleB = nullptr;
-	for (int particleIndex = 0; particleIndex < totalPoints; particleIndex++)
-	{
-		if (particleIndex == 0)
-		{
-			continue;
-		}
-		else if (particleIndex == 1)
-		{
-			particleA = new Particle2D(massPerPoint, inverseMassPerPoint, start +
-				(direction * ((particleIndex - 1) * lengthPerSpring)),
-				Vec2(), true);
-			m_particles.push_back(particleA);
-		}
-		else
-		{
-			particleA = particleB;
-		}
-
-		particleB = new Particle2D(massPerPoint, inverseMassPerPoint, start +
-			(direction * (particleIndex * lengthPerSpring)),
-			Vec2());
-		m_particles.push_back(particleB);
-		/*if (particleIndex == totalPoints - 1)
-		{
-			particleB->m_isLocked = true;
-		}*/
-		Spring2D* spring = new Spring2D(particleA, particleB, m_stiffnessConstant, 
-			(particleA->m_position - particleB->m_position).GetLength());
-		m_springs.push_back(spring);		
-	}
+	AddRope(totalPoints, massOfEachPoint, start, end);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -83,33 +96,64 @@ void MassSpringRope2D::Shutdown()
 //-----------------------------------------------------------------------------------------------
 void MassSpringRope2D::Update(float deltaSeconds)
 {
-	//float startTime = float(GetCurrentTimeSeconds());
-	m_physicsDebt += deltaSeconds;
-	while (m_physicsDebt > m_physicsTimestep)
+	m_fixedTimestepScheduler.SetFixedTimestep(m_physicsTimestep);
+	m_fixedTimestepScheduler.AddSimulation(this);
+	m_fixedTimestepScheduler.Update(deltaSeconds);
+}
+
+//-----------------------------------------------------------------------------------------------
+void MassSpringRope2D::SavePreviousState()
+{
+	m_previousPositions = m_particles.m_positions;
+}
+
+//-----------------------------------------------------------------------------------------------
+void MassSpringRope2D::FixedUpdate(float fixedDeltaSeconds)
+{
+	m_physicsTimestep = fixedDeltaSeconds;
+	if (m_integrationMethod == IntegrationMethod::EXPLICIT_EULER)
 	{
-		if (m_integrationMethod == IntegrationMethod::EXPLICIT_EULER)
-		{
-			UpdateExplicitEuler();
-		}
-		else if (m_integrationMethod == IntegrationMethod::SEMI_IMPLICIT_EULER)
-		{
-			UpdateSemiImplicitEuler();
-		}
-		else if (m_integrationMethod == IntegrationMethod::MIDPOINT)
-		{
-			UpdateMidparticle();
-		}
-		else if (m_integrationMethod == IntegrationMethod::RUNGE_KUTTA)
-		{
-			UpdateRungeKutta();
-		}
-		else if (m_integrationMethod == IntegrationMethod::VERLET)
-		{
-			UpdateVerlet();
-		}
-		m_physicsDebt -= m_physicsTimestep;
+		UpdateExplicitEuler();
 	}
-	//float endTime = float(GetCurrentTimeSeconds());
+	else if (m_integrationMethod == IntegrationMethod::SEMI_IMPLICIT_EULER)
+	{
+		UpdateSemiImplicitEuler();
+	}
+	else if (m_integrationMethod == IntegrationMethod::MIDPOINT)
+	{
+		UpdateMidparticle();
+	}
+	else if (m_integrationMethod == IntegrationMethod::RUNGE_KUTTA)
+	{
+		UpdateRungeKutta();
+	}
+	else if (m_integrationMethod == IntegrationMethod::VERLET)
+	{
+		UpdateVerlet();
+	}
+	else if (m_integrationMethod == IntegrationMethod::IMPLICIT_EULER)
+	{
+		UpdateImplicitEuler();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void MassSpringRope2D::EndFixedUpdates(float interpolationAlpha)
+{
+	m_interpolationAlpha = interpolationAlpha;
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec2 MassSpringRope2D::GetRenderPosition(int particleIndex) const
+{
+	Vec2 const& currentPosition = m_particles.m_positions[particleIndex];
+	if (m_previousPositions.size() != m_particles.m_positions.size())
+	{
+		return currentPosition;
+	}
+
+	Vec2 const& previousPosition = m_previousPositions[particleIndex];
+	return previousPosition + (currentPosition - previousPosition) * m_interpolationAlpha;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -118,21 +162,18 @@ void MassSpringRope2D::Render(std::vector<Vertex_PCU>& verts) const
 	verts.reserve(m_springs.size() * size_t(6));
 	for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
 	{
-		Spring2D*const spring = m_springs[springIndex];
-		if (spring != nullptr)
+		Spring2D const& spring = m_springs[springIndex];
+		LineSegment2 line;
+		line.m_start = GetRenderPosition(spring.m_particleIndexA);
+		line.m_end = GetRenderPosition(spring.m_particleIndexB);
+		Capsule2 capsule;
+		capsule.m_bone = line;
+		capsule.m_radius = m_ropeRadius;
+		AddVertsForCapsule2D(verts, capsule, Rgba8(142, 89, 60, 255));
+		if (m_isDebugMode)
 		{
-			LineSegment2 line;
-			line.m_start = spring->m_particleA->m_position;
-			line.m_end = spring->m_particleB->m_position;
-			Capsule2 capsule;
-			capsule.m_bone = line;
-			capsule.m_radius = m_ropeRadius;
-			AddVertsForCapsule2D(verts, capsule, Rgba8(142, 89, 60, 255));
-			if (m_isDebugMode)
-			{
-				AddVertsForDisc2D(verts, spring->m_particleA->m_position, m_ropeRadius * 3.0f, Rgba8::WHITE);
-				AddVertsForDisc2D(verts, spring->m_particleB->m_position, m_ropeRadius * 3.0f, Rgba8::WHITE);
-			}
+			AddVertsForDisc2D(verts, line.m_start, m_ropeRadius * 3.0f, Rgba8::WHITE);
+			AddVertsForDisc2D(verts, line.m_end, m_ropeRadius * 3.0f, Rgba8::WHITE);
 		}
 	}
 }
@@ -140,224 +181,357 @@ void MassSpringRope2D::Render(std::vector<Vertex_PCU>& verts) const
 //-----------------------------------------------------------------------------------------------
 void MassSpringRope2D::UpdateExplicitEuler()
 {
-	for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
+	AccumulateSpringForces();
+
+	int numParticles = m_particles.GetNumParticles();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 	{
-		Spring2D*& spring = m_springs[springIndex];
-		if (spring != nullptr)
+		if (m_particles.m_isLocked[particleIndex] == 0)
 		{
-			//Calculate forces using hookes law
-			Vec2 displacement = spring->m_particleB->m_position - spring->m_particleA->m_position;
-			float magnitude = displacement.GetLength();
-			Vec2 direction = displacement.GetNormalized();
-			float length = magnitude - spring->m_initialLength;
-			Vec2 springForceA = spring->m_stiffness * direction * length;
-			Vec2 springForceB = springForceA * -1.0f;
-			Vec2 dampingForce = (spring->m_particleB->m_velocity - spring->m_particleA->m_velocity) * m_dampingConstant;
-
-			spring->m_particleA->m_forces += (springForceA + dampingForce);
-			spring->m_particleB->m_forces += (springForceB - dampingForce);
+			//Apply Forces Through Explicit Euler Integration
+			Vec2 acceleration = (m_particles.m_forces[particleIndex] + Vec2(0.0f, -m_gravityConstant));
+			m_particles.m_positions[particleIndex] += m_particles.m_velocities[particleIndex] * m_physicsTimestep;
+			m_particles.m_velocities[particleIndex] +=  acceleration * m_physicsTimestep;
 		}
+
+		m_particles.m_forces[particleIndex] = Vec2();
 	}
+}
 
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+//-----------------------------------------------------------------------------------------------
+void MassSpringRope2D::UpdateSemiImplicitEuler()
+{
+	AccumulateSpringForces();
+
+	int numParticles = m_particles.GetNumParticles();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 	{
-		Particle2D*& particle = m_particles[particleIndex];
-		if (particle != nullptr)
+		if (m_particles.m_isLocked[particleIndex] == 0)
 		{
-			if (particle->m_isLocked == false)
-			{
-				//Apply Forces Through Explicit Euler Integration
-				Vec2 acceleration = (particle->m_forces + Vec2(0.0f, -m_gravityConstant));
-				particle->m_position += particle->m_velocity * m_physicsTimestep;
-				particle->m_velocity +=  acceleration * m_physicsTimestep;
-			}
-
-			particle->m_forces = Vec2();
+			//Apply Forces Through Semi-Implicit Euler Integration
+			Vec2 acceleration = (m_particles.m_forces[particleIndex] * m_particles.m_inverseMasses[particleIndex] + Vec2(0.0f, -m_gravityConstant));
+			m_particles.m_velocities[particleIndex] += acceleration * m_physicsTimestep;
+			m_particles.m_positions[particleIndex] += m_particles.m_velocities[particleIndex] * m_physicsTimestep;
 		}
+
+		m_particles.m_forces[particleIndex] = Vec2();
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void MassSpringRope2D::UpdateSemiImplicitEuler()
+void MassSpringRope2D::UpdateMidparticle()
 {
-	for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
+	AccumulateSpringForces();
+
+	int numParticles = m_particles.GetNumParticles();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 	{
-		Spring2D*& spring = m_springs[springIndex];
-		if (spring != nullptr)
+		if (m_particles.m_isLocked[particleIndex] == 0)
 		{
-			//Calculate forces using hookes law
-			Vec2 displacement = spring->m_particleB->m_position - spring->m_particleA->m_position;
-			float magnitude = displacement.GetLength();
-			Vec2 direction = displacement.GetNormalized();
-			float length = magnitude - spring->m_initialLength;
-			Vec2 springForceA = spring->m_stiffness * direction * length;
-			Vec2 springForceB = springForceA * -1.0f;
-			Vec2 dampingForce = (spring->m_particleB->m_velocity - spring->m_particleA->m_velocity) * m_dampingConstant;
-
-			spring->m_particleA->m_forces += (springForceA + dampingForce);
-			spring->m_particleB->m_forces += (springForceB - dampingForce);
+			Vec2 acceleration = (m_particles.m_forces[particleIndex] * m_particles.m_inverseMasses[particleIndex] + Vec2(0.0f, -m_gravityConstant));
+			Vec2& velocity = m_particles.m_velocities[particleIndex];
+			Vec2 originalVelocity = velocity;
+			velocity += acceleration * m_physicsTimestep;
+			m_particles.m_positions[particleIndex] += 0.5f * (velocity + originalVelocity) * m_physicsTimestep;
 		}
+
+		m_particles.m_forces[particleIndex] = Vec2();
 	}
+}
 
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+//-----------------------------------------------------------------------------------------------
+void MassSpringRope2D::UpdateRungeKutta()
+{
+	AccumulateSpringForces();
+
+	int numParticles = m_particles.GetNumParticles();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 	{
-		Particle2D*& particle = m_particles[particleIndex];
-		if (particle != nullptr)
+		if (m_particles.m_isLocked[particleIndex] == 0)
 		{
-			if (particle->m_isLocked == false)
-			{
-				//Apply Forces Through Semi-Implicit Euler Integration
-				Vec2 acceleration = (particle->m_forces * particle->m_inverseMass + Vec2(0.0f, -m_gravityConstant));
-				particle->m_velocity += acceleration * m_physicsTimestep;
-				particle->m_position += particle->m_velocity * m_physicsTimestep;
-			}
-
-			particle->m_forces = Vec2();
+			Vec2 acceleration = (m_particles.m_forces[particleIndex] * m_particles.m_inverseMasses[particleIndex] + Vec2(0.0f, -m_gravityConstant));
+			Vec2& velocity = m_particles.m_velocities[particleIndex];
+			Vec2 k1 = velocity + acceleration * m_physicsTimestep;
+			Vec2 k2 = 0.5f * (velocity + k1);
+			Vec2 k3 = 0.5f * (velocity + k2);
+			Vec2 k4 = velocity + k3;
+			m_particles.m_positions[particleIndex] += ((k1 + 2 * k2 + 2 * k3 + k4) / 6.0f) * m_physicsTimestep;
+			velocity = k1;
 		}
+
+		m_particles.m_forces[particleIndex] = Vec2();
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void MassSpringRope2D::UpdateMidparticle()
+void MassSpringRope2D::UpdateVerlet()
 {
-	for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
+	int numParticles = m_particles.GetNumParticles();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 	{
-		Spring2D*& spring = m_springs[springIndex];
-		if (spring != nullptr)
+		if (m_particles.m_isLocked[particleIndex] == 0)
 		{
-			//Calculate forces using hookes law
-			Vec2 displacement = spring->m_particleB->m_position - spring->m_particleA->m_position;
-			float magnitude = displacement.GetLength();
-			Vec2 direction = displacement.GetNormalized();
-			float length = magnitude - spring->m_initialLength;
-			Vec2 springForceA = spring->m_stiffness * direction * length;
-			Vec2 springForceB = springForceA * -1.0f;
-			Vec2 dampingForce = (spring->m_particleB->m_velocity - spring->m_particleA->m_velocity) * m_dampingConstant;
-
-			spring->m_particleA->m_forces += (springForceA + dampingForce);
-			spring->m_particleB->m_forces += (springForceB - dampingForce);
+			//Position manipulation only Verlet integration
+			Vec2 acceleration = (Vec2(0.0f, -m_gravityConstant));
+			Vec2& position = m_particles.m_positions[particleIndex];
+			Vec2 tempPosition = position;
+			position += (position - m_particles.m_verletPreviousPositions[particleIndex]) * (1.0f - m_dampingConstant) +
+				(acceleration * (m_physicsTimestep * m_physicsTimestep));
+			m_particles.m_verletPreviousPositions[particleIndex] = tempPosition;
 		}
+
+		m_particles.m_forces[particleIndex] = Vec2();
 	}
 
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+	
+	for(int sovlerIndex = 0; sovlerIndex < m_verletSolverIterations; sovlerIndex++)
 	{
-		Particle2D*& particle = m_particles[particleIndex];
-		if (particle != nullptr)
+		for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
 		{
-			if (particle->m_isLocked == false)
+			//Calculates direction and overflow along with weight constants
+			Spring2D const& spring = m_springs[springIndex];
+			Vec2& positionA = m_particles.m_positions[spring.m_particleIndexA];
+			Vec2& positionB = m_particles.m_positions[spring.m_particleIndexB];
+			bool isLockedA = m_particles.m_isLocked[spring.m_particleIndexA] != 0;
+			bool isLockedB = m_particles.m_isLocked[spring.m_particleIndexB] != 0;
+			Vec2 displacement = positionB - positionA;
+			float distanceConstraint = displacement.GetLength() - spring.m_initialLength;
+			Vec2 direction = displacement.GetNormalized();
+
+			if (isLockedA == false && isLockedB == false)
+			{
+				float inverseMassA = m_particles.m_inverseMasses[spring.m_particleIndexA];
+				float inverseMassB = m_particles.m_inverseMasses[spring.m_particleIndexB];
+				float particleAWeightConstant = (inverseMassA / (inverseMassA + inverseMassB));
+				float particleBWeightConstant = (inverseMassB / (inverseMassA + inverseMassB));
+
+				Vec2 deltaPointA = particleAWeightConstant * distanceConstraint * direction;
+				Vec2 deltaPointB = particleBWeightConstant * distanceConstraint * direction;
+
+				positionA += deltaPointA;
+				positionB -= deltaPointB;
+			}
+			else if (isLockedA && isLockedB == false)
+			{
+				Vec2 deltaPointB = distanceConstraint * direction;
+				positionB -= deltaPointB;
+			}
+			else if (isLockedA == false && isLockedB)
 			{
-				Vec2 acceleration = (particle->m_forces * particle->m_inverseMass + Vec2(0.0f, -m_gravityConstant));
-				Vec2 originalVelocity = particle->m_velocity;
-				particle->m_velocity += acceleration * m_physicsTimestep;
-				particle->m_position += 0.5f * (particle->m_velocity + originalVelocity) * m_physicsTimestep;
+				Vec2 deltaPointA = distanceConstraint * direction;
+				positionA += deltaPointA;
 			}
+		}
+	}
+}
 
-			particle->m_forces = Vec2();
+//-----------------------------------------------------------------------------------------------
+int MassSpringRope2D::AddRope(int totalPoints, float massOfEachPoint, Vec2 start, Vec2 end)
+{
+	GUARANTEE_OR_DIE(totalPoints >= 2, "A MassSpringRope2D rope needs at least two points");
+	Vec2 displacement = end - start;
+	Vec2 direction = displacement.GetNormalized();
+	float magnitude = displacement.GetLength();
+	float lengthPerSpring = magnitude / (totalPoints - 1);
+	float massPerPoint = (massOfEachPoint / totalPoints);
+	float inverseMassPerPoint = 1.0f / massPerPoint;
+	int firstParticleIndex = m_particles.GetNumParticles();
+	m_particles.Reserve(firstParticleIndex + totalPoints);
+	m_springs.reserve(m_springs.size() + totalPoints - 1);
+	for (int pointIndex = 0; pointIndex < totalPoints; pointIndex++)
+	{
+		int particleIndex = m_particles.AddParticle(massPerPoint, inverseMassPerPoint, start + (direction * (pointIndex * lengthPerSpring)), Vec2(), pointIndex == 0);
+		if (pointIndex != 0)
+		{
+			m_springs.push_back(Spring2D(particleIndex - 1, particleIndex, m_stiffnessConstant, lengthPerSpring));
 		}
 	}
+	return firstParticleIndex;
 }
 
 //-----------------------------------------------------------------------------------------------
-void MassSpringRope2D::UpdateRungeKutta()
+void MassSpringRope2D::AccumulateSpringForces()
 {
 	for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
 	{
-		Spring2D*& spring = m_springs[springIndex];
-		if (spring != nullptr)
-		{
-			//Calculate forces using hookes law
-			Vec2 displacement = spring->m_particleB->m_position - spring->m_particleA->m_position;
-			float magnitude = displacement.GetLength();
-			Vec2 direction = displacement.GetNormalized();
-			float length = magnitude - spring->m_initialLength;
-			Vec2 springForceA = spring->m_stiffness * direction * length;
-			Vec2 springForceB = springForceA * -1.0f;
-			Vec2 dampingForce = (spring->m_particleB->m_velocity - spring->m_particleA->m_velocity) * m_dampingConstant;
+		//Calculate forces using hookes law
+		Spring2D const& spring = m_springs[springIndex];
+		Vec2 displacement = m_particles.m_positions[spring.m_particleIndexB] - m_particles.m_positions[spring.m_particleIndexA];
+		float magnitude = displacement.GetLength();
+		Vec2 direction = displacement.GetNormalized();
+		float length = magnitude - spring.m_initialLength;
+		Vec2 springForceA = spring.m_stiffness * direction * length;
+		Vec2 springForceB = springForceA * -1.0f;
+		Vec2 dampingForce = (m_particles.m_velocities[spring.m_particleIndexB] - m_particles.m_velocities[spring.m_particleIndexA]) * m_dampingConstant;
+
+		m_particles.m_forces[spring.m_particleIndexA] += (springForceA + dampingForce);
+		m_particles.m_forces[spring.m_particleIndexB] += (springForceB - dampingForce);
+	}
+}
 
-			spring->m_particleA->m_forces += (springForceA + dampingForce);
-			spring->m_particleB->m_forces += (springForceB - dampingForce);
-		}
+//-----------------------------------------------------------------------------------------------
+void MassSpringRope2D::UpdateImplicitEuler()
+{
+	//Solve (M - h*D - h^2*K) dv = h*(f + M*g) + h^2*K*v, then step positions with the new velocities
+	m_implicitStartPositions = m_particles.m_positions;
+	m_implicitStartVelocities = m_particles.m_velocities;
+	AssembleImplicitEulerSystem(true);
+	SolveImplicitEulerSystem();
+
+	int numParticles = m_particles.GetNumParticles();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		m_particles.m_velocities[particleIndex] = m_implicitStartVelocities[particleIndex] + m_implicitVelocityChanges[particleIndex];
+		m_particles.m_positions[particleIndex] = m_implicitStartPositions[particleIndex] + m_particles.m_velocities[particleIndex] * m_physicsTimestep;
 	}
 
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+	if (m_isImplicitNewtonRefinementEnabled)
 	{
-		Particle2D*& particle = m_particles[particleIndex];
-		if (particle != nullptr)
+		//One Newton step on M*(v - v0) - h*f(x0 + h*v, v) = 0, linearized around the first solve
+		AssembleImplicitEulerSystem(false);
+		for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 		{
-			if (particle->m_isLocked == false)
+			if (m_particles.m_isLocked[particleIndex] == 0)
 			{
-				Vec2 acceleration = (particle->m_forces * particle->m_inverseMass + Vec2(0.0f, -m_gravityConstant));
-				Vec2 k1 = particle->m_velocity + acceleration * m_physicsTimestep;
-				Vec2 k2 = 0.5f * (particle->m_velocity + k1);
-				Vec2 k3 = 0.5f * (particle->m_velocity + k2);
-				Vec2 k4 = particle->m_velocity + k3;
-				particle->m_position += ((k1 + 2 * k2 + 2 * k3 + k4) / 6.0f) * m_physicsTimestep;
-				particle->m_velocity = k1;
+				m_implicitRightHandSides[particleIndex] -= (m_particles.m_velocities[particleIndex] - m_implicitStartVelocities[particleIndex]) * m_particles.m_masses[particleIndex];
 			}
-
-			particle->m_forces = Vec2();
 		}
+		SolveImplicitEulerSystem();
+		for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+		{
+			m_particles.m_velocities[particleIndex] += m_implicitVelocityChanges[particleIndex];
+			m_particles.m_positions[particleIndex] = m_implicitStartPositions[particleIndex] + m_particles.m_velocities[particleIndex] * m_physicsTimestep;
+		}
+	}
+
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		m_particles.m_forces[particleIndex] = Vec2();
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void MassSpringRope2D::UpdateVerlet()
+void MassSpringRope2D::AssembleImplicitEulerSystem(bool addStiffnessVelocityTerm)
 {
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+	int numParticles = m_particles.GetNumParticles();
+	float h = m_physicsTimestep;
+	m_implicitDiagonalBlocks.resize(numParticles);
+	m_implicitUpperBlocks.resize(numParticles);
+	m_implicitRightHandSides.resize(numParticles);
+
+	//Mass on the diagonal, external forces on the right hand side
+	Vec2 gravity = m_isGravityEnabled ? Vec2(0.0f, -m_gravityConstant) : Vec2();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 	{
-		Particle2D*& particle = m_particles[particleIndex];
-		if (particle != nullptr)
+		float mass = m_particles.m_masses[particleIndex];
+		ImplicitBlock2D& diagonalBlock = m_implicitDiagonalBlocks[particleIndex];
+		diagonalBlock = ImplicitBlock2D();
+		diagonalBlock.m_xx = mass;
+		diagonalBlock.m_yy = mass;
+		m_implicitUpperBlocks[particleIndex] = ImplicitBlock2D();
+		m_implicitRightHandSides[particleIndex] = gravity * (mass * h);
+	}
+
+	for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
+	{
+		Spring2D const& spring = m_springs[springIndex];
+		int lowerIndex = spring.m_particleIndexA < spring.m_particleIndexB ? spring.m_particleIndexA : spring.m_particleIndexB;
+		int upperIndex = spring.m_particleIndexA < spring.m_particleIndexB ? spring.m_particleIndexB : spring.m_particleIndexA;
+		GUARANTEE_OR_DIE(upperIndex == lowerIndex + 1, "IMPLICIT_EULER only supports springs between neighbouring particles");
+
+		Vec2 const& positionA = m_particles.m_positions[spring.m_particleIndexA];
+		Vec2 const& positionB = m_particles.m_positions[spring.m_particleIndexB];
+		Vec2 const& velocityA = m_particles.m_velocities[spring.m_particleIndexA];
+		Vec2 const& velocityB = m_particles.m_velocities[spring.m_particleIndexB];
+		Vec2 displacement = positionB - positionA;
+		float length = displacement.GetLength();
+		Vec2 direction = displacement.GetNormalized();
+
+		//Same hookes law and damping as the explicit integrators
+		Vec2 springForceA = spring.m_stiffness * direction * (length - spring.m_initialLength);
+		Vec2 dampingForce = (velocityB - velocityA) * m_dampingConstant;
+		m_implicitRightHandSides[spring.m_particleIndexA] += (springForceA + dampingForce) * h;
+		m_implicitRightHandSides[spring.m_particleIndexB] -= (springForceA + dampingForce) * h;
+
+		//Force jacobian k*(d*dT + (1 - L/l)*(I - d*dT)), the transverse term is clamped so compressed springs stay definite
+		float transverseScale = length > 0.0f ? GetClamped(1.0f - spring.m_initialLength / length, 0.0f, 1.0f) : 0.0f;
+		ImplicitBlock2D stiffnessBlock;
+		stiffnessBlock.m_xx = spring.m_stiffness * (direction.x * direction.x + transverseScale * (1.0f - direction.x * direction.x));
+		stiffnessBlock.m_xy = spring.m_stiffness * (direction.x * direction.y - transverseScale * direction.x * direction.y);
+		stiffnessBlock.m_yx = stiffnessBlock.m_xy;
+		stiffnessBlock.m_yy = spring.m_stiffness * (direction.y * direction.y + transverseScale * (1.0f - direction.y * direction.y));
+		if (addStiffnessVelocityTerm)
 		{
-			if (particle->m_isLocked == false)
-			{
-				//Position manipulation only Verlet integration
-				Vec2 acceleration = (Vec2(0.0f, -m_gravityConstant));
-				Vec2 tempPosition = particle->m_position;
-				particle->m_position += (particle->m_position - particle->m_previousPosition) * (1.0f - m_dampingConstant) +
-					(acceleration * (m_physicsTimestep * m_physicsTimestep));
-				particle->m_previousPosition = tempPosition;
-			}
+			Vec2 stiffnessVelocityTerm = MultiplyBlock(stiffnessBlock, velocityB - velocityA) * (h * h);
+			m_implicitRightHandSides[spring.m_particleIndexA] += stiffnessVelocityTerm;
+			m_implicitRightHandSides[spring.m_particleIndexB] -= stiffnessVelocityTerm;
+		}
+
+		//h*c*I + h^2*Ks goes on both diagonals and is subtracted from the coupling block
+		ImplicitBlock2D couplingBlock = stiffnessBlock;
+		couplingBlock.m_xx *= h * h;
+		couplingBlock.m_xy *= h * h;
+		couplingBlock.m_yx *= h * h;
+		couplingBlock.m_yy *= h * h;
+		couplingBlock.m_xx += h * m_dampingConstant;
+		couplingBlock.m_yy += h * m_dampingConstant;
+		AddToBlock(m_implicitDiagonalBlocks[spring.m_particleIndexA], couplingBlock, 1.0f);
+		AddToBlock(m_implicitDiagonalBlocks[spring.m_particleIndexB], couplingBlock, 1.0f);
+		AddToBlock(m_implicitUpperBlocks[lowerIndex], couplingBlock, -1.0f);
+	}
 
-			particle->m_forces = Vec2();
+	//Locked particles keep their velocity, so their rows become dv = 0
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		if (m_particles.m_isLocked[particleIndex] == 0)
+		{
+			continue;
 		}
+
+		ImplicitBlock2D& diagonalBlock = m_implicitDiagonalBlocks[particleIndex];
+		diagonalBlock = ImplicitBlock2D();
+		diagonalBlock.m_xx = 1.0f;
+		diagonalBlock.m_yy = 1.0f;
+		m_implicitRightHandSides[particleIndex] = Vec2();
 	}
+}
 
-	
-	for(int sovlerIndex = 0; sovlerIndex < m_verletSolverIterations; sovlerIndex++)
+//-----------------------------------------------------------------------------------------------
+void MassSpringRope2D::SolveImplicitEulerSystem()
+{
+	int numParticles = m_particles.GetNumParticles();
+	m_implicitModifiedUpperBlocks.resize(numParticles);
+	m_implicitVelocityChanges.resize(numParticles);
+	if (numParticles == 0)
 	{
-		for (int springIndex = 0; springIndex < m_springs.size(); springIndex++)
+		return;
+	}
+
+	//Forward elimination, overwriting the right hand sides with the modified ones.
+	//A locked particle's row is the identity, so its coupling blocks are left out.
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		ImplicitBlock2D pivotBlock = m_implicitDiagonalBlocks[particleIndex];
+		Vec2 rightHandSide = m_implicitRightHandSides[particleIndex];
+		bool isLocked = m_particles.m_isLocked[particleIndex] != 0;
+		if (particleIndex > 0 && !isLocked)
 		{
-			Spring2D*& spring = m_springs[springIndex];
-			if (spring != nullptr)
-			{
-				//Calculates direction and overflow along with weight constants
-				Vec2 displacement = spring->m_particleB->m_position - spring->m_particleA->m_position;
-				float distanceConstraint = displacement.GetLength() - spring->m_initialLength;
-				Vec2 direction = displacement.GetNormalized();
-
-				if (spring->m_particleA->m_isLocked == false && spring->m_particleB->m_isLocked == false)
-				{
-					float particleAWeightConstant = (spring->m_particleA->m_inverseMass / (spring->m_particleA->m_inverseMass + spring->m_particleB->m_inverseMass));
-					float particleBWeightConstant = (spring->m_particleB->m_inverseMass / (spring->m_particleA->m_inverseMass + spring->m_particleB->m_inverseMass));
-
-					Vec2 deltaPointA = particleAWeightConstant * distanceConstraint * direction;
-					Vec2 deltaPointB = particleBWeightConstant * distanceConstraint * direction;
-
-					spring->m_particleA->m_position += deltaPointA;
-					spring->m_particleB->m_position -= deltaPointB;
-				}
-				else if (spring->m_particleA->m_isLocked == true && spring->m_particleB->m_isLocked == false)
-				{
-					Vec2 deltaPointB = distanceConstraint * direction;
-					spring->m_particleB->m_position -= deltaPointB;
-				}
-				else if (spring->m_particleA->m_isLocked == false && spring->m_particleB->m_isLocked == true)
-				{
-					Vec2 deltaPointA = distanceConstraint * direction;
-					spring->m_particleA->m_position += deltaPointA;
-				}
-			}
+			ImplicitBlock2D lowerBlock = GetTransposedBlock(m_implicitUpperBlocks[particleIndex - 1]);
+			AddToBlock(pivotBlock, MultiplyBlocks(lowerBlock, m_implicitModifiedUpperBlocks[particleIndex - 1]), -1.0f);
+			rightHandSide -= MultiplyBlock(lowerBlock, m_implicitRightHandSides[particleIndex - 1]);
 		}
+
+		ImplicitBlock2D inversePivotBlock = GetInverseBlock(pivotBlock);
+		ImplicitBlock2D upperBlock = isLocked ? ImplicitBlock2D() : m_implicitUpperBlocks[particleIndex];
+		m_implicitModifiedUpperBlocks[particleIndex] = MultiplyBlocks(inversePivotBlock, upperBlock);
+		m_implicitRightHandSides[particleIndex] = MultiplyBlock(inversePivotBlock, rightHandSide);
 	}
 
+	//Back substitution
+	m_implicitVelocityChanges[numParticles - 1] = m_implicitRightHandSides[numParticles - 1];
+	for (int particleIndex = numParticles - 2; particleIndex >= 0; particleIndex--)
+	{
+		m_implicitVelocityChanges[particleIndex] = m_implicitRightHandSides[particleIndex] -
+			MultiplyBlock(m_implicitModifiedUpperBlocks[particleIndex], m_implicitVelocityChanges[particleIndex + 1]);
+	}
 }
@@ -1,11 +1,12 @@
 #pragma once
 #include "Engine/Math/Vec2.hpp"
+#include "FixedTimestepScheduler.hpp"
+#include "Engine/Simulations/Particles2D.hpp"
+#include "Engine/Simulations/Spring2D.hpp"
 #include <vector>
 
 //-----------------------------------------------------------------------------------------------
 struct Vertex_PCU;
-struct Spring2D;
-struct Particle2D;
 
 //-----------------------------------------------------------------------------------------------
 enum IntegrationMethod
@@ -15,11 +16,22 @@ enum IntegrationMethod
 	MIDPOINT,
 	RUNGE_KUTTA,
 	VERLET,
+	IMPLICIT_EULER,
 	COUNT
 };
 
 //-----------------------------------------------------------------------------------------------
-class MassSpringRope2D
+// 2x2 block of the implicit Euler system, row major
+struct ImplicitBlock2D
+{
+	float m_xx = 0.0f;
+	float m_xy = 0.0f;
+	float m_yx = 0.0f;
+	float m_yy = 0.0f;
+};
+
+//-----------------------------------------------------------------------------------------------
+class MassSpringRope2D : public FixedTimestepSimulation
 {
 public:
 	MassSpringRope2D(IntegrationMethod integrationMethod, int totalPoints, float stiffnessConstant, 
@@ -30,6 +42,13 @@ public:
 	void Shutdown();
 	void Update(float deltaSeconds);
 	void Render(std::vector<Vertex_PCU>& verts) const;
+	virtual void SavePreviousState() override;
+	virtual void FixedUpdate(float fixedDeltaSeconds) override;
+	virtual void EndFixedUpdates(float interpolationAlpha) override;
+	Vec2 GetRenderPosition(int particleIndex) const;
+
+	//Appends a rope to the shared particle block and returns the index of its first (locked) particle
+	int AddRope(int totalPoints, float massOfEachPoint, Vec2 start, Vec2 end);
 
 private:
 	void UpdateExplicitEuler();
@@ -37,12 +56,21 @@ private:
 	void UpdateMidparticle();
 	void UpdateRungeKutta();
 	void UpdateVerlet();
+	void AccumulateSpringForces();
+
+	//Backward Euler: springs are linearized and the velocity change is solved in one pass with a block Thomas solve.
+	//Only springs between neighbouring particle indices are supported, which keeps the system block tridiagonal.
+	void UpdateImplicitEuler();
+	void AssembleImplicitEulerSystem(bool addStiffnessVelocityTerm);
+	void SolveImplicitEulerSystem();
 
 public:
-	std::vector<Spring2D*>		m_springs;
-	std::vector<Particle2D*>	m_particles;
+	std::vector<Spring2D>		m_springs;
+	Particles2D					m_particles;
 	float						m_physicsTimestep = 0.0005f;
-	float						m_physicsDebt = 0.0f;
+	FixedTimestepScheduler		m_fixedTimestepScheduler;
+	std::vector<Vec2>			m_previousPositions;
+	float						m_interpolationAlpha = 0.0f;
 	int							m_numberOfPointsInRope = 0;
 	int							m_verletSolverIterations = 0;
 	float						m_stiffnessConstant = 0.0f;
@@ -54,4 +82,14 @@ public:
 	IntegrationMethod			m_integrationMethod = IntegrationMethod::SEMI_IMPLICIT_EULER;
 	bool						m_isGravityEnabled = true;
 	bool						m_isDebugMode = false;
-};
\ No newline at end of file
+
+	//Implicit Euler
+	bool						m_isImplicitNewtonRefinementEnabled = false;	// relinearizes once around the first solve for a closer backward Euler step
+	std::vector<Vec2>			m_implicitStartPositions;
+	std::vector<Vec2>			m_implicitStartVelocities;
+	std::vector<Vec2>			m_implicitRightHandSides;
+	std::vector<Vec2>			m_implicitVelocityChanges;
+	std::vector<ImplicitBlock2D>	m_implicitDiagonalBlocks;
+	std::vector<ImplicitBlock2D>	m_implicitUpperBlocks;			// block i couples particle i to particle i + 1, the lower block is its transpose
+	std::vector<ImplicitBlock2D>	m_implicitModifiedUpperBlocks;
+};
\ No newline at end of file
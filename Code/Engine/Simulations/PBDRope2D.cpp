@@ -3,8 +3,6 @@
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Math/LineSegment2.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Simulations/Spring2D.hpp"
-#include "Engine/Simulations/Particle2D.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Math/MathUtils.hpp"
@@ -29,43 +27,9 @@ PBDRope2D::PBDRope2D(int totalPoints, float totalMassOfRope, float dampingCoeffi
 	,m_isDebugMode(isDebugMode)
 	,m_physicsTimestep(physicsTimestep)
 {
-	Vec2 displacement = end - start;
-	Vec2 direction = displacement.GetNormalized();
-	float magnitude = displacement.GetLength();
-	m_desiredDistance = magnitude / (totalPoints - 1);
+	AddRope(totalPoints, totalMassOfRope, start, end);
+	m_desiredDistance = m_ropeDesiredDistances[0];
 	m_bendingConstraintDistance = m_desiredDistance * (2.0f);
-	float massPerPoint = (totalMassOfRope / totalPoints);
-	float inverseMassPerPoint = 1.0f / massPerPoint;
-	Particle2D* particleA = nullptr;
-	Particle2D* particleB = nullptr;
-	for (int particleIndex = 0; particleIndex < totalPoints; particleIndex++)
-	{	
-		if (particleIndex == 0)
-		{
-			continue;
-		}
-		else if (particleIndex == 1)
-		{
-			particleA = new Particle2D(massPerPoint, inverseMassPerPoint, start +
-				(direction * ((particleIndex - 1) * m_desiredDistance)), Vec2(), true);
-			m_particles.push_back(particleA);
-		}
-		else
-		{
-			particleA = particleB;
-		}
-
-		particleB = new Particle2D(massPerPoint, inverseMassPerPoint, start +
-			(direction * (particleIndex * m_desiredDistance)), Vec2());
-		m_particles.push_back(particleB);
-
-		Capsule2 capsule;
-		capsule.m_bone = LineSegment2(particleA->m_proposedPosition, particleB->m_proposedPosition);
-		capsule.m_radius = m_ropeRadius;
-		capsule.m_inverseMass = 1.0f / (massPerPoint + massPerPoint);
-		m_selfCollisionCapsules.push_back(capsule);
-	}
-
 	m_shapes = new Shapes2D();
 }
 
@@ -77,25 +41,8 @@ PBDRope2D::PBDRope2D()
 //-----------------------------------------------------------------------------------------------
 PBDRope2D::~PBDRope2D()
 {
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
-	{
-		Particle2D* particle = m_particles[particleIndex];
-		if (particle)
-		{
-			delete particle;
-			particle = nullptr;
-		}
-	}
-
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
-	{
-		Particle2D* particle = m_particles[particleIndex];
-		if (particle)
-		{
-			delete particle;
-			particle = nullptr;
-		}
-	}
+	delete m_shapes;
+	m_shapes = nullptr;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -111,153 +58,184 @@ void PBDRope2D::Shutdown()
 //-----------------------------------------------------------------------------------------------
 void PBDRope2D::Update(float deltaSeconds)
 {
-	//float startTime = float(GetCurrentTimeSeconds());
-	m_physicsDebt += deltaSeconds;
-	while (m_physicsDebt > m_physicsTimestep)
+	m_fixedTimestepScheduler.SetFixedTimestep(m_physicsTimestep);
+	m_fixedTimestepScheduler.AddSimulation(this);
+	m_fixedTimestepScheduler.Update(deltaSeconds);
+}
+
+//-----------------------------------------------------------------------------------------------
+void PBDRope2D::SavePreviousState()
+{
+	m_previousPositions = m_particles.m_positions;
+}
+
+//-----------------------------------------------------------------------------------------------
+void PBDRope2D::FixedUpdate(float fixedDeltaSeconds)
+{
+	m_physicsTimestep = fixedDeltaSeconds;
+	//Loop to estimate new velocities, proposed positions, and generate collisions
+	int numParticles = m_particles.GetNumParticles();
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 	{
-		//Loop to estimate new velocities, proposed positions, and generate collisions
-		for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+		if (m_particles.m_isLocked[particleIndex])
 		{
-			Particle2D* currentPoint = m_particles[particleIndex];
-			if (currentPoint->m_isLocked == true)
-			{
-				continue;
-			}
+			continue;
+		}
 
-			//Calculate next velocity (semi-implicit Euler)
-			Vec2 acceleration = (Vec2(0.0f, -m_gravityCoefficient));
-			Vec2 velocity = currentPoint->m_velocity;
-			velocity += acceleration * m_physicsTimestep;
+		//Calculate next velocity (semi-implicit Euler)
+		Vec2 acceleration = (Vec2(0.0f, -m_gravityCoefficient));
+		Vec2 velocity = m_particles.m_velocities[particleIndex];
+		velocity += acceleration * m_physicsTimestep;
 
-			//Damp Velocities (TO-DO: ADD MORE SOPHISTICATED DAMPING LATER)
-			velocity *= m_dampingCoefficient;
+		//Damp Velocities (TO-DO: ADD MORE SOPHISTICATED DAMPING LATER)
+		velocity *= m_dampingCoefficient;
 
-			//Calculate Proposed Positions
-			currentPoint->m_proposedPosition = currentPoint->m_position + velocity * m_physicsTimestep;
-		}
+		//Calculate Proposed Positions
+		m_particles.m_proposedPositions[particleIndex] = m_particles.m_positions[particleIndex] + velocity * m_physicsTimestep;
+	}
 
-		//Loop through constraints and project them
-		for (int solverIndex = 0; solverIndex < m_totalSolverIterations; solverIndex++)
-		{
-			ProjectConstraints();
-		}
+	//Loop through constraints and project them
+	for (int solverIndex = 0; solverIndex < m_totalSolverIterations; solverIndex++)
+	{
+		ProjectConstraints();
+	}
+
+	//Loop through and set projected positions and velocities
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		Vec2& velocity = m_particles.m_velocities[particleIndex];
+		velocity = (m_particles.m_proposedPositions[particleIndex] - m_particles.m_positions[particleIndex]) / m_physicsTimestep;
 
-		//Loop through and set projected positions and velocities
-		for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+		if (m_particles.m_frictionForces[particleIndex] != 0.0f)
 		{
-			Particle2D* currentPoint = m_particles[particleIndex];
-			currentPoint->m_velocity = (currentPoint->m_proposedPosition - currentPoint->m_position) / m_physicsTimestep;
+			velocity += (velocity.GetNormalized() * -1.0f) * m_particles.m_frictionForces[particleIndex] * m_physicsTimestep;
+		}
 
-			if (currentPoint->m_forcesAsFloat != 0.0f)
-			{
-				currentPoint->m_velocity += (currentPoint->m_velocity.GetNormalized() * -1.0f)
-					* currentPoint->m_forcesAsFloat * m_physicsTimestep;
-			}
+		m_particles.m_positions[particleIndex] = m_particles.m_proposedPositions[particleIndex];
+		m_particles.m_frictionForces[particleIndex] = 0.0f;
+	}
+}
 
-			currentPoint->m_position = currentPoint->m_proposedPosition;
-			currentPoint->m_forcesAsFloat = 0.0f;
-		}
+//-----------------------------------------------------------------------------------------------
+void PBDRope2D::EndFixedUpdates(float interpolationAlpha)
+{
+	m_interpolationAlpha = interpolationAlpha;
+}
 
-		m_physicsDebt -= m_physicsTimestep;
+//-----------------------------------------------------------------------------------------------
+Vec2 PBDRope2D::GetRenderPosition(int particleIndex) const
+{
+	Vec2 const& currentPosition = m_particles.m_positions[particleIndex];
+	if (m_previousPositions.size() != m_particles.m_positions.size())
+	{
+		return currentPosition;
 	}
-	//float endTime = float(GetCurrentTimeSeconds());
+
+	Vec2 const& previousPosition = m_previousPositions[particleIndex];
+	return previousPosition + (currentPosition - previousPosition) * m_interpolationAlpha;
 }
 
 //-----------------------------------------------------------------------------------------------
 void PBDRope2D::Render(std::vector<Vertex_PCU>& verts) const
 {
-	verts.reserve((m_particles.size() - 1) * size_t(6));
+	verts.reserve(m_particles.m_positions.size() * size_t(6));
 	
 	std::vector<Vec2> positions;
-	positions.reserve(m_particles.size());
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+	for (int ropeIndex = 0; ropeIndex < GetNumRopes(); ropeIndex++)
 	{
-		positions.push_back(m_particles[particleIndex]->m_position);
-		/*if (particleIndex == 0)
+		positions.clear();
+		for (int particleIndex = m_ropeFirstParticleIndices[ropeIndex]; particleIndex < m_ropeFirstParticleIndices[ropeIndex + 1]; particleIndex++)
 		{
-			continue;
-		}*/
-
-		/*Particle2D* previousPoint = m_particles[particleIndex - 1];
-		Particle2D* currentPoint = m_particles[particleIndex];
-		LineSegment2 line;
-		line.m_start = previousPoint->m_position;
-		line.m_end = currentPoint->m_position;
-		Capsule2 capsule;
-		capsule.m_bone = line;
-		capsule.m_radius = m_ropeRadius;
-		AddVertsForCapsule2D(verts, capsule, Rgba8(142, 89, 60, 255));*/
-
-		
+			positions.push_back(GetRenderPosition(particleIndex));
+		}
 
-		/*if (m_isDebugMode)
+		CatmullRomSpline2D newSpline(positions);
+		for (int curveIndex = 0; curveIndex < newSpline.m_hermiteCurves.size(); curveIndex++)
 		{
-			AddVertsForDisc2D(verts, previousPoint->m_position, m_ropeRadius * 3.0f, Rgba8::WHITE);
-			AddVertsForDisc2D(verts, currentPoint->m_position, m_ropeRadius * 3.0f, Rgba8::WHITE);
-		}*/
+			CubicHermiteCurve2D* previousCurve = nullptr;
+			if (curveIndex != 0)
+			{
+				previousCurve = newSpline.m_hermiteCurves[curveIndex - 1];
+			}
+			CubicHermiteCurve2D* currentCurve = newSpline.m_hermiteCurves[curveIndex];
+			if (currentCurve != nullptr && previousCurve != nullptr)
+			{
+				LineSegment2 line1; LineSegment2 line2;
+				line1.m_start = previousCurve->m_endPos;
+				line1.m_end = currentCurve->m_startPos;
+				line2.m_start = currentCurve->m_startPos;
+				line2.m_end = currentCurve->m_endPos;
+				Capsule2 capsule1;
+				capsule1.m_bone = line1;
+				capsule1.m_radius = m_ropeRadius; 
+				Capsule2 capsule2;
+				capsule2.m_bone = line1;
+				capsule2.m_radius = m_ropeRadius;
+				AddVertsForCapsule2D(verts, capsule1, Rgba8(142, 89, 60, 255));
+				AddVertsForCapsule2D(verts, capsule2, Rgba8(142, 89, 60, 255));
+				/*AddVertsForLineSegment2D(verts, line1, 0.05f, Rgba8(100, 130, 200, 255));
+				AddVertsForLineSegment2D(verts, line2, 0.05f, Rgba8(100, 130, 200, 255));*/
+			}
+			else if (currentCurve != nullptr && previousCurve == nullptr)
+			{
+				LineSegment2 line;
+				line.m_start = currentCurve->m_startPos;
+				line.m_end = currentCurve->m_endPos;
+				Capsule2 capsule1;
+				capsule1.m_bone = line;
+				capsule1.m_radius = m_ropeRadius;
+				AddVertsForCapsule2D(verts, capsule1, Rgba8(142, 89, 60, 255));
+				//AddVertsForLineSegment2D(verts, line, 0.05f, Rgba8(100, 130, 200, 255));
+			}
+		}
 	}
+}
 
-	CatmullRomSpline2D newSpline(positions);
-	for (int curveIndex = 0; curveIndex < newSpline.m_hermiteCurves.size(); curveIndex++)
+//-----------------------------------------------------------------------------------------------
+float PBDRope2D::GetCurrentLengthOfTheRope(int ropeIndex) const
+{
+	float currentLength = 0.0f;
+	for (int particleIndex = m_ropeFirstParticleIndices[ropeIndex] + 1; particleIndex < m_ropeFirstParticleIndices[ropeIndex + 1]; particleIndex++)
 	{
-		CubicHermiteCurve2D* previousCurve = nullptr;
-		if (curveIndex != 0)
-		{
-			previousCurve = newSpline.m_hermiteCurves[curveIndex - 1];
-		}
-		CubicHermiteCurve2D* currentCurve = newSpline.m_hermiteCurves[curveIndex];
-		if (currentCurve != nullptr && previousCurve != nullptr)
-		{
-			LineSegment2 line1; LineSegment2 line2;
-			line1.m_start = previousCurve->m_endPos;
-			line1.m_end = currentCurve->m_startPos;
-			line2.m_start = currentCurve->m_startPos;
-			line2.m_end = currentCurve->m_endPos;
-			Capsule2 capsule1;
-			capsule1.m_bone = line1;
-			capsule1.m_radius = m_ropeRadius; 
-			Capsule2 capsule2;
-			capsule2.m_bone = line1;
-			capsule2.m_radius = m_ropeRadius;
-			AddVertsForCapsule2D(verts, capsule1, Rgba8(142, 89, 60, 255));
-			AddVertsForCapsule2D(verts, capsule2, Rgba8(142, 89, 60, 255));
-			/*AddVertsForLineSegment2D(verts, line1, 0.05f, Rgba8(100, 130, 200, 255));
-			AddVertsForLineSegment2D(verts, line2, 0.05f, Rgba8(100, 130, 200, 255));*/
-		}
-		else if (currentCurve != nullptr && previousCurve == nullptr)
-		{
-			LineSegment2 line;
-			line.m_start = currentCurve->m_startPos;
-			line.m_end = currentCurve->m_endPos;
-			Capsule2 capsule1;
-			capsule1.m_bone = line;
-			capsule1.m_radius = m_ropeRadius;
-			AddVertsForCapsule2D(verts, capsule1, Rgba8(142, 89, 60, 255));
-			//AddVertsForLineSegment2D(verts, line, 0.05f, Rgba8(100, 130, 200, 255));
-		}
+		currentLength += (m_particles.m_positions[particleIndex - 1] - m_particles.m_positions[particleIndex]).GetLength();
 	}
+	return currentLength;
 }
 
 //-----------------------------------------------------------------------------------------------
-float PBDRope2D::GetCurrentLengthOfTheRope()
+int PBDRope2D::AddRope(int totalPoints, float totalMassOfRope, Vec2 start, Vec2 end)
 {
-	float currentLength = 0.0f;
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+	GUARANTEE_OR_DIE(totalPoints >= 2, "A PBDRope2D rope needs at least two points");
+	if (m_ropeFirstParticleIndices.empty())
 	{
-		Particle2D* particleA = nullptr;
-		Particle2D* particleB = m_particles[particleIndex];
+		m_ropeFirstParticleIndices.push_back(0);
+	}
 
-		if (particleIndex != 0)
+	Vec2 displacement = end - start;
+	Vec2 direction = displacement.GetNormalized();
+	float magnitude = displacement.GetLength();
+	float desiredDistance = magnitude / (totalPoints - 1);
+	float massPerPoint = (totalMassOfRope / totalPoints);
+	float inverseMassPerPoint = 1.0f / massPerPoint;
+	m_particles.Reserve(m_particles.GetNumParticles() + totalPoints);
+	for (int pointIndex = 0; pointIndex < totalPoints; pointIndex++)
+	{
+		m_particles.AddParticle(massPerPoint, inverseMassPerPoint, start + (direction * (pointIndex * desiredDistance)), Vec2(), pointIndex == 0);
+		if (pointIndex == 0)
 		{
-			particleA = m_particles[particleIndex - 1];
+			continue;
 		}
 
-		if (particleA)
-		{
-			currentLength += (particleA->m_position - particleB->m_position).GetLength();
-		}
+		Capsule2 capsule;
+		capsule.m_bone = LineSegment2(start + (direction * ((pointIndex - 1) * desiredDistance)), start + (direction * (pointIndex * desiredDistance)));
+		capsule.m_radius = m_ropeRadius;
+		capsule.m_inverseMass = 1.0f / (massPerPoint + massPerPoint);
+		m_selfCollisionCapsules.push_back(capsule);
 	}
-	return currentLength;
+
+	m_ropeFirstParticleIndices.push_back(m_particles.GetNumParticles());
+	m_ropeDesiredDistances.push_back(desiredDistance);
+	return GetNumRopes() - 1;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -272,49 +250,45 @@ void PBDRope2D::ClearShapeReferences()
 //-----------------------------------------------------------------------------------------------
 void PBDRope2D::ProjectConstraints()
 {	 
-	//Points to reference for ease of access
-	/*Particle2D* particleStart = m_particles[0];
-	Particle2D* particlePreviousToEnd = m_particles[m_particles.size() - 2];
-	Particle2D* particleEnd = m_particles[m_particles.size() - 1];*/
-
-	//Loop to project each constraint on each particle
-	for (int particleIndex = 0; particleIndex < m_particles.size(); particleIndex++)
+	//Loop to project each constraint on each particle, rope by rope so no constraint crosses into the next rope
+	for (int ropeIndex = 0; ropeIndex < GetNumRopes(); ropeIndex++)
 	{
-		Particle2D* particleA = nullptr;
-		Particle2D* particleB = m_particles[particleIndex];
-		Particle2D* particleC = nullptr;
-		
-		if (particleIndex != 0)
+		int firstParticleIndex = m_ropeFirstParticleIndices[ropeIndex];
+		int endParticleIndex = m_ropeFirstParticleIndices[ropeIndex + 1];
+		float desiredDistance = m_ropeDesiredDistances[ropeIndex];
+		float bendingConstraintDistance = desiredDistance * 2.0f;
+		for (int particleIndex = firstParticleIndex; particleIndex < endParticleIndex; particleIndex++)
 		{
-			particleA = m_particles[particleIndex - 1];
-		}
-		if (particleIndex != int(m_particles.size() - 1))
-		{
-			particleC = m_particles[particleIndex + 1];
-		}
+			bool hasPrevious = particleIndex != firstParticleIndex;
+			bool hasNext = particleIndex != endParticleIndex - 1;
 
-		//Constraints Projection
-		if (particleB->m_isLocked == false)
-		{
-			ProjectCollisionConstraints(particleB);
-		}
-		if (particleA)
-		{
-			ProjectDistanceConstraint(particleA, particleB);
-		}
-		if (particleA && particleC)
-		{
-			ProjectBendingConstraint(particleA, particleC);
+			//Constraints Projection
+			if (m_particles.m_isLocked[particleIndex] == 0)
+			{
+				ProjectCollisionConstraints(particleIndex);
+			}
+			if (hasPrevious)
+			{
+				ProjectDistanceConstraint(particleIndex - 1, particleIndex, desiredDistance);
+			}
+			if (hasPrevious && hasNext)
+			{
+				ProjectBendingConstraint(particleIndex - 1, particleIndex + 1, bendingConstraintDistance);
+			}
 		}
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void PBDRope2D::ProjectDistanceConstraint(Particle2D* particleA, Particle2D* particleB)
+void PBDRope2D::ProjectDistanceConstraint(int particleIndexA, int particleIndexB, float desiredDistance)
 {
 	//Calculates direction and overflow along with weight Coefficients
-	Vec2 displacement = particleB->m_proposedPosition - particleA->m_proposedPosition;
-	float distanceConstraint = (displacement.GetLength() - m_desiredDistance);
+	Vec2& proposedPositionA = m_particles.m_proposedPositions[particleIndexA];
+	Vec2& proposedPositionB = m_particles.m_proposedPositions[particleIndexB];
+	bool isLockedA = m_particles.m_isLocked[particleIndexA] != 0;
+	bool isLockedB = m_particles.m_isLocked[particleIndexB] != 0;
+	Vec2 displacement = proposedPositionB - proposedPositionA;
+	float distanceConstraint = (displacement.GetLength() - desiredDistance);
 
 	if (distanceConstraint == 0)
 	{
@@ -323,35 +297,39 @@ void PBDRope2D::ProjectDistanceConstraint(Particle2D* particleA, Particle2D* par
 
 	Vec2 gradient = displacement.GetNormalized();
 
-	if (particleA->m_isLocked == false && particleB->m_isLocked == false)
+	if (isLockedA == false && isLockedB == false)
 	{
-		float particleAWeightCoefficient = (particleA->m_inverseMass / (particleA->m_inverseMass + particleB->m_inverseMass));
-		float particleBWeightCoefficient = (particleB->m_inverseMass / (particleA->m_inverseMass + particleB->m_inverseMass));
+		float particleAWeightCoefficient = (m_particles.m_inverseMasses[particleIndexA] / (m_particles.m_inverseMasses[particleIndexA] + m_particles.m_inverseMasses[particleIndexB]));
+		float particleBWeightCoefficient = (m_particles.m_inverseMasses[particleIndexB] / (m_particles.m_inverseMasses[particleIndexA] + m_particles.m_inverseMasses[particleIndexB]));
 
 		Vec2 deltaPointA = particleAWeightCoefficient * distanceConstraint * gradient;
 		Vec2 deltaPointB = particleBWeightCoefficient * distanceConstraint * gradient;
 
-		particleA->m_proposedPosition += deltaPointA * m_stretchingCoefficient;
-		particleB->m_proposedPosition -= deltaPointB * m_stretchingCoefficient;
+		proposedPositionA += deltaPointA * m_stretchingCoefficient;
+		proposedPositionB -= deltaPointB * m_stretchingCoefficient;
 	}
-	else if (particleA->m_isLocked == true && particleB->m_isLocked == false)
+	else if (isLockedA && isLockedB == false)
 	{
 		Vec2 deltaPointB = distanceConstraint * gradient;
-		particleB->m_proposedPosition -= deltaPointB * m_stretchingCoefficient;
+		proposedPositionB -= deltaPointB * m_stretchingCoefficient;
 	}
-	else if (particleA->m_isLocked == false && particleB->m_isLocked == true)
+	else if (isLockedA == false && isLockedB)
 	{
 		Vec2 deltaPointA = distanceConstraint * gradient;
-		particleA->m_proposedPosition += deltaPointA * m_stretchingCoefficient;
+		proposedPositionA += deltaPointA * m_stretchingCoefficient;
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void PBDRope2D::ProjectBendingConstraint(Particle2D* particleA, Particle2D* particleC)
+void PBDRope2D::ProjectBendingConstraint(int particleIndexA, int particleIndexC, float bendingConstraintDistance)
 {
 	//Calculates direction and overflow along with weight Coefficients
-	Vec2 displacement = particleC->m_proposedPosition - particleA->m_proposedPosition;
-	float distanceConstraint = displacement.GetLength() - m_bendingConstraintDistance;
+	Vec2& proposedPositionA = m_particles.m_proposedPositions[particleIndexA];
+	Vec2& proposedPositionC = m_particles.m_proposedPositions[particleIndexC];
+	bool isLockedA = m_particles.m_isLocked[particleIndexA] != 0;
+	bool isLockedC = m_particles.m_isLocked[particleIndexC] != 0;
+	Vec2 displacement = proposedPositionC - proposedPositionA;
+	float distanceConstraint = displacement.GetLength() - bendingConstraintDistance;
 	
 	//Check if less than the minimum distance, if so no need to constrain
 	if (distanceConstraint > 0.0f)
@@ -361,41 +339,44 @@ void PBDRope2D::ProjectBendingConstraint(Particle2D* particleA, Particle2D* part
 
 	Vec2 gradient = displacement.GetNormalized();
 
-	if (particleA->m_isLocked == false && particleC->m_isLocked == false)
+	if (isLockedA == false && isLockedC == false)
 	{
-		float particleAWeightCoefficient = (particleA->m_inverseMass / (particleA->m_inverseMass + particleC->m_inverseMass));
-		float particleCWeightCoefficient = (particleC->m_inverseMass / (particleA->m_inverseMass + particleC->m_inverseMass));
+		float particleAWeightCoefficient = (m_particles.m_inverseMasses[particleIndexA] / (m_particles.m_inverseMasses[particleIndexA] + m_particles.m_inverseMasses[particleIndexC]));
+		float particleCWeightCoefficient = (m_particles.m_inverseMasses[particleIndexC] / (m_particles.m_inverseMasses[particleIndexA] + m_particles.m_inverseMasses[particleIndexC]));
 
 		Vec2 deltaPointA = m_bendingCoefficient * particleAWeightCoefficient * distanceConstraint * gradient;
 		Vec2 deltaPointC = m_bendingCoefficient * particleCWeightCoefficient * distanceConstraint * gradient;
 
-		particleA->m_proposedPosition += deltaPointA;
-		particleC->m_proposedPosition -= deltaPointC;
+		proposedPositionA += deltaPointA;
+		proposedPositionC -= deltaPointC;
 	}
-	else if (particleA->m_isLocked == true && particleC->m_isLocked == false)
+	else if (isLockedA && isLockedC == false)
 	{
 		Vec2 deltaPointC = m_bendingCoefficient * distanceConstraint * gradient;
-		particleC->m_proposedPosition -= deltaPointC;
+		proposedPositionC -= deltaPointC;
 	}
-	else if (particleA->m_isLocked == false && particleC->m_isLocked == true)
+	else if (isLockedA == false && isLockedC)
 	{
 		Vec2 deltaPointA = m_bendingCoefficient * distanceConstraint * gradient;
-		particleA->m_proposedPosition += deltaPointA;
+		proposedPositionA += deltaPointA;
 	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void PBDRope2D::ProjectCollisionConstraints(Particle2D* particle)
+void PBDRope2D::ProjectCollisionConstraints(int particleIndex)
 {
+	Vec2& proposedPosition = m_particles.m_proposedPositions[particleIndex];
+	bool isMoving = m_particles.m_velocities[particleIndex] != Vec2();
+	float normalForce = m_particles.m_masses[particleIndex] * m_gravityCoefficient;
+
 	//Floor Collisions
-	if (particle->m_proposedPosition.y < m_ropeRadius)
+	if (proposedPosition.y < m_ropeRadius)
 	{
-		particle->m_proposedPosition.y = m_ropeRadius;
+		proposedPosition.y = m_ropeRadius;
 
-		if (particle->m_velocity != Vec2())
+		if (isMoving)
 		{
-			float normalForce = particle->m_mass * m_gravityCoefficient;
-			particle->m_forcesAsFloat += m_kineticFrictionCoefficient * normalForce;
+			m_particles.m_frictionForces[particleIndex] += m_kineticFrictionCoefficient * normalForce;
 		}
 	}
 
@@ -403,12 +384,11 @@ void PBDRope2D::ProjectCollisionConstraints(Particle2D* particle)
 	for (int discIndex = 0; discIndex < m_shapes->m_discs.size(); discIndex++)
 	{
 		Disc2& disc = m_shapes->m_discs[discIndex];
-		if (PushDiscOutOfFixedDisc2D(particle->m_proposedPosition, m_ropeRadius, disc.m_center, disc.m_radius))
+		if (PushDiscOutOfFixedDisc2D(proposedPosition, m_ropeRadius, disc.m_center, disc.m_radius))
 		{
-			if (particle->m_velocity != Vec2())
+			if (isMoving)
 			{
-				float normalForce = particle->m_mass * m_gravityCoefficient;
-				particle->m_forcesAsFloat += m_kineticFrictionCoefficient * normalForce;
+				m_particles.m_frictionForces[particleIndex] += m_kineticFrictionCoefficient * normalForce;
 			}
 		}
 	}
@@ -417,12 +397,11 @@ void PBDRope2D::ProjectCollisionConstraints(Particle2D* particle)
 	for (int aabbIndex = 0; aabbIndex < m_shapes->m_aabbs.size(); aabbIndex++)
 	{
 		AABB2& aabb = m_shapes->m_aabbs[aabbIndex];
-		if (PushDiscOutOfFixedAABB2D(particle->m_proposedPosition, m_ropeRadius, aabb))
+		if (PushDiscOutOfFixedAABB2D(proposedPosition, m_ropeRadius, aabb))
 		{
-			if (particle->m_velocity != Vec2())
+			if (isMoving)
 			{
-				float normalForce = particle->m_mass * m_gravityCoefficient;
-				particle->m_forcesAsFloat += m_kineticFrictionCoefficient * normalForce;
+				m_particles.m_frictionForces[particleIndex] += m_kineticFrictionCoefficient * normalForce;
 			}
 		}
 	}
@@ -431,12 +410,11 @@ void PBDRope2D::ProjectCollisionConstraints(Particle2D* particle)
 	for (int obbIndex = 0; obbIndex < m_shapes->m_obbs.size(); obbIndex++)
 	{
 		OBB2& obb = m_shapes->m_obbs[obbIndex];
-		if (PushDiscOutOfFixedOBB2D(particle->m_proposedPosition, m_ropeRadius, obb))
+		if (PushDiscOutOfFixedOBB2D(proposedPosition, m_ropeRadius, obb))
 		{
-			if (particle->m_velocity != Vec2())
+			if (isMoving)
 			{
-				float normalForce = particle->m_mass * m_gravityCoefficient;
-				particle->m_forcesAsFloat += m_kineticFrictionCoefficient * normalForce;
+				m_particles.m_frictionForces[particleIndex] += m_kineticFrictionCoefficient * normalForce;
 			}
 		}
 	}
@@ -445,39 +423,38 @@ void PBDRope2D::ProjectCollisionConstraints(Particle2D* particle)
 	for (int capsuleIndex = 0; capsuleIndex < m_shapes->m_capsules.size(); capsuleIndex++)
 	{
 		Capsule2& capsule = m_shapes->m_capsules[capsuleIndex];
-		if (PushDiscOutOfFixedCapsule2D(particle->m_proposedPosition, m_ropeRadius, capsule))
+		if (PushDiscOutOfFixedCapsule2D(proposedPosition, m_ropeRadius, capsule))
 		{
-			if (particle->m_velocity != Vec2())
+			if (isMoving)
 			{
-				float normalForce = particle->m_mass * m_gravityCoefficient;
-				particle->m_forcesAsFloat += m_kineticFrictionCoefficient * normalForce;
+				m_particles.m_frictionForces[particleIndex] += m_kineticFrictionCoefficient * normalForce;
 			}
 		}
 	}
 
 	//SELF COLLISIONS
 	/*int capsuleIndex = 0;
-	for (int particleIndex = 0; particleIndex < m_numberOfPointsInRope; particleIndex++)
+	for (int otherParticleIndex = 0; otherParticleIndex < m_numberOfPointsInRope; otherParticleIndex++)
 	{
-		if (particleIndex == 0)
+		if (otherParticleIndex == 0)
 		{
 			continue;
 		}
 
-		Particle2D* particleA = m_particles[particleIndex - 1];
-		Particle2D* particleB = m_particles[particleIndex];
+		int particleIndexA = otherParticleIndex - 1;
+		int particleIndexB = otherParticleIndex;
 
-		if (particle == particleA || particle == particleB)
+		if (particleIndex == particleIndexA || particleIndex == particleIndexB)
 		{
 			continue;
 		}
 
 		Capsule2& capsule = m_selfCollisionCapsules[capsuleIndex];
-		capsule.m_bone.m_start = particleA->m_proposedPosition;
-		capsule.m_bone.m_end = particleB->m_proposedPosition;
-		PushDiscOutOfMobileCapsule2D(particle->m_proposedPosition, m_ropeRadius, particle->m_inverseMass, capsule);
-		particleA->m_proposedPosition = capsule.m_bone.m_start;
-		particleB->m_proposedPosition = capsule.m_bone.m_end;
+		capsule.m_bone.m_start = m_particles.m_proposedPositions[particleIndexA];
+		capsule.m_bone.m_end = m_particles.m_proposedPositions[particleIndexB];
+		PushDiscOutOfMobileCapsule2D(proposedPosition, m_ropeRadius, m_particles.m_inverseMasses[particleIndex], capsule);
+		m_particles.m_proposedPositions[particleIndexA] = capsule.m_bone.m_start;
+		m_particles.m_proposedPositions[particleIndexB] = capsule.m_bone.m_end;
 		capsuleIndex++;
 	}*/
 }
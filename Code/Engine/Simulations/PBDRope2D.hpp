@@ -4,12 +4,12 @@
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/Capsule2.hpp"
 #include "Engine/Math/Disc2.hpp"
+#include "FixedTimestepScheduler.hpp"
+#include "Particles2D.hpp"
 #include <vector>
 
 //-----------------------------------------------------------------------------------------------
 struct Vertex_PCU;
-struct Spring2D;
-struct Particle2D;
 
 //-----------------------------------------------------------------------------------------------
 struct Shapes2D
@@ -26,7 +26,9 @@ public:
 };
 
 //-----------------------------------------------------------------------------------------------
-class PBDRope2D
+// Every rope lives in one shared Particles2D block, so adding more ropes with AddRope steps them all in the same pass.
+// Rope r owns particles [m_ropeFirstParticleIndices[r], m_ropeFirstParticleIndices[r + 1]) and its first particle is locked.
+class PBDRope2D : public FixedTimestepSimulation
 {
 public:
 	PBDRope2D(int totalPoints, float totalMassOfRope, float dampingCoefficient, float stretchCoefficient, 
@@ -38,22 +40,32 @@ public:
 	void	Shutdown();
 	void	Update(float deltaSeconds);
 	void	Render(std::vector<Vertex_PCU>& verts) const;
-	float	GetCurrentLengthOfTheRope();
+	virtual void	SavePreviousState() override;
+	virtual void	FixedUpdate(float fixedDeltaSeconds) override;
+	virtual void	EndFixedUpdates(float interpolationAlpha) override;
+	Vec2	GetRenderPosition(int particleIndex) const;
+	float	GetCurrentLengthOfTheRope(int ropeIndex = 0) const;
 	void	ClearShapeReferences();
+	int		AddRope(int totalPoints, float totalMassOfRope, Vec2 start, Vec2 end);
+	int		GetNumRopes() const { return static_cast<int>(m_ropeDesiredDistances.size()); }
 
 private:
 	void	ProjectConstraints();
-	void	ProjectDistanceConstraint(Particle2D* particleA, Particle2D* particleB);
-	void	ProjectBendingConstraint(Particle2D* particleA, Particle2D* particleC);
-	void	ProjectCollisionConstraints(Particle2D* particle);
+	void	ProjectDistanceConstraint(int particleIndexA, int particleIndexB, float desiredDistance);
+	void	ProjectBendingConstraint(int particleIndexA, int particleIndexC, float bendingConstraintDistance);
+	void	ProjectCollisionConstraints(int particleIndex);
 
 public:
-	std::vector<Particle2D*>	m_particles;
+	Particles2D				m_particles;
+	std::vector<int>		m_ropeFirstParticleIndices;		// one per rope plus a trailing end index
+	std::vector<float>		m_ropeDesiredDistances;
 	Shapes2D*				m_shapes = nullptr;
 	std::vector<Capsule2>	m_selfCollisionCapsules;
 	float					m_physicsTimestep = 0.0005f;
-	float					m_physicsDebt = 0.0f;
-	float					m_desiredDistance = 0.0f;
+	FixedTimestepScheduler	m_fixedTimestepScheduler;
+	std::vector<Vec2>		m_previousPositions;
+	float					m_interpolationAlpha = 0.0f;
+	float					m_desiredDistance = 0.0f;			// first rope's spacing, every rope bends at twice its own spacing
 	float					m_bendingConstraintDistance = 0.0f;
 	float					m_bendingCoefficient = 0.0f; // Lower the bend value, the greater angle of bending
 	float					m_stretchingCoefficient = 0.0f; // Lower the stretch value the greater the elasticity
@@ -69,4 +81,4 @@ public:
 	Vec2					m_ropeEndPosition;
 	bool					m_isGravityEnabled = true;
 	bool					m_isDebugMode = false;
-};
\ No newline at end of file
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "Particles2D.hpp"
+
+//-----------------------------------------------------------------------------------------------
+Particles2D::Particles2D()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+Particles2D::~Particles2D()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+Particles2D::Particles2D(const Particles2D& copyFrom)
+	:m_positions(copyFrom.m_positions)
+	,m_velocities(copyFrom.m_velocities)
+	,m_forces(copyFrom.m_forces)
+	,m_verletPreviousPositions(copyFrom.m_verletPreviousPositions)
+	,m_proposedPositions(copyFrom.m_proposedPositions)
+	,m_masses(copyFrom.m_masses)
+	,m_inverseMasses(copyFrom.m_inverseMasses)
+	,m_frictionForces(copyFrom.m_frictionForces)
+	,m_isLocked(copyFrom.m_isLocked)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+int Particles2D::AddParticle(float mass, float inverseMass, Vec2 const& position, Vec2 const& velocity, bool isLocked)
+{
+	m_positions.push_back(position);
+	m_velocities.push_back(velocity);
+	m_forces.push_back(Vec2());
+	m_verletPreviousPositions.push_back(position);
+	m_proposedPositions.push_back(position);
+	m_masses.push_back(mass);
+	m_inverseMasses.push_back(inverseMass);
+	m_frictionForces.push_back(0.0f);
+	m_isLocked.push_back(isLocked ? 1 : 0);
+	return static_cast<int>(m_positions.size()) - 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Particles2D::Reserve(int numParticles)
+{
+	m_positions.reserve(numParticles);
+	m_velocities.reserve(numParticles);
+	m_forces.reserve(numParticles);
+	m_verletPreviousPositions.reserve(numParticles);
+	m_proposedPositions.reserve(numParticles);
+	m_masses.reserve(numParticles);
+	m_inverseMasses.reserve(numParticles);
+	m_frictionForces.reserve(numParticles);
+	m_isLocked.reserve(numParticles);
+}
+
+//-----------------------------------------------------------------------------------------------
+void Particles2D::Clear()
+{
+	m_positions.clear();
+	m_velocities.clear();
+	m_forces.clear();
+	m_verletPreviousPositions.clear();
+	m_proposedPositions.clear();
+	m_masses.clear();
+	m_inverseMasses.clear();
+	m_frictionForces.clear();
+	m_isLocked.clear();
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+//SOA Format
+//-----------------------------------------------------------------------------------------------
+struct Particles2D
+{
+public:
+	Particles2D();
+	~Particles2D();
+	Particles2D(const Particles2D& copyFrom);
+
+	int		AddParticle(float mass, float inverseMass, Vec2 const& position, Vec2 const& velocity = Vec2(), bool isLocked = false);
+	void	Reserve(int numParticles);
+	void	Clear();
+	int		GetNumParticles() const { return static_cast<int>(m_positions.size()); }
+
+public:
+	std::vector<Vec2>		m_positions;
+	std::vector<Vec2>		m_velocities;
+	std::vector<Vec2>		m_forces;
+	std::vector<Vec2>		m_verletPreviousPositions;	//Verlet Integration
+	std::vector<Vec2>		m_proposedPositions;		//Position Based Dynamics
+	std::vector<float>		m_masses;
+	std::vector<float>		m_inverseMasses;
+	std::vector<float>		m_frictionForces;			//Kinetic friction gathered while projecting collisions
+	std::vector<int>		m_isLocked;
+};
@@ -1,11 +1,15 @@
 #include "PhysicsScene3D.hpp"
 #include "RigidBody3D.hpp"
 #include "Collider3D.hpp"
+#include "CollisionWorld.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/ConvexPoly2D.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/DebugRender.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Simulations/RopeSimulation3D.hpp"
 #include <algorithm>
 
 //-----------------------------------------------------------------------------------------------
@@ -17,13 +21,26 @@ PhysicsScene3D::PhysicsScene3D(AABB3 const& worldBounds)
 //-----------------------------------------------------------------------------------------------
 void PhysicsScene3D::Update(float deltaSeconds)
 {
-	m_physicsDebt += deltaSeconds;
-	while (m_physicsDebt > m_physicsTimestep)
+	PROFILE_SCOPE("PhysicsScene3D::Update");
+
+	//Standalone stepping, coupled ropes share one FixedTimestepScheduler with the scene and call FixedUpdate from there instead
+	m_fixedTimestepScheduler.SetFixedTimestep(m_physicsTimestep);
+	m_fixedTimestepScheduler.AddSimulation(this);
+	m_fixedTimestepScheduler.Update(deltaSeconds);
+}
+
+//-----------------------------------------------------------------------------------------------
+void PhysicsScene3D::FixedUpdate(float fixedDeltaSeconds)
+{
+	m_physicsTimestep = fixedDeltaSeconds;
+	UpdateRigidBodies();
+	DetectCollisions();
+	ResolveCollisions();
+
+	//Simulations added to the scheduler after this scene read these hulls in the same substep, so they must see this substep's poses
+	if (m_collisionWorld != nullptr)
 	{
-		UpdateRigidBodies();
-		DetectCollisions();
-		ResolveCollisions();
-		m_physicsDebt -= m_physicsTimestep;
+		m_collisionWorld->Update();
 	}
 }
 
@@ -31,6 +48,13 @@ void PhysicsScene3D::Update(float deltaSeconds)
 void PhysicsScene3D::AddRigidBody(RigidBody3D* rigidBody)
 {
 	m_rigidBodies.push_back(rigidBody);
+
+	int collisionWorldHandle = -1;
+	if (m_collisionWorld != nullptr && rigidBody->m_collider != nullptr && rigidBody->m_collider->m_hull != nullptr)
+	{
+		collisionWorldHandle = m_collisionWorld->AddCollisionObject(new ConvexHullCollisionObject(rigidBody->m_collider), false);
+	}
+	m_collisionWorldHandles.push_back(collisionWorldHandle);
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -39,13 +63,40 @@ bool PhysicsScene3D::RemoveRigidBody(RigidBody3D* rigidBody)
 	auto it = std::find(m_rigidBodies.begin(), m_rigidBodies.end(), rigidBody);
 	if (it != m_rigidBodies.end())
 	{
+		int rigidBodyIndex = static_cast<int>(it - m_rigidBodies.begin());
+		if (m_collisionWorld != nullptr && m_collisionWorldHandles[rigidBodyIndex] != -1)
+		{
+			m_collisionWorld->RemoveCollisionObject(m_collisionWorldHandles[rigidBodyIndex]);
+		}
+		m_collisionWorldHandles.erase(m_collisionWorldHandles.begin() + rigidBodyIndex);
 		m_rigidBodies.erase(it);
+
+		//Otherwise a rope would keep pulling on, and reading the pose of, a body that may be deleted next
+		for (int ropeIndex = 0; ropeIndex < static_cast<int>(m_coupledRopes.size()); ropeIndex++)
+		{
+			m_coupledRopes[ropeIndex]->UnattachAllFromRigidBody(rigidBody);
+		}
 		return true;
 	}
 
 	return false;
 }
 
+//-----------------------------------------------------------------------------------------------
+void PhysicsScene3D::AddCoupledRope(RopeSimulation3D* rope)
+{
+	if (std::find(m_coupledRopes.begin(), m_coupledRopes.end(), rope) == m_coupledRopes.end())
+	{
+		m_coupledRopes.push_back(rope);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void PhysicsScene3D::RemoveCoupledRope(RopeSimulation3D* rope)
+{
+	m_coupledRopes.erase(std::remove(m_coupledRopes.begin(), m_coupledRopes.end(), rope), m_coupledRopes.end());
+}
+
 //-----------------------------------------------------------------------------------------------
 void PhysicsScene3D::UpdateRigidBodies()
 {
@@ -62,6 +113,7 @@ void PhysicsScene3D::UpdateRigidBodies()
 //-----------------------------------------------------------------------------------------------
 void PhysicsScene3D::DetectCollisions()
 {
+	PROFILE_SCOPE("PhysicsScene3D::DetectCollisions");
 	m_contactManifolds.clear();
 	DetectCollisionsRigidBodies(); 
 	DetectCollisionsWorldBounds();
@@ -140,7 +192,8 @@ bool PhysicsScene3D::RigidBodyVSGroundPlane(RigidBody3D* a)
 	std::vector<Vec3> contactPoints = a->m_collider->GetFurthestPointsInDireciton(Vec3(0.0f, 0.0f, -1.0f));
 	if (contactPoints.size() == 0)
 	{
-		a = a;
+		//Only happens once the body's transform has gone non-finite
+		return false;
 	}
 	float penetration = DotProduct3D(contactPoints[0], Vec3(0.0f, 0.0f, 1.0f));
 
@@ -474,8 +527,9 @@ bool PhysicsScene3D::GJK_EPA(RigidBody3D* a, RigidBody3D* b)
 	}
 
 	//EPA Section
+	//Rebuild the simplex as a half-edge hull so support points can be added incrementally
 	breakCounter = 0;
-	hull.m_conflictLists.resize(4);
+	hull.GenerateTetrahedron(points[0], points[1], points[2], points[3]);
 	Vec3 supportPoint;
 	int closestIndex = -1;
 	while (true)
@@ -497,27 +551,11 @@ bool PhysicsScene3D::GJK_EPA(RigidBody3D* a, RigidBody3D* b)
 			break;
 		}
 
-		//Partitioning of Points and Faces
-		hull.m_pointsToPartition.push_back(supportPoint);
-		for (int pointIndex = 0; pointIndex < hull.m_pointsToPartition.size(); pointIndex++)
+		//Expand the hull through the horizon of the new support point
+		if (hull.AddPointToHull(supportPoint) == false)
 		{
-			Vec3& point = hull.m_pointsToPartition[pointIndex];
-			float minDist = FLT_MAX;
-			int closestPlaneIndex = -1;
-			for (int planeIndex = 0; planeIndex < hull.m_boundingPlanes.size(); planeIndex++)
-			{
-				Plane3D& plane = hull.m_boundingPlanes[planeIndex];
-				float altitude = DotProduct3D(point, plane.m_normal) - plane.m_distanceFromOrigin;
-				if (altitude < minDist && altitude > 0.0f)
-				{
-					minDist = altitude;
-					closestPlaneIndex = planeIndex;
-				}
-			}
-
-			hull.m_conflictLists[closestPlaneIndex].push_back(Vec2(float(pointIndex), minDist));
+			break;
 		}
-		hull.IterativeQuickullGeneration(true);
 
 		if (breakCounter >= 100)
 		{
@@ -742,6 +780,7 @@ void PhysicsScene3D::ComputeContactPoints(Vec3 const& contactNormal, RigidBody3D
 //-----------------------------------------------------------------------------------------------
 void PhysicsScene3D::ResolveCollisions()
 {
+	PROFILE_SCOPE("PhysicsScene3D::ResolveCollisions");
 	//Check all contact manifolds
 	for (int contactIndex = 0; contactIndex < m_contactManifolds.size(); contactIndex++)
 	{
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Math/AABB3.hpp"
+#include "FixedTimestepScheduler.hpp"
 #include <vector>
 
 //-----------------------------------------------------------------------------------------------
@@ -7,6 +8,8 @@ constexpr float VELOCITY_THRESHOLD = 0.001f;
 
 //-----------------------------------------------------------------------------------------------
 class  RigidBody3D;
+class  CollisionWorld;
+class  RopeSimulation3D;
 struct ConvexHull3D;
 
 //-----------------------------------------------------------------------------------------------
@@ -20,7 +23,7 @@ struct ContactManifold3D
 };
 
 //-----------------------------------------------------------------------------------------------
-class PhysicsScene3D
+class PhysicsScene3D : public FixedTimestepSimulation
 {
 public:
 	PhysicsScene3D() {}
@@ -28,9 +31,14 @@ public:
 	explicit PhysicsScene3D(AABB3 const& m_worldBounds);
 
 	void							Update(float deltaSeconds);
+	virtual void					FixedUpdate(float fixedDeltaSeconds) override;
 	void							AddRigidBody(RigidBody3D* rigidBody);
 	bool							RemoveRigidBody(RigidBody3D* rigidBody);
 
+	//Ropes attached to this scene's bodies, removing a body detaches them; remove a rope before deleting it
+	void							AddCoupledRope(RopeSimulation3D* rope);
+	void							RemoveCoupledRope(RopeSimulation3D* rope);
+
 private:
 	void							UpdateRigidBodies();
 	void							DetectCollisions();
@@ -50,12 +58,15 @@ private:
 
 public:
 	bool							m_debugDraw = true;
+	CollisionWorld*					m_collisionWorld = nullptr;		// not owned, set before adding bodies so their hulls get registered
 
 private:
 	std::vector<RigidBody3D*>		m_rigidBodies;
+	std::vector<int>				m_collisionWorldHandles;		// parallel to m_rigidBodies, -1 when not registered
+	std::vector<RopeSimulation3D*>	m_coupledRopes;					// not owned
 	std::vector<ContactManifold3D*>	m_contactManifolds;
 	AABB3							m_worldBounds;
 	float							m_physicsTimestep = 0.0005f;
-	float							m_physicsDebt = 0.0f;
+	FixedTimestepScheduler			m_fixedTimestepScheduler;
 	bool							m_isSAT = false;
-};
\ No newline at end of file
+};
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Simulations/Collider3D.hpp"
+#include "Engine/Math/ConvexHull3D.hpp"
 
 //-----------------------------------------------------------------------------------------------
 RigidBody3D::RigidBody3D(std::string xmlFileName, float totalMass)
@@ -70,6 +71,50 @@ RigidBody3D::RigidBody3D(std::string xmlFileName, float totalMass)
 	}
 }
 
+//-----------------------------------------------------------------------------------------------
+RigidBody3D::RigidBody3D(RigidBody3D const& definition)
+	:m_position(definition.m_position)
+	,m_velocity(definition.m_velocity)
+	,m_linearMomentum(definition.m_linearMomentum)
+	,m_force(definition.m_force)
+	,m_gravity(definition.m_gravity)
+	,m_rotation(definition.m_rotation)
+	,m_inertiaTensor(definition.m_inertiaTensor)
+	,m_inverseInertiaTensor(definition.m_inverseInertiaTensor)
+	,m_angularVelocity(definition.m_angularVelocity)
+	,m_angularMomentum(definition.m_angularMomentum)
+	,m_torque(definition.m_torque)
+	,m_mass(definition.m_mass)
+	,m_Us(definition.m_Us)
+	,m_Uk(definition.m_Uk)
+	,m_penetration(definition.m_penetration)
+	,m_isGravityEnabled(definition.m_isGravityEnabled)
+{
+	//Each body needs its own collider, the cooked hull is copied so definitions can be instanced many times
+	m_collider = new Collider3D(this);
+	if (definition.m_collider != nullptr)
+	{
+		if (definition.m_collider->m_hull != nullptr)
+		{
+			m_collider->m_hull = new ConvexHull3D(*definition.m_collider->m_hull);
+		}
+		m_collider->m_boundingSphereRadius = definition.m_collider->m_boundingSphereRadius;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+RigidBody3D::~RigidBody3D()
+{
+	//Both constructors give the body its own collider and hull
+	if (m_collider)
+	{
+		delete m_collider->m_hull;
+		m_collider->m_hull = nullptr;
+		delete m_collider;
+		m_collider = nullptr;
+	}
+}
+
 //-----------------------------------------------------------------------------------------------
 void RigidBody3D::Update(float deltaSeconds)
 {
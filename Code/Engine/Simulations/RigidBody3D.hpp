@@ -15,7 +15,9 @@ class RigidBody3D
 public:
 	RigidBody3D(std::string xmlFileName, float totalMass);
 	RigidBody3D() {}
-	~RigidBody3D() {}
+	RigidBody3D(RigidBody3D const& definition);
+	~RigidBody3D();
+	RigidBody3D& operator=(RigidBody3D const& copyFrom) = delete;
 	
 	void				Update(float deltaSeconds);
 	void				ComputeForcesAndTorque();
@@ -43,4 +45,4 @@ public:
 
 	Vec3				m_penetration;
 	bool				m_isGravityEnabled = false;
-};
\ No newline at end of file
+};
\ No newline at end of file
@@ -0,0 +1,814 @@
+#include "RopeComputeCPU.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/LineSegment3.hpp"
+#include <cmath>
+
+//-----------------------------------------------------------------------------------------------
+// The shaders split the 64 bit regions into two uints and count a half as overlapping when it is empty on both sides.
+// Kept as is so this backend culls exactly the pairs the GPU does.
+static bool DoBitRegionsOverlap(uint64_t bitRegionsA, uint64_t bitRegionsB)
+{
+	uint32_t lowBitsA = static_cast<uint32_t>(bitRegionsA);
+	uint32_t lowBitsB = static_cast<uint32_t>(bitRegionsB);
+	uint32_t highBitsA = static_cast<uint32_t>(bitRegionsA >> 32);
+	uint32_t highBitsB = static_cast<uint32_t>(bitRegionsB >> 32);
+	uint32_t lowBitResult = lowBitsA & lowBitsB;
+	uint32_t highBitResult = highBitsA & highBitsB;
+	if (highBitsA == 0 && highBitsB == 0)
+	{
+		highBitResult = 1;
+	}
+	if (lowBitsA == 0 && lowBitsB == 0)
+	{
+		lowBitResult = 1;
+	}
+	return lowBitResult != 0 || highBitResult != 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+static bool DoBitRegionsOverlap(uint64_t macroBitRegionsA, uint64_t microBitRegionsA, CollisionObject const& collisionObject)
+{
+	return DoBitRegionsOverlap(macroBitRegionsA, collisionObject.m_macroBitRegions) && DoBitRegionsOverlap(microBitRegionsA, collisionObject.m_microBitRegions);
+}
+
+//-----------------------------------------------------------------------------------------------
+// xyz sums the corrections and w counts them, the same float4 the shaders average over
+static void AddJacobiCorrection(Vec4& jacobiCorrection, Vec3 const& correction)
+{
+	jacobiCorrection.x += correction.x;
+	jacobiCorrection.y += correction.y;
+	jacobiCorrection.z += correction.z;
+	jacobiCorrection.w++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Shader version of capsule against capsule, only the first capsule moves and the push is shared between its ends
+// by where along it the contact is
+static void PushRopeCapsuleOutOfRopeCapsule3D(Capsule3& capsuleA, Capsule3 const& capsuleB)
+{
+	LineSegment3 lineA = LineSegment3(capsuleA.m_bone.m_start, capsuleA.m_bone.m_end);
+	LineSegment3 lineB = LineSegment3(capsuleB.m_bone.m_start, capsuleB.m_bone.m_end);
+	std::vector<Vec3> nearestPoints = GetNearestPointsBetweenLines3D(lineA, lineB);
+
+	Vec3 displacementNearestPoints = nearestPoints[0] - nearestPoints[1];
+	float distanceNearestPoints = displacementNearestPoints.GetLengthSquared();
+	float overallRadii = capsuleA.m_radius + capsuleB.m_radius;
+	if (distanceNearestPoints >= overallRadii * overallRadii)
+	{
+		return;
+	}
+
+	float offset = (overallRadii - sqrtf(distanceNearestPoints)) * 0.5f;
+	displacementNearestPoints.SetLength(offset);
+	if (nearestPoints[0] == capsuleA.m_bone.m_start)
+	{
+		capsuleA.m_bone.m_start += displacementNearestPoints;
+	}
+	else if (nearestPoints[0] == capsuleA.m_bone.m_end)
+	{
+		capsuleA.m_bone.m_end += displacementNearestPoints;
+	}
+	else
+	{
+		float startToEndOfCapsuleDistance = (capsuleA.m_bone.m_end - capsuleA.m_bone.m_start).GetLength();
+		float capsuleStartToLinePointDistance = (nearestPoints[0] - capsuleA.m_bone.m_end).GetLength();
+		float percentToPushStart = capsuleStartToLinePointDistance / startToEndOfCapsuleDistance;
+		float percentToPushEnd = (startToEndOfCapsuleDistance - capsuleStartToLinePointDistance) / startToEndOfCapsuleDistance;
+		capsuleA.m_bone.m_start += displacementNearestPoints * percentToPushStart;
+		capsuleA.m_bone.m_end += displacementNearestPoints * percentToPushEnd;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+RopeComputeJob::RopeComputeJob(RopeComputeCPU* computeCPU)
+	:m_computeCPU(computeCPU)
+{
+	m_jobType = JOB_TYPE_SIMULATION;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeJob::Execute()
+{
+	for (int threadGroupIndex = m_firstThreadGroup; threadGroupIndex < m_endThreadGroup; threadGroupIndex++)
+	{
+		m_computeCPU->ExecuteThreadGroup(m_kernel, threadGroupIndex);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+RopeComputeCPU::RopeComputeCPU(RopeSimulation3D* rope)
+	:m_rope(rope)
+{
+	GUARANTEE_OR_DIE(m_rope != nullptr, "RopeComputeCPU needs a rope to simulate");
+	UpdateConstants();
+	InitializeCollisionObjects();
+}
+
+//-----------------------------------------------------------------------------------------------
+RopeComputeCPU::~RopeComputeCPU()
+{
+	for (int jobIndex = 0; jobIndex < static_cast<int>(m_jobs.size()); jobIndex++)
+	{
+		delete m_jobs[jobIndex];
+	}
+	m_jobs.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::UpdateConstants()
+{
+	m_constants.m_totalParticles = static_cast<int>(m_rope->m_particles.m_positions.size());
+	m_constants.m_ropeRadius = m_rope->m_ropeRadius;
+	m_constants.m_gravityCoefficient = m_rope->m_gravityCoefficient;
+	m_constants.m_physicsTimestep = m_rope->m_physicsTimestep;
+	m_constants.m_dampingCoefficient = m_rope->m_dampingCoefficient;
+	m_constants.m_totalSolverIterations = m_rope->m_totalSolverIterations;
+	m_constants.m_desiredDistance = m_rope->m_desiredDistance;
+	m_constants.m_compressionCoefficient = m_rope->m_compressionCoefficient;
+	m_constants.m_stretchingCoefficient = m_rope->m_stretchingCoefficient;
+	m_constants.m_kineticFrictionCoefficient = m_rope->m_kineticFrictionCoefficient;
+	m_constants.m_bendingConstraintDistance = m_rope->m_bendingConstraintDistance;
+	m_constants.m_bendingCoefficient = m_rope->m_bendingCoefficient;
+	m_constants.m_worldBoundsMins = m_rope->m_worldBounds.m_mins;
+	m_constants.m_worldBoundsMaxs = m_rope->m_worldBounds.m_maxs;
+	m_constants.m_totalCollisionObjects = static_cast<int>(m_aabbs.size() + m_obbs.size() + m_cylinders.size() + m_capsules.size() + m_spheres.size());
+	m_constants.m_totalAABBs = static_cast<int>(m_aabbs.size());
+	m_constants.m_totalOBBs = static_cast<int>(m_obbs.size());
+	m_constants.m_totalCylinders = static_cast<int>(m_cylinders.size());
+	m_constants.m_totalCapsules = static_cast<int>(m_capsules.size());
+	m_constants.m_totalSpheres = static_cast<int>(m_spheres.size());
+	m_constants.m_isSelfCollisionEnabled = m_rope->m_isSelfCollisionEnabled ? 1 : 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::InitializeCollisionObjects()
+{
+	//Same split by type as the GPU collision buffers, the rope's own bit region pass stands in for CSInitializeCollisionObjects
+	m_rope->BitRegionDetectionAllCollisionObjects();
+	m_aabbs.clear();
+	m_obbs.clear();
+	m_cylinders.clear();
+	m_capsules.clear();
+	m_spheres.clear();
+	int totalCollisionObjects = m_rope->m_totalCollisionObjects;
+	if (totalCollisionObjects > static_cast<int>(m_rope->m_collisionObjects.size()))
+	{
+		totalCollisionObjects = static_cast<int>(m_rope->m_collisionObjects.size());
+	}
+	int endAABBs = m_rope->m_totalAABBs;
+	int endOBBs = endAABBs + m_rope->m_totalOBBs;
+	int endCylinders = endOBBs + m_rope->m_totalCylinders;
+	int endCapsules = endCylinders + m_rope->m_totalCapsules;
+	int endSpheres = endCapsules + m_rope->m_totalSpheres;
+	for (int objectIndex = 0; objectIndex < totalCollisionObjects; objectIndex++)
+	{
+		CollisionObject* collisionObject = m_rope->m_collisionObjects[objectIndex];
+		if (objectIndex < endAABBs)
+		{
+			m_aabbs.push_back(*dynamic_cast<AABBCollisionObject*>(collisionObject));
+		}
+		else if (objectIndex < endOBBs)
+		{
+			m_obbs.push_back(*dynamic_cast<OBBCollisionObject*>(collisionObject));
+		}
+		else if (objectIndex < endCylinders)
+		{
+			m_cylinders.push_back(*dynamic_cast<CylinderCollisionObject*>(collisionObject));
+		}
+		else if (objectIndex < endCapsules)
+		{
+			m_capsules.push_back(*dynamic_cast<CapsuleCollisionObject*>(collisionObject));
+		}
+		else if (objectIndex < endSpheres)
+		{
+			m_spheres.push_back(*dynamic_cast<SphereCollisionObject*>(collisionObject));
+		}
+	}
+	UpdateConstants();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::Dispatch(RopeComputeKernel kernel, int numThreadGroups)
+{
+	if (numThreadGroups <= 0)
+	{
+		return;
+	}
+
+	int numWorkers = g_theJobSystem != nullptr && !g_theJobSystem->IsQuitting() ? g_theJobSystem->GetNumWorkers() : 0;
+	int numJobs = (numThreadGroups * GetThreadsPerGroup(kernel)) / m_minThreadsPerJob;
+	if (numJobs > numWorkers + 1)
+	{
+		numJobs = numWorkers + 1;
+	}
+	if (numJobs > numThreadGroups)
+	{
+		numJobs = numThreadGroups;
+	}
+	if (numJobs < 1)
+	{
+		numJobs = 1;
+	}
+	while (static_cast<int>(m_jobs.size()) < numJobs)
+	{
+		m_jobs.push_back(new RopeComputeJob(this));
+	}
+
+	int numThreadGroupsPerJob = (numThreadGroups + numJobs - 1) / numJobs;
+	for (int jobIndex = 0; jobIndex < numJobs; jobIndex++)
+	{
+		RopeComputeJob* job = m_jobs[jobIndex];
+		job->m_kernel = kernel;
+		job->m_firstThreadGroup = jobIndex * numThreadGroupsPerJob;
+		job->m_endThreadGroup = (jobIndex + 1) * numThreadGroupsPerJob;
+		if (job->m_endThreadGroup > numThreadGroups)
+		{
+			job->m_endThreadGroup = numThreadGroups;
+		}
+	}
+
+	//A dispatch ends in a barrier, every thread group finishes before the next kernel reads what it wrote
+	RunJobsAndWait(m_jobs, numJobs);
+}
+
+//-----------------------------------------------------------------------------------------------
+int RopeComputeCPU::GetThreadsPerGroup(RopeComputeKernel kernel)
+{
+	//Matches the numthreads of each shader
+	switch (kernel)
+	{
+	case RopeComputeKernel::PROJECT_COLLISION_CONSTRAINTS_SPHERES:
+	case RopeComputeKernel::CAPSULE_COLLISIONS_PHASE_ONE:
+	case RopeComputeKernel::CAPSULE_COLLISIONS_PHASE_TWO:
+		return 1;
+	default:
+		return 32;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::ExecuteThreadGroup(RopeComputeKernel kernel, int threadGroupIndex)
+{
+	int threadsPerGroup = GetThreadsPerGroup(kernel);
+	int startIndex = threadGroupIndex * threadsPerGroup;
+	for (int threadIndex = startIndex; threadIndex < startIndex + threadsPerGroup; threadIndex++)
+	{
+		switch (kernel)
+		{
+		case RopeComputeKernel::INITIAL_UPDATES:							InitialUpdates(threadIndex);						break;
+		case RopeComputeKernel::PROJECT_NON_COLLISION_CONSTRAINTS:			ProjectNonCollisionConstraints(threadIndex);		break;
+		case RopeComputeKernel::UPDATE_AFTER_NON_COLLISION_CONSTRAINTS:		UpdateAfterNonCollisionConstraints(threadIndex);	break;
+		case RopeComputeKernel::UPDATE_PARTICLE_BIT_REGIONS:				UpdateParticleBitRegions(threadIndex);				break;
+		case RopeComputeKernel::PROJECT_COLLISION_CONSTRAINTS_SPHERES:		ProjectCollisionConstraintsSpheres(threadIndex);	break;
+		case RopeComputeKernel::INITIALIZE_BIT_REGIONS_CAPSULES:			InitializeBitRegionsCapsules(threadIndex);			break;
+		case RopeComputeKernel::CAPSULE_COLLISIONS_PHASE_ONE:				CapsuleCollisions(threadIndex * 2);					break;
+		case RopeComputeKernel::CAPSULE_COLLISIONS_PHASE_TWO:				CapsuleCollisions(threadIndex * 2 + 1);				break;
+		case RopeComputeKernel::FINAL_UPDATES:								FinalUpdates(threadIndex);							break;
+		default:
+			ERROR_AND_DIE("Unknown rope compute kernel");
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::InitialUpdates(int particleIndex)
+{
+	if (particleIndex >= m_constants.m_totalParticles)
+		return;
+
+	Particles3D& particles = m_rope->m_particles;
+	if (particles.m_isAttached[particleIndex] == 1)
+	{
+		particles.m_proposedPositions[particleIndex] = particles.m_positions[particleIndex];
+		return;
+	}
+
+	//Calculate next velocity (semi-implicit Euler)
+	Vec3 acceleration = Vec3(0.0f, 0.0f, -m_constants.m_gravityCoefficient);
+	Vec3 velocity = particles.m_velocities[particleIndex];
+	velocity += acceleration * m_constants.m_physicsTimestep;
+
+	//Damp Velocities
+	velocity *= m_constants.m_dampingCoefficient;
+	particles.m_velocities[particleIndex] = velocity;
+
+	//Calculate Proposed Positions
+	particles.m_proposedPositions[particleIndex] = particles.m_positions[particleIndex] + velocity * m_constants.m_physicsTimestep;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::ProjectNonCollisionConstraints(int particleIndex)
+{
+	int totalParticles = m_constants.m_totalParticles;
+	if (particleIndex >= totalParticles)
+		return;
+
+	//Distance Constraints, each thread only writes the correction of its own particle
+	if (particleIndex - 1 >= 0)
+	{
+		ProjectDistanceConstraintJacobi(particleIndex - 1, particleIndex, false);
+	}
+	if (particleIndex + 1 < totalParticles)
+	{
+		ProjectDistanceConstraintJacobi(particleIndex, particleIndex + 1, true);
+	}
+	//Bending Constraints
+	if (particleIndex - 2 >= 0)
+	{
+		ProjectBendingConstraintJacobi(particleIndex - 2, particleIndex - 1, particleIndex, false);
+	}
+	if (particleIndex + 2 < totalParticles)
+	{
+		ProjectBendingConstraintJacobi(particleIndex, particleIndex + 1, particleIndex + 2, true);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::UpdateAfterNonCollisionConstraints(int particleIndex)
+{
+	if (particleIndex >= m_constants.m_totalParticles)
+		return;
+
+	Particles3D& particles = m_rope->m_particles;
+	Vec4& jacobiCorrection = particles.m_jacobiCorrections[particleIndex];
+	if (particles.m_isAttached[particleIndex] == 0 && jacobiCorrection.w != 0.0f)
+	{
+		particles.m_proposedPositions[particleIndex] += Vec3(jacobiCorrection.x, jacobiCorrection.y, jacobiCorrection.z) / jacobiCorrection.w;
+		jacobiCorrection = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::UpdateParticleBitRegions(int particleIndex)
+{
+	if (particleIndex >= m_constants.m_totalParticles)
+		return;
+
+	//The sphere shader refreshes these at its top while other threads are already reading them, a pass of its own keeps this deterministic
+	m_rope->BitRegionDetectionSingleParticle(particleIndex);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::ProjectCollisionConstraintsSpheres(int sentParticleIndex)
+{
+	int totalParticles = m_constants.m_totalParticles;
+	if (sentParticleIndex >= totalParticles)
+		return;
+
+	Particles3D& particles = m_rope->m_particles;
+	float ropeRadius = m_constants.m_ropeRadius;
+	uint64_t macroBitRegions = particles.m_macroBitRegions[sentParticleIndex];
+	uint64_t microBitRegions = particles.m_microBitRegions[sentParticleIndex];
+
+	//Self Collisions, only this particle moves and it takes half of the overlap
+	if (m_constants.m_isSelfCollisionEnabled == 1)
+	{
+		for (int particleIndex = 0; particleIndex < totalParticles; particleIndex++)
+		{
+			if (particleIndex == sentParticleIndex || particleIndex == sentParticleIndex - 1 || particleIndex == sentParticleIndex + 1)
+				continue;
+			if (!DoBitRegionsOverlap(macroBitRegions, particles.m_macroBitRegions[particleIndex]) || !DoBitRegionsOverlap(microBitRegions, particles.m_microBitRegions[particleIndex]))
+				continue;
+
+			Vec3 sentPosition = particles.m_proposedPositions[sentParticleIndex];
+			Vec3 displacement = sentPosition - particles.m_proposedPositions[particleIndex];
+			float distanceSquared = displacement.GetLengthSquared();
+			if ((ropeRadius + ropeRadius) * (ropeRadius + ropeRadius) >= distanceSquared)
+			{
+				displacement.SetLength(ropeRadius + ropeRadius - sqrtf(distanceSquared));
+				AddParticleCollisionCorrection(sentParticleIndex, sentPosition + displacement * 0.5f);
+			}
+		}
+	}
+
+	//AABBs
+	for (int aabbIndex = 0; aabbIndex < static_cast<int>(m_aabbs.size()); aabbIndex++)
+	{
+		AABBCollisionObject const& aabb = m_aabbs[aabbIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, aabb) || !DoSpheresOverlap(particles.m_proposedPositions[sentParticleIndex], ropeRadius, aabb.m_boundingDiscCenter, aabb.m_boundingDiscRadius))
+			continue;
+		Vec3 newPosition = particles.m_proposedPositions[sentParticleIndex];
+		PushSphereOutOfFixedAABB3D(newPosition, ropeRadius, aabb.m_aabb);
+		AddParticleCollisionCorrection(sentParticleIndex, newPosition);
+	}
+	//OBBs
+	for (int obbIndex = 0; obbIndex < static_cast<int>(m_obbs.size()); obbIndex++)
+	{
+		OBBCollisionObject const& obb = m_obbs[obbIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, obb) || !DoSpheresOverlap(particles.m_proposedPositions[sentParticleIndex], ropeRadius, obb.m_boundingDiscCenter, obb.m_boundingDiscRadius))
+			continue;
+		Vec3 newPosition = particles.m_proposedPositions[sentParticleIndex];
+		PushDiscOutOfFixedOBB3D(newPosition, ropeRadius, obb.m_obb);
+		AddParticleCollisionCorrection(sentParticleIndex, newPosition);
+	}
+	//Cylinders
+	for (int cylinderIndex = 0; cylinderIndex < static_cast<int>(m_cylinders.size()); cylinderIndex++)
+	{
+		CylinderCollisionObject const& cylinder = m_cylinders[cylinderIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, cylinder) || !DoSpheresOverlap(particles.m_proposedPositions[sentParticleIndex], ropeRadius, cylinder.m_boundingDiscCenter, cylinder.m_boundingDiscRadius))
+			continue;
+		Vec3 newPosition = particles.m_proposedPositions[sentParticleIndex];
+		PushSphereOutOfFixedCylinder3D(newPosition, ropeRadius, cylinder.m_cylinder);
+		AddParticleCollisionCorrection(sentParticleIndex, newPosition);
+	}
+	//Capsules
+	for (int capsuleIndex = 0; capsuleIndex < static_cast<int>(m_capsules.size()); capsuleIndex++)
+	{
+		CapsuleCollisionObject const& capsule = m_capsules[capsuleIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, capsule) || !DoSpheresOverlap(particles.m_proposedPositions[sentParticleIndex], ropeRadius, capsule.m_boundingDiscCenter, capsule.m_boundingDiscRadius))
+			continue;
+		Vec3 newPosition = particles.m_proposedPositions[sentParticleIndex];
+		PushSphereOutOfFixedCapsule3D(newPosition, ropeRadius, capsule.m_capsule);
+		AddParticleCollisionCorrection(sentParticleIndex, newPosition);
+	}
+	//Spheres, the shader skips the bounding disc here
+	for (int sphereIndex = 0; sphereIndex < static_cast<int>(m_spheres.size()); sphereIndex++)
+	{
+		SphereCollisionObject const& sphere = m_spheres[sphereIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, sphere))
+			continue;
+		Vec3 newPosition = particles.m_proposedPositions[sentParticleIndex];
+		PushSphereOutOfFixedSphere3D(newPosition, ropeRadius, sphere.m_sphere.m_center, sphere.m_sphere.m_radius);
+		AddParticleCollisionCorrection(sentParticleIndex, newPosition);
+	}
+
+	//World Bounds Collisions
+	ProjectWorldBoundsConstraintsJacobi(sentParticleIndex);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::InitializeBitRegionsCapsules(int sentCapsuleIndex)
+{
+	//The shader has every thread refresh the capsules on both sides of its particle, so neighbours write the same capsule.
+	//Here each thread owns one capsule, which gives the same result without the duplicate writes.
+	if (sentCapsuleIndex >= m_constants.m_totalParticles - 1)
+		return;
+
+	Particles3D const& particles = m_rope->m_particles;
+	CapsuleCollisionObject& ropeCapsule = m_rope->m_collisionCapsules[sentCapsuleIndex];
+	float ropeRadius = m_constants.m_ropeRadius;
+	ropeCapsule.m_capsule.m_bone.m_start = particles.m_proposedPositions[sentCapsuleIndex];
+	ropeCapsule.m_capsule.m_bone.m_end = particles.m_proposedPositions[sentCapsuleIndex + 1];
+	ropeCapsule.m_boundingDiscCenter = (ropeCapsule.m_capsule.m_bone.m_start + ropeCapsule.m_capsule.m_bone.m_end) * 0.5f;
+	ropeCapsule.m_boundingDiscRadius = (ropeCapsule.m_capsule.m_bone.m_start - ropeCapsule.m_boundingDiscCenter).GetLength() + ropeRadius;
+	ropeCapsule.m_capsule.m_radius = ropeRadius;
+	ropeCapsule.m_capsule.m_bone.m_radius = ropeRadius;
+	ropeCapsule.m_isCollidingStart = 0;
+	ropeCapsule.m_collisionNormalStart = Vec3();
+	ropeCapsule.m_jacobiCorrectionStart = Vec3();
+	ropeCapsule.m_jacobiConstraintTotalStart = 0;
+	ropeCapsule.m_isCollidingEnd = 0;
+	ropeCapsule.m_collisionNormalEnd = Vec3();
+	ropeCapsule.m_jacobiCorrectionEnd = Vec3();
+	ropeCapsule.m_jacobiConstraintTotalEnd = 0;
+	m_rope->BitRegionDetectionSingleCapsule(sentCapsuleIndex);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::CapsuleCollisions(int sentCapsuleIndex)
+{
+	//The shader only checks against the particle count, the last thread of an odd rope would read past the capsules
+	int totalCapsules = m_constants.m_totalParticles - 1;
+	if (sentCapsuleIndex >= totalCapsules)
+		return;
+
+	std::vector<CapsuleCollisionObject>& ropeCapsules = m_rope->m_collisionCapsules;
+	CapsuleCollisionObject& sentCapsule = ropeCapsules[sentCapsuleIndex];
+	uint64_t macroBitRegions = sentCapsule.m_macroBitRegions;
+	uint64_t microBitRegions = sentCapsule.m_microBitRegions;
+
+	//Self Collision
+	if (m_constants.m_isSelfCollisionEnabled == 1)
+	{
+		for (int capsuleIndex = 0; capsuleIndex < totalCapsules; capsuleIndex++)
+		{
+			if (capsuleIndex >= sentCapsuleIndex - 2 && capsuleIndex <= sentCapsuleIndex + 2)
+				continue;
+			CapsuleCollisionObject const& currentCapsule = ropeCapsules[capsuleIndex];
+			if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, currentCapsule) ||
+				!DoSpheresOverlap(sentCapsule.m_boundingDiscCenter, sentCapsule.m_boundingDiscRadius, currentCapsule.m_boundingDiscCenter, currentCapsule.m_boundingDiscRadius))
+				continue;
+			Capsule3 newCapsule = sentCapsule.m_capsule;
+			PushRopeCapsuleOutOfRopeCapsule3D(newCapsule, currentCapsule.m_capsule);
+			AddCapsuleCollisionCorrection(sentCapsule, newCapsule);
+		}
+	}
+
+	//AABBs
+	for (int aabbIndex = 0; aabbIndex < static_cast<int>(m_aabbs.size()); aabbIndex++)
+	{
+		AABBCollisionObject const& aabb = m_aabbs[aabbIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, aabb) || !DoSpheresOverlap(sentCapsule.m_boundingDiscCenter, sentCapsule.m_boundingDiscRadius, aabb.m_boundingDiscCenter, aabb.m_boundingDiscRadius))
+			continue;
+		Capsule3 newCapsule = sentCapsule.m_capsule;
+		PushCapsuleOutOfFixedAABB3D(newCapsule, aabb.m_aabb);
+		AddCapsuleCollisionCorrection(sentCapsule, newCapsule);
+	}
+	//OBBs
+	for (int obbIndex = 0; obbIndex < static_cast<int>(m_obbs.size()); obbIndex++)
+	{
+		OBBCollisionObject const& obb = m_obbs[obbIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, obb) || !DoSpheresOverlap(sentCapsule.m_boundingDiscCenter, sentCapsule.m_boundingDiscRadius, obb.m_boundingDiscCenter, obb.m_boundingDiscRadius))
+			continue;
+		Capsule3 newCapsule = sentCapsule.m_capsule;
+		PushCapsuleOutOfFixedOBB3D(newCapsule, obb.m_obb);
+		AddCapsuleCollisionCorrection(sentCapsule, newCapsule);
+	}
+	//Cylinders
+	for (int cylinderIndex = 0; cylinderIndex < static_cast<int>(m_cylinders.size()); cylinderIndex++)
+	{
+		CylinderCollisionObject const& cylinder = m_cylinders[cylinderIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, cylinder) || !DoSpheresOverlap(sentCapsule.m_boundingDiscCenter, sentCapsule.m_boundingDiscRadius, cylinder.m_boundingDiscCenter, cylinder.m_boundingDiscRadius))
+			continue;
+		Capsule3 newCapsule = sentCapsule.m_capsule;
+		PushCapsuleOutOfFixedCylinder3D(newCapsule, cylinder.m_cylinder);
+		AddCapsuleCollisionCorrection(sentCapsule, newCapsule);
+	}
+	//Capsules
+	for (int capsuleIndex = 0; capsuleIndex < static_cast<int>(m_capsules.size()); capsuleIndex++)
+	{
+		CapsuleCollisionObject const& capsule = m_capsules[capsuleIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, capsule) || !DoSpheresOverlap(sentCapsule.m_boundingDiscCenter, sentCapsule.m_boundingDiscRadius, capsule.m_boundingDiscCenter, capsule.m_boundingDiscRadius))
+			continue;
+		Capsule3 newCapsule = sentCapsule.m_capsule;
+		PushCapsuleOutOfFixedCapsule3D(newCapsule, capsule.m_capsule);
+		AddCapsuleCollisionCorrection(sentCapsule, newCapsule);
+	}
+	//Spheres
+	for (int sphereIndex = 0; sphereIndex < static_cast<int>(m_spheres.size()); sphereIndex++)
+	{
+		SphereCollisionObject const& sphere = m_spheres[sphereIndex];
+		if (!DoBitRegionsOverlap(macroBitRegions, microBitRegions, sphere))
+			continue;
+		Capsule3 newCapsule = sentCapsule.m_capsule;
+		PushCapsuleOutOfFixedSphere3D(newCapsule, sphere.m_sphere.m_center, sphere.m_sphere.m_radius);
+		AddCapsuleCollisionCorrection(sentCapsule, newCapsule);
+	}
+
+	//Update proposed positions based on jacobi corrections, phases only touch every other capsule so the two ends are this thread's alone
+	Particles3D& particles = m_rope->m_particles;
+	if (sentCapsule.m_jacobiConstraintTotalStart != 0 && particles.m_isAttached[sentCapsuleIndex] == 0)
+	{
+		particles.m_proposedPositions[sentCapsuleIndex] += sentCapsule.m_jacobiCorrectionStart / float(sentCapsule.m_jacobiConstraintTotalStart);
+		particles.m_jacobiCorrections[sentCapsuleIndex] = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
+		particles.m_collisionNormals[sentCapsuleIndex] = sentCapsule.m_collisionNormalStart;
+	}
+	if (sentCapsule.m_jacobiConstraintTotalEnd != 0 && particles.m_isAttached[sentCapsuleIndex + 1] == 0)
+	{
+		particles.m_proposedPositions[sentCapsuleIndex + 1] += sentCapsule.m_jacobiCorrectionEnd / float(sentCapsule.m_jacobiConstraintTotalEnd);
+		particles.m_jacobiCorrections[sentCapsuleIndex + 1] = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
+		particles.m_collisionNormals[sentCapsuleIndex + 1] = sentCapsule.m_collisionNormalEnd;
+	}
+
+	//World Bounds Collisions
+	ProjectWorldBoundsConstraintsJacobi(sentCapsuleIndex);
+	ProjectWorldBoundsConstraintsJacobi(sentCapsuleIndex + 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::FinalUpdates(int particleIndex)
+{
+	if (particleIndex >= m_constants.m_totalParticles)
+		return;
+
+	Particles3D& particles = m_rope->m_particles;
+	if (particles.m_isAttached[particleIndex] == 1)
+	{
+		particles.m_positions[particleIndex] = particles.m_proposedPositions[particleIndex];
+		return;
+	}
+
+	//Update proposed position based on jacobi correction
+	Vec4& jacobiCorrection = particles.m_jacobiCorrections[particleIndex];
+	if (jacobiCorrection.w != 0.0f)
+	{
+		particles.m_proposedPositions[particleIndex] += Vec3(jacobiCorrection.x, jacobiCorrection.y, jacobiCorrection.z) / jacobiCorrection.w;
+		jacobiCorrection = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	//Calculate new velocity
+	Vec3& velocity = particles.m_velocities[particleIndex];
+	velocity = (particles.m_proposedPositions[particleIndex] - particles.m_positions[particleIndex]) / m_constants.m_physicsTimestep;
+
+	//Friction Logic
+	Vec3& collisionNormal = particles.m_collisionNormals[particleIndex];
+	if (collisionNormal.x != 0.0f || collisionNormal.y != 0.0f || collisionNormal.z != 0.0f)
+	{
+		//Static Friction, like the shader the particle keeps its old position for this step
+		if (velocity.GetLength() < 0.15f)
+		{
+			velocity = Vec3();
+			collisionNormal = Vec3();
+			return;
+		}
+
+		//Kinetic Friction
+		Vec3 tangentalFriction = GetProjectedOnto3D(velocity, collisionNormal) - velocity;
+		velocity += tangentalFriction * m_constants.m_kineticFrictionCoefficient;
+		collisionNormal = Vec3();
+	}
+
+	particles.m_positions[particleIndex] = particles.m_proposedPositions[particleIndex];
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::ProjectDistanceConstraintJacobi(int particleAIndex, int particleBIndex, bool isParticleA)
+{
+	//Calculates direction and overflow along with weight Coefficients
+	Particles3D& particles = m_rope->m_particles;
+	Vec3 displacement = particles.m_proposedPositions[particleBIndex] - particles.m_proposedPositions[particleAIndex];
+	float distanceConstraint = displacement.GetLength() - m_constants.m_desiredDistance;
+
+	//Early out check
+	if (distanceConstraint == 0.0f)
+	{
+		return;
+	}
+
+	Vec3 gradient = displacement.GetNormalized();
+	float coefficientValue = distanceConstraint < 0.0f ? m_constants.m_compressionCoefficient : m_constants.m_stretchingCoefficient;
+	int isAttachedA = particles.m_isAttached[particleAIndex];
+	int isAttachedB = particles.m_isAttached[particleBIndex];
+	if (isAttachedA == 0 && isAttachedB == 0)
+	{
+		float inverseMassSum = particles.m_inverseMasses[particleAIndex] + particles.m_inverseMasses[particleBIndex];
+		if (isParticleA)
+		{
+			Vec3 deltaParticleA = gradient * (distanceConstraint * (particles.m_inverseMasses[particleAIndex] / inverseMassSum) * coefficientValue);
+			AddJacobiCorrection(particles.m_jacobiCorrections[particleAIndex], deltaParticleA);
+		}
+		else
+		{
+			Vec3 deltaParticleB = gradient * (distanceConstraint * (particles.m_inverseMasses[particleBIndex] / inverseMassSum) * coefficientValue);
+			AddJacobiCorrection(particles.m_jacobiCorrections[particleBIndex], -1.0f * deltaParticleB);
+		}
+	}
+	else if (isAttachedA == 1 && isAttachedB == 0)
+	{
+		if (isParticleA == false)
+		{
+			Vec3 deltaParticleB = gradient * (distanceConstraint * coefficientValue);
+			AddJacobiCorrection(particles.m_jacobiCorrections[particleBIndex], -1.0f * deltaParticleB);
+		}
+	}
+	else if (isParticleA)
+	{
+		Vec3 deltaParticleA = gradient * (distanceConstraint * coefficientValue);
+		AddJacobiCorrection(particles.m_jacobiCorrections[particleAIndex], deltaParticleA);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::ProjectBendingConstraintJacobi(int particleAIndex, int particleBIndex, int particleCIndex, bool isParticleA)
+{
+	//Calculates direction and overflow along with weight Coefficients
+	Particles3D& particles = m_rope->m_particles;
+	Vec3 displacement = particles.m_proposedPositions[particleCIndex] - particles.m_proposedPositions[particleAIndex];
+	float distanceConstraint = displacement.GetLength() - m_constants.m_bendingConstraintDistance;
+
+	//Check if less than the minimum distance, if so no need to constrain
+	if (distanceConstraint > 0.0f)
+	{
+		return;
+	}
+
+	//Because this is a cheap method to check for bending need to ensure the direction inst the same
+	Vec3 gradient = displacement.GetNormalized();
+	Vec3 directionCheck = (particles.m_proposedPositions[particleBIndex] - particles.m_proposedPositions[particleAIndex]).GetNormalized();
+	if (gradient == directionCheck)
+	{
+		return;
+	}
+
+	float bendingCoefficient = m_constants.m_bendingCoefficient;
+	int isAttachedA = particles.m_isAttached[particleAIndex];
+	int isAttachedC = particles.m_isAttached[particleCIndex];
+	if (isAttachedA == 0 && isAttachedC == 0)
+	{
+		float inverseMassSum = particles.m_inverseMasses[particleAIndex] + particles.m_inverseMasses[particleCIndex];
+		if (isParticleA)
+		{
+			Vec3 deltaParticleA = gradient * ((particles.m_inverseMasses[particleAIndex] / inverseMassSum) * distanceConstraint * bendingCoefficient);
+			AddJacobiCorrection(particles.m_jacobiCorrections[particleAIndex], deltaParticleA);
+		}
+		else
+		{
+			Vec3 deltaParticleC = gradient * ((particles.m_inverseMasses[particleCIndex] / inverseMassSum) * distanceConstraint * bendingCoefficient);
+			AddJacobiCorrection(particles.m_jacobiCorrections[particleCIndex], -1.0f * deltaParticleC);
+		}
+	}
+	else if (isAttachedA == 1 && isAttachedC == 0)
+	{
+		if (isParticleA == false)
+		{
+			Vec3 deltaParticleC = gradient * (distanceConstraint * bendingCoefficient);
+			AddJacobiCorrection(particles.m_jacobiCorrections[particleCIndex], -1.0f * deltaParticleC);
+		}
+	}
+	else if (isParticleA)
+	{
+		Vec3 deltaParticleA = gradient * (distanceConstraint * bendingCoefficient);
+		AddJacobiCorrection(particles.m_jacobiCorrections[particleAIndex], deltaParticleA);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::ProjectWorldBoundsConstraintsJacobi(int sentParticleIndex)
+{
+	//Initializations
+	Particles3D& particles = m_rope->m_particles;
+	Vec3 const& proposedPosition = particles.m_proposedPositions[sentParticleIndex];
+	Vec3& collisionNormal = particles.m_collisionNormals[sentParticleIndex];
+	Vec4& jacobiCorrection = particles.m_jacobiCorrections[sentParticleIndex];
+	Vec3 const& worldMins = m_constants.m_worldBoundsMins;
+	Vec3 const& worldMaxs = m_constants.m_worldBoundsMaxs;
+	float ropeRadius = m_constants.m_ropeRadius;
+	Vec3 newPosition = proposedPosition;
+
+	//Min Z
+	if (proposedPosition.z < worldMins.z + ropeRadius)
+	{
+		newPosition.z = worldMins.z + ropeRadius;
+		collisionNormal = Vec3(0.0f, 0.0f, 1.0f);
+		jacobiCorrection.w++;
+	}
+	//Max Z
+	if (proposedPosition.z > worldMaxs.z - ropeRadius)
+	{
+		newPosition.z = worldMaxs.z - ropeRadius;
+		collisionNormal = Vec3(0.0f, 0.0f, -1.0f);
+		jacobiCorrection.w++;
+	}
+	//Min X
+	if (proposedPosition.x < worldMins.x + ropeRadius)
+	{
+		newPosition.x = worldMins.x + ropeRadius;
+		collisionNormal = Vec3(1.0f, 0.0f, 0.0f);
+		jacobiCorrection.w++;
+	}
+	//Max X
+	if (proposedPosition.x > worldMaxs.x - ropeRadius)
+	{
+		newPosition.x = worldMaxs.x - ropeRadius;
+		collisionNormal = Vec3(-1.0f, 0.0f, 0.0f);
+		jacobiCorrection.w++;
+	}
+	//Min Y
+	if (proposedPosition.y < worldMins.y + ropeRadius)
+	{
+		newPosition.y = worldMins.y + ropeRadius;
+		collisionNormal = Vec3(0.0f, 1.0f, 0.0f);
+		jacobiCorrection.w++;
+	}
+	//Max Y
+	if (proposedPosition.y > worldMaxs.y - ropeRadius)
+	{
+		newPosition.y = worldMaxs.y - ropeRadius;
+		collisionNormal = Vec3(0.0f, -1.0f, 0.0f);
+		jacobiCorrection.w++;
+	}
+
+	//Update back into buffer
+	Vec3 correction = newPosition - proposedPosition;
+	jacobiCorrection.x += correction.x;
+	jacobiCorrection.y += correction.y;
+	jacobiCorrection.z += correction.z;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::AddParticleCollisionCorrection(int particleIndex, Vec3 const& newPosition)
+{
+	Particles3D& particles = m_rope->m_particles;
+	if (newPosition == particles.m_proposedPositions[particleIndex])
+	{
+		return;
+	}
+
+	Vec3 displacement = newPosition - particles.m_proposedPositions[particleIndex];
+	particles.m_collisionNormals[particleIndex] = displacement.GetNormalized();
+	AddJacobiCorrection(particles.m_jacobiCorrections[particleIndex], displacement);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeComputeCPU::AddCapsuleCollisionCorrection(CapsuleCollisionObject& ropeCapsule, Capsule3 const& newCapsule)
+{
+	if (newCapsule.m_bone.m_start != ropeCapsule.m_capsule.m_bone.m_start)
+	{
+		Vec3 displacementStart = newCapsule.m_bone.m_start - ropeCapsule.m_capsule.m_bone.m_start;
+		ropeCapsule.m_isCollidingStart = 1;
+		ropeCapsule.m_collisionNormalStart = displacementStart.GetNormalized();
+		ropeCapsule.m_jacobiCorrectionStart += displacementStart;
+		ropeCapsule.m_jacobiConstraintTotalStart++;
+	}
+	if (newCapsule.m_bone.m_end != ropeCapsule.m_capsule.m_bone.m_end)
+	{
+		Vec3 displacementEnd = newCapsule.m_bone.m_end - ropeCapsule.m_capsule.m_bone.m_end;
+		ropeCapsule.m_isCollidingEnd = 1;
+		ropeCapsule.m_collisionNormalEnd = displacementEnd.GetNormalized();
+		ropeCapsule.m_jacobiCorrectionEnd += displacementEnd;
+		ropeCapsule.m_jacobiConstraintTotalEnd++;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "RopeSimulation3D.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------------------------
+class	RopeComputeCPU;
+
+//-----------------------------------------------------------------------------------------------
+// One entry per rope compute shader, in the order UpdateGPU dispatches them
+enum class RopeComputeKernel
+{
+	INITIAL_UPDATES,
+	PROJECT_NON_COLLISION_CONSTRAINTS,
+	UPDATE_AFTER_NON_COLLISION_CONSTRAINTS,
+	UPDATE_PARTICLE_BIT_REGIONS,
+	PROJECT_COLLISION_CONSTRAINTS_SPHERES,
+	INITIALIZE_BIT_REGIONS_CAPSULES,
+	CAPSULE_COLLISIONS_PHASE_ONE,
+	CAPSULE_COLLISIONS_PHASE_TWO,
+	FINAL_UPDATES,
+	COUNT
+};
+
+//-----------------------------------------------------------------------------------------------
+// Runs a contiguous range of thread groups of one kernel, the same way a single dispatch would hand them to the GPU
+class RopeComputeJob : public Job
+{
+public:
+	explicit RopeComputeJob(RopeComputeCPU* computeCPU);
+	virtual ~RopeComputeJob() = default;
+	virtual void Execute() override;
+
+public:
+	RopeComputeCPU*		m_computeCPU = nullptr;
+	RopeComputeKernel	m_kernel = RopeComputeKernel::INITIAL_UPDATES;
+	int					m_firstThreadGroup = 0;
+	int					m_endThreadGroup = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// CPU port of the rope compute shader pipeline. Each kernel is a line for line copy of its CSMain working on the rope's
+// particle arrays, which have the same layout as the structured buffers, and a copy of the rope constant buffer.
+// Thread groups are split across the job system so the GPU algorithm can be stepped, timed and checked without a device.
+class RopeComputeCPU
+{
+public:
+	explicit RopeComputeCPU(RopeSimulation3D* rope);
+	~RopeComputeCPU();
+
+	void		UpdateConstants();
+	void		InitializeCollisionObjects();
+	void		Dispatch(RopeComputeKernel kernel, int numThreadGroups);
+	void		ExecuteThreadGroup(RopeComputeKernel kernel, int threadGroupIndex);
+
+	static int	GetThreadsPerGroup(RopeComputeKernel kernel);
+
+private:
+	//Kernels
+	void		InitialUpdates(int particleIndex);
+	void		ProjectNonCollisionConstraints(int particleIndex);
+	void		UpdateAfterNonCollisionConstraints(int particleIndex);
+	void		UpdateParticleBitRegions(int particleIndex);
+	void		ProjectCollisionConstraintsSpheres(int sentParticleIndex);
+	void		InitializeBitRegionsCapsules(int sentCapsuleIndex);
+	void		CapsuleCollisions(int sentCapsuleIndex);
+	void		FinalUpdates(int particleIndex);
+
+	//Kernel Helpers
+	void		ProjectDistanceConstraintJacobi(int particleAIndex, int particleBIndex, bool isParticleA);
+	void		ProjectBendingConstraintJacobi(int particleAIndex, int particleBIndex, int particleCIndex, bool isParticleA);
+	void		ProjectWorldBoundsConstraintsJacobi(int sentParticleIndex);
+	void		AddParticleCollisionCorrection(int particleIndex, Vec3 const& newPosition);
+	void		AddCapsuleCollisionCorrection(CapsuleCollisionObject& ropeCapsule, Capsule3 const& newCapsule);
+
+public:
+	RopeSimulation3D*						m_rope = nullptr;
+	RopeSimualtionConstantBufferVariables	m_constants;
+	int										m_minThreadsPerJob = 256;		// a dispatch is only split across workers once each job gets this many threads
+	//Copies in the GPU buffer layout, the capsule kernels accumulate Jacobi corrections into their objects
+	std::vector<AABBCollisionObject>		m_aabbs;
+	std::vector<OBBCollisionObject>			m_obbs;
+	std::vector<CylinderCollisionObject>	m_cylinders;
+	std::vector<CapsuleCollisionObject>		m_capsules;
+	std::vector<SphereCollisionObject>		m_spheres;
+	std::vector<RopeComputeJob*>			m_jobs;
+};
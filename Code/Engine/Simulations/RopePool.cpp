@@ -0,0 +1,1209 @@
+#include "RopePool.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <climits>
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+static void EraseRange(std::vector<T>& values, int firstIndex, int count)
+{
+	if (static_cast<int>(values.size()) < firstIndex + count)
+	{
+		return;
+	}
+	values.erase(values.begin() + firstIndex, values.begin() + firstIndex + count);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Moves a range by offset within the same array, copying in the direction that never reads an overwritten value
+template <typename T>
+static void ShiftRange(std::vector<T>& values, int firstIndex, int count, int offset)
+{
+	if (offset < 0)
+	{
+		std::copy(values.begin() + firstIndex, values.begin() + firstIndex + count, values.begin() + firstIndex + offset);
+	}
+	else if (offset > 0)
+	{
+		std::copy_backward(values.begin() + firstIndex, values.begin() + firstIndex + count, values.begin() + firstIndex + count + offset);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parameters along each segment of their closest points, clamped to the segments
+static void GetNearestSegmentParameters(Vec3 const& startA, Vec3 const& endA, Vec3 const& startB, Vec3 const& endB, float& out_parameterA, float& out_parameterB)
+{
+	Vec3 directionA = endA - startA;
+	Vec3 directionB = endB - startB;
+	Vec3 startOffset = startA - startB;
+	float lengthSquaredA = DotProduct3D(directionA, directionA);
+	float lengthSquaredB = DotProduct3D(directionB, directionB);
+	float dotAB = DotProduct3D(directionA, directionB);
+	float dotAOffset = DotProduct3D(directionA, startOffset);
+	float dotBOffset = DotProduct3D(directionB, startOffset);
+
+	//Parallel or degenerate segments fall back to the start of A
+	float denominator = lengthSquaredA * lengthSquaredB - dotAB * dotAB;
+	out_parameterA = denominator > 0.0000001f ? GetClampedZeroToOne((dotAB * dotBOffset - lengthSquaredB * dotAOffset) / denominator) : 0.0f;
+	out_parameterB = lengthSquaredB > 0.0000001f ? (dotAB * out_parameterA + dotBOffset) / lengthSquaredB : 0.0f;
+	if (out_parameterB < 0.0f || out_parameterB > 1.0f)
+	{
+		out_parameterB = GetClampedZeroToOne(out_parameterB);
+		out_parameterA = lengthSquaredA > 0.0000001f ? GetClampedZeroToOne((dotAB * out_parameterB - dotAOffset) / lengthSquaredA) : 0.0f;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+RopePoolJob::RopePoolJob(RopePool* ropePool)
+	:m_ropePool(ropePool)
+{
+	m_jobType = JOB_TYPE_SIMULATION;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePoolJob::Execute()
+{
+	m_ropePool->StepRopes(*this);
+}
+
+//-----------------------------------------------------------------------------------------------
+RopePool::RopePool(RopePoolConfig const& config)
+	:m_config(config)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+RopePool::~RopePool()
+{
+	for (int jobIndex = 0; jobIndex < static_cast<int>(m_jobs.size()); jobIndex++)
+	{
+		delete m_jobs[jobIndex];
+	}
+	m_jobs.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+int RopePool::AddRope(int numParticles, float totalMassOfRope, Vec3 const& start, Vec3 const& end, bool isStartAttached)
+{
+	GUARANTEE_OR_DIE(numParticles >= 2, "A RopePool rope needs at least two particles");
+
+	RopePoolRope rope;
+	rope.m_firstParticleIndex = GetNumParticles();
+	rope.m_numParticles = numParticles;
+	rope.m_firstDistanceConstraintIndex = static_cast<int>(m_distanceConstraintIndices.size());
+	rope.m_numDistanceConstraints = numParticles - 1;
+	rope.m_firstBendingConstraintIndex = static_cast<int>(m_bendingConstraintIndices.size());
+	rope.m_numBendingConstraints = numParticles - 2;
+	rope.m_baseRestLength = (end - start).GetLength() / static_cast<float>(numParticles - 1);
+
+	//Particles, laid out the same way RopeSimulation3D builds its rope
+	Vec3 direction = (end - start).GetNormalized();
+	float desiredDistance = rope.m_baseRestLength;
+	float massPerParticle = totalMassOfRope / static_cast<float>(numParticles);
+	float inverseMassPerParticle = 1.0f / massPerParticle;
+	for (int ropeParticleIndex = 0; ropeParticleIndex < numParticles; ropeParticleIndex++)
+	{
+		Vec3 position = start + direction * (static_cast<float>(ropeParticleIndex) * desiredDistance);
+		m_particles.m_positions.push_back(position);
+		m_particles.m_velocities.push_back(Vec3());
+		m_particles.m_proposedPositions.push_back(position);
+		m_particles.m_collisionNormals.push_back(Vec3());
+		m_particles.m_masses.push_back(massPerParticle);
+		m_particles.m_inverseMasses.push_back(inverseMassPerParticle);
+		m_particles.m_isAttached.push_back(ropeParticleIndex == 0 && isStartAttached ? 1 : 0);
+		m_isParticleInContact.push_back(0);
+	}
+	if (!m_previousPositions.empty())
+	{
+		m_previousPositions.resize(m_particles.m_positions.size());
+		for (int particleIndex = rope.m_firstParticleIndex; particleIndex < GetNumParticles(); particleIndex++)
+		{
+			m_previousPositions[particleIndex] = m_particles.m_positions[particleIndex];
+		}
+	}
+
+	//Constraints
+	for (int ropeParticleIndex = 0; ropeParticleIndex < numParticles - 1; ropeParticleIndex++)
+	{
+		int particleIndex = rope.m_firstParticleIndex + ropeParticleIndex;
+		m_distanceConstraintIndices.push_back(IntVec2(particleIndex, particleIndex + 1));
+		m_distanceConstraintRestLengths.push_back(desiredDistance);
+	}
+	for (int ropeParticleIndex = 0; ropeParticleIndex < numParticles - 2; ropeParticleIndex++)
+	{
+		int particleIndex = rope.m_firstParticleIndex + ropeParticleIndex;
+		m_bendingConstraintIndices.push_back(IntVec2(particleIndex, particleIndex + 2));
+		m_bendingConstraintRestLengths.push_back(desiredDistance * 2.0f);
+	}
+
+	//Handle
+	if (m_freeHandles.empty())
+	{
+		rope.m_handle = static_cast<int>(m_handleRopeIndices.size());
+		m_handleRopeIndices.push_back(-1);
+	}
+	else
+	{
+		rope.m_handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	m_handleRopeIndices[rope.m_handle] = static_cast<int>(m_ropes.size());
+	m_ropes.push_back(rope);
+	m_distanceConstraintRopeHandles.resize(m_distanceConstraintIndices.size(), rope.m_handle);
+	m_isBroadphaseDirty = true;
+	return rope.m_handle;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::RemoveRope(int ropeHandle)
+{
+	int ropeIndex = GetRopeIndex(ropeHandle);
+	RopePoolRope removedRope = m_ropes[ropeIndex];
+
+	//Close the gaps in the shared arrays
+	int firstParticleIndex = removedRope.m_firstParticleIndex;
+	int numParticles = removedRope.m_numParticles;
+	EraseRange(m_particles.m_positions, firstParticleIndex, numParticles);
+	EraseRange(m_particles.m_velocities, firstParticleIndex, numParticles);
+	EraseRange(m_particles.m_proposedPositions, firstParticleIndex, numParticles);
+	EraseRange(m_particles.m_collisionNormals, firstParticleIndex, numParticles);
+	EraseRange(m_particles.m_masses, firstParticleIndex, numParticles);
+	EraseRange(m_particles.m_inverseMasses, firstParticleIndex, numParticles);
+	EraseRange(m_particles.m_isAttached, firstParticleIndex, numParticles);
+	EraseRange(m_previousPositions, firstParticleIndex, numParticles);
+	EraseRange(m_isParticleInContact, firstParticleIndex, numParticles);
+	EraseRange(m_distanceConstraintIndices, removedRope.m_firstDistanceConstraintIndex, removedRope.m_numDistanceConstraints);
+	EraseRange(m_distanceConstraintRestLengths, removedRope.m_firstDistanceConstraintIndex, removedRope.m_numDistanceConstraints);
+	EraseRange(m_distanceConstraintRopeHandles, removedRope.m_firstDistanceConstraintIndex, removedRope.m_numDistanceConstraints);
+	EraseRange(m_bendingConstraintIndices, removedRope.m_firstBendingConstraintIndex, removedRope.m_numBendingConstraints);
+	EraseRange(m_bendingConstraintRestLengths, removedRope.m_firstBendingConstraintIndex, removedRope.m_numBendingConstraints);
+
+	//Every later rope slides down by the removed ranges
+	m_ropes.erase(m_ropes.begin() + ropeIndex);
+	OffsetLaterRopes(ropeIndex, -numParticles, -removedRope.m_numDistanceConstraints, -removedRope.m_numBendingConstraints);
+
+	m_handleRopeIndices[ropeHandle] = -1;
+	m_freeHandles.push_back(ropeHandle);
+	m_isBroadphaseDirty = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::Clear()
+{
+	m_particles = Particles3D();
+	m_distanceConstraintIndices.clear();
+	m_distanceConstraintRestLengths.clear();
+	m_distanceConstraintRopeHandles.clear();
+	m_bendingConstraintIndices.clear();
+	m_bendingConstraintRestLengths.clear();
+	m_ropes.clear();
+	m_handleRopeIndices.clear();
+	m_freeHandles.clear();
+	m_previousPositions.clear();
+	m_isParticleInContact.clear();
+	m_ropeCollisionPairs.clear();
+	m_isBroadphaseDirty = true;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RopePool::IsValidRope(int ropeHandle) const
+{
+	return ropeHandle >= 0 && ropeHandle < static_cast<int>(m_handleRopeIndices.size()) && m_handleRopeIndices[ropeHandle] != -1;
+}
+
+//-----------------------------------------------------------------------------------------------
+int RopePool::GetNumParticlesInRope(int ropeHandle) const
+{
+	return m_ropes[GetRopeIndex(ropeHandle)].m_numParticles;
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec3 RopePool::GetRopeParticlePosition(int ropeHandle, int ropeParticleIndex) const
+{
+	RopePoolRope const& rope = m_ropes[GetRopeIndex(ropeHandle)];
+	GUARANTEE_OR_DIE(ropeParticleIndex >= 0 && ropeParticleIndex < rope.m_numParticles, "Rope particle index out of range");
+	return m_particles.m_positions[rope.m_firstParticleIndex + ropeParticleIndex];
+}
+
+//-----------------------------------------------------------------------------------------------
+float RopePool::GetRopeLength(int ropeHandle) const
+{
+	RopePoolRope const& rope = m_ropes[GetRopeIndex(ropeHandle)];
+	float currentLength = 0.0f;
+	for (int particleIndex = rope.m_firstParticleIndex + 1; particleIndex < rope.m_firstParticleIndex + rope.m_numParticles; particleIndex++)
+	{
+		currentLength += (m_particles.m_positions[particleIndex] - m_particles.m_positions[particleIndex - 1]).GetLength();
+	}
+	return currentLength;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::AttachRopeParticle(int ropeHandle, int ropeParticleIndex, Vec3 const& position)
+{
+	RopePoolRope& rope = m_ropes[GetRopeIndex(ropeHandle)];
+	GUARANTEE_OR_DIE(ropeParticleIndex >= 0 && ropeParticleIndex < rope.m_numParticles, "Rope particle index out of range");
+	int particleIndex = rope.m_firstParticleIndex + ropeParticleIndex;
+	if (particleIndex == rope.m_grabbedParticleIndex)
+	{
+		rope.m_wasGrabbedParticleAttached = 1;
+	}
+	m_particles.m_isAttached[particleIndex] = 1;
+	m_particles.m_positions[particleIndex] = position;
+	m_particles.m_proposedPositions[particleIndex] = position;
+	m_particles.m_velocities[particleIndex] = Vec3();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::UnattachRopeParticle(int ropeHandle, int ropeParticleIndex)
+{
+	RopePoolRope& rope = m_ropes[GetRopeIndex(ropeHandle)];
+	GUARANTEE_OR_DIE(ropeParticleIndex >= 0 && ropeParticleIndex < rope.m_numParticles, "Rope particle index out of range");
+	int particleIndex = rope.m_firstParticleIndex + ropeParticleIndex;
+	if (particleIndex == rope.m_grabbedParticleIndex)
+	{
+		rope.m_wasGrabbedParticleAttached = 0;
+		return;
+	}
+	m_particles.m_isAttached[particleIndex] = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::GrabRopeParticle(int ropeHandle, int ropeParticleIndex, Vec3 const& position)
+{
+	RopePoolRope& rope = m_ropes[GetRopeIndex(ropeHandle)];
+	GUARANTEE_OR_DIE(ropeParticleIndex >= 0 && ropeParticleIndex < rope.m_numParticles, "Rope particle index out of range");
+	int particleIndex = rope.m_firstParticleIndex + ropeParticleIndex;
+	if (rope.m_grabbedParticleIndex != particleIndex)
+	{
+		ReleaseGrabbedRopeParticle(ropeHandle);
+		rope.m_grabbedParticleIndex = particleIndex;
+		rope.m_wasGrabbedParticleAttached = m_particles.m_isAttached[particleIndex];
+	}
+	MoveGrabbedRopeParticle(ropeHandle, position);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::MoveGrabbedRopeParticle(int ropeHandle, Vec3 const& position)
+{
+	RopePoolRope const& rope = m_ropes[GetRopeIndex(ropeHandle)];
+	int particleIndex = rope.m_grabbedParticleIndex;
+	if (particleIndex == -1)
+	{
+		return;
+	}
+
+	//A grabbed particle is pinned wherever the grab moves it, call again every frame the grab moves
+	m_particles.m_isAttached[particleIndex] = 1;
+	m_particles.m_positions[particleIndex] = position;
+	m_particles.m_proposedPositions[particleIndex] = position;
+	m_particles.m_velocities[particleIndex] = Vec3();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ReleaseGrabbedRopeParticle(int ropeHandle)
+{
+	RopePoolRope& rope = m_ropes[GetRopeIndex(ropeHandle)];
+	if (rope.m_grabbedParticleIndex == -1)
+	{
+		return;
+	}
+
+	m_particles.m_isAttached[rope.m_grabbedParticleIndex] = rope.m_wasGrabbedParticleAttached;
+	rope.m_grabbedParticleIndex = -1;
+	rope.m_wasGrabbedParticleAttached = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::Update(float deltaSeconds)
+{
+	PROFILE_SCOPE("RopePool::Update");
+
+	//Standalone stepping, a shared FixedTimestepScheduler calls the overrides below directly instead
+	m_fixedTimestepScheduler.SetFixedTimestep(m_config.m_physicsTimestep);
+	m_fixedTimestepScheduler.AddSimulation(this);
+	m_fixedTimestepScheduler.Update(deltaSeconds);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::AddVertsForRopes(std::vector<Vertex_PCU>& verts, Rgba8 const& color) const
+{
+	for (int ropeIndex = 0; ropeIndex < GetNumRopes(); ropeIndex++)
+	{
+		RopePoolRope const& rope = m_ropes[ropeIndex];
+		for (int particleIndex = rope.m_firstParticleIndex + 1; particleIndex < rope.m_firstParticleIndex + rope.m_numParticles; particleIndex++)
+		{
+			AddVertsForCylinder3D(verts, GetRenderPosition(particleIndex - 1), GetRenderPosition(particleIndex), m_config.m_ropeRadius, color);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+Vec3 RopePool::GetRenderPosition(int particleIndex) const
+{
+	Vec3 const& currentPosition = m_particles.m_positions[particleIndex];
+	if (m_previousPositions.size() != m_particles.m_positions.size())
+	{
+		return currentPosition;
+	}
+
+	Vec3 const& previousPosition = m_previousPositions[particleIndex];
+	return previousPosition + (currentPosition - previousPosition) * m_interpolationAlpha;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::SavePreviousState()
+{
+	m_previousPositions = m_particles.m_positions;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::FixedUpdate(float fixedDeltaSeconds)
+{
+	PROFILE_SCOPE("RopePool::FixedUpdate");
+
+	m_config.m_physicsTimestep = fixedDeltaSeconds;
+	if (m_ropes.empty())
+	{
+		return;
+	}
+
+	//Hand out whole ropes, cutting a new job each time the running particle count passes an even share
+	int numJobs = GetNumJobs();
+	while (static_cast<int>(m_jobs.size()) < numJobs)
+	{
+		m_jobs.push_back(new RopePoolJob(this));
+	}
+
+	int numParticlesPerJob = (GetNumParticles() + numJobs - 1) / numJobs;
+	int ropeIndex = 0;
+	for (int jobIndex = 0; jobIndex < numJobs; jobIndex++)
+	{
+		RopePoolJob* job = m_jobs[jobIndex];
+		job->m_firstRopeIndex = ropeIndex;
+		int jobEndParticleIndex = (jobIndex + 1) * numParticlesPerJob;
+		while (ropeIndex < GetNumRopes() && (m_ropes[ropeIndex].m_firstParticleIndex < jobEndParticleIndex || jobIndex == numJobs - 1))
+		{
+			ropeIndex++;
+		}
+		job->m_endRopeIndex = ropeIndex;
+	}
+
+	//Rope against rope contacts couple jobs together, so they get their own serial pass between solving and finishing
+	if (!m_config.m_isRopeCollisionEnabled && !m_config.m_isSelfCollisionEnabled)
+	{
+		RunJobs(numJobs, true, true);
+		return;
+	}
+
+	RunJobs(numJobs, true, false);
+	UpdateRopeCollisionBroadphase();
+	for (int iterationIndex = 0; iterationIndex < m_config.m_totalRopeCollisionIterations; iterationIndex++)
+	{
+		for (int pairIndex = 0; pairIndex < static_cast<int>(m_ropeCollisionPairs.size()); pairIndex++)
+		{
+			ProjectRopeCollisionConstraint(m_ropeCollisionPairs[pairIndex].x, m_ropeCollisionPairs[pairIndex].y);
+		}
+	}
+	RunJobs(numJobs, false, true);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::EndFixedUpdates(float interpolationAlpha)
+{
+	m_interpolationAlpha = interpolationAlpha;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::StepRopes(RopePoolJob& job)
+{
+	for (int ropeIndex = job.m_firstRopeIndex; ropeIndex < job.m_endRopeIndex; ropeIndex++)
+	{
+		if (job.m_isSolving)
+		{
+			SolveRope(job, m_ropes[ropeIndex]);
+		}
+		if (job.m_isFinishing)
+		{
+			FinishRope(m_ropes[ropeIndex]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::RunJobs(int numJobs, bool isSolving, bool isFinishing)
+{
+	for (int jobIndex = 0; jobIndex < numJobs; jobIndex++)
+	{
+		RopePoolJob* job = m_jobs[jobIndex];
+		job->m_isSolving = isSolving;
+		job->m_isFinishing = isFinishing;
+	}
+	RunJobsAndWait(m_jobs, numJobs);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::SolveRope(RopePoolJob& job, RopePoolRope const& rope)
+{
+	float physicsTimestep = m_config.m_physicsTimestep;
+	int firstParticleIndex = rope.m_firstParticleIndex;
+	int endParticleIndex = rope.m_firstParticleIndex + rope.m_numParticles;
+
+	//Propose Positions
+	for (int particleIndex = firstParticleIndex; particleIndex < endParticleIndex; particleIndex++)
+	{
+		m_isParticleInContact[particleIndex] = 0;
+		if (m_particles.m_isAttached[particleIndex] == 1)
+		{
+			m_particles.m_proposedPositions[particleIndex] = m_particles.m_positions[particleIndex];
+			continue;
+		}
+
+		Vec3 velocity = m_particles.m_velocities[particleIndex];
+		velocity += Vec3(0.0f, 0.0f, -m_config.m_gravityCoefficient) * physicsTimestep;
+		velocity *= m_config.m_dampingCoefficient;
+		m_particles.m_proposedPositions[particleIndex] = m_particles.m_positions[particleIndex] + velocity * physicsTimestep;
+	}
+
+	//Constraint Projection
+	for (int solverIndex = 0; solverIndex < m_config.m_totalSolverIterations; solverIndex++)
+	{
+		for (int constraintIndex = rope.m_firstDistanceConstraintIndex; constraintIndex < rope.m_firstDistanceConstraintIndex + rope.m_numDistanceConstraints; constraintIndex++)
+		{
+			ProjectDistanceConstraint(constraintIndex);
+		}
+		for (int constraintIndex = rope.m_firstBendingConstraintIndex; constraintIndex < rope.m_firstBendingConstraintIndex + rope.m_numBendingConstraints; constraintIndex++)
+		{
+			ProjectBendingConstraint(constraintIndex);
+		}
+		for (int particleIndex = firstParticleIndex; particleIndex < endParticleIndex; particleIndex++)
+		{
+			ProjectWorldBoundsConstraints(particleIndex);
+		}
+		ProjectCollisionWorldConstraints(job, rope);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::FinishRope(RopePoolRope const& rope)
+{
+	float physicsTimestep = m_config.m_physicsTimestep;
+	int firstParticleIndex = rope.m_firstParticleIndex;
+	int endParticleIndex = rope.m_firstParticleIndex + rope.m_numParticles;
+
+	//Velocity and Friction Updates
+	for (int particleIndex = firstParticleIndex; particleIndex < endParticleIndex; particleIndex++)
+	{
+		Vec3& velocity = m_particles.m_velocities[particleIndex];
+		velocity = (m_particles.m_proposedPositions[particleIndex] - m_particles.m_positions[particleIndex]) / physicsTimestep;
+
+		Vec3& collisionNormal = m_particles.m_collisionNormals[particleIndex];
+		if (collisionNormal != Vec3())
+		{
+			Vec3 tangentalFriction = GetProjectedOnto3D(velocity, collisionNormal) - velocity;
+			velocity += tangentalFriction * m_config.m_kineticFrictionCoefficient;
+			collisionNormal = Vec3();
+		}
+
+		m_particles.m_positions[particleIndex] = m_particles.m_proposedPositions[particleIndex];
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ProjectDistanceConstraint(int constraintIndex)
+{
+	int particleIndexA = m_distanceConstraintIndices[constraintIndex].x;
+	int particleIndexB = m_distanceConstraintIndices[constraintIndex].y;
+	Vec3& proposedPositionA = m_particles.m_proposedPositions[particleIndexA];
+	Vec3& proposedPositionB = m_particles.m_proposedPositions[particleIndexB];
+	bool isAttachedA = m_particles.m_isAttached[particleIndexA] != 0;
+	bool isAttachedB = m_particles.m_isAttached[particleIndexB] != 0;
+	if (isAttachedA && isAttachedB)
+	{
+		return;
+	}
+
+	Vec3 displacement = proposedPositionB - proposedPositionA;
+	float distanceConstraint = displacement.GetLength() - m_distanceConstraintRestLengths[constraintIndex];
+	if (distanceConstraint == 0.0f)
+	{
+		return;
+	}
+
+	Vec3 gradient = displacement.GetNormalized();
+	float coefficientValue = distanceConstraint < 0.0f ? m_config.m_compressionCoefficient : m_config.m_stretchingCoefficient;
+	float inverseMassA = isAttachedA ? 0.0f : m_particles.m_inverseMasses[particleIndexA];
+	float inverseMassB = isAttachedB ? 0.0f : m_particles.m_inverseMasses[particleIndexB];
+	Vec3 correction = gradient * (coefficientValue * distanceConstraint / (inverseMassA + inverseMassB));
+	proposedPositionA += correction * inverseMassA;
+	proposedPositionB -= correction * inverseMassB;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ProjectBendingConstraint(int constraintIndex)
+{
+	int particleIndexA = m_bendingConstraintIndices[constraintIndex].x;
+	int particleIndexC = m_bendingConstraintIndices[constraintIndex].y;
+	Vec3& proposedPositionA = m_particles.m_proposedPositions[particleIndexA];
+	Vec3& proposedPositionC = m_particles.m_proposedPositions[particleIndexC];
+	bool isAttachedA = m_particles.m_isAttached[particleIndexA] != 0;
+	bool isAttachedC = m_particles.m_isAttached[particleIndexC] != 0;
+	if (isAttachedA && isAttachedC)
+	{
+		return;
+	}
+
+	//Only pushes the ends of a bend apart, a straight span needs no correction
+	Vec3 displacement = proposedPositionC - proposedPositionA;
+	float distanceConstraint = displacement.GetLength() - m_bendingConstraintRestLengths[constraintIndex];
+	if (distanceConstraint > 0.0f)
+	{
+		return;
+	}
+
+	Vec3 gradient = displacement.GetNormalized();
+	Vec3 directionCheck = (m_particles.m_proposedPositions[particleIndexA + 1] - proposedPositionA).GetNormalized();
+	if (gradient == directionCheck)
+	{
+		return;
+	}
+
+	float inverseMassA = isAttachedA ? 0.0f : m_particles.m_inverseMasses[particleIndexA];
+	float inverseMassC = isAttachedC ? 0.0f : m_particles.m_inverseMasses[particleIndexC];
+	Vec3 correction = gradient * (m_config.m_bendingCoefficient * distanceConstraint / (inverseMassA + inverseMassC));
+	proposedPositionA += correction * inverseMassA;
+	proposedPositionC -= correction * inverseMassC;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ProjectWorldBoundsConstraints(int particleIndex)
+{
+	Vec3& proposedPosition = m_particles.m_proposedPositions[particleIndex];
+	Vec3 mins = m_config.m_worldBounds.m_mins + Vec3(m_config.m_ropeRadius, m_config.m_ropeRadius, m_config.m_ropeRadius);
+	Vec3 maxs = m_config.m_worldBounds.m_maxs - Vec3(m_config.m_ropeRadius, m_config.m_ropeRadius, m_config.m_ropeRadius);
+	Vec3& collisionNormal = m_particles.m_collisionNormals[particleIndex];
+	if (proposedPosition.z < mins.z)
+	{
+		proposedPosition.z = mins.z;
+		collisionNormal = Vec3(0.0f, 0.0f, 1.0f);
+	}
+	if (proposedPosition.z > maxs.z)
+	{
+		proposedPosition.z = maxs.z;
+		collisionNormal = Vec3(0.0f, 0.0f, -1.0f);
+	}
+	if (proposedPosition.x < mins.x)
+	{
+		proposedPosition.x = mins.x;
+		collisionNormal = Vec3(1.0f, 0.0f, 0.0f);
+	}
+	if (proposedPosition.x > maxs.x)
+	{
+		proposedPosition.x = maxs.x;
+		collisionNormal = Vec3(-1.0f, 0.0f, 0.0f);
+	}
+	if (proposedPosition.y < mins.y)
+	{
+		proposedPosition.y = mins.y;
+		collisionNormal = Vec3(0.0f, 1.0f, 0.0f);
+	}
+	if (proposedPosition.y > maxs.y)
+	{
+		proposedPosition.y = maxs.y;
+		collisionNormal = Vec3(0.0f, -1.0f, 0.0f);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ProjectCollisionWorldConstraints(RopePoolJob& job, RopePoolRope const& rope)
+{
+	if (m_config.m_collisionWorld == nullptr)
+	{
+		return;
+	}
+
+	//One batched query per rope, with the rope's proposed positions copied into the job's own scratch
+	job.m_queryCenters.assign(m_particles.m_proposedPositions.begin() + rope.m_firstParticleIndex,
+		m_particles.m_proposedPositions.begin() + rope.m_firstParticleIndex + rope.m_numParticles);
+	job.m_contacts.clear();
+	m_config.m_collisionWorld->QuerySphereContacts(job.m_queryCenters, m_config.m_ropeRadius, job.m_contacts, job.m_candidateHandles);
+	for (int contactIndex = 0; contactIndex < static_cast<int>(job.m_contacts.size()); contactIndex++)
+	{
+		CollisionContact const& contact = job.m_contacts[contactIndex];
+		int particleIndex = rope.m_firstParticleIndex + contact.m_queryIndex;
+		if (m_particles.m_isAttached[particleIndex])
+		{
+			continue;
+		}
+
+		m_particles.m_proposedPositions[particleIndex] += contact.m_correction;
+		m_particles.m_collisionNormals[particleIndex] = contact.m_correction.GetNormalized();
+		m_isParticleInContact[particleIndex] = 1;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::UpdateRopeCollisionBroadphase()
+{
+	PROFILE_SCOPE("RopePool::UpdateRopeCollisionBroadphase");
+
+	//Pairs were gathered with a skin around each capsule, so they stay complete until two particles could have closed that gap
+	if (!m_isBroadphaseDirty && m_broadphasePositions.size() == m_particles.m_proposedPositions.size())
+	{
+		float maxDistanceSquared = 0.25f * m_config.m_ropeCollisionSkinDistance * m_config.m_ropeCollisionSkinDistance;
+		bool isStale = false;
+		for (int particleIndex = 0; particleIndex < GetNumParticles(); particleIndex++)
+		{
+			if ((m_particles.m_proposedPositions[particleIndex] - m_broadphasePositions[particleIndex]).GetLengthSquared() > maxDistanceSquared)
+			{
+				isStale = true;
+				break;
+			}
+		}
+		if (!isStale)
+		{
+			return;
+		}
+	}
+
+	RebuildRopeCollisionPairs();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::RebuildRopeCollisionPairs()
+{
+	PROFILE_SCOPE("RopePool::RebuildRopeCollisionPairs");
+
+	m_broadphasePositions = m_particles.m_proposedPositions;
+	m_ropeCollisionPairs.clear();
+	m_isBroadphaseDirty = false;
+	m_numBroadphaseRebuilds++;
+	int numSegments = static_cast<int>(m_distanceConstraintIndices.size());
+	if (numSegments == 0)
+	{
+		return;
+	}
+
+	//Hash segment midpoints, with cells sized so one neighbourhood covers the longest segment reaching the longest segment
+	m_segmentMidpoints.resize(numSegments);
+	float maxHalfLength = 0.0f;
+	for (int segmentIndex = 0; segmentIndex < numSegments; segmentIndex++)
+	{
+		Vec3 const& start = m_broadphasePositions[m_distanceConstraintIndices[segmentIndex].x];
+		Vec3 const& end = m_broadphasePositions[m_distanceConstraintIndices[segmentIndex].y];
+		m_segmentMidpoints[segmentIndex] = (start + end) * 0.5f;
+		maxHalfLength = std::max(maxHalfLength, (end - start).GetLength() * 0.5f);
+	}
+	float contactDistance = 2.0f * m_config.m_ropeRadius + m_config.m_ropeCollisionSkinDistance;
+	m_segmentSpatialHash.SetCellSize(2.0f * maxHalfLength + contactDistance);
+	m_segmentSpatialHash.Build(m_segmentMidpoints);
+
+	for (int segmentIndexA = 0; segmentIndexA < numSegments; segmentIndexA++)
+	{
+		Vec3 const& startA = m_broadphasePositions[m_distanceConstraintIndices[segmentIndexA].x];
+		Vec3 const& endA = m_broadphasePositions[m_distanceConstraintIndices[segmentIndexA].y];
+		float halfLengthA = (endA - startA).GetLength() * 0.5f;
+		m_segmentSpatialHash.QueryRadius(m_segmentMidpoints[segmentIndexA], halfLengthA + maxHalfLength + contactDistance, m_segmentQueryResults);
+		for (int resultIndex = 0; resultIndex < static_cast<int>(m_segmentQueryResults.size()); resultIndex++)
+		{
+			int segmentIndexB = m_segmentQueryResults[resultIndex];
+			if (segmentIndexB <= segmentIndexA || IsRopeCollisionPairFiltered(segmentIndexA, segmentIndexB))
+			{
+				continue;
+			}
+
+			Vec3 const& startB = m_broadphasePositions[m_distanceConstraintIndices[segmentIndexB].x];
+			Vec3 const& endB = m_broadphasePositions[m_distanceConstraintIndices[segmentIndexB].y];
+			float boundingDistance = halfLengthA + (endB - startB).GetLength() * 0.5f + contactDistance;
+			if ((m_segmentMidpoints[segmentIndexA] - m_segmentMidpoints[segmentIndexB]).GetLengthSquared() > boundingDistance * boundingDistance)
+			{
+				continue;
+			}
+
+			float parameterA = 0.0f;
+			float parameterB = 0.0f;
+			GetNearestSegmentParameters(startA, endA, startB, endB, parameterA, parameterB);
+			Vec3 nearestPointA = startA + (endA - startA) * parameterA;
+			Vec3 nearestPointB = startB + (endB - startB) * parameterB;
+			if ((nearestPointA - nearestPointB).GetLengthSquared() < contactDistance * contactDistance)
+			{
+				m_ropeCollisionPairs.push_back(IntVec2(segmentIndexA, segmentIndexB));
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RopePool::IsRopeCollisionPairFiltered(int segmentIndexA, int segmentIndexB) const
+{
+	if (m_distanceConstraintRopeHandles[segmentIndexA] != m_distanceConstraintRopeHandles[segmentIndexB])
+	{
+		return !m_config.m_isRopeCollisionEnabled;
+	}
+
+	//Neighbouring segments of one rope always touch, so only distant parts of the same rope may collide
+	return !m_config.m_isSelfCollisionEnabled || abs(segmentIndexA - segmentIndexB) <= m_config.m_numAdjacentSegmentsToSkip;
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ProjectRopeCollisionConstraint(int segmentIndexA, int segmentIndexB)
+{
+	int particleIndices[4] = { m_distanceConstraintIndices[segmentIndexA].x, m_distanceConstraintIndices[segmentIndexA].y,
+		m_distanceConstraintIndices[segmentIndexB].x, m_distanceConstraintIndices[segmentIndexB].y };
+	Vec3& startA = m_particles.m_proposedPositions[particleIndices[0]];
+	Vec3& endA = m_particles.m_proposedPositions[particleIndices[1]];
+	Vec3& startB = m_particles.m_proposedPositions[particleIndices[2]];
+	Vec3& endB = m_particles.m_proposedPositions[particleIndices[3]];
+	float parameterA = 0.0f;
+	float parameterB = 0.0f;
+	GetNearestSegmentParameters(startA, endA, startB, endB, parameterA, parameterB);
+	Vec3 separation = (startA + (endA - startA) * parameterA) - (startB + (endB - startB) * parameterB);
+	float distance = separation.GetLength();
+	float penetration = 2.0f * m_config.m_ropeRadius - distance;
+	if (penetration <= 0.0f || distance == 0.0f)
+	{
+		return;
+	}
+
+	//Each endpoint is pushed along the contact normal by its share of the nearest point and its inverse mass
+	Vec3 normal = separation / distance;
+	float weights[4] = { 1.0f - parameterA, parameterA, -(1.0f - parameterB), -parameterB };
+	float inverseMasses[4];
+	float denominator = 0.0f;
+	for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+	{
+		int particleIndex = particleIndices[cornerIndex];
+		inverseMasses[cornerIndex] = m_particles.m_isAttached[particleIndex] ? 0.0f : m_particles.m_inverseMasses[particleIndex];
+		denominator += inverseMasses[cornerIndex] * weights[cornerIndex] * weights[cornerIndex];
+	}
+	if (denominator == 0.0f)
+	{
+		return;
+	}
+
+	float lambda = penetration / denominator;
+	for (int cornerIndex = 0; cornerIndex < 4; cornerIndex++)
+	{
+		if (inverseMasses[cornerIndex] == 0.0f || weights[cornerIndex] == 0.0f)
+		{
+			continue;
+		}
+
+		int particleIndex = particleIndices[cornerIndex];
+		m_particles.m_proposedPositions[particleIndex] += normal * (lambda * inverseMasses[cornerIndex] * weights[cornerIndex]);
+		m_particles.m_collisionNormals[particleIndex] = weights[cornerIndex] > 0.0f ? normal : normal * -1.0f;
+		m_isParticleInContact[particleIndex] = 1;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::UpdateLevelOfDetail(Vec3 const& cameraPosition)
+{
+	PROFILE_SCOPE("RopePool::UpdateLevelOfDetail");
+
+	//Nearest ropes first, so they get first claim on the particle budget
+	int numRopes = GetNumRopes();
+	m_lodRopeOrder.resize(numRopes);
+	m_lodRopeDistancesSquared.resize(numRopes);
+	for (int ropeIndex = 0; ropeIndex < numRopes; ropeIndex++)
+	{
+		RopePoolRope const& rope = m_ropes[ropeIndex];
+		Vec3 const& middlePosition = m_particles.m_positions[rope.m_firstParticleIndex + rope.m_numParticles / 2];
+		m_lodRopeOrder[ropeIndex] = ropeIndex;
+		m_lodRopeDistancesSquared[ropeIndex] = (middlePosition - cameraPosition).GetLengthSquared();
+	}
+	std::sort(m_lodRopeOrder.begin(), m_lodRopeOrder.end(), [this](int ropeIndexA, int ropeIndexB)
+		{ return m_lodRopeDistancesSquared[ropeIndexA] < m_lodRopeDistancesSquared[ropeIndexB]; });
+
+	m_lodRopeRanges.assign(numRopes, IntVec2(-1, 0));
+	m_lodGrabbedRopeParticleIndices.assign(numRopes, -1);
+	m_lodPositions.clear();
+	m_lodPreviousPositions.clear();
+	m_lodVelocities.clear();
+	m_lodMasses.clear();
+	m_lodIsAttached.clear();
+	m_lodRestLengths.clear();
+	bool hasChanged = false;
+	int numParticlesAvailable = m_config.m_maxParticles > 0 ? m_config.m_maxParticles - GetNumParticles() : INT_MAX;	// never charged when uncapped
+	for (int orderIndex = 0; orderIndex < numRopes; orderIndex++)
+	{
+		if (ResampleRope(m_lodRopeOrder[orderIndex], cameraPosition, numParticlesAvailable))
+		{
+			hasChanged = true;
+		}
+	}
+
+	if (hasChanged)
+	{
+		CompactResampledRopes();
+		m_isBroadphaseDirty = true;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// One greedy pass along the rope that drops flat particles whose merged span still fits the wanted spacing, and halves
+// spans that are too long for it or sit on a bend or contact. The result is appended to the scratch arrays for
+// CompactResampledRopes. Returns false, leaving the scratch arrays as they were, when the rope already fits.
+bool RopePool::ResampleRope(int ropeIndex, Vec3 const& cameraPosition, int& numParticlesAvailable)
+{
+	RopePoolRope const& rope = m_ropes[ropeIndex];
+	int firstParticleIndex = rope.m_firstParticleIndex;
+	int numParticles = rope.m_numParticles;
+	float mergeCosine = CosDegrees(m_config.m_lodMergeAngleDegrees);
+	float splitCosine = CosDegrees(m_config.m_lodSplitAngleDegrees);
+	float minRestLength = rope.m_baseRestLength * 0.999f;
+	bool isParticleBudgetCapped = m_config.m_maxParticles > 0;
+	bool hasPreviousPositions = m_previousPositions.size() == m_particles.m_positions.size();
+	int firstResampledIndex = static_cast<int>(m_lodPositions.size());
+
+	bool hasChanged = false;
+	int numMergedParticles = 0;
+	int newGrabbedRopeParticleIndex = -1;
+	int lastKeptParticleIndex = -1;
+	float restLengthSinceLastKept = 0.0f;
+	float carriedMass = 0.0f;
+	Vec3 carriedMomentum;
+	for (int ropeParticleIndex = 0; ropeParticleIndex < numParticles; ropeParticleIndex++)
+	{
+		int particleIndex = firstParticleIndex + ropeParticleIndex;
+		Vec3 const& position = m_particles.m_positions[particleIndex];
+		float mass = m_particles.m_masses[particleIndex];
+		if (ropeParticleIndex > 0)
+		{
+			restLengthSinceLastKept += m_distanceConstraintRestLengths[rope.m_firstDistanceConstraintIndex + ropeParticleIndex - 1];
+		}
+
+		//Merge, splitting the dropped particle's mass and momentum between its kept neighbours by distance
+		bool isInterior = ropeParticleIndex > 0 && ropeParticleIndex < numParticles - 1;
+		if (isInterior && m_particles.m_isAttached[particleIndex] == 0 && m_isParticleInContact[particleIndex] == 0 && particleIndex != rope.m_grabbedParticleIndex)
+		{
+			float nextRestLength = m_distanceConstraintRestLengths[rope.m_firstDistanceConstraintIndex + ropeParticleIndex];
+			Vec3 const& lastKeptPosition = m_particles.m_positions[lastKeptParticleIndex];
+			Vec3 const& nextPosition = m_particles.m_positions[particleIndex + 1];
+			float bendCosine = DotProduct3D((position - lastKeptPosition).GetNormalized(), (nextPosition - position).GetNormalized());
+			if (bendCosine > mergeCosine && restLengthSinceLastKept + nextRestLength <= GetLevelOfDetailSpacing(rope, position, cameraPosition))
+			{
+				float fractionToNext = restLengthSinceLastKept / (restLengthSinceLastKept + nextRestLength);
+				Vec3 momentum = m_particles.m_velocities[particleIndex] * mass;
+				float lastKeptMass = m_lodMasses.back();
+				m_lodVelocities.back() = (m_lodVelocities.back() * lastKeptMass + momentum * (1.0f - fractionToNext)) / (lastKeptMass + mass * (1.0f - fractionToNext));
+				m_lodMasses.back() += mass * (1.0f - fractionToNext);
+				carriedMass += mass * fractionToNext;
+				carriedMomentum += momentum * fractionToNext;
+				numMergedParticles++;
+				hasChanged = true;
+				continue;
+			}
+		}
+
+		//Split the span back to the last kept particle in half
+		Vec3 velocity = (m_particles.m_velocities[particleIndex] * mass + carriedMomentum) / (mass + carriedMass);
+		mass += carriedMass;
+		carriedMass = 0.0f;
+		carriedMomentum = Vec3();
+		if (ropeParticleIndex > 0 && numParticlesAvailable > 0 && restLengthSinceLastKept * 0.5f >= minRestLength)
+		{
+			Vec3 const& lastKeptPosition = m_particles.m_positions[lastKeptParticleIndex];
+			float wantedSpacing = GetLevelOfDetailSpacing(rope, (lastKeptPosition + position) * 0.5f, cameraPosition);
+			bool isDetailNeeded = m_isParticleInContact[lastKeptParticleIndex] != 0 || m_isParticleInContact[particleIndex] != 0;
+			if (!isDetailNeeded && lastKeptParticleIndex > firstParticleIndex)
+			{
+				Vec3 const& beforeLastKeptPosition = m_lodPositions[m_lodPositions.size() - 2];
+				isDetailNeeded = DotProduct3D((lastKeptPosition - beforeLastKeptPosition).GetNormalized(), (position - lastKeptPosition).GetNormalized()) < splitCosine;
+			}
+			if (restLengthSinceLastKept > 1.5f * wantedSpacing || isDetailNeeded)
+			{
+				float lastKeptMassShare = m_lodMasses.back() * 0.25f;
+				float massShare = mass * 0.25f;
+				m_lodMasses.back() -= lastKeptMassShare;
+				mass -= massShare;
+				m_lodPositions.push_back((lastKeptPosition + position) * 0.5f);
+				m_lodPreviousPositions.push_back(hasPreviousPositions ? (m_previousPositions[lastKeptParticleIndex] + m_previousPositions[particleIndex]) * 0.5f : m_lodPositions.back());
+				m_lodVelocities.push_back((m_lodVelocities.back() * lastKeptMassShare + velocity * massShare) / (lastKeptMassShare + massShare));
+				m_lodMasses.push_back(lastKeptMassShare + massShare);
+				m_lodIsAttached.push_back(0);
+				m_lodRestLengths.push_back(restLengthSinceLastKept * 0.5f);
+				restLengthSinceLastKept *= 0.5f;
+				if (isParticleBudgetCapped)
+				{
+					numParticlesAvailable--;
+				}
+				hasChanged = true;
+			}
+		}
+
+		if (particleIndex == rope.m_grabbedParticleIndex)
+		{
+			newGrabbedRopeParticleIndex = static_cast<int>(m_lodPositions.size()) - firstResampledIndex;
+		}
+		m_lodPositions.push_back(position);
+		m_lodPreviousPositions.push_back(hasPreviousPositions ? m_previousPositions[particleIndex] : position);
+		m_lodVelocities.push_back(velocity);
+		m_lodMasses.push_back(mass);
+		m_lodIsAttached.push_back(m_particles.m_isAttached[particleIndex]);
+		m_lodRestLengths.push_back(restLengthSinceLastKept);
+		lastKeptParticleIndex = particleIndex;
+		restLengthSinceLastKept = 0.0f;
+	}
+
+	int newNumParticles = static_cast<int>(m_lodPositions.size()) - firstResampledIndex;
+	if (!hasChanged)
+	{
+		m_lodPositions.resize(firstResampledIndex);
+		m_lodPreviousPositions.resize(firstResampledIndex);
+		m_lodVelocities.resize(firstResampledIndex);
+		m_lodMasses.resize(firstResampledIndex);
+		m_lodIsAttached.resize(firstResampledIndex);
+		m_lodRestLengths.resize(firstResampledIndex);
+		return false;
+	}
+
+	//Splits were charged as they were made, merged particles go back to the ropes further out
+	if (isParticleBudgetCapped)
+	{
+		numParticlesAvailable += numMergedParticles;
+	}
+	m_lodRopeRanges[ropeIndex] = IntVec2(firstResampledIndex, newNumParticles);
+	m_lodGrabbedRopeParticleIndices[ropeIndex] = newGrabbedRopeParticleIndex;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Writes every resampled rope back over its old range. Unchanged ropes keep their data and only slide by the growth of
+// the resampled ropes before them, ropes in front of the first resampled rope are not touched at all.
+void RopePool::CompactResampledRopes()
+{
+	bool hasPreviousPositions = m_previousPositions.size() == m_particles.m_positions.size();
+	int numRopes = GetNumRopes();
+	int oldNumParticles = GetNumParticles();
+
+	//A rope's constraint counts follow its particle count, so its constraint ranges slide by the same offset as its particles
+	m_lodRopeOffsets.resize(numRopes);
+	int offset = 0;
+	for (int ropeIndex = 0; ropeIndex < numRopes; ropeIndex++)
+	{
+		m_lodRopeOffsets[ropeIndex] = offset;
+		if (m_lodRopeRanges[ropeIndex].x != -1)
+		{
+			offset += m_lodRopeRanges[ropeIndex].y - m_ropes[ropeIndex].m_numParticles;
+		}
+	}
+	int newNumParticles = oldNumParticles + offset;
+	if (newNumParticles > oldNumParticles)
+	{
+		ResizeRopeArrays(newNumParticles, hasPreviousPositions);
+	}
+
+	//Ropes sliding down go front to back and ropes sliding up back to front, so none lands on one that has not moved yet
+	for (int ropeIndex = 0; ropeIndex < numRopes; ropeIndex++)
+	{
+		if (m_lodRopeRanges[ropeIndex].x == -1 && m_lodRopeOffsets[ropeIndex] < 0)
+		{
+			ShiftRope(m_ropes[ropeIndex], m_lodRopeOffsets[ropeIndex], hasPreviousPositions);
+		}
+	}
+	for (int ropeIndex = numRopes - 1; ropeIndex >= 0; ropeIndex--)
+	{
+		if (m_lodRopeRanges[ropeIndex].x == -1 && m_lodRopeOffsets[ropeIndex] > 0)
+		{
+			ShiftRope(m_ropes[ropeIndex], m_lodRopeOffsets[ropeIndex], hasPreviousPositions);
+		}
+	}
+
+	//Resampled ropes last, their new ranges only overlap data that has already moved out or is being replaced
+	for (int ropeIndex = 0; ropeIndex < numRopes; ropeIndex++)
+	{
+		IntVec2 const& resampledRange = m_lodRopeRanges[ropeIndex];
+		if (resampledRange.x == -1)
+		{
+			continue;
+		}
+
+		RopePoolRope& rope = m_ropes[ropeIndex];
+		int firstResampledIndex = resampledRange.x;
+		int endResampledIndex = resampledRange.x + resampledRange.y;
+		rope.m_firstParticleIndex += m_lodRopeOffsets[ropeIndex];
+		rope.m_firstDistanceConstraintIndex += m_lodRopeOffsets[ropeIndex];
+		rope.m_firstBendingConstraintIndex += m_lodRopeOffsets[ropeIndex];
+		rope.m_numParticles = resampledRange.y;
+		rope.m_numDistanceConstraints = resampledRange.y - 1;
+		rope.m_numBendingConstraints = resampledRange.y - 2;
+		if (m_lodGrabbedRopeParticleIndices[ropeIndex] != -1)
+		{
+			rope.m_grabbedParticleIndex = rope.m_firstParticleIndex + m_lodGrabbedRopeParticleIndices[ropeIndex];
+		}
+
+		std::copy(m_lodPositions.begin() + firstResampledIndex, m_lodPositions.begin() + endResampledIndex, m_particles.m_positions.begin() + rope.m_firstParticleIndex);
+		std::copy(m_lodVelocities.begin() + firstResampledIndex, m_lodVelocities.begin() + endResampledIndex, m_particles.m_velocities.begin() + rope.m_firstParticleIndex);
+		std::copy(m_lodPositions.begin() + firstResampledIndex, m_lodPositions.begin() + endResampledIndex, m_particles.m_proposedPositions.begin() + rope.m_firstParticleIndex);
+		std::copy(m_lodMasses.begin() + firstResampledIndex, m_lodMasses.begin() + endResampledIndex, m_particles.m_masses.begin() + rope.m_firstParticleIndex);
+		std::copy(m_lodIsAttached.begin() + firstResampledIndex, m_lodIsAttached.begin() + endResampledIndex, m_particles.m_isAttached.begin() + rope.m_firstParticleIndex);
+		if (hasPreviousPositions)
+		{
+			std::copy(m_lodPreviousPositions.begin() + firstResampledIndex, m_lodPreviousPositions.begin() + endResampledIndex, m_previousPositions.begin() + rope.m_firstParticleIndex);
+		}
+		for (int ropeParticleIndex = 0; ropeParticleIndex < rope.m_numParticles; ropeParticleIndex++)
+		{
+			int particleIndex = rope.m_firstParticleIndex + ropeParticleIndex;
+			int resampledIndex = firstResampledIndex + ropeParticleIndex;
+			m_particles.m_inverseMasses[particleIndex] = 1.0f / m_lodMasses[resampledIndex];
+			m_particles.m_collisionNormals[particleIndex] = Vec3();
+			m_isParticleInContact[particleIndex] = 0;
+			if (ropeParticleIndex > 0)
+			{
+				int constraintIndex = rope.m_firstDistanceConstraintIndex + ropeParticleIndex - 1;
+				m_distanceConstraintIndices[constraintIndex] = IntVec2(particleIndex - 1, particleIndex);
+				m_distanceConstraintRestLengths[constraintIndex] = m_lodRestLengths[resampledIndex];
+				m_distanceConstraintRopeHandles[constraintIndex] = rope.m_handle;
+			}
+			if (ropeParticleIndex > 1)
+			{
+				int constraintIndex = rope.m_firstBendingConstraintIndex + ropeParticleIndex - 2;
+				m_bendingConstraintIndices[constraintIndex] = IntVec2(particleIndex - 2, particleIndex);
+				m_bendingConstraintRestLengths[constraintIndex] = m_lodRestLengths[resampledIndex - 1] + m_lodRestLengths[resampledIndex];
+			}
+		}
+	}
+
+	if (newNumParticles < oldNumParticles)
+	{
+		ResizeRopeArrays(newNumParticles, hasPreviousPositions);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ShiftRope(RopePoolRope& rope, int offset, bool hasPreviousPositions)
+{
+	int firstParticleIndex = rope.m_firstParticleIndex;
+	int numParticles = rope.m_numParticles;
+	ShiftRange(m_particles.m_positions, firstParticleIndex, numParticles, offset);
+	ShiftRange(m_particles.m_velocities, firstParticleIndex, numParticles, offset);
+	ShiftRange(m_particles.m_proposedPositions, firstParticleIndex, numParticles, offset);
+	ShiftRange(m_particles.m_collisionNormals, firstParticleIndex, numParticles, offset);
+	ShiftRange(m_particles.m_masses, firstParticleIndex, numParticles, offset);
+	ShiftRange(m_particles.m_inverseMasses, firstParticleIndex, numParticles, offset);
+	ShiftRange(m_particles.m_isAttached, firstParticleIndex, numParticles, offset);
+	ShiftRange(m_isParticleInContact, firstParticleIndex, numParticles, offset);
+	if (hasPreviousPositions)
+	{
+		ShiftRange(m_previousPositions, firstParticleIndex, numParticles, offset);
+	}
+	ShiftRange(m_distanceConstraintIndices, rope.m_firstDistanceConstraintIndex, rope.m_numDistanceConstraints, offset);
+	ShiftRange(m_distanceConstraintRestLengths, rope.m_firstDistanceConstraintIndex, rope.m_numDistanceConstraints, offset);
+	ShiftRange(m_distanceConstraintRopeHandles, rope.m_firstDistanceConstraintIndex, rope.m_numDistanceConstraints, offset);
+	ShiftRange(m_bendingConstraintIndices, rope.m_firstBendingConstraintIndex, rope.m_numBendingConstraints, offset);
+	ShiftRange(m_bendingConstraintRestLengths, rope.m_firstBendingConstraintIndex, rope.m_numBendingConstraints, offset);
+
+	rope.m_firstParticleIndex += offset;
+	rope.m_firstDistanceConstraintIndex += offset;
+	rope.m_firstBendingConstraintIndex += offset;
+	if (rope.m_grabbedParticleIndex != -1)
+	{
+		rope.m_grabbedParticleIndex += offset;
+	}
+
+	IntVec2 indexOffset(offset, offset);
+	for (int constraintIndex = rope.m_firstDistanceConstraintIndex; constraintIndex < rope.m_firstDistanceConstraintIndex + rope.m_numDistanceConstraints; constraintIndex++)
+	{
+		m_distanceConstraintIndices[constraintIndex] = m_distanceConstraintIndices[constraintIndex] + indexOffset;
+	}
+	for (int constraintIndex = rope.m_firstBendingConstraintIndex; constraintIndex < rope.m_firstBendingConstraintIndex + rope.m_numBendingConstraints; constraintIndex++)
+	{
+		m_bendingConstraintIndices[constraintIndex] = m_bendingConstraintIndices[constraintIndex] + indexOffset;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::ResizeRopeArrays(int numParticles, bool hasPreviousPositions)
+{
+	m_particles.m_positions.resize(numParticles);
+	m_particles.m_velocities.resize(numParticles);
+	m_particles.m_proposedPositions.resize(numParticles);
+	m_particles.m_collisionNormals.resize(numParticles);
+	m_particles.m_masses.resize(numParticles);
+	m_particles.m_inverseMasses.resize(numParticles);
+	m_particles.m_isAttached.resize(numParticles);
+	m_isParticleInContact.resize(numParticles);
+	if (hasPreviousPositions)
+	{
+		m_previousPositions.resize(numParticles);
+	}
+
+	//Every rope has one distance constraint fewer than particles and two bending constraints fewer
+	int numDistanceConstraints = numParticles - GetNumRopes();
+	int numBendingConstraints = numParticles - 2 * GetNumRopes();
+	m_distanceConstraintIndices.resize(numDistanceConstraints);
+	m_distanceConstraintRestLengths.resize(numDistanceConstraints);
+	m_distanceConstraintRopeHandles.resize(numDistanceConstraints);
+	m_bendingConstraintIndices.resize(numBendingConstraints);
+	m_bendingConstraintRestLengths.resize(numBendingConstraints);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopePool::OffsetLaterRopes(int firstRopeIndex, int particleOffset, int distanceConstraintOffset, int bendingConstraintOffset)
+{
+	if (firstRopeIndex >= GetNumRopes())
+	{
+		return;
+	}
+
+	for (int ropeIndex = firstRopeIndex; ropeIndex < GetNumRopes(); ropeIndex++)
+	{
+		RopePoolRope& rope = m_ropes[ropeIndex];
+		rope.m_firstParticleIndex += particleOffset;
+		rope.m_firstDistanceConstraintIndex += distanceConstraintOffset;
+		rope.m_firstBendingConstraintIndex += bendingConstraintOffset;
+		if (rope.m_grabbedParticleIndex != -1)
+		{
+			rope.m_grabbedParticleIndex += particleOffset;
+		}
+		m_handleRopeIndices[rope.m_handle] = ropeIndex;
+	}
+
+	IntVec2 indexOffset(particleOffset, particleOffset);
+	for (int constraintIndex = m_ropes[firstRopeIndex].m_firstDistanceConstraintIndex; constraintIndex < static_cast<int>(m_distanceConstraintIndices.size()); constraintIndex++)
+	{
+		m_distanceConstraintIndices[constraintIndex] = m_distanceConstraintIndices[constraintIndex] + indexOffset;
+	}
+	for (int constraintIndex = m_ropes[firstRopeIndex].m_firstBendingConstraintIndex; constraintIndex < static_cast<int>(m_bendingConstraintIndices.size()); constraintIndex++)
+	{
+		m_bendingConstraintIndices[constraintIndex] = m_bendingConstraintIndices[constraintIndex] + indexOffset;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+float RopePool::GetLevelOfDetailSpacing(RopePoolRope const& rope, Vec3 const& position, Vec3 const& cameraPosition) const
+{
+	float cameraDistance = (position - cameraPosition).GetLength();
+	return rope.m_baseRestLength * RangeMapClamped(cameraDistance, m_config.m_lodNearDistance, m_config.m_lodFarDistance, 1.0f, m_config.m_lodMaxSpacingScale);
+}
+
+//-----------------------------------------------------------------------------------------------
+int RopePool::GetRopeIndex(int ropeHandle) const
+{
+	GUARANTEE_OR_DIE(IsValidRope(ropeHandle), "Invalid RopePool rope handle");
+	return m_handleRopeIndices[ropeHandle];
+}
+
+//-----------------------------------------------------------------------------------------------
+int RopePool::GetNumJobs() const
+{
+	int numWorkers = g_theJobSystem != nullptr && !g_theJobSystem->IsQuitting() ? g_theJobSystem->GetNumWorkers() : 0;
+	int numJobs = GetNumParticles() / m_config.m_minParticlesPerJob;
+	if (numJobs > numWorkers + 1)
+	{
+		numJobs = numWorkers + 1;
+	}
+	if (numJobs > GetNumRopes())
+	{
+		numJobs = GetNumRopes();
+	}
+	if (numJobs < 1)
+	{
+		numJobs = 1;
+	}
+	return numJobs;
+}
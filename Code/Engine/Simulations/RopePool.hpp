@@ -0,0 +1,192 @@
+#pragma once
+#include "Particles3D.hpp"
+#include "FixedTimestepScheduler.hpp"
+#include "CollisionWorld.hpp"
+#include "SpatialHash3D.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+struct	Vertex_PCU;
+class	RopePool;
+
+//-----------------------------------------------------------------------------------------------
+// Settings shared by every rope in a pool, per rope values are given to AddRope
+struct RopePoolConfig
+{
+	AABB3				m_worldBounds = AABB3(Vec3(-10.0f, -10.0f, 0.0f), Vec3(10.0f, 10.0f, 20.0f));
+	float				m_physicsTimestep = 0.0005f;
+	int					m_totalSolverIterations = 10;
+	float				m_dampingCoefficient = 0.999f;
+	float				m_stretchingCoefficient = 1.0f;
+	float				m_compressionCoefficient = 1.0f;
+	float				m_bendingCoefficient = 0.5f;
+	float				m_kineticFrictionCoefficient = 0.3f;
+	float				m_gravityCoefficient = 9.81f;
+	float				m_ropeRadius = 0.015f;
+	CollisionWorld*		m_collisionWorld = nullptr;			// optional shared scene, not owned
+	int					m_minParticlesPerJob = 1024;		// ropes are only split across workers once each job gets this many particles
+
+	//Rope against rope collisions between the segment capsules of every rope in the pool
+	bool				m_isRopeCollisionEnabled = false;
+	bool				m_isSelfCollisionEnabled = false;	// segments of the same rope, past the adjacent ones, also collide
+	int					m_numAdjacentSegmentsToSkip = 2;
+	int					m_totalRopeCollisionIterations = 2;
+	float				m_ropeCollisionSkinDistance = 0.05f;	// pair lists are reused until some particle moves half of this
+
+	//Level of detail, applied by UpdateLevelOfDetail and never finer than the spacing a rope was added with
+	int					m_maxParticles = 0;					// splits stop once the pool holds this many particles, 0 for no cap
+	float				m_lodNearDistance = 5.0f;			// full resolution inside this camera distance
+	float				m_lodFarDistance = 30.0f;			// coarsest spacing past this camera distance
+	float				m_lodMaxSpacingScale = 4.0f;		// coarsest spacing as a multiple of the spacing a rope was added with
+	float				m_lodMergeAngleDegrees = 5.0f;		// particles only merge where the rope bends less than this
+	float				m_lodSplitAngleDegrees = 20.0f;		// segments split back down where the rope bends more than this
+};
+
+//-----------------------------------------------------------------------------------------------
+// One rope's ranges into the pool's shared arrays. Ranges shift when an earlier rope is removed, so hold on to the handle instead.
+struct RopePoolRope
+{
+	int		m_handle = -1;
+	int		m_firstParticleIndex = 0;
+	int		m_numParticles = 0;
+	int		m_firstDistanceConstraintIndex = 0;
+	int		m_numDistanceConstraints = 0;
+	int		m_firstBendingConstraintIndex = 0;
+	int		m_numBendingConstraints = 0;
+	int		m_grabbedParticleIndex = -1;					// pool particle index, -1 when nothing is grabbed
+	int		m_wasGrabbedParticleAttached = 0;
+	float	m_baseRestLength = 0.0f;						// spacing at full resolution
+};
+
+//-----------------------------------------------------------------------------------------------
+// Steps a contiguous run of whole ropes. Ropes never share particles, so jobs can run their Gauss Seidel loops side by side.
+class RopePoolJob : public Job
+{
+public:
+	explicit RopePoolJob(RopePool* ropePool);
+	virtual ~RopePoolJob() = default;
+	virtual void Execute() override;
+
+public:
+	RopePool*						m_ropePool = nullptr;
+	int								m_firstRopeIndex = 0;
+	int								m_endRopeIndex = 0;
+	bool							m_isSolving = true;			// predict and project each rope's own constraints
+	bool							m_isFinishing = true;		// derive velocities and commit positions
+	std::vector<Vec3>				m_queryCenters;
+	std::vector<CollisionContact>	m_contacts;
+	std::vector<int>				m_candidateHandles;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Packs many CPU ropes into one set of SoA particle and constraint arrays with per-rope ranges, so a scene full of short
+// ropes pays the per-simulation overhead once and steps every rope in one parallel pass per substep. The solver matches
+// RopeSimulation3D's Gauss Seidel path with sphere collisions against the world bounds and the optional CollisionWorld.
+// Only the positions, velocities, proposed positions, collision normals, masses and attachment flags of m_particles are used.
+class RopePool : public FixedTimestepSimulation
+{
+public:
+	RopePool() {}
+	explicit RopePool(RopePoolConfig const& config);
+	~RopePool();
+
+	//Ropes, each handle stays valid until its rope is removed
+	int				AddRope(int numParticles, float totalMassOfRope, Vec3 const& start, Vec3 const& end, bool isStartAttached = true);
+	void			RemoveRope(int ropeHandle);
+	void			Clear();
+	bool			IsValidRope(int ropeHandle) const;
+	int				GetNumRopes() const { return static_cast<int>(m_ropes.size()); }
+	int				GetNumParticles() const { return static_cast<int>(m_particles.m_positions.size()); }
+	int				GetNumParticlesInRope(int ropeHandle) const;
+	int				GetNumRopeCollisionPairs() const { return static_cast<int>(m_ropeCollisionPairs.size()); }
+	int				GetNumBroadphaseRebuilds() const { return m_numBroadphaseRebuilds; }
+	Vec3			GetRopeParticlePosition(int ropeHandle, int ropeParticleIndex) const;
+	float			GetRopeLength(int ropeHandle) const;
+
+	//Interaction, particles are given as an index along their rope. UpdateLevelOfDetail renumbers the particles of every rope
+	//it resamples, so indices go stale after it; grab once and follow the cursor with MoveGrabbedRopeParticle instead.
+	void			AttachRopeParticle(int ropeHandle, int ropeParticleIndex, Vec3 const& position);
+	void			UnattachRopeParticle(int ropeHandle, int ropeParticleIndex);
+	void			GrabRopeParticle(int ropeHandle, int ropeParticleIndex, Vec3 const& position);
+	void			MoveGrabbedRopeParticle(int ropeHandle, Vec3 const& position);
+	void			ReleaseGrabbedRopeParticle(int ropeHandle);
+
+	//Update/Render
+	void			Update(float deltaSeconds);
+	void			UpdateLevelOfDetail(Vec3 const& cameraPosition);
+	void			AddVertsForRopes(std::vector<Vertex_PCU>& verts, Rgba8 const& color = Rgba8(142, 89, 60, 255)) const;
+	Vec3			GetRenderPosition(int particleIndex) const;
+
+	//Fixed Timestep Scheduling
+	virtual void	SavePreviousState() override;
+	virtual void	FixedUpdate(float fixedDeltaSeconds) override;
+	virtual void	EndFixedUpdates(float interpolationAlpha) override;
+
+	void			StepRopes(RopePoolJob& job);
+
+protected:
+	void			RunJobs(int numJobs, bool isSolving, bool isFinishing);
+	void			SolveRope(RopePoolJob& job, RopePoolRope const& rope);
+	void			FinishRope(RopePoolRope const& rope);
+	void			ProjectDistanceConstraint(int constraintIndex);
+	void			ProjectBendingConstraint(int constraintIndex);
+	void			ProjectWorldBoundsConstraints(int particleIndex);
+	void			ProjectCollisionWorldConstraints(RopePoolJob& job, RopePoolRope const& rope);
+	void			UpdateRopeCollisionBroadphase();
+	void			RebuildRopeCollisionPairs();
+	bool			IsRopeCollisionPairFiltered(int segmentIndexA, int segmentIndexB) const;
+	void			ProjectRopeCollisionConstraint(int segmentIndexA, int segmentIndexB);
+	bool			ResampleRope(int ropeIndex, Vec3 const& cameraPosition, int& numParticlesAvailable);
+	void			CompactResampledRopes();
+	void			ShiftRope(RopePoolRope& rope, int offset, bool hasPreviousPositions);
+	void			ResizeRopeArrays(int numParticles, bool hasPreviousPositions);
+	void			OffsetLaterRopes(int firstRopeIndex, int particleOffset, int distanceConstraintOffset, int bendingConstraintOffset);
+	float			GetLevelOfDetailSpacing(RopePoolRope const& rope, Vec3 const& position, Vec3 const& cameraPosition) const;
+	int				GetRopeIndex(int ropeHandle) const;
+	int				GetNumJobs() const;
+
+public:
+	RopePoolConfig				m_config;
+	Particles3D					m_particles;
+	std::vector<IntVec2>		m_distanceConstraintIndices;
+	std::vector<float>			m_distanceConstraintRestLengths;
+	std::vector<int>			m_distanceConstraintRopeHandles;	// each distance constraint doubles as a collision segment
+	std::vector<IntVec2>		m_bendingConstraintIndices;			// the two particles either side of a bend
+	std::vector<float>			m_bendingConstraintRestLengths;
+	std::vector<RopePoolRope>	m_ropes;
+	std::vector<int>			m_handleRopeIndices;				// rope index for each handle, -1 for free handles
+	std::vector<int>			m_freeHandles;
+	std::vector<Vec3>			m_previousPositions;
+	std::vector<int>			m_isParticleInContact;				// touched a CollisionWorld object or another segment last substep
+	float						m_interpolationAlpha = 0.0f;
+	FixedTimestepScheduler		m_fixedTimestepScheduler;
+	std::vector<RopePoolJob*>	m_jobs;
+
+	//Rope collision broadphase, a skin padded pair list over segment midpoints that is only rebuilt once it could be stale
+	SpatialHash3D				m_segmentSpatialHash;
+	std::vector<Vec3>			m_segmentMidpoints;
+	std::vector<int>			m_segmentQueryResults;
+	std::vector<Vec3>			m_broadphasePositions;				// particle positions when the pair list was built
+	std::vector<IntVec2>		m_ropeCollisionPairs;
+	bool						m_isBroadphaseDirty = true;
+	int							m_numBroadphaseRebuilds = 0;
+
+	//Level of detail scratch, every changed rope is resampled here first and then written back in one pass. Unchanged ropes
+	//stay put unless an earlier rope changed size, in which case they slide over by that much, like RemoveRope
+	std::vector<int>			m_lodRopeOrder;
+	std::vector<float>			m_lodRopeDistancesSquared;
+	std::vector<IntVec2>		m_lodRopeRanges;					// first resampled particle and count for each rope, x is -1 when unchanged
+	std::vector<int>			m_lodGrabbedRopeParticleIndices;	// grabbed particle's index along its resampled rope
+	std::vector<int>			m_lodRopeOffsets;					// how far each rope's ranges slide
+	std::vector<Vec3>			m_lodPositions;
+	std::vector<Vec3>			m_lodPreviousPositions;
+	std::vector<Vec3>			m_lodVelocities;
+	std::vector<float>			m_lodMasses;
+	std::vector<int>			m_lodIsAttached;
+	std::vector<float>			m_lodRestLengths;					// rest length from each resampled particle to the one before it
+};
@@ -6,6 +6,7 @@
 #include "Engine/Simulations/Particles3D.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Time.hpp"
+#include "Engine/Core/Profiler.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/LineSegment3.hpp"
 #include "Engine/Math/Mat44.hpp"
@@ -13,6 +14,9 @@
 #include "Engine/Core/DebugRender.hpp"
 #include "Engine/Math/Plane3D.hpp"
 #include "Engine/Simulations/Constraint3D.hpp"
+#include "Engine/Simulations/RigidBody3D.hpp"
+#include "Engine/Simulations/Collider3D.hpp"
+#include "Engine/Simulations/RopeComputeCPU.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/ConstantBuffer.hpp"
 #include "Engine/Renderer/StructuredBuffer.hpp"
@@ -100,6 +104,9 @@ RopeSimulation3D::RopeSimulation3D(Renderer* renderer, AABB3 worldBounds, int to
 		m_collisionCapsules.push_back(capsuleObject);
 	}
 
+	m_rigidBodyAttachmentSlots.assign(m_particles.m_positions.size(), -1);
+	m_pendingImpulseSlots.assign(m_particles.m_positions.size(), -1);
+
 	//Initialization of Bit Regions
 	InitializeBitRegions();
 	m_worldScaleX = abs(m_worldBounds.m_maxs.x - m_worldBounds.m_mins.x) * m_bitRegionScale;
@@ -112,7 +119,12 @@ RopeSimulation3D::RopeSimulation3D(Renderer* renderer, AABB3 worldBounds, int to
 	//Constraint Generation
 	GenerateConstraints();
 
-	//Shader and buffer Initializations
+	//Shader and buffer Initializations, a null renderer runs the CPU solver headless
+	if (m_renderer == nullptr)
+	{
+		m_isGPUSimulated = false;
+		return;
+	}
 	InitializeShaders();
 }
 
@@ -142,6 +154,7 @@ RopeSimulation3D::~RopeSimulation3D()
 	delete m_startGPUQuery;
 	delete m_endGPUQuery;
 	delete m_bitRegionVertexBuffer;
+	delete m_computeCPU;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -157,11 +170,27 @@ void RopeSimulation3D::Shutdown()
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::Update(float deltaSeconds)
 {
-	UpdateGPUBuffers();
+	PROFILE_SCOPE("RopeSimulation3D::Update");
+
+	//Standalone stepping, a shared FixedTimestepScheduler calls the overrides below directly instead
+	m_fixedTimestepScheduler.SetFixedTimestep(m_physicsTimestep);
+	m_fixedTimestepScheduler.AddSimulation(this);
+	m_fixedTimestepScheduler.Update(deltaSeconds);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::BeginFixedUpdates(int numSubsteps)
+{
+	UNUSED(numSubsteps);
 	m_simulationStartTime = float(GetCurrentTimeSeconds());
+	if (m_renderer == nullptr)
+	{
+		return;
+	}
+	UpdateGPUBuffers();
 
 	//Game Updates
-	if (m_isGPUSimulated)
+	if (IsSimulatedOnGPUDevice())
 	{
 		//Game Updates
 		if (m_shouldRunGameUpdateComputeShader == true)
@@ -218,24 +247,54 @@ void RopeSimulation3D::Update(float deltaSeconds)
 
 	
 
-	//Main Update Loop
-	m_physicsDebt += deltaSeconds;
 	m_renderer->EndQuery(m_startGPUQuery);
-	while (m_physicsDebt > m_physicsTimestep)
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::SavePreviousState()
+{
+	//Only the CPU path has its positions on this side to blend, the GPU path renders the latest step
+	if (IsSimulatedOnGPUDevice() == false)
 	{
-		if (m_isGPUSimulated)
-		{
-			UpdateGPU();
-		}
-		else
-		{
-			UpdateCPU();
-		}
-		m_physicsDebt -= m_physicsTimestep;
+		m_previousPositions = m_particles.m_positions;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::FixedUpdate(float fixedDeltaSeconds)
+{
+	//The GPU constant buffer copies the timestep when the shaders are initialized
+	m_physicsTimestep = fixedDeltaSeconds;
+	if (m_isGPUSimulated || m_isJacobiSolver || !m_isSleepingEnabled)
+	{
+		m_sleepIslands.WakeAll();
+	}
+	if (m_isGPUSimulated && (m_isComputeOnCPU || m_renderer == nullptr))
+	{
+		UpdateComputeCPU();
+	}
+	else if (m_isGPUSimulated)
+	{
+		UpdateGPU();
+	}
+	else
+	{
+		UpdateCPU();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::EndFixedUpdates(float interpolationAlpha)
+{
+	m_interpolationAlpha = interpolationAlpha;
+	if (m_renderer == nullptr)
+	{
+		m_simulationEndTime = float(GetCurrentTimeSeconds());
+		return;
 	}
 	m_renderer->EndQuery(m_endGPUQuery);
 
-	if (m_isGPUSimulated)
+	if (IsSimulatedOnGPUDevice())
 	{
 		//Unbinding
 		m_renderer->UnbindStructuredBufferUAVCS(0);
@@ -253,11 +312,24 @@ void RopeSimulation3D::Update(float deltaSeconds)
 	}
 
 
-	if (m_isGPUSimulated == false)
+	if (IsSimulatedOnGPUDevice() == false)
 	{
-		//CPU simulation structured buffer
+		//CPU simulation structured buffer, blended between the last two steps so the render never stutters against the frame rate
+		std::vector<Vec3>& renderPositions = m_renderPositions;
+		if (m_previousPositions.size() == m_particles.m_positions.size())
+		{
+			renderPositions.resize(m_particles.m_positions.size());
+			for (int particleIndex = 0; particleIndex < int(renderPositions.size()); particleIndex++)
+			{
+				renderPositions[particleIndex] = m_previousPositions[particleIndex] + (m_particles.m_positions[particleIndex] - m_previousPositions[particleIndex]) * m_interpolationAlpha;
+			}
+		}
+		else
+		{
+			renderPositions.assign(m_particles.m_positions.begin(), m_particles.m_positions.end());
+		}
 		delete m_sbParticlePositions;
-		m_sbParticlePositions = m_renderer->CreateStructuredBuffer(m_particles.m_positions.size() * sizeof(Vec3), sizeof(Vec3), m_particles.m_positions.data());
+		m_sbParticlePositions = m_renderer->CreateStructuredBuffer(renderPositions.size() * sizeof(Vec3), sizeof(Vec3), renderPositions.data());
 	}
 	
 	//Vertex Updating
@@ -280,6 +352,7 @@ void RopeSimulation3D::Update(float deltaSeconds)
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::UpdateCPU()
 {
+	PROFILE_SCOPE("RopeSimulation3D::UpdateCPU");
 	if (m_isJacobiSolver)
 	{
 		UpdateJacobi();
@@ -293,6 +366,7 @@ void RopeSimulation3D::UpdateCPU()
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::UpdateGPU()
 {
+	PROFILE_SCOPE("RopeSimulation3D::UpdateGPU");
 	//Initial Updates
 	m_renderer->DispatchComputeShader(m_csInitialUpdates, m_dispatchThreadX, m_dispatchThreadY, m_dispatchThreadZ);
 	for (int solverIterationIndex = 0; solverIterationIndex < m_totalSolverIterations; solverIterationIndex++)
@@ -324,6 +398,47 @@ void RopeSimulation3D::UpdateGPU()
 	m_renderer->DispatchComputeShader(m_csFinalUpdates, m_dispatchThreadX, m_dispatchThreadY, m_dispatchThreadZ);
 }
 
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::UpdateComputeCPU()
+{
+	PROFILE_SCOPE("RopeSimulation3D::UpdateComputeCPU");
+	if (m_computeCPU == nullptr)
+	{
+		m_computeCPU = new RopeComputeCPU(this);
+	}
+	m_computeCPU->UpdateConstants();
+
+	//Same dispatch order as UpdateGPU, but the particle kernels get enough thread groups to cover every particle
+	int threadsPerGroup = RopeComputeCPU::GetThreadsPerGroup(RopeComputeKernel::INITIAL_UPDATES);
+	int particleDispatch = (m_numberOfParticlesInRope + threadsPerGroup - 1) / threadsPerGroup;
+	int capsuleDispatch = m_numberOfParticlesInRope / 2;
+	m_computeCPU->Dispatch(RopeComputeKernel::INITIAL_UPDATES, particleDispatch);
+	for (int solverIterationIndex = 0; solverIterationIndex < m_totalSolverIterations; solverIterationIndex++)
+	{
+		m_computeCPU->Dispatch(RopeComputeKernel::PROJECT_NON_COLLISION_CONSTRAINTS, particleDispatch);
+		m_computeCPU->Dispatch(RopeComputeKernel::UPDATE_AFTER_NON_COLLISION_CONSTRAINTS, particleDispatch);
+		if (m_collisionType == CollisionType::SPHERES)
+		{
+			m_computeCPU->Dispatch(RopeComputeKernel::UPDATE_PARTICLE_BIT_REGIONS, particleDispatch);
+			m_computeCPU->Dispatch(RopeComputeKernel::PROJECT_COLLISION_CONSTRAINTS_SPHERES, m_numberOfParticlesInRope);
+		}
+		else if (m_collisionType == CollisionType::CAPSULES)
+		{
+			m_computeCPU->Dispatch(RopeComputeKernel::INITIALIZE_BIT_REGIONS_CAPSULES, particleDispatch);
+			m_computeCPU->Dispatch(RopeComputeKernel::CAPSULE_COLLISIONS_PHASE_ONE, capsuleDispatch);
+			m_computeCPU->Dispatch(RopeComputeKernel::INITIALIZE_BIT_REGIONS_CAPSULES, particleDispatch);
+			m_computeCPU->Dispatch(RopeComputeKernel::CAPSULE_COLLISIONS_PHASE_TWO, capsuleDispatch);
+		}
+	}
+	m_computeCPU->Dispatch(RopeComputeKernel::FINAL_UPDATES, particleDispatch);
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RopeSimulation3D::IsSimulatedOnGPUDevice() const
+{
+	return m_isGPUSimulated && m_isComputeOnCPU == false && m_renderer != nullptr;
+}
+
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::Render() const
 {
@@ -353,6 +468,10 @@ void RopeSimulation3D::InitializeGPUCollisionObjects()
 {
 	if (m_collisionObjects.size() == 0)
 		return;
+	if (m_computeCPU)
+		m_computeCPU->InitializeCollisionObjects();
+	if (m_renderer == nullptr)
+		return;
 	if (m_sbAABBs)
 		delete m_sbAABBs;
 		m_sbAABBs = nullptr;	
@@ -479,12 +598,14 @@ void RopeSimulation3D::UpdateGrabbedRopeParticle(int sentParticleIndex, Vec3 con
 	m_grabbedParticleIndex = sentParticleIndex;
 	m_particles.m_positions[sentParticleIndex] = newPosition;
 	m_particles.m_proposedPositions[sentParticleIndex] = newPosition;
+	m_sleepIslands.WakeParticle(sentParticleIndex);
 }
 
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::AttachRopeParticle(int const& particleIndex)
 {
 	m_particles.m_isAttached[particleIndex] = true;
+	m_sleepIslands.WakeParticle(particleIndex);
 
 	bool isAttached = false;
 	for (int attachedIndex = 0; attachedIndex < m_attachedParticleIndices.size(); attachedIndex++)
@@ -506,9 +627,81 @@ void RopeSimulation3D::UnattachRopeParticle(int const& particleIndex)
 {
 	m_particles.m_isAttached[particleIndex] = false;
 	m_grabbedParticleIndex = -1;
+	m_sleepIslands.WakeParticle(particleIndex);
 	m_attachedParticleIndices.erase(std::remove(m_attachedParticleIndices.begin(), m_attachedParticleIndices.end(), particleIndex), m_attachedParticleIndices.end());
 }
 
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::AttachRopeParticleToRigidBody(int particleIndex, RigidBody3D* rigidBody, Vec3 const& worldAnchorPosition)
+{
+	GUARANTEE_OR_DIE(rigidBody != nullptr, "Cannot attach a rope particle to a null rigid body");
+	GUARANTEE_OR_DIE(m_isGPUSimulated == false && m_isJacobiSolver == false, "Rigid body attachments are only solved by the CPU Gauss Seidel rope");
+
+	RopeRigidBodyAttachment attachment;
+	attachment.m_particleIndex = particleIndex;
+	attachment.m_rigidBody = rigidBody;
+	attachment.m_localAnchor = rigidBody->m_rotation.GetOrthonormalInverse().TransformVectorQuantity3D(worldAnchorPosition - rigidBody->m_position);
+
+	//The body anchor replaces any fixed pin, a pinned particle would never leave its spot to pull on the body
+	m_particles.m_isAttached[particleIndex] = false;
+	m_attachedParticleIndices.erase(std::remove(m_attachedParticleIndices.begin(), m_attachedParticleIndices.end(), particleIndex), m_attachedParticleIndices.end());
+
+	int attachmentIndex = GetRigidBodyAttachmentIndex(particleIndex);
+	if (attachmentIndex != -1)
+	{
+		m_rigidBodyAttachments[attachmentIndex] = attachment;
+	}
+	else
+	{
+		m_rigidBodyAttachmentSlots[particleIndex] = static_cast<int>(m_rigidBodyAttachments.size());
+		m_rigidBodyAttachments.push_back(attachment);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::UnattachRopeParticleFromRigidBody(int particleIndex)
+{
+	int attachmentIndex = GetRigidBodyAttachmentIndex(particleIndex);
+	if (attachmentIndex != -1)
+	{
+		RemoveRigidBodyAttachment(attachmentIndex);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::UnattachAllFromRigidBody(RigidBody3D* rigidBody)
+{
+	for (int attachmentIndex = static_cast<int>(m_rigidBodyAttachments.size()) - 1; attachmentIndex >= 0; attachmentIndex--)
+	{
+		if (m_rigidBodyAttachments[attachmentIndex].m_rigidBody == rigidBody)
+		{
+			RemoveRigidBodyAttachment(attachmentIndex);
+		}
+	}
+
+	int numKeptImpulses = 0;
+	for (int impulseIndex = 0; impulseIndex < static_cast<int>(m_pendingRigidBodyImpulses.size()); impulseIndex++)
+	{
+		RopeRigidBodyImpulse const& pendingImpulse = m_pendingRigidBodyImpulses[impulseIndex];
+		if (pendingImpulse.m_rigidBody == rigidBody)
+		{
+			if (m_pendingImpulseSlots[pendingImpulse.m_particleIndex] == impulseIndex)
+			{
+				m_pendingImpulseSlots[pendingImpulse.m_particleIndex] = -1;
+			}
+			continue;
+		}
+
+		if (m_pendingImpulseSlots[pendingImpulse.m_particleIndex] == impulseIndex)
+		{
+			m_pendingImpulseSlots[pendingImpulse.m_particleIndex] = numKeptImpulses;
+		}
+		m_pendingRigidBodyImpulses[numKeptImpulses] = pendingImpulse;
+		numKeptImpulses++;
+	}
+	m_pendingRigidBodyImpulses.resize(numKeptImpulses);
+}
+
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::UpdateCollisionObjectBitRegions()
 {
@@ -700,7 +893,7 @@ void RopeSimulation3D::UpdateGPUBuffers()
 	}
 	if (m_hasGPUSwitchOccured)
 	{
-		if(m_isGPUSimulated)
+		if (IsSimulatedOnGPUDevice())
 		{
 			delete m_sbParticlePositions;
 			delete m_sbParticleProposedPositions;
@@ -752,10 +945,21 @@ void RopeSimulation3D::UpdateGPUBuffers()
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::UpdateGaussSeidel()
 {
+	if (m_isSleepingEnabled && !m_sleepIslands.IsInitialized(static_cast<int>(m_particles.m_positions.size())))
+	{
+		InitializeSleepIslands();
+	}
+
+	//A body can carry its anchor away at any time, so spans tied to one never sleep
+	for (int attachmentIndex = 0; attachmentIndex < m_rigidBodyAttachments.size(); attachmentIndex++)
+	{
+		m_sleepIslands.WakeParticle(m_rigidBodyAttachments[attachmentIndex].m_particleIndex);
+	}
+
 	//Propose Positions
 	for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
 	{
-		if (m_particles.m_isAttached[particleIndex] == 1)
+		if (m_particles.m_isAttached[particleIndex] == 1 || m_sleepIslands.IsParticleAsleep(particleIndex))
 		{
 			m_particles.m_proposedPositions[particleIndex] = m_particles.m_positions[particleIndex];
 			UpdateCollisionCapsulesFromParticle(particleIndex);
@@ -770,12 +974,16 @@ void RopeSimulation3D::UpdateGaussSeidel()
 		UpdateCollisionCapsulesFromParticle(particleIndex);
 		UnaddCollidingRopeParticle(particleIndex);
 	}
+	ClampProposedPositionsToTimeOfImpact();
 
-	//Constraint Projection
-	for (int solverIndex = 0; solverIndex < m_totalSolverIterations; solverIndex++)
+	//Constraint Projection, a rope that is asleep end to end only needs one pass to see whether anything touched it
+	int numSolverIterations = m_sleepIslands.AreAllAsleep() ? 1 : m_totalSolverIterations;
+	for (int solverIndex = 0; solverIndex < numSolverIterations; solverIndex++)
 	{
-		ProjectConstraintsGaussSeidel();
+		ProjectConstraintsGaussSeidel(solverIndex);
 	}
+	ApplyRigidBodyImpulses();
+	m_sleepIslands.WakeDisturbedIslands(m_particles);
 
 	//Velocity and Friction Updates
 	for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
@@ -807,28 +1015,46 @@ void RopeSimulation3D::UpdateGaussSeidel()
 
 		m_particles.m_positions[particleIndex] = m_particles.m_proposedPositions[particleIndex];
 	}
+
+	if (m_isSleepingEnabled)
+	{
+		m_sleepIslands.UpdateRestTimes(m_particles, m_physicsTimestep);
+	}
 }
 
 //-----------------------------------------------------------------------------------------------
-void RopeSimulation3D::ProjectConstraintsGaussSeidel()
+void RopeSimulation3D::ProjectConstraintsGaussSeidel(int solverIndex)
 {
 	//Distance and Bending Constraints
 	for (int constraintIndex = 0; constraintIndex < m_distanceConstraints.size(); constraintIndex++)
 	{
+		if (IsConstraintAsleep(m_distanceConstraints[constraintIndex]))
+		{
+			continue;
+		}
 		ProjectDistanceConstraintGaussSeidel(constraintIndex);
 	}
 	for (int constraintIndex = 0; constraintIndex < m_bendingConstraints.size(); constraintIndex++)
 	{
+		if (IsConstraintAsleep(m_bendingConstraints[constraintIndex]))
+		{
+			continue;
+		}
 		ProjectBendingConstraintGaussSeidel(constraintIndex);
 	}
 
-	//Collision Constraints
+	//Collision Constraints, sleeping particles only take part in the first iteration so a contact can still wake them
+	bool isSkippingSleepingParticles = solverIndex > 0 && m_sleepIslands.IsAnyAsleep();
 	if (m_collisionType == CollisionType::SPHERES)
 	{
 		BitRegionDetectionAllParticles();
 
 		for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
 		{
+			if (isSkippingSleepingParticles && m_sleepIslands.IsParticleAsleep(particleIndex))
+			{
+				continue;
+			}
 			ProjectCollisionConstraintsSpheresGaussSeidel(particleIndex);
 		}
 	}
@@ -838,12 +1064,51 @@ void RopeSimulation3D::ProjectConstraintsGaussSeidel()
 
 		for (int capsuleIndex = 0; capsuleIndex < m_collisionCapsules.size(); capsuleIndex++)
 		{
+			if (isSkippingSleepingParticles && m_sleepIslands.IsParticleAsleep(capsuleIndex) && m_sleepIslands.IsParticleAsleep(capsuleIndex + 1))
+			{
+				continue;
+			}
 			Capsule3& capsule = m_collisionCapsules[capsuleIndex].m_capsule;
 			capsule.m_bone.m_start = m_particles.m_proposedPositions[capsuleIndex];
 			capsule.m_bone.m_end = m_particles.m_proposedPositions[capsuleIndex + 1];
 			ProjectCollisionConstraintsCapsulesGaussSeidel(capsuleIndex);
 		}
 	}
+	ProjectCollisionWorldConstraintsGaussSeidel();
+
+	//Rigid Body Anchors, last so an anchored particle ends every iteration exactly on its anchor
+	ProjectRigidBodyAttachmentsGaussSeidel();
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::InitializeSleepIslands()
+{
+	int numParticles = static_cast<int>(m_particles.m_positions.size());
+	int spanSize = m_sleepSpanSize > 0 ? m_sleepSpanSize : 1;
+	std::vector<int> particleSpanIndices(numParticles);
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		particleSpanIndices[particleIndex] = particleIndex / spanSize;
+	}
+	m_sleepIslands.Initialize(particleSpanIndices, (numParticles + spanSize - 1) / spanSize);
+}
+
+//-----------------------------------------------------------------------------------------------
+bool RopeSimulation3D::IsConstraintAsleep(Constraint3D const& constraint) const
+{
+	if (!m_sleepIslands.IsAnyAsleep())
+	{
+		return false;
+	}
+
+	for (int index = 0; index < static_cast<int>(constraint.m_indices.size()); index++)
+	{
+		if (!m_sleepIslands.IsParticleAsleep(constraint.m_indices[index]))
+		{
+			return false;
+		}
+	}
+	return true;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -972,13 +1237,18 @@ void RopeSimulation3D::ProjectBendingConstraintGaussSeidel(int constraintIndex)
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::ProjectCollisionConstraintsSpheresGaussSeidel(int sentParticleIndex)
 {
-	//Self Collisions
-	if (m_isSelfCollisionEnabled)
+	//Self Collisions, two sleeping particles are already resting against each other
+	if (m_isSelfCollisionEnabled && !m_sleepIslands.AreAllAsleep())
 	{
+		bool isSentParticleAsleep = m_sleepIslands.IsParticleAsleep(sentParticleIndex);
 		for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
 		{
 			if (particleIndex != sentParticleIndex && particleIndex != sentParticleIndex - 1 && particleIndex != sentParticleIndex + 1)
 			{
+				if (isSentParticleAsleep && m_sleepIslands.IsParticleAsleep(particleIndex))
+				{
+					continue;
+				}
 				if ((m_particles.m_macroBitRegions[sentParticleIndex] & m_particles.m_macroBitRegions[particleIndex]) != 0)
 				{
 					if ((m_particles.m_microBitRegions[sentParticleIndex] & m_particles.m_microBitRegions[particleIndex]) != 0)
@@ -1493,6 +1763,157 @@ void RopeSimulation3D::ProjectCollisionConstraintsCapsulesGaussSeidel(int sentCa
 	UpdateProposedParticlesFromCollisionCapsule(sentCapsuleIndex);
 }
 
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::ProjectCollisionWorldConstraintsGaussSeidel()
+{
+	if (m_collisionWorld == nullptr)
+	{
+		return;
+	}
+
+	//One batched query for the whole rope, every contact is measured against the positions from before this pass
+	m_collisionWorldContacts.clear();
+	if (m_collisionType == CollisionType::SPHERES)
+	{
+		m_collisionWorld->QuerySphereContacts(m_particles.m_proposedPositions, m_ropeRadius, m_collisionWorldContacts, m_collisionWorldHandles);
+		for (int contactIndex = 0; contactIndex < m_collisionWorldContacts.size(); contactIndex++)
+		{
+			CollisionContact const& contact = m_collisionWorldContacts[contactIndex];
+			if (m_particles.m_isAttached[contact.m_queryIndex] || GetRigidBodyAttachmentIndex(contact.m_queryIndex) != -1)
+			{
+				continue;
+			}
+
+			m_particles.m_proposedPositions[contact.m_queryIndex] += contact.m_correction;
+			m_particles.m_collisionNormals[contact.m_queryIndex] = contact.m_correction.GetNormalized();
+			m_particles.m_isSelfCollision[contact.m_queryIndex] = 0;
+			if (m_collisionWorld->GetCollisionObjectType(contact.m_objectHandle) == CollisionObjectType::CONVEX_HULL && m_collisionWorld->IsCollisionObjectStatic(contact.m_objectHandle) == false)
+			{
+				ConvexHullCollisionObject* hullObject = static_cast<ConvexHullCollisionObject*>(m_collisionWorld->GetCollisionObject(contact.m_objectHandle));
+				AddRigidBodyReaction(hullObject->m_collider->m_rigidBody, contact.m_queryIndex, contact.m_correction);
+			}
+		}
+	}
+	else if (m_collisionType == CollisionType::CAPSULES)
+	{
+		m_collisionWorldCapsules.resize(m_collisionCapsules.size());
+		for (int capsuleIndex = 0; capsuleIndex < m_collisionCapsules.size(); capsuleIndex++)
+		{
+			m_collisionWorldCapsules[capsuleIndex] = m_collisionCapsules[capsuleIndex].m_capsule;
+			m_collisionWorldCapsules[capsuleIndex].m_bone.m_start = m_particles.m_proposedPositions[capsuleIndex];
+			m_collisionWorldCapsules[capsuleIndex].m_bone.m_end = m_particles.m_proposedPositions[capsuleIndex + 1];
+		}
+
+		m_collisionWorld->QueryCapsuleContacts(m_collisionWorldCapsules, m_collisionWorldContacts, m_collisionWorldHandles);
+		for (int contactIndex = 0; contactIndex < m_collisionWorldContacts.size(); contactIndex++)
+		{
+			CollisionContact const& contact = m_collisionWorldContacts[contactIndex];
+			int startIndex = contact.m_queryIndex;
+			int endIndex = contact.m_queryIndex + 1;
+			RigidBody3D* rigidBody = nullptr;
+			if (m_collisionWorld->GetCollisionObjectType(contact.m_objectHandle) == CollisionObjectType::CONVEX_HULL && m_collisionWorld->IsCollisionObjectStatic(contact.m_objectHandle) == false)
+			{
+				rigidBody = static_cast<ConvexHullCollisionObject*>(m_collisionWorld->GetCollisionObject(contact.m_objectHandle))->m_collider->m_rigidBody;
+			}
+			if (m_particles.m_isAttached[startIndex] == false && GetRigidBodyAttachmentIndex(startIndex) == -1 && contact.m_correction != Vec3())
+			{
+				m_particles.m_proposedPositions[startIndex] += contact.m_correction;
+				m_particles.m_collisionNormals[startIndex] = contact.m_correction.GetNormalized();
+				m_particles.m_isSelfCollision[startIndex] = 0;
+				if (rigidBody != nullptr)
+				{
+					AddRigidBodyReaction(rigidBody, startIndex, contact.m_correction);
+				}
+			}
+			if (m_particles.m_isAttached[endIndex] == false && GetRigidBodyAttachmentIndex(endIndex) == -1 && contact.m_endCorrection != Vec3())
+			{
+				m_particles.m_proposedPositions[endIndex] += contact.m_endCorrection;
+				m_particles.m_collisionNormals[endIndex] = contact.m_endCorrection.GetNormalized();
+				m_particles.m_isSelfCollision[endIndex] = 0;
+				if (rigidBody != nullptr)
+				{
+					AddRigidBodyReaction(rigidBody, endIndex, contact.m_endCorrection);
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::ProjectRigidBodyAttachmentsGaussSeidel()
+{
+	for (int attachmentIndex = 0; attachmentIndex < m_rigidBodyAttachments.size(); attachmentIndex++)
+	{
+		RopeRigidBodyAttachment const& attachment = m_rigidBodyAttachments[attachmentIndex];
+		RigidBody3D const* rigidBody = attachment.m_rigidBody;
+		Vec3 anchorPosition = rigidBody->m_position + rigidBody->m_rotation.TransformVectorQuantity3D(attachment.m_localAnchor);
+		Vec3 correction = anchorPosition - m_particles.m_proposedPositions[attachment.m_particleIndex];
+		if (correction == Vec3())
+		{
+			continue;
+		}
+
+		m_particles.m_proposedPositions[attachment.m_particleIndex] = anchorPosition;
+		AddRigidBodyReaction(attachment.m_rigidBody, attachment.m_particleIndex, correction);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::AddRigidBodyReaction(RigidBody3D* rigidBody, int particleIndex, Vec3 const& particleCorrection)
+{
+	//Whatever moved the particle pushed back on the body, merge repeats from later iterations into one impulse
+	Vec3 impulse = particleCorrection * (-m_particles.m_masses[particleIndex] / m_physicsTimestep);
+	int& impulseSlot = m_pendingImpulseSlots[particleIndex];
+	if (impulseSlot != -1 && m_pendingRigidBodyImpulses[impulseSlot].m_rigidBody == rigidBody)
+	{
+		m_pendingRigidBodyImpulses[impulseSlot].m_impulse += impulse;
+		return;
+	}
+
+	RopeRigidBodyImpulse pendingImpulse;
+	pendingImpulse.m_rigidBody = rigidBody;
+	pendingImpulse.m_particleIndex = particleIndex;
+	pendingImpulse.m_impulse = impulse;
+	pendingImpulse.m_impactLocation = m_particles.m_positions[particleIndex];
+	impulseSlot = static_cast<int>(m_pendingRigidBodyImpulses.size());
+	m_pendingRigidBodyImpulses.push_back(pendingImpulse);
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::ApplyRigidBodyImpulses()
+{
+	for (int impulseIndex = 0; impulseIndex < m_pendingRigidBodyImpulses.size(); impulseIndex++)
+	{
+		RopeRigidBodyImpulse const& pendingImpulse = m_pendingRigidBodyImpulses[impulseIndex];
+		if (pendingImpulse.m_rigidBody->m_mass > 0.0f)
+		{
+			pendingImpulse.m_rigidBody->ApplyImpulse(pendingImpulse.m_impulse, pendingImpulse.m_impactLocation);
+		}
+		m_pendingImpulseSlots[pendingImpulse.m_particleIndex] = -1;
+	}
+	m_pendingRigidBodyImpulses.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+int RopeSimulation3D::GetRigidBodyAttachmentIndex(int particleIndex) const
+{
+	return m_rigidBodyAttachmentSlots[particleIndex];
+}
+
+//-----------------------------------------------------------------------------------------------
+// Swaps the last attachment into the hole, so only one other particle's slot has to change
+void RopeSimulation3D::RemoveRigidBodyAttachment(int attachmentIndex)
+{
+	m_rigidBodyAttachmentSlots[m_rigidBodyAttachments[attachmentIndex].m_particleIndex] = -1;
+	int lastAttachmentIndex = static_cast<int>(m_rigidBodyAttachments.size()) - 1;
+	if (attachmentIndex != lastAttachmentIndex)
+	{
+		m_rigidBodyAttachments[attachmentIndex] = m_rigidBodyAttachments[lastAttachmentIndex];
+		m_rigidBodyAttachmentSlots[m_rigidBodyAttachments[attachmentIndex].m_particleIndex] = attachmentIndex;
+	}
+	m_rigidBodyAttachments.pop_back();
+}
+
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::ProjectWorldBoundsConstraintsCapsulesGaussSeidel(int sentCapsuleIndex)
 {
@@ -1589,6 +2010,7 @@ void RopeSimulation3D::UpdateJacobi()
 		m_particles.m_proposedPositions[particleIndex] = m_particles.m_positions[particleIndex] + deltaPosition;
 		UpdateCollisionCapsulesFromParticle(particleIndex);
 	}
+	ClampProposedPositionsToTimeOfImpact();
 
 	//Constraint Projection
 	m_collisionCount = 0;
@@ -2616,6 +3038,10 @@ void RopeSimulation3D::InitializeBitRegions()
 		AddVertsForLineList(verts, Vec3(macroBounds.m_mins.x, macroBounds.m_mins.y, 0.0f), Vec3(macroBounds.m_mins.x, macroBounds.m_maxs.y, 0.0f), Rgba8::BLUE);
 	}
 	m_bitRegionDebugVertCount = int(verts.size());
+	if (m_renderer == nullptr)
+	{
+		return;
+	}
 	m_bitRegionVertexBuffer = m_renderer->CreateVertexBuffer(sizeof(Vertex_PCU) * verts.size(), sizeof(Vertex_PCU));
 	m_renderer->CopyCPUToGPU(verts.data(), sizeof(Vertex_PCU)* verts.size(), m_bitRegionVertexBuffer);
 }
@@ -3407,6 +3833,104 @@ IntVec3 RopeSimulation3D::GetCoordsForRegionIndex(int const& region)
 	return coords;
 }
 
+//-----------------------------------------------------------------------------------------------
+static RaycastResult3D SweepSphereVsCollisionObject3D(Vec3 const& start, Vec3 const& end, float sphereRadius, CollisionObject const* collisionObject, CollisionObjectType type)
+{
+	switch (type)
+	{
+		case CollisionObjectType::SPHERE:
+		{
+			SphereCollisionObject const* sphereObject = static_cast<SphereCollisionObject const*>(collisionObject);
+			return SweepSphereVsSphere3D(start, end, sphereRadius, sphereObject->m_sphere.m_center, sphereObject->m_sphere.m_radius);
+		}
+		case CollisionObjectType::CAPSULE:
+		{
+			return SweepSphereVsCapsule3D(start, end, sphereRadius, static_cast<CapsuleCollisionObject const*>(collisionObject)->m_capsule);
+		}
+		case CollisionObjectType::AABB:
+		{
+			return SweepSphereVsAABB3D(start, end, sphereRadius, static_cast<AABBCollisionObject const*>(collisionObject)->m_aabb);
+		}
+		case CollisionObjectType::OBB:
+		{
+			return SweepSphereVsOBB3D(start, end, sphereRadius, static_cast<OBBCollisionObject const*>(collisionObject)->m_obb);
+		}
+		case CollisionObjectType::CYLINDER:
+		{
+			return SweepSphereVsCylinder3D(start, end, sphereRadius, static_cast<CylinderCollisionObject const*>(collisionObject)->m_cylinder);
+		}
+		default:
+		{
+			//Convex hulls move with their rigid bodies, the contact queries handle them
+			return RaycastResult3D();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void RopeSimulation3D::ClampProposedPositionsToTimeOfImpact()
+{
+	if (m_isContinuousCollisionEnabled == false)
+	{
+		return;
+	}
+
+	//Swept with half the radius so a particle the discrete tests left resting on a surface starts the sweep outside of it,
+	//anything moving less than that cannot get its center past a surface and is left to the discrete tests
+	float sweepRadius = 0.5f * m_ropeRadius;
+	float sweepRadiusSquared = sweepRadius * sweepRadius;
+	for (int particleIndex = 0; particleIndex < m_particles.m_positions.size(); particleIndex++)
+	{
+		Vec3 const& startPosition = m_particles.m_positions[particleIndex];
+		Vec3 const& proposedPosition = m_particles.m_proposedPositions[particleIndex];
+		if (m_particles.m_isAttached[particleIndex] == 1 || GetRigidBodyAttachmentIndex(particleIndex) != -1 || m_sleepIslands.IsParticleAsleep(particleIndex) ||
+			(proposedPosition - startPosition).GetLengthSquared() <= sweepRadiusSquared)
+		{
+			continue;
+		}
+
+		//Earliest impact against the rope's own objects and whatever the shared scene has along the sweep
+		RaycastResult3D earliestImpact;
+		for (int collisionObjectIndex = 0; collisionObjectIndex < m_collisionObjects.size(); collisionObjectIndex++)
+		{
+			if (m_collisionObjects[collisionObjectIndex] == nullptr)
+			{
+				continue;
+			}
+			CollisionObject const* collisionObject = m_collisionObjects[collisionObjectIndex];
+			RaycastResult3D impact = SweepSphereVsCollisionObject3D(startPosition, proposedPosition, sweepRadius, collisionObject, collisionObject->GetType());
+			if (impact.m_didImpact && (earliestImpact.m_didImpact == false || impact.m_impactDist < earliestImpact.m_impactDist))
+			{
+				earliestImpact = impact;
+			}
+		}
+		if (m_collisionWorld)
+		{
+			Vec3 radiusExtents = Vec3(sweepRadius, sweepRadius, sweepRadius);
+			AABB3 sweptBounds = AABB3(Vec3(fminf(startPosition.x, proposedPosition.x), fminf(startPosition.y, proposedPosition.y), fminf(startPosition.z, proposedPosition.z)) - radiusExtents,
+				Vec3(fmaxf(startPosition.x, proposedPosition.x), fmaxf(startPosition.y, proposedPosition.y), fmaxf(startPosition.z, proposedPosition.z)) + radiusExtents);
+			m_collisionWorld->QueryAABB(sweptBounds, m_continuousCollisionHandles);
+			for (int handleIndex = 0; handleIndex < m_continuousCollisionHandles.size(); handleIndex++)
+			{
+				int handle = m_continuousCollisionHandles[handleIndex];
+				RaycastResult3D impact = SweepSphereVsCollisionObject3D(startPosition, proposedPosition, sweepRadius, m_collisionWorld->GetCollisionObject(handle), m_collisionWorld->GetCollisionObjectType(handle));
+				if (impact.m_didImpact && (earliestImpact.m_didImpact == false || impact.m_impactDist < earliestImpact.m_impactDist))
+				{
+					earliestImpact = impact;
+				}
+			}
+		}
+
+		if (earliestImpact.m_didImpact)
+		{
+			m_particles.m_proposedPositions[particleIndex] = earliestImpact.m_impactPos;
+			m_particles.m_collisionNormals[particleIndex] = earliestImpact.m_impactNormal;
+			m_particles.m_isSelfCollision[particleIndex] = 0;
+			UpdateCollisionCapsulesFromParticle(particleIndex);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------------------------
 void RopeSimulation3D::UpdateCollisionCapsulesFromParticle(int const& sentParticleIndex)
 {	
@@ -3565,45 +4089,3 @@ void RopeSimulation3D::DeleteConstraints()
 	m_distanceConstraints.clear();
 	m_bendingConstraints.clear();
 }
-
-//-----------------------------------------------------------------------------------------------
-CollisionObject::CollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius)
-	:m_boundingDiscCenter(boundingDiscCenter)
-	,m_boundingDiscRadius(boundingDiscRadius)
-{
-}
-
-//-----------------------------------------------------------------------------------------------
-SphereCollisionObject::SphereCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Sphere3 const& sphere)
-	:CollisionObject(boundingDiscCenter, boundingDiscRadius)
-	,m_sphere(sphere)
-{
-}
-
-//-----------------------------------------------------------------------------------------------
-AABBCollisionObject::AABBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, AABB3 const& aabb)
-	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
-	, m_aabb(aabb) 
-{
-}
-
-//-----------------------------------------------------------------------------------------------
-OBBCollisionObject::OBBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, OBB3 const& obb)
-	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
-	, m_obb(obb) 
-{
-}
-
-//-----------------------------------------------------------------------------------------------
-CapsuleCollisionObject::CapsuleCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Capsule3 const& capsule)
-	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
-	, m_capsule(capsule) 
-{
-}
-
-//-----------------------------------------------------------------------------------------------
-CylinderCollisionObject::CylinderCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Cylinder3 const& cylinder)
-	: CollisionObject(boundingDiscCenter, boundingDiscRadius)
-	, m_cylinder(cylinder) 
-{
-}
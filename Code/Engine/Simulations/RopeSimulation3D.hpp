@@ -1,6 +1,9 @@
 #pragma once
 #include "Constraint3D.hpp"
 #include "Particles3D.hpp"
+#include "FixedTimestepScheduler.hpp"
+#include "CollisionWorld.hpp"
+#include "SleepIslands.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/DPVec4.hpp"
 #include "Engine/Math/Vec4.hpp"
@@ -28,6 +31,8 @@ class	ConstantBuffer;
 class	Renderer;
 class	VertexBuffer;
 class	Query;
+class	RigidBody3D;
+class	RopeComputeCPU;
 
 //-----------------------------------------------------------------------------------------------
 enum class CollisionType
@@ -38,82 +43,33 @@ enum class CollisionType
 };
 
 //-----------------------------------------------------------------------------------------------
-struct GPUVertex_PCUTBN
+// Pins a rope particle to a point fixed in a rigid body's local space. The body is treated as kinematic while the
+// rope iterates, and the correction the anchor had to apply goes back to the body as an impulse at the end of the step.
+struct RopeRigidBodyAttachment
 {
-	Vec3 m_position;
-	Vec4 m_color;
-	Vec2 m_uvTexCoords;
-	Vec3 m_tangent;
-	Vec3 m_binormal;
-	Vec3 m_normal;
+	int				m_particleIndex = -1;
+	RigidBody3D*	m_rigidBody = nullptr;
+	Vec3			m_localAnchor;
 };
 
 //-----------------------------------------------------------------------------------------------
-//Polymorphic Collision Objects 
-struct CollisionObject
+struct RopeRigidBodyImpulse
 {
-public:
-	CollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius);
-	virtual ~CollisionObject() {}
-	
-public:
-	uint64_t	m_macroBitRegions = 0;
-	uint64_t	m_microBitRegions = 0;
-	Vec3		m_boundingDiscCenter;
-	float		m_boundingDiscRadius = 0.0f;
+	RigidBody3D*	m_rigidBody = nullptr;
+	int				m_particleIndex = -1;
+	Vec3			m_impulse;
+	Vec3			m_impactLocation;
 };
-struct SphereCollisionObject : public CollisionObject
-{
-public:
-	SphereCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Sphere3 const& sphere);
-	~SphereCollisionObject() {}
 
-public:
-	Sphere3 m_sphere;
-};
-struct AABBCollisionObject : public CollisionObject
-{
-public:
-	AABBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, AABB3 const& aabb);
-	~AABBCollisionObject() {}
-
-public:
-	AABB3 m_aabb;
-};
-struct OBBCollisionObject : public CollisionObject
-{
-public:
-	OBBCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, OBB3 const& obb);
-	~OBBCollisionObject() {}
-	
-public:
-	OBB3 m_obb;
-};
-struct CapsuleCollisionObject : public CollisionObject
-{
-public:
-	CapsuleCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Capsule3 const& capsule);
-	~CapsuleCollisionObject() {}
-		
-public:
-	Capsule3	m_capsule;
-	Vec3		m_collisionNormalStart;
-	Vec3		m_jacobiCorrectionStart;
-	int			m_jacobiConstraintTotalStart;
-	int			m_isCollidingStart;
-	Vec3		m_collisionNormalEnd;
-	Vec3		m_jacobiCorrectionEnd;
-	int			m_jacobiConstraintTotalEnd;
-	int			m_isCollidingEnd;
-};
-struct CylinderCollisionObject : public CollisionObject
+//-----------------------------------------------------------------------------------------------
+struct GPUVertex_PCUTBN
 {
-public:
-	CylinderCollisionObject(Vec3 const& boundingDiscCenter, float boundingDiscRadius, Cylinder3 const& cylinder);
-	~CylinderCollisionObject() {}
-	
-public:
-	Cylinder3 m_cylinder;
+	Vec3 m_position;
+	Vec4 m_color;
+	Vec2 m_uvTexCoords;
+	Vec3 m_tangent;
+	Vec3 m_binormal;
+	Vec3 m_normal;
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -168,7 +124,7 @@ struct GameStructuredBufferVariables
 
 
 //-----------------------------------------------------------------------------------------------
-class RopeSimulation3D
+class RopeSimulation3D : public FixedTimestepSimulation
 {
 public:
 	RopeSimulation3D() {};
@@ -185,31 +141,52 @@ public:
 	void		Update(float deltaSeconds);
 	void		Render() const;
 
+	//Fixed Timestep Scheduling
+	virtual void	BeginFixedUpdates(int numSubsteps) override;
+	virtual void	SavePreviousState() override;
+	virtual void	FixedUpdate(float fixedDeltaSeconds) override;
+	virtual void	EndFixedUpdates(float interpolationAlpha) override;
+
 	//Misc Public Methods
 	float		GetCurrentLengthOfTheRope();
 	void		ClearShapeReferences();
 	void		UpdateGrabbedRopeParticle(int sentParticleIndex, Vec3 const& newPosition);
 	void		AttachRopeParticle(int const& particleIndex);
 	void		UnattachRopeParticle(int const& particleIndex);
+	void		AttachRopeParticleToRigidBody(int particleIndex, RigidBody3D* rigidBody, Vec3 const& worldAnchorPosition);
+	void		UnattachRopeParticleFromRigidBody(int particleIndex);
+	void		UnattachAllFromRigidBody(RigidBody3D* rigidBody);
 	void		UpdateCollisionObjectBitRegions();
 	void		InitializeGPUCollisionObjects();
 
 private:
+	friend class RopeComputeCPU;
+
 	//GPU/CPU Functions
 	void		InitializeShaders();
 	void		UpdateGPUBuffers();
 	void		UpdateCPU();
 	void		UpdateGPU();
+	void		UpdateComputeCPU();
+	bool		IsSimulatedOnGPUDevice() const;
 	 
 	//Gauss Seidel CPU
 	void		UpdateGaussSeidel();
-	void		ProjectConstraintsGaussSeidel();
+	void		ProjectConstraintsGaussSeidel(int solverIndex);
+	void		InitializeSleepIslands();
+	bool		IsConstraintAsleep(Constraint3D const& constraint) const;
 	void		ProjectDistanceConstraintGaussSeidel(int constraintIndex);
 	void		ProjectBendingConstraintGaussSeidel(int constraintIndex);
 	void		ProjectCollisionConstraintsSpheresGaussSeidel(int sentParticleIndex);
 	void		ProjectWorldBoundsConstraintsSpheresGaussSeidel(int sentParticleIndex);
 	void		ProjectCollisionConstraintsCapsulesGaussSeidel(int sentCapsuleIndex);
 	void		ProjectWorldBoundsConstraintsCapsulesGaussSeidel(int sentCapsuleIndex);
+	void		ProjectCollisionWorldConstraintsGaussSeidel();
+	void		ProjectRigidBodyAttachmentsGaussSeidel();
+	void		AddRigidBodyReaction(RigidBody3D* rigidBody, int particleIndex, Vec3 const& particleCorrection);
+	void		ApplyRigidBodyImpulses();
+	int			GetRigidBodyAttachmentIndex(int particleIndex) const;
+	void		RemoveRigidBodyAttachment(int attachmentIndex);
 
 	//Jacobi CPU
 	void		UpdateJacobi();
@@ -240,6 +217,7 @@ private:
 	int			GetRegionIndexForCoords(IntVec3 const& coords);
 	IntVec3		GetCoordsForRegionIndex(int const& region);
 	void		UpdateCollisionCapsulesFromParticle(int const& sentParticleIndex);
+	void		ClampProposedPositionsToTimeOfImpact();
 	void		UpdateProposedParticlesFromCollisionCapsule(int const& sentCapsuleIndex);
 	void		UpdateNeighboringCollisionCapsules(int const& sentCapsuleIndex);
 	void		AddCollidingRopeParticle(int const& particleIndex);
@@ -254,7 +232,15 @@ public:
 	std::vector<Constraint3D>				m_distanceConstraints;
 	std::vector<Constraint3D>				m_bendingConstraints;
 	std::vector<CapsuleCollisionObject>		m_collisionCapsules;
-	std::vector<CollisionObject*>			m_collisionObjects;
+	std::vector<CollisionObject*>			m_collisionObjects;				// this rope's own obstacles, they carry its bit regions and capsule Jacobi totals so they can not be shared
+	CollisionWorld*							m_collisionWorld = nullptr;		// optional shared scene, not owned; only the CPU Gauss Seidel solver queries it
+	std::vector<CollisionContact>			m_collisionWorldContacts;
+	std::vector<int>						m_collisionWorldHandles;
+	std::vector<Capsule3>					m_collisionWorldCapsules;
+	std::vector<RopeRigidBodyAttachment>	m_rigidBodyAttachments;
+	std::vector<int>						m_rigidBodyAttachmentSlots;		// per particle, its index in m_rigidBodyAttachments or -1
+	std::vector<RopeRigidBodyImpulse>		m_pendingRigidBodyImpulses;		// gathered over one substep, flushed into the bodies at its end
+	std::vector<int>						m_pendingImpulseSlots;			// per particle, the impulse it last added this substep or -1
 	std::vector<Vertex_PCU>					m_verts;
 	std::vector<int>						m_attachedParticleIndices;
 	std::vector<int>						m_collisionParticleIndices;
@@ -263,7 +249,10 @@ public:
 	Vec3									m_ropeStartPosition;
 	Vec3									m_ropeEndPosition;
 	float									m_physicsTimestep = 0.0005f;
-	float									m_physicsDebt = 0.0f;
+	FixedTimestepScheduler					m_fixedTimestepScheduler;
+	std::vector<Vec3>						m_previousPositions;
+	std::vector<Vec3>						m_renderPositions;
+	float									m_interpolationAlpha = 0.0f;
 	float									m_desiredDistance = 0.0f;
 	float									m_bendingConstraintDistance = 0.0f;
 	float									m_bendingCoefficient = 0.0f;
@@ -294,6 +283,16 @@ public:
 	bool									m_isSelfCollisionEnabled = true;
 	bool									m_isHierarchical = false;
 
+	//Sleeping, CPU Gauss Seidel only. Spans that stay slow are pinned and only collision tested once per substep until disturbed
+	bool									m_isSleepingEnabled = true;
+	int										m_sleepSpanSize = 8;
+	SleepIslands							m_sleepIslands;
+
+	//Continuous collision, CPU solvers only. Particles moving further than half their radius in a substep are swept from
+	//their last position and stopped at the first collision object they would have passed through
+	bool									m_isContinuousCollisionEnabled = true;
+	std::vector<int>						m_continuousCollisionHandles;
+
 	//Bit Bucket Variables / Collision Variables
 	VertexBuffer*							m_bitRegionVertexBuffer = nullptr;
 	std::vector<AABB3>						m_macroBitRegionBounds;
@@ -368,4 +367,9 @@ public:
 	bool									m_readyToQuery = false;
 	bool									m_hasGPUSwitchOccured = false;
 	bool									m_shouldRunGameUpdateComputeShader = false;
-};
\ No newline at end of file
+
+	//Compute shader pipeline run on the CPU, always used when m_isGPUSimulated is set without a renderer.
+	//Set m_hasGPUSwitchOccured after toggling it with a renderer so the particle buffers are synced.
+	bool									m_isComputeOnCPU = false;
+	RopeComputeCPU*							m_computeCPU = nullptr;
+};
\ No newline at end of file
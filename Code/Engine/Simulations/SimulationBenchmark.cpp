@@ -0,0 +1,240 @@
+#include "SimulationBenchmark.hpp"
+#include "Game/EngineBuildPreferences.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Simulations/RopeSimulation3D.hpp"
+#include "Engine/Simulations/ClothSimulation3D.hpp"
+#include "Engine/Simulations/RopePool.hpp"
+#include "Engine/Simulations/PhysicsScene3D.hpp"
+#include "Engine/Simulations/RigidBody3D.hpp"
+#include "Engine/Simulations/Collider3D.hpp"
+#include "Engine/Simulations/PBDRope2D.hpp"
+#include "Engine/Simulations/MassSpringRope2D.hpp"
+#include "Engine/Math/ConvexHull3D.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//-----------------------------------------------------------------------------------------------
+#if defined( ENGINE_BENCHMARK_COUNT_ALLOCATIONS )
+static std::atomic<uint64_t> s_numAllocations = 0;
+
+//-----------------------------------------------------------------------------------------------
+void* operator new(size_t numBytes)
+{
+	s_numAllocations.fetch_add(1, std::memory_order_relaxed);
+	void* allocation = malloc(numBytes == 0 ? 1 : numBytes);
+	if (allocation == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return allocation;
+}
+
+//-----------------------------------------------------------------------------------------------
+void operator delete(void* allocation) noexcept
+{
+	free(allocation);
+}
+
+//-----------------------------------------------------------------------------------------------
+void operator delete(void* allocation, size_t) noexcept
+{
+	free(allocation);
+}
+
+//-----------------------------------------------------------------------------------------------
+static uint64_t GetNumAllocations()
+{
+	return s_numAllocations.load(std::memory_order_relaxed);
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// Runs the same stepping order a FixedTimestepScheduler would, one BeginFixedUpdates/EndFixedUpdates per frame
+static SimulationBenchmarkResult BenchmarkSimulation(std::string const& name, FixedTimestepSimulation* simulation, int numParticles,
+	SimulationBenchmarkConfig const& config)
+{
+	int numSubstepsPerFrame = static_cast<int>(config.m_frameSeconds / config.m_physicsTimestep);
+	if (numSubstepsPerFrame < 1)
+	{
+		numSubstepsPerFrame = 1;
+	}
+
+	//One untimed frame so first touch costs stay out of the numbers
+	simulation->BeginFixedUpdates(numSubstepsPerFrame);
+	for (int substepIndex = 0; substepIndex < numSubstepsPerFrame; substepIndex++)
+	{
+		simulation->FixedUpdate(config.m_physicsTimestep);
+	}
+	simulation->EndFixedUpdates(0.0f);
+
+#if defined( ENGINE_BENCHMARK_COUNT_ALLOCATIONS )
+	uint64_t startAllocations = GetNumAllocations();
+#endif
+	uint64_t startTicks = GetCurrentTimeTicks();
+	for (int frameIndex = 0; frameIndex < config.m_numFrames; frameIndex++)
+	{
+		simulation->BeginFixedUpdates(numSubstepsPerFrame);
+		for (int substepIndex = 0; substepIndex < numSubstepsPerFrame; substepIndex++)
+		{
+			if (substepIndex == numSubstepsPerFrame - 1)
+			{
+				simulation->SavePreviousState();
+			}
+			simulation->FixedUpdate(config.m_physicsTimestep);
+		}
+		simulation->EndFixedUpdates(0.0f);
+	}
+	uint64_t endTicks = GetCurrentTimeTicks();
+
+	SimulationBenchmarkResult result;
+	result.m_name = name;
+	result.m_numParticles = numParticles;
+	result.m_numSubsteps = numSubstepsPerFrame * config.m_numFrames;
+	double totalNanoseconds = static_cast<double>(endTicks - startTicks) * GetSecondsPerTimeTick() * 1000000000.0;
+	result.m_totalMilliseconds = totalNanoseconds / 1000000.0;
+	if (result.m_numSubsteps > 0)
+	{
+		result.m_nanosecondsPerSubstep = totalNanoseconds / static_cast<double>(result.m_numSubsteps);
+		if (numParticles > 0)
+		{
+			result.m_nanosecondsPerParticle = result.m_nanosecondsPerSubstep / static_cast<double>(numParticles);
+		}
+#if defined( ENGINE_BENCHMARK_COUNT_ALLOCATIONS )
+		result.m_allocationsPerSubstep = static_cast<double>(GetNumAllocations() - startAllocations) / static_cast<double>(result.m_numSubsteps);
+#endif
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+std::vector<SimulationBenchmarkResult> RunSimulationBenchmarks(SimulationBenchmarkConfig const& config)
+{
+	std::vector<SimulationBenchmarkResult> results;
+	AABB3 worldBounds(Vec3(-10.0f, -10.0f, 0.0f), Vec3(10.0f, 10.0f, 20.0f));
+
+	//Rope 3D, there is no renderer so the compute shader pipeline runs on its CPU backend
+	char const* ropeSolverNames[] = { "RopeSimulation3D_GaussSeidel", "RopeSimulation3D_Jacobi", "RopeSimulation3D_ComputeCPU" };
+	for (int solverIndex = 0; solverIndex < 3; solverIndex++)
+	{
+		RopeSimulation3D* rope = new RopeSimulation3D(nullptr, worldBounds, config.m_numRopeParticles, 1.0f, 0.999f, 1.0f, 1.0f, 0.5f, 0.5f, 0.3f,
+			config.m_numRopeSolverIterations, Vec3(-5.0f, 0.0f, 15.0f), Vec3(5.0f, 0.0f, 15.0f), config.m_physicsTimestep,
+			CollisionType::SPHERES, false, 0, 0, 0, 0, 0, 0);
+		rope->m_isJacobiSolver = (solverIndex == 1);
+		rope->m_isGPUSimulated = (solverIndex == 2);
+		results.push_back(BenchmarkSimulation(ropeSolverNames[solverIndex], rope, static_cast<int>(rope->m_particles.m_positions.size()), config));
+		delete rope;
+	}
+
+	//Many short ropes sharing one pool, hung in a grid under the top of the world, then again colliding with each other
+	for (int collisionIndex = 0; collisionIndex < 2; collisionIndex++)
+	{
+		RopePoolConfig poolConfig;
+		poolConfig.m_worldBounds = worldBounds;
+		poolConfig.m_physicsTimestep = config.m_physicsTimestep;
+		poolConfig.m_totalSolverIterations = config.m_numRopeSolverIterations;
+		poolConfig.m_isRopeCollisionEnabled = (collisionIndex == 1);
+		RopePool* pool = new RopePool(poolConfig);
+		int numRopesPerRow = static_cast<int>(sqrtf(static_cast<float>(config.m_numPoolRopes))) + 1;
+		for (int ropeIndex = 0; ropeIndex < config.m_numPoolRopes; ropeIndex++)
+		{
+			Vec3 start(-9.0f + 18.0f * static_cast<float>(ropeIndex % numRopesPerRow) / static_cast<float>(numRopesPerRow),
+				-9.0f + 18.0f * static_cast<float>(ropeIndex / numRopesPerRow) / static_cast<float>(numRopesPerRow), 19.0f);
+			pool->AddRope(config.m_numPoolRopeParticles, 1.0f, start, start + Vec3(1.0f, 0.0f, 0.0f));
+		}
+		results.push_back(BenchmarkSimulation(poolConfig.m_isRopeCollisionEnabled ? "RopePool_RopeCollisions" : "RopePool", pool, pool->GetNumParticles(), config));
+		delete pool;
+	}
+
+	//Cloth
+	{
+		ClothSimulation3D* cloth = new ClothSimulation3D(nullptr, worldBounds, Vec2(4.0f, 4.0f), config.m_numClothParticles,
+			config.m_numClothSolverIterations, Vec3(-2.0f, 0.0f, 15.0f), Vec3(2.0f, 0.0f, 15.0f));
+		results.push_back(BenchmarkSimulation("ClothSimulation3D", cloth, static_cast<int>(cloth->m_particles.m_positions.size()), config));
+		delete cloth;
+	}
+
+	//Rigid bodies loaded from the model definitions, stacked without overlapping so they fall onto each other
+	{
+		PhysicsScene3D* scene = new PhysicsScene3D(AABB3(Vec3(-30.0f, -30.0f, 0.0f), Vec3(30.0f, 30.0f, 60.0f)));
+		std::vector<RigidBody3D*> rigidBodies;
+		for (int copyIndex = 0; copyIndex < config.m_numRigidBodyCopies; copyIndex++)
+		{
+			for (int fileIndex = 0; fileIndex < static_cast<int>(config.m_rigidBodyXmlFiles.size()); fileIndex++)
+			{
+				RigidBody3D* rigidBody = new RigidBody3D(config.m_rigidBodyXmlFiles[fileIndex], 1.0f);
+				rigidBody->m_position = Vec3(static_cast<float>(fileIndex) * 12.0f - 12.0f, 0.0f, 3.0f + static_cast<float>(copyIndex) * 8.0f);
+				rigidBody->m_isGravityEnabled = true;
+				rigidBodies.push_back(rigidBody);
+				scene->AddRigidBody(rigidBody);
+			}
+		}
+		results.push_back(BenchmarkSimulation("PhysicsScene3D", scene, static_cast<int>(rigidBodies.size()), config));
+		delete scene;
+
+		for (int bodyIndex = 0; bodyIndex < static_cast<int>(rigidBodies.size()); bodyIndex++)
+		{
+			delete rigidBodies[bodyIndex];
+		}
+	}
+
+	//PBD rope 2D
+	{
+		PBDRope2D* rope = new PBDRope2D(config.m_numRope2DParticles, 1.0f, 0.999f, 1.0f, 0.5f, 0.5f, 0.3f, config.m_numRopeSolverIterations,
+			Vec2(10.0f, 40.0f), Vec2(60.0f, 40.0f), config.m_physicsTimestep);
+		results.push_back(BenchmarkSimulation("PBDRope2D", rope, rope->m_particles.GetNumParticles(), config));
+		delete rope;
+	}
+
+	//Mass spring rope 2D, one run per integrator
+	char const* integrationMethodNames[IntegrationMethod::COUNT] = { "ExplicitEuler", "SemiImplicitEuler", "Midpoint", "RungeKutta", "Verlet", "ImplicitEuler" };
+	for (int methodIndex = 0; methodIndex < IntegrationMethod::COUNT; methodIndex++)
+	{
+		MassSpringRope2D* rope = new MassSpringRope2D(static_cast<IntegrationMethod>(methodIndex), config.m_numRope2DParticles, 500.0f, 0.5f, 1.0f,
+			Vec2(10.0f, 40.0f), Vec2(60.0f, 40.0f));
+		rope->m_physicsTimestep = config.m_physicsTimestep;
+		results.push_back(BenchmarkSimulation(Stringf("MassSpringRope2D_%s", integrationMethodNames[methodIndex]), rope,
+			rope->m_particles.GetNumParticles(), config));
+		delete rope;
+	}
+
+	if (!config.m_jsonOutputPath.empty())
+	{
+		std::string jsonText = GetSimulationBenchmarkResultsAsJson(config, results);
+		std::vector<uint8_t> jsonBuffer(jsonText.begin(), jsonText.end());
+		if (!FileWriteToFileBinary(jsonBuffer, config.m_jsonOutputPath))
+		{
+			DebuggerPrintf("Could not write simulation benchmark results to %s\n", config.m_jsonOutputPath.c_str());
+		}
+	}
+
+	for (int resultIndex = 0; resultIndex < static_cast<int>(results.size()); resultIndex++)
+	{
+		SimulationBenchmarkResult const& result = results[resultIndex];
+		DebuggerPrintf("[benchmark] %-36s %6d particles %10.1f ns/substep %8.2f ns/particle %6.2f allocs/substep\n", result.m_name.c_str(),
+			result.m_numParticles, result.m_nanosecondsPerSubstep, result.m_nanosecondsPerParticle, result.m_allocationsPerSubstep);
+	}
+	return results;
+}
+
+//-----------------------------------------------------------------------------------------------
+std::string GetSimulationBenchmarkResultsAsJson(SimulationBenchmarkConfig const& config, std::vector<SimulationBenchmarkResult> const& results)
+{
+	std::string jsonText = "{\n";
+	jsonText += Stringf("\t\"numFrames\": %d,\n\t\"frameSeconds\": %f,\n\t\"physicsTimestep\": %f,\n", config.m_numFrames, config.m_frameSeconds, config.m_physicsTimestep);
+	jsonText += "\t\"results\": [\n";
+	for (int resultIndex = 0; resultIndex < static_cast<int>(results.size()); resultIndex++)
+	{
+		SimulationBenchmarkResult const& result = results[resultIndex];
+		jsonText += Stringf("\t\t{ \"name\": \"%s\", \"particles\": %d, \"substeps\": %d, \"totalMs\": %.3f, \"nsPerSubstep\": %.1f, \"nsPerParticle\": %.3f, \"allocsPerSubstep\": %.3f }%s\n",
+			result.m_name.c_str(), result.m_numParticles, result.m_numSubsteps, result.m_totalMilliseconds, result.m_nanosecondsPerSubstep,
+			result.m_nanosecondsPerParticle, result.m_allocationsPerSubstep, resultIndex + 1 < static_cast<int>(results.size()) ? "," : "");
+	}
+	jsonText += "\t]\n}\n";
+	return jsonText;
+}
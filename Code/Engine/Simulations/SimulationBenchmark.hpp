@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Steps every solver without a window, renderer or input so solver throughput can be tracked over time.
+// #define ENGINE_BENCHMARK_COUNT_ALLOCATIONS in your game's Code/Game/EngineBuildPreferences.hpp to also count
+// heap allocations per substep (this replaces the global operator new, so only turn it on in a benchmark build).
+struct SimulationBenchmarkConfig
+{
+	int							m_numFrames = 600;
+	float						m_frameSeconds = 1.0f / 60.0f;
+	float						m_physicsTimestep = 0.005f;
+	int							m_numRopeParticles = 128;
+	int							m_numRopeSolverIterations = 10;
+	int							m_numPoolRopes = 200;
+	int							m_numPoolRopeParticles = 16;
+	int							m_numClothParticles = 1024;
+	int							m_numClothSolverIterations = 10;
+	int							m_numRope2DParticles = 64;
+	int							m_numRigidBodyCopies = 2;
+	std::vector<std::string>	m_rigidBodyXmlFiles = { "Data/Models/Cube_vf.xml", "Data/Models/Cubeoid_vf.xml", "Data/Models/Dodecahedron_vf.xml" };
+	std::string					m_jsonOutputPath = "Data/Benchmarks/SimulationBenchmark.json";		// empty skips writing
+};
+
+//-----------------------------------------------------------------------------------------------
+struct SimulationBenchmarkResult
+{
+	std::string		m_name;
+	int				m_numParticles = 0;					// bodies for PhysicsScene3D
+	int				m_numSubsteps = 0;
+	double			m_totalMilliseconds = 0.0;
+	double			m_nanosecondsPerSubstep = 0.0;
+	double			m_nanosecondsPerParticle = 0.0;		// per particle per substep
+	double			m_allocationsPerSubstep = -1.0;		// -1 when allocation counting is compiled out
+};
+
+//-----------------------------------------------------------------------------------------------
+std::vector<SimulationBenchmarkResult>	RunSimulationBenchmarks(SimulationBenchmarkConfig const& config);
+std::string								GetSimulationBenchmarkResultsAsJson(SimulationBenchmarkConfig const& config, std::vector<SimulationBenchmarkResult> const& results);
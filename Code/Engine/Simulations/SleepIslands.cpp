@@ -0,0 +1,124 @@
+#include "SleepIslands.hpp"
+#include "Particles3D.hpp"
+
+//-----------------------------------------------------------------------------------------------
+void SleepIslands::Initialize(std::vector<int> const& particleIslandIndices, int numIslands)
+{
+	m_particleIslandIndices = particleIslandIndices;
+	m_islandRestSeconds.assign(numIslands, 0.0f);
+	m_isIslandAsleep.assign(numIslands, 0);
+	m_isIslandSlow.assign(numIslands, 0);
+	m_numSleepingIslands = 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+void SleepIslands::WakeParticle(int particleIndex)
+{
+	if (particleIndex < 0 || particleIndex >= static_cast<int>(m_particleIslandIndices.size()))
+	{
+		return;
+	}
+	WakeIsland(m_particleIslandIndices[particleIndex]);
+}
+
+//-----------------------------------------------------------------------------------------------
+void SleepIslands::WakeIsland(int islandIndex)
+{
+	//Restarting the timer also keeps an island that is woken every substep from dozing off
+	m_islandRestSeconds[islandIndex] = 0.0f;
+	if (m_isIslandAsleep[islandIndex] != 0)
+	{
+		m_isIslandAsleep[islandIndex] = 0;
+		m_numSleepingIslands--;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SleepIslands::WakeAll()
+{
+	if (m_numSleepingIslands == 0)
+	{
+		return;
+	}
+
+	for (int islandIndex = 0; islandIndex < GetNumIslands(); islandIndex++)
+	{
+		WakeIsland(islandIndex);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SleepIslands::WakeDisturbedIslands(Particles3D& particles)
+{
+	if (m_numSleepingIslands == 0)
+	{
+		return;
+	}
+
+	float wakeDistanceSquared = m_wakeDistanceThreshold * m_wakeDistanceThreshold;
+	for (int particleIndex = 0; particleIndex < static_cast<int>(m_particleIslandIndices.size()); particleIndex++)
+	{
+		if (IsParticleAsleep(particleIndex) && (particles.m_proposedPositions[particleIndex] - particles.m_positions[particleIndex]).GetLengthSquared() > wakeDistanceSquared)
+		{
+			WakeIsland(m_particleIslandIndices[particleIndex]);
+		}
+	}
+
+	//Still asleep, so undo whatever small nudges the solve made and leave no velocity behind
+	for (int particleIndex = 0; particleIndex < static_cast<int>(m_particleIslandIndices.size()); particleIndex++)
+	{
+		if (IsParticleAsleep(particleIndex))
+		{
+			particles.m_proposedPositions[particleIndex] = particles.m_positions[particleIndex];
+			particles.m_collisionNormals[particleIndex] = Vec3();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SleepIslands::UpdateRestTimes(Particles3D& particles, float deltaSeconds)
+{
+	int numIslands = GetNumIslands();
+	float sleepVelocitySquared = m_sleepVelocityThreshold * m_sleepVelocityThreshold;
+	m_isIslandSlow.assign(numIslands, 1);
+	for (int particleIndex = 0; particleIndex < static_cast<int>(m_particleIslandIndices.size()); particleIndex++)
+	{
+		if (particles.m_velocities[particleIndex].GetLengthSquared() > sleepVelocitySquared)
+		{
+			m_isIslandSlow[m_particleIslandIndices[particleIndex]] = 0;
+		}
+	}
+
+	bool hasFallenAsleep = false;
+	for (int islandIndex = 0; islandIndex < numIslands; islandIndex++)
+	{
+		if (m_isIslandAsleep[islandIndex] != 0)
+		{
+			continue;
+		}
+		if (m_isIslandSlow[islandIndex] == 0)
+		{
+			m_islandRestSeconds[islandIndex] = 0.0f;
+			continue;
+		}
+
+		m_islandRestSeconds[islandIndex] += deltaSeconds;
+		if (m_islandRestSeconds[islandIndex] >= m_secondsBeforeSleep)
+		{
+			m_isIslandAsleep[islandIndex] = 1;
+			m_numSleepingIslands++;
+			hasFallenAsleep = true;
+		}
+	}
+
+	if (hasFallenAsleep)
+	{
+		for (int particleIndex = 0; particleIndex < static_cast<int>(m_particleIslandIndices.size()); particleIndex++)
+		{
+			if (IsParticleAsleep(particleIndex))
+			{
+				particles.m_velocities[particleIndex] = Vec3();
+			}
+		}
+	}
+}
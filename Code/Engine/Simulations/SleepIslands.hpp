@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+struct Particles3D;
+
+//-----------------------------------------------------------------------------------------------
+// Groups particles into islands (rope spans, cloth patches) that fall asleep together once every particle in them has
+// stayed slow long enough. The owning simulation skips sleeping particles and calls WakeDisturbedIslands after its solve,
+// so anything that pushed a sleeping particle (a contact, a moving neighbour) wakes the whole island on the next substep.
+class SleepIslands
+{
+public:
+	SleepIslands() {}
+	~SleepIslands() {}
+
+	void			Initialize(std::vector<int> const& particleIslandIndices, int numIslands);
+	bool			IsInitialized(int numParticles) const { return static_cast<int>(m_particleIslandIndices.size()) == numParticles; }
+	int				GetNumIslands() const { return static_cast<int>(m_isIslandAsleep.size()); }
+	int				GetNumSleepingIslands() const { return m_numSleepingIslands; }
+	bool			IsAnyAsleep() const { return m_numSleepingIslands > 0; }
+	bool			AreAllAsleep() const { return m_numSleepingIslands > 0 && m_numSleepingIslands == GetNumIslands(); }
+	bool			IsParticleAsleep(int particleIndex) const { return m_numSleepingIslands > 0 && m_isIslandAsleep[m_particleIslandIndices[particleIndex]] != 0; }
+
+	void			WakeParticle(int particleIndex);
+	void			WakeIsland(int islandIndex);
+	void			WakeAll();
+
+	//Before velocities are derived: wakes islands whose sleeping particles were moved, and holds the rest exactly in place
+	void			WakeDisturbedIslands(Particles3D& particles);
+	//After positions are committed: islands that stayed under the velocity threshold long enough go to sleep
+	void			UpdateRestTimes(Particles3D& particles, float deltaSeconds);
+
+public:
+	float				m_sleepVelocityThreshold = 0.05f;
+	float				m_secondsBeforeSleep = 0.5f;
+	float				m_wakeDistanceThreshold = 0.0005f;
+
+protected:
+	std::vector<int>	m_particleIslandIndices;
+	std::vector<float>	m_islandRestSeconds;
+	std::vector<int>	m_isIslandAsleep;
+	std::vector<int>	m_isIslandSlow;
+	int					m_numSleepingIslands = 0;
+};
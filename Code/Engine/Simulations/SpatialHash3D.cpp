@@ -0,0 +1,205 @@
+#include "SpatialHash3D.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <algorithm>
+#include <cmath>
+
+//-----------------------------------------------------------------------------------------------
+// Past this many cells a query dedupes with a sort instead of remembering visited table entries
+constexpr int MAX_TRACKED_QUERY_CELLS = 64;
+
+//-----------------------------------------------------------------------------------------------
+template<typename CellFunction>
+static void ForEachCellInRange(IntVec3 const& minCell, IntVec3 const& maxCell, CellFunction const& cellFunction)
+{
+	for (int cellZ = minCell.z; cellZ <= maxCell.z; cellZ++)
+	{
+		for (int cellY = minCell.y; cellY <= maxCell.y; cellY++)
+		{
+			for (int cellX = minCell.x; cellX <= maxCell.x; cellX++)
+			{
+				cellFunction(cellX, cellY, cellZ);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+SpatialHash3D::SpatialHash3D(float cellSize)
+{
+	SetCellSize(cellSize);
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHash3D::SetCellSize(float cellSize)
+{
+	GUARANTEE_OR_DIE(cellSize > 0.0f, "SpatialHash3D cell size must be greater than zero");
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.0f / cellSize;
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHash3D::Build(std::vector<Vec3> const& positions)
+{
+	int numPoints = static_cast<int>(positions.size());
+	int tableSize = 1;
+	while (tableSize < 2 * numPoints)
+	{
+		tableSize <<= 1;
+	}
+	m_tableMask = static_cast<unsigned int>(tableSize - 1);
+	m_cellStarts.assign(tableSize + 1, 0);
+	m_sortedItemIndices.resize(numPoints);
+	m_pointTableIndices.resize(numPoints);
+	m_hasMultiCellItems = false;
+
+	//Count, prefix sum, then fill backwards so each entry ends up at its cell's start
+	for (int pointIndex = 0; pointIndex < numPoints; pointIndex++)
+	{
+		IntVec3 cellCoords = GetCellCoords(positions[pointIndex]);
+		m_pointTableIndices[pointIndex] = GetTableIndex(cellCoords.x, cellCoords.y, cellCoords.z);
+		m_cellStarts[m_pointTableIndices[pointIndex]]++;
+	}
+	int runningTotal = 0;
+	for (int tableIndex = 0; tableIndex < tableSize; tableIndex++)
+	{
+		runningTotal += m_cellStarts[tableIndex];
+		m_cellStarts[tableIndex] = runningTotal;
+	}
+	m_cellStarts[tableSize] = runningTotal;
+	for (int pointIndex = 0; pointIndex < numPoints; pointIndex++)
+	{
+		int tableIndex = m_pointTableIndices[pointIndex];
+		m_cellStarts[tableIndex]--;
+		m_sortedItemIndices[m_cellStarts[tableIndex]] = pointIndex;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHash3D::Build(std::vector<AABB3> const& bounds)
+{
+	int numItems = static_cast<int>(bounds.size());
+	int numCellEntries = 0;
+	for (int itemIndex = 0; itemIndex < numItems; itemIndex++)
+	{
+		IntVec3 minCell = GetCellCoords(bounds[itemIndex].m_mins);
+		IntVec3 maxCell = GetCellCoords(bounds[itemIndex].m_maxs);
+		numCellEntries += (maxCell.x - minCell.x + 1) * (maxCell.y - minCell.y + 1) * (maxCell.z - minCell.z + 1);
+	}
+
+	int tableSize = 1;
+	while (tableSize < 2 * numCellEntries)
+	{
+		tableSize <<= 1;
+	}
+	m_tableMask = static_cast<unsigned int>(tableSize - 1);
+	m_cellStarts.assign(tableSize + 1, 0);
+	m_sortedItemIndices.resize(numCellEntries);
+	m_hasMultiCellItems = true;
+
+	//Same count, prefix sum and backwards fill as the point build, walking each item's cells twice instead of caching them
+	for (int itemIndex = 0; itemIndex < numItems; itemIndex++)
+	{
+		ForEachCellInRange(GetCellCoords(bounds[itemIndex].m_mins), GetCellCoords(bounds[itemIndex].m_maxs), [&](int cellX, int cellY, int cellZ)
+		{
+			m_cellStarts[GetTableIndex(cellX, cellY, cellZ)]++;
+		});
+	}
+	int runningTotal = 0;
+	for (int tableIndex = 0; tableIndex < tableSize; tableIndex++)
+	{
+		runningTotal += m_cellStarts[tableIndex];
+		m_cellStarts[tableIndex] = runningTotal;
+	}
+	m_cellStarts[tableSize] = runningTotal;
+	for (int itemIndex = 0; itemIndex < numItems; itemIndex++)
+	{
+		ForEachCellInRange(GetCellCoords(bounds[itemIndex].m_mins), GetCellCoords(bounds[itemIndex].m_maxs), [&](int cellX, int cellY, int cellZ)
+		{
+			int tableIndex = GetTableIndex(cellX, cellY, cellZ);
+			m_cellStarts[tableIndex]--;
+			m_sortedItemIndices[m_cellStarts[tableIndex]] = itemIndex;
+		});
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+IntVec3 SpatialHash3D::GetCellCoords(Vec3 const& position) const
+{
+	return IntVec3(static_cast<int>(floorf(position.x * m_inverseCellSize)), static_cast<int>(floorf(position.y * m_inverseCellSize)),
+		static_cast<int>(floorf(position.z * m_inverseCellSize)));
+}
+
+//-----------------------------------------------------------------------------------------------
+int SpatialHash3D::GetTableIndex(int cellX, int cellY, int cellZ) const
+{
+	unsigned int hash = (static_cast<unsigned int>(cellX) * 92837111u) ^ (static_cast<unsigned int>(cellY) * 689287499u) ^ (static_cast<unsigned int>(cellZ) * 283923481u);
+	return static_cast<int>(hash & m_tableMask);
+}
+
+//-----------------------------------------------------------------------------------------------
+int SpatialHash3D::GetNumCellsOverlapped(AABB3 const& bounds, int maxCells) const
+{
+	//Done in floats so a huge or infinite box cannot overflow the cell count
+	float cellsX = floorf(bounds.m_maxs.x * m_inverseCellSize) - floorf(bounds.m_mins.x * m_inverseCellSize) + 1.0f;
+	float cellsY = floorf(bounds.m_maxs.y * m_inverseCellSize) - floorf(bounds.m_mins.y * m_inverseCellSize) + 1.0f;
+	float cellsZ = floorf(bounds.m_maxs.z * m_inverseCellSize) - floorf(bounds.m_mins.z * m_inverseCellSize) + 1.0f;
+	float numCells = cellsX * cellsY * cellsZ;
+	if (!(numCells <= static_cast<float>(maxCells)))
+	{
+		return maxCells + 1;
+	}
+	return static_cast<int>(numCells);
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHash3D::QueryAABB(AABB3 const& bounds, std::vector<int>& out_indices) const
+{
+	out_indices.clear();
+	if (m_cellStarts.size() < 2)
+	{
+		return;
+	}
+
+	//Different cells can share a table entry, so skip entries that were already gathered
+	int visitedTableIndices[MAX_TRACKED_QUERY_CELLS];
+	int numVisited = 0;
+	bool needsDedupe = m_hasMultiCellItems;
+	ForEachCellInRange(GetCellCoords(bounds.m_mins), GetCellCoords(bounds.m_maxs), [&](int cellX, int cellY, int cellZ)
+	{
+		int tableIndex = GetTableIndex(cellX, cellY, cellZ);
+		if (numVisited < MAX_TRACKED_QUERY_CELLS)
+		{
+			for (int visitedIndex = 0; visitedIndex < numVisited; visitedIndex++)
+			{
+				if (visitedTableIndices[visitedIndex] == tableIndex)
+				{
+					return;
+				}
+			}
+			visitedTableIndices[numVisited] = tableIndex;
+			numVisited++;
+		}
+		else
+		{
+			needsDedupe = true;
+		}
+
+		for (int sortedIndex = m_cellStarts[tableIndex]; sortedIndex < m_cellStarts[tableIndex + 1]; sortedIndex++)
+		{
+			out_indices.push_back(m_sortedItemIndices[sortedIndex]);
+		}
+	});
+
+	if (needsDedupe && out_indices.size() > 1)
+	{
+		std::sort(out_indices.begin(), out_indices.end());
+		out_indices.erase(std::unique(out_indices.begin(), out_indices.end()), out_indices.end());
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void SpatialHash3D::QueryRadius(Vec3 const& center, float radius, std::vector<int>& out_indices) const
+{
+	Vec3 extents(radius, radius, radius);
+	QueryAABB(AABB3(center - extents, center + extents), out_indices);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/IntVec3.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// Dense spatial hash over a set of points or boxes, rebuilt from scratch with a counting sort instead of updated in place.
+// Unbounded grid cells are hashed into a power of two table so memory only depends on the item count. Rebuilding reuses
+// the same arrays, so once warmed up it does not allocate. Queries are const and can run from several threads.
+class SpatialHash3D
+{
+public:
+	SpatialHash3D() {}
+	explicit SpatialHash3D(float cellSize);
+	~SpatialHash3D() {}
+
+	void			SetCellSize(float cellSize);
+	float			GetCellSize() const { return m_cellSize; }
+	void			Build(std::vector<Vec3> const& positions);
+	void			Build(std::vector<AABB3> const& bounds);		// item i goes into every cell bounds[i] overlaps
+
+	IntVec3			GetCellCoords(Vec3 const& position) const;
+	int				GetTableIndex(int cellX, int cellY, int cellZ) const;
+	int				GetNumCellsOverlapped(AABB3 const& bounds, int maxCells) const;		// maxCells + 1 once past maxCells
+
+	//Clears out_indices, then fills it with every item whose cell overlaps the bounds, each at most once.
+	//Items built from bounds come back sorted
+	void			QueryAABB(AABB3 const& bounds, std::vector<int>& out_indices) const;
+	void			QueryRadius(Vec3 const& center, float radius, std::vector<int>& out_indices) const;
+
+protected:
+	float				m_cellSize = 1.0f;
+	float				m_inverseCellSize = 1.0f;
+	unsigned int		m_tableMask = 0;
+	std::vector<int>	m_cellStarts;				// table size + 1, items of table entry i live in [m_cellStarts[i], m_cellStarts[i + 1])
+	std::vector<int>	m_sortedItemIndices;
+	std::vector<int>	m_pointTableIndices;
+	bool				m_hasMultiCellItems = false;
+};
@@ -13,17 +13,17 @@ Spring2D::~Spring2D()
 //-----------------------------------------------------------------------------------------------
 Spring2D::Spring2D(const Spring2D& copyFrom)
 {
-	m_particleA = copyFrom.m_particleA;
-	m_particleB = copyFrom.m_particleB;
+	m_particleIndexA = copyFrom.m_particleIndexA;
+	m_particleIndexB = copyFrom.m_particleIndexB;
 	m_stiffness = copyFrom.m_stiffness;
 	m_initialLength = copyFrom.m_initialLength;
 }
 
 //-----------------------------------------------------------------------------------------------
-Spring2D::Spring2D(Particle2D* particleA, Particle2D* particleB, float stiffness, float initialLength)
-	:m_particleA(particleA)
-	,m_particleB(particleB)
+Spring2D::Spring2D(int particleIndexA, int particleIndexB, float stiffness, float initialLength)
+	:m_particleIndexA(particleIndexA)
+	,m_particleIndexB(particleIndexB)
 	,m_stiffness(stiffness)
 	,m_initialLength(initialLength)
 {
-}
+}
\ No newline at end of file
@@ -1,20 +1,18 @@
 #pragma once
 
 //-----------------------------------------------------------------------------------------------
-struct Particle2D;
-
-//-----------------------------------------------------------------------------------------------
+// Joins two particles of a Particles2D block by index
 struct Spring2D
 {
 public:
 	Spring2D();
 	~Spring2D();
 	Spring2D(const Spring2D& copyFrom); 
-	explicit Spring2D(Particle2D* particleA, Particle2D* particleB, float stiffness, float initialLength);
+	explicit Spring2D(int particleIndexA, int particleIndexB, float stiffness, float initialLength);
 
 public:
-	Particle2D*	m_particleA = nullptr;
-	Particle2D*	m_particleB = nullptr;
+	int			m_particleIndexA = -1;
+	int			m_particleIndexB = -1;
 	float		m_stiffness = 0.0f;
 	float		m_initialLength = 0.0f;
-};
\ No newline at end of file
+};
\ No newline at end of file
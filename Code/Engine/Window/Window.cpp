@@ -50,8 +50,9 @@ LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessa
 
 		case WM_CHAR:
 		{
-			EventArgs args;
-			args.SetValue("Char", Stringf("%c", (char)wParam));
+			char inputChar = (char)wParam;
+			TypedEventArgs args;
+			args.SetValue(EVENT_ARG_CHAR, std::string_view(&inputChar, 1));
 			g_theEventSystem->FireEvent("CharInput", args);
 			return 0;
 		}
@@ -59,8 +60,8 @@ LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessa
 		// Raw physical keyboard "key-was-just-depressed" event (case-insensitive, not translated)
 		case WM_KEYDOWN:
 		{
-			EventArgs args;
-			args.SetValue("KeyCode", Stringf("%d", (unsigned char)wParam));
+			TypedEventArgs args;
+			args.SetValue(EVENT_ARG_KEY_CODE, int((unsigned char)wParam));
 			g_theEventSystem->FireEvent("KeyPressed", args);
 			return 0;
 		}
@@ -68,8 +69,8 @@ LRESULT CALLBACK WindowsMessageHandlingProcedure(HWND windowHandle, UINT wmMessa
 		// Raw physical keyboard "key-was-just-released" event (case-insensitive, not translated)
 		case WM_KEYUP:
 		{
-			EventArgs args;
-			args.SetValue("KeyCode", Stringf("%d", (unsigned char)wParam));
+			TypedEventArgs args;
+			args.SetValue(EVENT_ARG_KEY_CODE, int((unsigned char)wParam));
 			g_theEventSystem->FireEvent("KeyReleased", args);
 			return 0;
 		}